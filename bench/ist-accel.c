@@ -0,0 +1,456 @@
+
+/* hxnd: A framework for n-dimensional hypercomplex calculations for NMR.
+ * Copyright (C) 2014-2015  Bradley Worley  <geekysuavo@gmail.com>.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to:
+ *
+ *   Free Software Foundation, Inc.
+ *   51 Franklin Street, Fifth Floor
+ *   Boston, MA  02110-1301, USA.
+ */
+
+/* include the hypercomplex math header. */
+#include <hxnd/hx.h>
+
+/* BENCH_NTR, BENCH_NPT: number of traces and number of complex points per
+ * trace of the synthetic test spectrum.
+ */
+#define BENCH_NTR  32
+#define BENCH_NPT  256
+
+/* BENCH_NSCHED: number of sampled points in the fixed schedule.
+ */
+#define BENCH_NSCHED  64
+
+/* BENCH_NPEAK: number of peaks in the synthetic test spectrum.
+ */
+#define BENCH_NPEAK  6
+
+/* BENCH_NACCEL: number of compared ist acceleration schemes.
+ */
+#define BENCH_NACCEL  3
+
+/* BENCH_NTHRESH: number of compared ist thresholding factors.
+ */
+#define BENCH_NTHRESH  6
+
+/* BENCH_NREP: number of timed repetitions of each reconstruction, of
+ * which the fastest is reported.
+ */
+#define BENCH_NREP  3
+
+/* bench_rand(): return the next value of a fixed linear congruential
+ * sequence, so the schedule is identical on every platform.
+ * @state: pointer to the generator state.
+ */
+unsigned int bench_rand (unsigned int *state) {
+  /* advance the generator and return its upper bits. */
+  *state = *state * 1103515245u + 12345u;
+  return (*state >> 16) & 0x7fff;
+}
+
+/* bench_synth(): fill an array with a synthetic two-dimensional signal.
+ * each trace holds a sum of decaying complex sinusoids along the second
+ * dimension, whose amplitudes vary smoothly along the first dimension.
+ * @x: the structure pointer to the output array.
+ */
+void bench_synth (hx_array *x) {
+  /* declare peak parameters of the signal:
+   * @freq: frequency of each peak, in cycles per point.
+   * @decay: decay rate of each peak, in inverse points.
+   * @amp: amplitude of each peak.
+   * @ctr: center trace of each peak.
+   */
+  const real freq[BENCH_NPEAK] = { -0.31, -0.17, -0.04, 0.08, 0.21, 0.37 };
+  const real decay[BENCH_NPEAK] = { 0.010, 0.015, 0.008, 0.020, 0.012,
+                                    0.018 };
+  const real amp[BENCH_NPEAK] = { 1.0, 0.6, 0.8, 0.3, 0.5, 0.9 };
+  const real ctr[BENCH_NPEAK] = { 4.0, 10.0, 15.0, 19.0, 24.0, 28.0 };
+
+  /* declare a few required variables:
+   * @i: trace loop counter.
+   * @j: point loop counter.
+   * @p: peak loop counter.
+   * @a: amplitude of the current peak in the current trace.
+   * @re, @im: real and imaginary parts of the current point.
+   * @x0: coefficients of the current point.
+   */
+  int i, j, p;
+  real a, re, im, *x0;
+
+  /* loop over the points of the array. */
+  hx_array_zero(x);
+  for (j = 0; j < x->sz[1]; j++) {
+    for (i = 0; i < x->sz[0]; i++) {
+      /* sum the contributions of every peak. */
+      for (p = 0, re = im = 0.0; p < BENCH_NPEAK; p++) {
+        a = amp[p] * exp(-0.1 * (i - ctr[p]) * (i - ctr[p]));
+        re += a * exp(-decay[p] * j) * cos(2.0 * M_PI * freq[p] * j);
+        im += a * exp(-decay[p] * j) * sin(2.0 * M_PI * freq[p] * j);
+      }
+
+      /* store the point into the second-dimension basis elements. */
+      x0 = x->x + (i + j * x->sz[0]) * x->n;
+      x0[0] = re;
+      x0[2] = im;
+    }
+  }
+}
+
+/* bench_sched(): build a fixed schedule of sampled points, weighted
+ * towards the beginning of the signal.
+ * @sched: output array of sampled point indices.
+ * @n: number of points to sample.
+ * @len: number of points in the signal.
+ */
+void bench_sched (hx_index sched, int n, int len) {
+  /* declare a few required variables:
+   * @state: random number generator state.
+   * @mask: sampling status of each point.
+   * @i, @j: point loop counters.
+   * @u: uniform deviate.
+   */
+  unsigned int state = 1;
+  char mask[BENCH_NPT];
+  int i, j;
+  real u;
+
+  /* always sample the first point. */
+  memset(mask, 0, len);
+  mask[0] = 1;
+
+  /* draw exponentially distributed points until enough are sampled. */
+  for (i = 1; i < n;) {
+    u = (bench_rand(&state) + 0.5) / 32768.0;
+    j = (int) (-0.4 * len * log(u));
+    if (j < len && !mask[j]) {
+      mask[j] = 1;
+      i++;
+    }
+  }
+
+  /* store the sampled points in ascending order. */
+  for (i = 0, j = 0; i < len; i++) {
+    if (mask[i])
+      sched[j++] = i;
+  }
+}
+
+/* bench_error(): compute the relative error of a reconstructed array
+ * against its fully sampled source.
+ * @x: the structure pointer to the reconstructed array.
+ * @x0: the structure pointer to the fully sampled array.
+ */
+real bench_error (hx_array *x, hx_array *x0) {
+  /* declare a few required variables:
+   * @i: coefficient loop counter.
+   * @num, @den: squared norms of the error and the source.
+   */
+  real num, den;
+  int i;
+
+  /* sum the squared coefficients. */
+  for (i = 0, num = den = 0.0; i < x->len; i++) {
+    num += (x->x[i] - x0->x[i]) * (x->x[i] - x0->x[i]);
+    den += x0->x[i] * x0->x[i];
+  }
+
+  /* return the relative error. */
+  return sqrt(num / den);
+}
+
+/* bench_run(): reconstruct a subsampled array for a fixed number of
+ * iterations, returning the fastest wall time of several repetitions.
+ * @x: the structure pointer to the output array.
+ * @xs: the structure pointer to the subsampled array.
+ * @S: sampled and unsampled index sets of the schedule.
+ * @thresh: ist thresholding factor.
+ * @accel: ist acceleration scheme.
+ * @niter: number of iterations.
+ * @nrep: number of timed repetitions.
+ */
+double bench_run (hx_array *x, hx_array *xs, hx_sched *S, real thresh,
+                  enum hx_ist_accel accel, int niter, int nrep) {
+  /* declare a few required variables:
+   * @dx, @kx: algebraic and topological dimension indices.
+   * @stop: stopping criteria of the reconstruction.
+   * @t, @tmin: current and fastest wall times.
+   * @rep: repetition loop counter.
+   */
+  int dx[2] = { 0, 1 };
+  int kx[2] = { 0, 1 };
+  hx_nus_stop stop;
+  double t, tmin;
+  int rep;
+
+  /* loop over the repetitions. */
+  for (rep = 0, tmin = INFINITY; rep < nrep; rep++) {
+    /* start from the subsampled array. */
+    memcpy(x->x, xs->x, x->len * sizeof(real));
+
+    /* reconstruct for exactly the requested number of iterations. */
+    hx_nus_stop_init(&stop, niter);
+    t = omp_get_wtime();
+    if (!hx_array_ist(x, dx, kx, S, &stop, thresh, accel, 0)) {
+      hx_nus_stop_free(&stop);
+      return -1.0;
+    }
+
+    /* store the fastest wall time. */
+    t = omp_get_wtime() - t;
+    tmin = (t < tmin ? t : tmin);
+    hx_nus_stop_free(&stop);
+  }
+
+  /* return the fastest wall time. */
+  return tmin;
+}
+
+/* bench_search(): find the fewest iterations at which a reconstruction
+ * reaches a target relative error. each run repeats the iterates of every
+ * shorter run, so the count is bracketed by doubling and then refined by
+ * bisection, assuming the error does not rise again once it has fallen
+ * below the target. returns the iteration count, one more than the limit
+ * if the target was never reached, or -1 on failure.
+ * @x: the structure pointer to the output array.
+ * @xs: the structure pointer to the subsampled array.
+ * @x0: the structure pointer to the fully sampled array.
+ * @S: sampled and unsampled index sets of the schedule.
+ * @thresh: ist thresholding factor.
+ * @accel: ist acceleration scheme.
+ * @target: target relative error.
+ * @limit: maximum number of iterations.
+ * @err: pointer to the relative error at the returned count.
+ */
+int bench_search (hx_array *x, hx_array *xs, hx_array *x0, hx_sched *S,
+                  real thresh, enum hx_ist_accel accel, real target,
+                  int limit, real *err) {
+  /* declare a few required variables:
+   * @lo: largest count known to miss the target.
+   * @hi: smallest count known to reach the target.
+   * @n: current iteration count.
+   * @e, @ehi: relative errors at the current and upper counts.
+   */
+  int lo, hi, n;
+  real e, ehi;
+
+  /* double the count until the target is reached. */
+  for (lo = 0, hi = 1; ; lo = hi, hi *= 2) {
+    /* clamp the count to the limit. */
+    hi = (hi > limit ? limit : hi);
+
+    /* reconstruct and measure the error. */
+    if (bench_run(x, xs, S, thresh, accel, hi, 1) < 0.0)
+      return -1;
+
+    /* stop once the target is reached. */
+    ehi = bench_error(x, x0);
+    if (ehi <= target)
+      break;
+
+    /* stop once the limit is reached. */
+    if (hi == limit) {
+      *err = ehi;
+      return limit + 1;
+    }
+  }
+
+  /* bisect the bracketing counts. */
+  while (hi - lo > 1) {
+    /* reconstruct and measure the error at the midpoint. */
+    n = (lo + hi) / 2;
+    if (bench_run(x, xs, S, thresh, accel, n, 1) < 0.0)
+      return -1;
+
+    /* replace one of the bracketing counts. */
+    e = bench_error(x, x0);
+    if (e <= target) {
+      hi = n;
+      ehi = e;
+    }
+    else
+      lo = n;
+  }
+
+  /* return the smallest count that reached the target. */
+  *err = ehi;
+  return hi;
+}
+
+/* main(): compare the iterations and wall time required by each ist
+ * acceleration scheme to reach a target relative error on a synthetic
+ * test spectrum, subsampled by a fixed schedule. accelerated iterations
+ * tolerate a faster threshold decay, so each scheme is run over a range
+ * of thresholding factors and compared at its own best factor, unless a
+ * single factor is given.
+ *
+ * usage: ist-accel [target-error] [iteration-limit] [thresh]
+ */
+int main (int argc, char **argv) {
+  /* declare variables for the benchmark parameters:
+   * @target: target relative error of the reconstruction.
+   * @limit: maximum number of iterations to search.
+   * @thresh: ist thresholding factors to compare.
+   * @nthresh: number of thresholding factors.
+   */
+  real target = 0.05;
+  int limit = 200;
+  real thresh[BENCH_NTHRESH] = { 0.6, 0.7, 0.8, 0.85, 0.9, 0.95 };
+  int nthresh = BENCH_NTHRESH;
+
+  /* declare variables for the test spectrum:
+   * @x0: fully sampled source array.
+   * @xs: subsampled input array.
+   * @x: reconstructed output array.
+   * @sz: topological array size.
+   */
+  hx_array x0, xs, x;
+  int sz[2] = { BENCH_NTR, BENCH_NPT };
+
+  /* declare variables for the sampling schedule:
+   * @sched: sampled point indices.
+   * @S: sampled and unsampled index sets over the reconstruction grid.
+   * @grid: size of the reconstruction grid.
+   */
+  int sched[BENCH_NSCHED];
+  int grid = 2 * BENCH_NPT;
+  hx_sched S;
+
+  /* declare variables for the compared schemes:
+   * @names: acceleration scheme names.
+   * @accel: current acceleration scheme.
+   * @err: relative error of the current reconstruction.
+   * @n: iteration count of the current reconstruction.
+   * @best: index of the fastest-converging factor of each scheme.
+   * @nbest, @ebest: iteration count and error at that factor.
+   * @tbest: wall time to the target at that factor.
+   * @i, @j: general purpose loop counters.
+   */
+  const char *names[BENCH_NACCEL] = {
+    HX_IST_ACCEL_NAME_NONE,
+    HX_IST_ACCEL_NAME_FISTA,
+    HX_IST_ACCEL_NAME_RESTART
+  };
+  int best[BENCH_NACCEL], nbest[BENCH_NACCEL];
+  real ebest[BENCH_NACCEL];
+  double tbest[BENCH_NACCEL];
+  enum hx_ist_accel accel;
+  real err;
+  int i, j, n;
+
+  /* read the optional benchmark parameters. */
+  if (argc > 1) target = atof(argv[1]);
+  if (argc > 2) limit = atoi(argv[2]);
+  if (argc > 3) {
+    thresh[0] = atof(argv[3]);
+    nthresh = 1;
+  }
+
+  /* check the benchmark parameters. */
+  if (target <= 0.0 || limit < 1 || thresh[0] <= 0.0 || thresh[0] >= 1.0)
+    trace("usage: %s [target-error] [iteration-limit] [thresh]", argv[0]);
+
+  /* allocate the arrays. */
+  hx_array_init(&x0);
+  hx_array_init(&xs);
+  hx_array_init(&x);
+  if (!hx_array_alloc(&x0, 2, 2, sz) ||
+      !hx_array_alloc(&xs, 2, 2, sz) ||
+      !hx_array_alloc(&x, 2, 2, sz))
+    trace("failed to allocate (2, 2)-arrays");
+
+  /* synthesize the fully sampled test spectrum. */
+  bench_synth(&x0);
+
+  /* build the schedule and its index sets over the reconstruction grid. */
+  bench_sched(sched, BENCH_NSCHED, BENCH_NPT);
+  hx_sched_init(&S);
+  if (!hx_sched_build(&S, 1, &grid, 1, BENCH_NSCHED, sched))
+    trace("failed to build schedule index sets");
+
+  /* subsample the test spectrum, zeroing every unsampled point. */
+  hx_array_zero(&xs);
+  for (i = 0; i < BENCH_NSCHED; i++) {
+    j = sched[i] * x0.sz[0] * x0.n;
+    memcpy(xs.x + j, x0.x + j, x0.sz[0] * x0.n * sizeof(real));
+  }
+
+  /* print the benchmark configuration. */
+  printf("ist-accel: %d traces, %d of %d points sampled, %d threads\n",
+         BENCH_NTR, BENCH_NSCHED, BENCH_NPT, omp_get_max_threads());
+  printf("target relative error %.3e, iteration limit %d\n\n",
+         target, limit);
+  printf("  %-8s %8s %10s %12s\n", "accel", "thresh", "iters", "error");
+
+  /* loop over the acceleration schemes. */
+  for (i = 0; i < BENCH_NACCEL; i++) {
+    /* look up the acceleration scheme. */
+    accel = hx_ist_lookup_accel(names[i]);
+    best[i] = -1;
+    nbest[i] = limit + 1;
+    ebest[i] = INFINITY;
+    tbest[i] = 0.0;
+
+    /* loop over the thresholding factors. */
+    for (j = 0; j < nthresh; j++) {
+      /* find the fewest iterations that reach the target error. */
+      n = bench_search(&x, &xs, &x0, &S, thresh[j], accel, target, limit,
+                       &err);
+      if (n < 0)
+        trace("failed to reconstruct with accel=%s", names[i]);
+
+      /* report the iteration count, or its absence. */
+      if (n > limit)
+        printf("  %-8s %8.2f %10s %12.3e\n", names[i], thresh[j], "-", err);
+      else
+        printf("  %-8s %8.2f %10d %12.3e\n", names[i], thresh[j], n, err);
+
+      /* store the fastest-converging factor. */
+      if (n < nbest[i]) {
+        best[i] = j;
+        nbest[i] = n;
+        ebest[i] = err;
+      }
+    }
+
+    /* time the reconstruction to the target at the best factor. */
+    if (best[i] >= 0) {
+      tbest[i] = bench_run(&x, &xs, &S, thresh[best[i]], accel, nbest[i],
+                           BENCH_NREP);
+      if (tbest[i] < 0.0)
+        trace("failed to reconstruct with accel=%s", names[i]);
+    }
+  }
+
+  /* report each scheme at its best thresholding factor. */
+  printf("\n  %-8s %8s %10s %12s %12s\n",
+         "accel", "thresh", "iters", "time (s)", "error");
+  for (i = 0; i < BENCH_NACCEL; i++) {
+    if (best[i] < 0)
+      printf("  %-8s %8s %10s %12s %12s\n", names[i], "-", "-", "-", "-");
+    else
+      printf("  %-8s %8.2f %10d %12.4f %12.3e\n", names[i],
+             thresh[best[i]], nbest[i], tbest[i], ebest[i]);
+  }
+
+  /* free the arrays and schedule index sets. */
+  hx_array_free(&x0);
+  hx_array_free(&xs);
+  hx_array_free(&x);
+  hx_sched_free(&S);
+
+  /* return success. */
+  return 0;
+}
+
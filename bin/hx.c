@@ -20,10 +20,18 @@
  *   Boston, MA  02110-1301, USA.
  */
 
+/* request posix extensions for file status, directory and path queries. */
+#define _XOPEN_SOURCE 700
+
 /* include the datum and function headers. */
 #include <hxnd/nmr-datum.h>
 #include <hxnd/fn.h>
 
+/* include the posix file status, directory and process headers. */
+#include <sys/stat.h>
+#include <dirent.h>
+#include <unistd.h>
+
 /* include the portable option parsing header. */
 #include <hxnd/opts.h>
 
@@ -43,12 +51,26 @@
    -o, --output FOUT      Specify an output filename [stdout]\n\
    -F, --format FMT       Specify an output format [hx]\n\
    -p, --pretend          Perform no actual processing\n\
+   -s, --stream           Process pipe-format data one plane at a time\n\
+   -c, --cache DIR        Cache decoded input data in DIR (optional)\n\
    -f, --function FNDEF   Apply a processing function (optional)\n\
    -v, --value VALDEF     Change a parameter value (optional)\n\
 \n\
  The hx tool performs all functions required to convert and process NMR\n\
  time-domain and spectral data, based on the libhxnd framework for using\n\
  multidimensional arrays of hypercomplex numbers.\n\
+\n\
+ In streaming mode, pipe-format data is read from FIN and written to FOUT\n\
+ one plane at a time. Only functions that act along the first two\n\
+ dimensions may be applied in streaming mode.\n\
+\n\
+ The -o and -F options may be repeated to write several outputs. The\n\
+ n-th format applies to the n-th output, and the last format applies to\n\
+ any further outputs.\n\
+\n\
+ With a cache directory, decoded and corrected input data is stored as\n\
+ an hx-format file keyed by the input path, size, modification time and\n\
+ parameter values. Later runs on the unchanged input load that file.\n\
 \n\
  For more information on available processing functions and their syntax,\n\
  see the manual page for hx(1).\n\
@@ -75,6 +97,17 @@ int main_apply_procs (datum *D, struct parsed_arg *lst, unsigned int n);
 
 int main_apply_corrs (datum *D, struct parsed_arg *lst, unsigned int n);
 
+char *main_cache_name (const char *dname, const char *fname,
+                       struct parsed_arg *lst, unsigned int n);
+
+int main_stream_read (datum *D, datum *P, int p0, int np, FILE *fh);
+
+int main_stream_write (datum *D, datum *P, int p0, int np, FILE *fh);
+
+int main_stream (const char *fname_in, const char *fname_out,
+                 struct parsed_arg *procs, unsigned int n_procs,
+                 struct parsed_arg *corrs, unsigned int n_corrs);
+
 /* main(): application entry point.
  * @argc: argument count.
  * @argv: argument array.
@@ -92,6 +125,8 @@ int main (int argc, char **argv) {
     { "output",   1, 'o' },
     { "format",   1, 'F' },
     { "pretend",  0, 'p' },
+    { "stream",   0, 's' },
+    { "cache",    1, 'c' },
     { "function", 1, 'f' },
     { "value",    1, 'v' },
     { NULL, 0, '\0' }
@@ -105,21 +140,54 @@ int main (int argc, char **argv) {
   int c;
 
   /* declare variables for file input/output:
-   * @fmt_out: output file format.
-   * @fname_out: output filename.
+   * @fmt_out: output file formats.
+   * @fname_out: output filenames.
+   * @n_fmt: number of output formats.
+   * @n_out: number of output filenames.
+   * @n_enc: number of outputs to encode.
    * @fname_in: input filename.
    */
-  enum datum_type fmt_out = DATUM_TYPE_HXND;
-  char *fname_out = NULL;
+  enum datum_type *fmt_out = NULL;
+  char **fname_out = NULL;
+  unsigned int n_fmt = 0;
+  unsigned int n_out = 0;
+  unsigned int n_enc;
   char *fname_in = NULL;
 
+  /* declare variables for concurrent output encoding:
+   * @enc_ok: whether each output was successfully encoded.
+   * @n_fail: number of outputs that failed to encode.
+   * @levels: saved limit on nested parallel regions.
+   * @j: output comparison loop counter.
+   */
+  unsigned int n_fail, j;
+  int *enc_ok;
+  int levels;
+
+  /* declare variables for caching decoded input data:
+   * @dname_cache: cache directory name.
+   * @fname_cache: cache filename of the current input.
+   * @fname_tmp: temporary filename for writing the cache file.
+   * @fh: cache file handle, used to check for its existence.
+   * @cached: whether the cache file was successfully written.
+   * @i: correction loop counter.
+   */
+  char *dname_cache = NULL;
+  char *fname_cache = NULL;
+  char *fname_tmp;
+  int cached = 0;
+  unsigned int i;
+  FILE *fh = NULL;
+
   /* declare variables for behavior determination:
    * @ndnew: number of dimensions to create if @mknew is raised.
    * @pretend: whether to continue writing to @fh or print header info.
+   * @stream: whether to process the input one plane at a time.
    * @mknew: whether to create a new datum or read from the input file.
    */
   unsigned int ndnew = 0;
   int pretend = 0;
+  int stream = 0;
   int mknew = 0;
 
   /* declare variables for function execution:
@@ -166,16 +234,33 @@ int main (int argc, char **argv) {
 
       /* o: output filename. */
       case 'o':
-        fname_out = argv[argi - 1];
+        /* reallocate the array of output filenames. */
+        fname_out = (char**)
+          realloc(fname_out, ++n_out * sizeof(char*));
+
+        /* check that the reallocation succeeded. */
+        if (!fname_out)
+          trace("failed to reallocate output filename array");
+
+        /* store the output filename. */
+        fname_out[n_out - 1] = argv[argi - 1];
         break;
 
       /* F: output format. */
       case 'F':
+        /* reallocate the array of output formats. */
+        fmt_out = (enum datum_type*)
+          realloc(fmt_out, ++n_fmt * sizeof(enum datum_type));
+
+        /* check that the reallocation succeeded. */
+        if (!fmt_out)
+          trace("failed to reallocate output format array");
+
         /* determine which output type was specified. */
-        fmt_out = datum_type_lookup(argv[argi - 1]);
+        fmt_out[n_fmt - 1] = datum_type_lookup(argv[argi - 1]);
 
         /* check that the datum type is supported. */
-        if (fmt_out == DATUM_TYPE_UNDEFINED)
+        if (fmt_out[n_fmt - 1] == DATUM_TYPE_UNDEFINED)
           trace("unsupported output format '%s'", argv[argi - 1]);
 
         /* break the switch. */
@@ -186,6 +271,16 @@ int main (int argc, char **argv) {
         pretend = 1;
         break;
 
+      /* s: streaming mode. */
+      case 's':
+        stream = 1;
+        break;
+
+      /* c: cache directory. */
+      case 'c':
+        dname_cache = argv[argi - 1];
+        break;
+
       /* f: processing function. */
       case 'f':
         /* parse the processing function argument string. */
@@ -236,6 +331,62 @@ int main (int argc, char **argv) {
     }
   }
 
+  /* pair the output filenames with output formats. the n-th format
+   * applies to the n-th filename, and the last format applies to any
+   * remaining filenames. with no filenames, a single output is written
+   * to standard output.
+   */
+  n_enc = (n_out ? n_out : 1);
+  if (n_fmt > n_enc)
+    trace("%u output formats given for %u outputs", n_fmt, n_enc);
+
+  /* complete the arrays of output filenames and formats. */
+  fname_out = (char**) realloc(fname_out, n_enc * sizeof(char*));
+  fmt_out = (enum datum_type*)
+    realloc(fmt_out, n_enc * sizeof(enum datum_type));
+
+  /* check that the reallocation succeeded. */
+  if (!fname_out || !fmt_out)
+    trace("failed to allocate output arrays");
+
+  /* fill in the unspecified filenames and formats. */
+  for (i = 0; i < n_enc; i++) {
+    if (i >= n_out)
+      fname_out[i] = NULL;
+
+    if (i >= n_fmt)
+      fmt_out[i] = (n_fmt ? fmt_out[n_fmt - 1] : DATUM_TYPE_HXND);
+  }
+
+  /* check that no two outputs share a file. */
+  for (i = 1; i < n_out; i++) {
+    for (j = 0; j < i; j++) {
+      if (strcmp(fname_out[i], fname_out[j]) == 0 ||
+          bytes_fsame(fname_out[i], fname_out[j]))
+        trace("output '%s' given more than once", fname_out[i]);
+    }
+  }
+
+  /* check if streaming mode was requested. */
+  if (stream) {
+    /* check that the options are compatible with streaming. */
+    if (mknew || pretend)
+      trace("streaming mode is incompatible with new and pretend modes");
+
+    /* check that the output format is compatible with streaming. */
+    if (n_enc > 1 ||
+        (fmt_out[0] != DATUM_TYPE_HXND && fmt_out[0] != DATUM_TYPE_PIPE))
+      trace("streaming mode only supports a single pipe-format output");
+
+    /* process the input stream. */
+    if (!main_stream(fname_in, fname_out[0], procs, n_procs,
+                     corrs, n_corrs))
+      trace("failed to stream pipe-format data");
+
+    /* return successfully. */
+    return 0;
+  }
+
   /* initialize the datum structure. */
   datum_init(&D);
 
@@ -267,28 +418,113 @@ int main (int argc, char **argv) {
     if (D.type == DATUM_TYPE_UNDEFINED)
       trace("unsupported data type in '%s'", fname_in);
 
-    /* decode the file parameters into the datum structure. */
-    if (!datum_type_decode(&D, fname_in, D.type))
-      trace("failed to read %s-format data from '%s'",
-            datum_type_name(D.type), fname_in);
+    /* inputs that are not already native may be cached. */
+    if (dname_cache && fname_in &&
+        D.type != DATUM_TYPE_HXND && D.type != DATUM_TYPE_HXNDC) {
+      /* build the cache filename of the input. */
+      fname_cache = main_cache_name(dname_cache, fname_in, corrs, n_corrs);
+      if (!fname_cache)
+        trace("failed to build cache filename for '%s'", fname_in);
 
-    /* apply parameter corrections at this point. */
-    if (!main_apply_corrs(&D, corrs, n_corrs))
-      trace("failed to apply parameter corrections");
+      /* check whether the cache file exists. */
+      fh = fopen(fname_cache, "rb");
+    }
+
+    /* check if the input has already been cached. */
+    if (fh) {
+      /* close the cache file, which will be reopened for reading. */
+      fclose(fh);
+
+      /* decode the cached parameters, which already hold the corrections.
+       */
+      D.type = DATUM_TYPE_HXND;
+      if (!datum_type_decode(&D, fname_cache, D.type))
+        trace("failed to read cached data from '%s'", fname_cache);
+
+      /* free the unused correction strings. */
+      for (i = 0; i < n_corrs; i++) {
+        free(corrs[i].lstr);
+        free(corrs[i].rstr);
+      }
+
+      /* free the corrections array. */
+      free(corrs);
+
+      /* load the cached array data. */
+      if (!datum_array_read(&D))
+        trace("failed to read cached array from '%s'", fname_cache);
+    }
+    else {
+      /* decode the file parameters into the datum structure. */
+      if (!datum_type_decode(&D, fname_in, D.type))
+        trace("failed to read %s-format data from '%s'",
+              datum_type_name(D.type), fname_in);
+
+      /* apply parameter corrections at this point. */
+      if (!main_apply_corrs(&D, corrs, n_corrs))
+        trace("failed to apply parameter corrections");
+
+      /* load the array data. */
+      if (!datum_array_read(&D))
+        trace("failed to generate hx-format data from '%s'", fname_in);
+    }
+
+    /* check if the decoded data remains to be cached. */
+    if (fname_cache && !fh) {
+      /* build a temporary filename unique to this process. */
+      fname_tmp = (char*) malloc((strlen(fname_cache) + 32) * sizeof(char));
+
+      /* write the cache file under the temporary name, and move the
+       * complete file into place. the cache is optional, so any failure
+       * is reported as a warning and the decoded data are used as-is.
+       */
+      if (!fname_tmp) {
+        /* report the allocation failure. */
+        raise("failed to allocate cache filename");
+      }
+      else {
+        /* write and rename the cache file. */
+        sprintf(fname_tmp, "%s.%ld", fname_cache, (long) getpid());
+        if (!datum_type_encode(&D, fname_tmp, DATUM_TYPE_HXND))
+          raise("failed to write cache file '%s'", fname_tmp);
+        else if (rename(fname_tmp, fname_cache))
+          raise("failed to rename cache file to '%s'", fname_cache);
+        else
+          cached = 1;
+
+        /* remove any partially written cache file. */
+        if (!cached)
+          unlink(fname_tmp);
+
+        /* free the temporary filename. */
+        free(fname_tmp);
+      }
 
-    /* load the array data. */
-    if (!datum_array_read(&D))
-      trace("failed to generate hx-format data from '%s'", fname_in);
+      /* print and discard any caching errors. */
+      if (!cached) {
+        fprintf(stderr, "warning: input data were not cached\n");
+        traceback_print();
+        traceback_clear();
+      }
+    }
+
+    /* free the cache filename. */
+    free(fname_cache);
   }
 
+  /* release the parsed parameter files, which are only required while
+   * decoding the input.
+   */
+  parms_cache_free();
+
   /* check if we're only pretending to read the data. */
   if (pretend) {
     /* print the datum metadata to the terminal. */
-    if (!datum_print(&D, fname_out))
+    if (!datum_print(&D, fname_out[0]))
       trace("failed to print hx-format metadata to %s%s%s",
-            fname_out ? "'" : "",
-            fname_out ? fname_out : "standard output",
-            fname_out ? "'" : "");
+            fname_out[0] ? "'" : "",
+            fname_out[0] ? fname_out[0] : "standard output",
+            fname_out[0] ? "'" : "");
 
     /* free the datum structure. */
     datum_free(&D);
@@ -301,15 +537,61 @@ int main (int argc, char **argv) {
   if (!main_apply_procs(&D, procs, n_procs))
     trace("failed to apply processing functions");
 
-  /* encode the data into the output file. datum formats that support writing
+  /* arrays mapped from the input file must be moved into memory before
+   * the input file is overwritten by an output.
+   */
+  for (i = 0; i < n_enc; i++) {
+    if (bytes_fsame(D.fname, fname_out[i]) && !hx_array_unmap(&D.array))
+      trace("failed to release mapping of '%s'", D.fname);
+  }
+
+  /* allocate the output status array. */
+  enc_ok = (int*) calloc(n_enc, sizeof(int));
+  if (!enc_ok)
+    trace("failed to allocate output status array");
+
+  /* allow the parallel loops within each encoder to keep their own
+   * threads while several encoders run at once.
+   */
+  levels = omp_get_max_active_levels();
+  if (n_enc > 1 && levels < 2)
+    omp_set_max_active_levels(2);
+
+  /* encode the data into the output files, one thread per output. the
+   * encoders only read from the datum. datum formats that support writing
    * to standard output must accept @fname as NULL.
    */
-  if (!datum_type_encode(&D, fname_out, fmt_out))
-    trace("failed to write '%s'-format data to %s%s%s",
-          datum_type_name(fmt_out),
-          fname_out ? "'" : "",
-          fname_out ? fname_out : "standard output",
-          fname_out ? "'" : "");
+  #pragma omp parallel for num_threads(n_enc) schedule(dynamic, 1)
+  for (i = 0; i < n_enc; i++)
+    enc_ok[i] = datum_type_encode(&D, fname_out[i], fmt_out[i]);
+
+  /* restore the nesting limit. */
+  omp_set_max_active_levels(levels);
+
+  /* check that each output was written. */
+  for (i = 0, n_fail = 0; i < n_enc; i++) {
+    if (enc_ok[i])
+      continue;
+
+    /* raise an error for the failed output. */
+    raise("failed to write '%s'-format data to %s%s%s",
+          datum_type_name(fmt_out[i]),
+          fname_out[i] ? "'" : "",
+          fname_out[i] ? fname_out[i] : "standard output",
+          fname_out[i] ? "'" : "");
+
+    /* count the failure. */
+    n_fail++;
+  }
+
+  /* output the traceback if any output failed. */
+  if (n_fail)
+    trace("failed to write %u of %u outputs", n_fail, n_enc);
+
+  /* free the output arrays. */
+  free(enc_ok);
+  free(fname_out);
+  free(fmt_out);
 
   /* free the datum structure. */
   datum_free(&D);
@@ -385,3 +667,421 @@ int main_apply_corrs (datum *D, struct parsed_arg *lst, unsigned int n) {
   return 1;
 }
 
+/* main_cache_hash(): fold a block of bytes into a 64-bit fnv-1a hash.
+ * @h: the current hash value.
+ * @data: pointer to the bytes to hash.
+ * @n: number of bytes to hash.
+ */
+uint64_t main_cache_hash (uint64_t h, const void *data, size_t n) {
+  /* declare a required variable:
+   * @b: pointer to the current byte.
+   */
+  const uint8_t *b;
+
+  /* fold each byte into the hash. */
+  for (b = (const uint8_t*) data; n; n--, b++) {
+    h ^= *b;
+    h *= 1099511628211ull;
+  }
+
+  /* return the new hash value. */
+  return h;
+}
+
+/* main_cache_stat(): fold the name, size and modification time of a file
+ * into a 64-bit fnv-1a hash.
+ * @h: the current hash value.
+ * @name: the name to hash.
+ * @st: the file status to hash.
+ */
+uint64_t main_cache_stat (uint64_t h, const char *name, struct stat *st) {
+  /* declare variables holding the hashed status fields:
+   * @sz: file size.
+   * @sec: modification time, whole seconds.
+   * @nsec: modification time, nanoseconds.
+   */
+  int64_t sz, sec, nsec;
+
+  /* copy the status fields into fixed-width values. */
+  sz = (int64_t) st->st_size;
+  sec = (int64_t) st->st_mtim.tv_sec;
+  nsec = (int64_t) st->st_mtim.tv_nsec;
+
+  /* fold the name and status into the hash. */
+  h = main_cache_hash(h, name, strlen(name) + 1);
+  h = main_cache_hash(h, &sz, sizeof(int64_t));
+  h = main_cache_hash(h, &sec, sizeof(int64_t));
+  h = main_cache_hash(h, &nsec, sizeof(int64_t));
+
+  /* return the new hash value. */
+  return h;
+}
+
+/* main_cache_name(): build the cache filename of an input file or
+ * directory. the name is a hash of the resolved input path, its size
+ * and modification time, the same of every entry of an input directory,
+ * and each parameter correction to be applied after decoding.
+ * @dname: the cache directory name.
+ * @fname: the input filename.
+ * @lst: list of correction arguments.
+ * @n: number of corrections.
+ */
+char *main_cache_name (const char *dname, const char *fname,
+                       struct parsed_arg *lst, unsigned int n) {
+  /* declare variables for hashing the input:
+   * @h: hash of the input and corrections.
+   * @hdir: order-independent sum of directory entry hashes.
+   * @path: resolved input path.
+   * @fpath: directory entry path.
+   * @st: file status of the input, or of a directory entry.
+   * @dir: input directory handle.
+   * @ent: current directory entry.
+   */
+  uint64_t h, hdir;
+  char *path, *fpath;
+  struct dirent *ent;
+  struct stat st;
+  DIR *dir;
+
+  /* declare variables for building the cache filename:
+   * @name: output cache filename.
+   * @i: correction loop counter.
+   * @d: correction dimension index.
+   * @szr: size of real values, which differ between builds.
+   */
+  unsigned int i;
+  int32_t d, szr;
+  char *name;
+
+  /* resolve the input path. */
+  path = realpath(fname, NULL);
+  if (!path) {
+    /* raise an error and return nothing. */
+    raise("failed to resolve path '%s'", fname);
+    return NULL;
+  }
+
+  /* get the status of the input. */
+  if (stat(path, &st)) {
+    /* raise an error and return nothing. */
+    raise("failed to stat '%s'", path);
+    free(path);
+    return NULL;
+  }
+
+  /* hash the build, the input path and its status. */
+  szr = (int32_t) sizeof(real);
+  h = main_cache_hash(14695981039346656037ull, &szr, sizeof(int32_t));
+  h = main_cache_stat(h, path, &st);
+
+  /* check if the input is a directory. */
+  if (S_ISDIR(st.st_mode)) {
+    /* open the directory. */
+    dir = opendir(path);
+    if (!dir) {
+      /* raise an error and return nothing. */
+      raise("failed to open directory '%s'", path);
+      free(path);
+      return NULL;
+    }
+
+    /* hash each entry, summing so that the listing order is irrelevant. */
+    hdir = 0;
+    while ((ent = readdir(dir))) {
+      /* skip the special entries. */
+      if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0)
+        continue;
+
+      /* build the entry path. */
+      fpath = (char*) malloc(strlen(path) + strlen(ent->d_name) + 2);
+      if (!fpath) {
+        /* raise an error and return nothing. */
+        raise("failed to allocate entry path");
+        closedir(dir);
+        free(path);
+        return NULL;
+      }
+
+      /* add the hash of the entry, if it can be queried. */
+      sprintf(fpath, "%s/%s", path, ent->d_name);
+      if (stat(fpath, &st) == 0)
+        hdir += main_cache_stat(14695981039346656037ull, ent->d_name, &st);
+
+      /* free the entry path. */
+      free(fpath);
+    }
+
+    /* close the directory and fold in the entry hashes. */
+    closedir(dir);
+    h = main_cache_hash(h, &hdir, sizeof(uint64_t));
+  }
+
+  /* hash each correction. */
+  for (i = 0; i < n; i++) {
+    d = (int32_t) lst[i].d;
+    h = main_cache_hash(h, &d, sizeof(int32_t));
+    h = main_cache_hash(h, lst[i].lstr, strlen(lst[i].lstr) + 1);
+    h = main_cache_hash(h, lst[i].rstr, strlen(lst[i].rstr) + 1);
+  }
+
+  /* free the resolved path. */
+  free(path);
+
+  /* allocate the cache filename. */
+  name = (char*) malloc((strlen(dname) + 24) * sizeof(char));
+  if (!name) {
+    /* raise an error and return nothing. */
+    raise("failed to allocate cache filename");
+    return NULL;
+  }
+
+  /* build and return the cache filename. */
+  sprintf(name, "%s/%016llx.hx", dname, (unsigned long long) h);
+  return name;
+}
+
+/* main_stream_read(): read a block of planes from a pipe-format stream.
+ * @D: pointer to the stream datum structure.
+ * @P: array of plane datum structures to read into.
+ * @p0: index of the first plane to read.
+ * @np: number of planes to read.
+ * @fh: input file handle.
+ */
+int main_stream_read (datum *D, datum *P, int p0, int np, FILE *fh) {
+  /* declare a required loop counter. */
+  int p;
+
+  /* read each plane of the block. */
+  for (p = 0; p < np; p++) {
+    if (!pipe_stream_read(D, P + p, p0 + p, fh))
+      throw("failed to read plane %d", p0 + p);
+  }
+
+  /* return success. */
+  return 1;
+}
+
+/* main_stream_write(): write a block of planes to a pipe-format stream,
+ * preceded by the stream header if the block is the first of the stream.
+ * the stream datum is only read, as later planes are read from it
+ * concurrently.
+ * @D: pointer to the stream datum structure.
+ * @P: array of plane datum structures to write.
+ * @p0: index of the first plane to write.
+ * @np: number of planes to write.
+ * @fh: output file handle.
+ */
+int main_stream_write (datum *D, datum *P, int p0, int np, FILE *fh) {
+  /* declare a few required variables:
+   * @H: private copy of the stream datum describing the output.
+   * @dims: output stream parameters of every dimension.
+   * @p: plane loop counter.
+   */
+  datum_dim *dims;
+  datum H;
+  int p;
+
+  /* check if the output header remains to be written. */
+  if (p0 == 0) {
+    /* allocate the output stream parameters. */
+    dims = (datum_dim*) malloc(D->nd * sizeof(datum_dim));
+    if (!dims)
+      throw("failed to allocate %u dimensions", D->nd);
+
+    /* combine the processed plane parameters with the input parameters
+     * of the remaining dimensions.
+     */
+    memcpy(dims, D->dims, D->nd * sizeof(datum_dim));
+    memcpy(dims, P->dims, P->nd * sizeof(datum_dim));
+
+    /* describe the output by a shallow copy of the stream datum. */
+    H = *D;
+    H.dims = dims;
+
+    /* write the output header. */
+    if (!pipe_stream_header(&H, fh)) {
+      free(dims);
+      throw("failed to write pipe-format header");
+    }
+
+    /* free the output stream parameters. */
+    free(dims);
+  }
+
+  /* write each plane of the block. */
+  for (p = 0; p < np; p++) {
+    if (!pipe_stream_write(P + p, fh))
+      throw("failed to write plane %d", p0 + p);
+  }
+
+  /* return success. */
+  return 1;
+}
+
+/* main_stream(): read, process and write pipe-format data one plane at a
+ * time, without holding the complete array in memory. reading, processing
+ * and writing are overlapped in a three-stage pipeline: while one block of
+ * planes is read and another is written, the planes of a third block are
+ * processed in parallel.
+ * @fname_in: input filename, or NULL for standard input.
+ * @fname_out: output filename, or NULL for standard output.
+ * @procs: list of processing function arguments.
+ * @n_procs: number of processing functions.
+ * @corrs: list of correction arguments.
+ * @n_corrs: number of corrections.
+ */
+int main_stream (const char *fname_in, const char *fname_out,
+                 struct parsed_arg *procs, unsigned int n_procs,
+                 struct parsed_arg *corrs, unsigned int n_corrs) {
+  /* declare variables for the stream and its planes:
+   * @D: datum structure holding the stream parameters.
+   * @P: array of datum structures holding three blocks of planes.
+   * @fin: input file handle.
+   * @fout: output file handle.
+   * @nd: number of plane dimensions.
+   * @nplanes: number of planes in the stream.
+   */
+  datum D, *P;
+  FILE *fin, *fout;
+  int nd, nplanes;
+
+  /* declare variables for pipeline execution:
+   * @nblk: number of planes per block.
+   * @nb: number of blocks in the stream.
+   * @b: pipeline step loop counter.
+   * @n: number of planes read, processed and written in the current step.
+   * @ok: whether all stages of the current step succeeded.
+   * @i: general-purpose loop counter.
+   */
+  int nblk, nb, b, n[3], ok;
+  unsigned int i;
+
+  /* open the input stream. */
+  fin = (fname_in ? fopen(fname_in, "rb") : stdin);
+  if (!fin)
+    throw("failed to open '%s'", fname_in);
+
+  /* initialize the stream datum structure. */
+  datum_init(&D);
+
+  /* read the stream parameters. */
+  if (!pipe_stream_open(&D, fin))
+    throw("failed to read pipe-format header");
+
+  /* apply parameter corrections at this point. */
+  if (!main_apply_corrs(&D, corrs, n_corrs))
+    throw("failed to apply parameter corrections");
+
+  /* determine the number of plane dimensions and planes. */
+  nd = (D.nd < 2 ? D.nd : 2);
+  nplanes = pipe_stream_planes(&D);
+
+  /* reject functions that do not act within a single plane. */
+  for (i = 0; i < n_procs; i++) {
+    if (!fn_check_scope(procs[i].lstr, procs[i].d - 1, nd))
+      throw("function '%s' (#%u) may not be streamed", procs[i].lstr, i);
+  }
+
+  /* size the blocks to keep every thread busy while processing. */
+  nblk = omp_get_max_threads();
+  nb = (nplanes + nblk - 1) / nblk;
+
+  /* allocate and initialize three blocks of plane datum structures. */
+  P = (datum*) malloc(3 * nblk * sizeof(datum));
+  if (!P)
+    throw("failed to allocate %d plane structures", 3 * nblk);
+
+  for (i = 0; i < 3 * nblk; i++)
+    datum_init(P + i);
+
+  /* open the output stream. */
+  fout = (fname_out ? fopen(fname_out, "wb") : stdout);
+  if (!fout)
+    throw("failed to open '%s'", fname_out);
+
+  /* run the pipeline: at step @b, block @b is read, block @b - 1 is
+   * processed and block @b - 2 is written.
+   */
+  for (b = 0, ok = 1; b < nb + 2 && ok; b++) {
+    /* compute the number of planes handled by each stage. */
+    for (i = 0; i < 3; i++) {
+      n[i] = (b - (int) i >= 0 && b - (int) i < nb ?
+              nplanes - (b - (int) i) * nblk : 0);
+      n[i] = (n[i] < nblk ? n[i] : nblk);
+    }
+
+    #pragma omp parallel
+    {
+      /* run the reader and writer stages on one thread each. */
+      #pragma omp sections nowait
+      {
+        /* reader stage. */
+        #pragma omp section
+        if (n[0] && !main_stream_read(&D, P + (b % 3) * nblk,
+                                      b * nblk, n[0], fin)) {
+          #pragma omp atomic write
+          ok = 0;
+        }
+
+        /* writer stage. */
+        #pragma omp section
+        if (n[2] && !main_stream_write(&D, P + ((b + 1) % 3) * nblk,
+                                       (b - 2) * nblk, n[2], fout)) {
+          #pragma omp atomic write
+          ok = 0;
+        }
+      }
+
+      /* worker stage: all remaining threads process planes. */
+      #pragma omp for schedule(dynamic, 1)
+      for (int p = 0; p < n[1]; p++) {
+        /* @live: whether no stage has failed. */
+        int live = 1;
+
+        /* apply the processing functions to the plane, until any stage
+         * has failed.
+         */
+        for (unsigned int j = 0; j < n_procs && live; j++) {
+          if (!fn_execute_from_strings(P + ((b + 2) % 3) * nblk + p,
+                                       procs[j].d - 1,
+                                       procs[j].lstr, procs[j].rstr)) {
+            #pragma omp atomic write
+            ok = 0;
+          }
+
+          /* check for failures of the other stages. */
+          #pragma omp atomic read
+          live = ok;
+        }
+      }
+    }
+  }
+
+  /* check that the pipeline completed. */
+  if (!ok)
+    throw("failed to stream planes");
+
+  /* close the input and output streams, if necessary. */
+  if (fname_in)
+    fclose(fin);
+
+  if (fname_out)
+    fclose(fout);
+
+  /* free the processing function strings. */
+  for (i = 0; i < n_procs; i++) {
+    free(procs[i].lstr);
+    free(procs[i].rstr);
+  }
+
+  /* free the processing functions array and the datum structures. */
+  for (i = 0; i < 3 * nblk; i++)
+    datum_free(P + i);
+
+  free(procs);
+  free(P);
+  datum_free(&D);
+
+  /* return success. */
+  return 1;
+}
@@ -62,6 +62,18 @@
   (BYTES_LSHIFT4(((b7) << 24) | ((b6) << 16) | ((b5) << 8) | (b4))| \
                 (((b3) << 24) | ((b2) << 16) | ((b1) << 8) | (b0)))
 
+/* define macros to reverse the byte order of 32- and 64-bit words. these
+ * are written such that optimizing compilers emit single (or vectorized)
+ * byte-swap instructions for them.
+ */
+#define BYTES_BSWAP32(x) \
+  ((((x) & 0x000000ffu) << 24) | (((x) & 0x0000ff00u) << 8) | \
+   (((x) & 0x00ff0000u) >> 8)  | (((x) & 0xff000000u) >> 24))
+
+#define BYTES_BSWAP64(x) \
+  (BYTES_LSHIFT4(BYTES_BSWAP32((uint32_t) (x))) | \
+   (uint64_t) BYTES_BSWAP32((uint32_t) BYTES_RSHIFT4(x)))
+
 /* define constants to specify the endianness of loaded serial files.
  */
 enum byteorder {
@@ -90,6 +102,8 @@ void bytes_swap (uint8_t *bytes, unsigned int n, unsigned int sz);
 
 int bytes_fexist (const char *fname);
 
+int bytes_fsame (const char *fa, const char *fb);
+
 unsigned int bytes_size (const char *fname);
 
 uint8_t *bytes_read_block (const char *fname,
@@ -55,9 +55,16 @@ static fn_arg fn_args_cut[] = {
 };
 
 static fn_arg fn_args_ffm[] = {
-  { "func",  { .s = NULL }, 0, FN_VALTYPE_STRING },
-  { "iters", { .i = 1000 }, 0, FN_VALTYPE_INT },
-  { NULL,    {},            0, FN_VALTYPE_UNKNOWN }
+  { "func",    { .s = NULL }, 0, FN_VALTYPE_STRING },
+  { "iters",   { .i = 1000 }, 0, FN_VALTYPE_INT },
+  { "tol",     { .f = 0.0  }, 0, FN_VALTYPE_FLOAT },
+  { "dobj",    { .f = 0.0  }, 0, FN_VALTYPE_FLOAT },
+  { "report",  { .b = 0    }, 0, FN_VALTYPE_BOOL },
+  { "solver",  { .s = NULL }, 0, FN_VALTYPE_STRING },
+  { "warm",    { .b = 0    }, 0, FN_VALTYPE_BOOL },
+  { "log",     { .s = NULL }, 0, FN_VALTYPE_STRING },
+  { "logstep", { .i = 1    }, 0, FN_VALTYPE_INT },
+  { NULL,      {},            0, FN_VALTYPE_UNKNOWN }
 };
 
 static fn_arg fn_args_fft[] = {
@@ -77,15 +84,30 @@ static fn_arg fn_args_filter[] = {
 };
 
 static fn_arg fn_args_irls[] = {
-  { "norm",  { .f = 1.0 }, 0, FN_VALTYPE_FLOAT },
-  { "iters", { .i = 10  }, 0, FN_VALTYPE_INT },
-  { NULL,    {},           0, FN_VALTYPE_UNKNOWN }
+  { "norm",    { .f = 1.0  }, 0, FN_VALTYPE_FLOAT },
+  { "iters",   { .i = 10   }, 0, FN_VALTYPE_INT },
+  { "tol",     { .f = 0.0  }, 0, FN_VALTYPE_FLOAT },
+  { "dobj",    { .f = 0.0  }, 0, FN_VALTYPE_FLOAT },
+  { "report",  { .b = 0    }, 0, FN_VALTYPE_BOOL },
+  { "solver",  { .s = NULL }, 0, FN_VALTYPE_STRING },
+  { "warm",    { .b = 0    }, 0, FN_VALTYPE_BOOL },
+  { "log",     { .s = NULL }, 0, FN_VALTYPE_STRING },
+  { "logstep", { .i = 1    }, 0, FN_VALTYPE_INT },
+  { NULL,      {},            0, FN_VALTYPE_UNKNOWN }
 };
 
 static fn_arg fn_args_ist[] = {
-  { "thresh", { .f = 0.9 }, 0, FN_VALTYPE_FLOAT },
-  { "iters",  { .i = 200 }, 0, FN_VALTYPE_INT },
-  { NULL,     {},           0, FN_VALTYPE_UNKNOWN }
+  { "thresh",  { .f = 0.9  }, 0, FN_VALTYPE_FLOAT },
+  { "iters",   { .i = 200  }, 0, FN_VALTYPE_INT },
+  { "tol",     { .f = 0.0  }, 0, FN_VALTYPE_FLOAT },
+  { "dobj",    { .f = 0.0  }, 0, FN_VALTYPE_FLOAT },
+  { "floor",   { .f = 0.0  }, 0, FN_VALTYPE_FLOAT },
+  { "report",  { .b = 0    }, 0, FN_VALTYPE_BOOL },
+  { "accel",   { .s = NULL }, 0, FN_VALTYPE_STRING },
+  { "warm",    { .b = 0    }, 0, FN_VALTYPE_BOOL },
+  { "log",     { .s = NULL }, 0, FN_VALTYPE_STRING },
+  { "logstep", { .i = 1    }, 0, FN_VALTYPE_INT },
+  { NULL,      {},            0, FN_VALTYPE_UNKNOWN }
 };
 
 static fn_arg fn_args_multiply[] = {
@@ -111,8 +133,11 @@ static fn_arg fn_args_project[] = {
 };
 
 static fn_arg fn_args_report[] = {
-  { "sumsq", { .b = 0 }, 0, FN_VALTYPE_BOOL },
-  { NULL,    {},         0, FN_VALTYPE_UNKNOWN }
+  { "sumsq", { .b = 0    }, 0, FN_VALTYPE_BOOL },
+  { "log",   { .s = NULL }, 0, FN_VALTYPE_STRING },
+  { "top",   { .i = 5    }, 0, FN_VALTYPE_INT },
+  { "trace", { .i = -1   }, 0, FN_VALTYPE_INT },
+  { NULL,    {},            0, FN_VALTYPE_UNKNOWN }
 };
 
 static fn_arg fn_args_resize[] = {
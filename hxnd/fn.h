@@ -66,6 +66,17 @@ typedef struct {
 }
 fn_arg;
 
+/* fn_scope: enumerated type for the extent of datum content that each
+ * processing function requires in order to execute. functions that act
+ * independently along a single dimension may be applied to any sub-array
+ * that fully contains that dimension, e.g. a plane of a larger datum.
+ */
+enum fn_scope {
+  FN_ARRAY = 0,  /* requires the complete array.       */
+  FN_DIM   = 1,  /* acts along the specified dimension. */
+  FN_FIRST = 2   /* acts along the first dimension.     */
+};
+
 /* fn_pointer: callback function prototype for all macro-executable
  * processing functions.
  * @fndata: pointer to the datum or dataset structure to manipulate.
@@ -82,10 +93,12 @@ typedef struct {
   /* @name: function name string used for function lookup and display.
    * @ptr: function pointer to call when applying the function.
    * @args: array of argument definition structures.
+   * @scope: extent of datum content required by the function.
    */
   const char *name;
   fn_pointer ptr;
   fn_arg *args;
+  enum fn_scope scope;
 }
 fn;
 
@@ -110,6 +123,8 @@ int fn_execute_from_strings (void *fndata, const int dim,
                              const char *fnname,
                              const char *argstr);
 
+int fn_check_scope (const char *fnname, const int dim, const int nd);
+
 /* function declarations (fn-args.c): */
 
 int fn_args_get (const fn_arg *argdef, const int i, void *val, size_t *sz);
@@ -94,6 +94,8 @@ int hx_array_alternate_sign (hx_array *x, int k);
 
 int hx_array_negate_basis (hx_array *x, int dneg);
 
+int hx_array_correct (hx_array *x, int alt, int neg, int ncrop);
+
 int hx_array_reorder_bases (hx_array *x, int *order);
 
 #endif /* __HXND_HX_ARITH_H__ */
@@ -33,6 +33,24 @@
  */
 #define HX_ARRAY_MAGIC  0x59525241444e5848
 
+/* define a magic number for chunked binary-format hypercomplex
+ * multidimensional array files. (in L.E. = 'HXNDCHNK')
+ */
+#define HX_ARRAY_MAGIC_CHUNK  0x4b4e4843444e5848
+
+/* define the approximate number of coefficients held in each chunk of
+ * chunked array files.
+ */
+#define HX_ARRAY_CHUNK_SZ  32768
+
+/* define flags for the lossless codecs that may be applied to each chunk
+ * of chunked array files.
+ */
+#define HX_ARRAY_CODEC_SHUFFLE  0x01
+#define HX_ARRAY_CODEC_DELTA    0x02
+#define HX_ARRAY_CODEC_LZ       0x04
+#define HX_ARRAY_CODEC_ALL      0x07
+
 /* define constants for forward (slice) and reverse (store) slicer operations.
  */
 #define HX_ARRAY_SLICER_SLICE 0
@@ -49,6 +67,11 @@
 #define HX_ARRAY_INCR_NORMAL   0
 #define HX_ARRAY_INCR_REVERSE  1
 
+/* define the maximum number of adjacent vectors that are gathered into a
+ * single 'brick' when operating along a strided array dimension.
+ */
+#define HX_ARRAY_BRICK_SZ  16
+
 /* hx_array: data type for nD arrays of hypercomplex nD numbers.
  *
  * all the above information still applies to arrays, but an extra layer of
@@ -59,6 +82,16 @@
  * as it turns out, this squashing not only aids in memory compactness of
  * multidimensional datasets, but also in communicating array data between
  * the opencl host and device layers.
+ *
+ * coefficients are always stored in column-major order, so vectors along
+ * any dimension other than the first are strided by the product of all
+ * lower dimension sizes. routines that operate along such dimensions
+ * (slicing, per-vector iteration, fourier transforms) therefore gather up
+ * to HX_ARRAY_BRICK_SZ neighboring vectors at once into a 'brick': a
+ * (n, nv)-matrix whose columns are the vectors, filled by reading short
+ * contiguous runs of scalars from each row of the source array. this gives
+ * every dimension near-uniform cache behavior without requiring the rest
+ * of the library to understand a tiled storage layout.
  */
 typedef struct {
   /* d: dimensionality of the hypercomplex space.
@@ -76,6 +109,13 @@ typedef struct {
   /* real coefficients. */
   real *x;
 
+  /* map: base address of the file mapping that holds the coefficients,
+   *      or NULL if the coefficients were allocated on the heap.
+   * nmap: number of mapped bytes at @map.
+   */
+  void *map;
+  size_t nmap;
+
   /* multiplication table. this is also a shared table. */
   hx_algebra tbl;
 }
@@ -126,6 +166,10 @@ int hx_array_copy_real (hx_array *dst, hx_array *src);
 
 void hx_array_free (hx_array *x);
 
+int hx_array_map (hx_array *x, FILE *fh);
+
+int hx_array_unmap (hx_array *x);
+
 /* function declarations (hx-array-io.c): */
 
 int hx_array_print (hx_array *x, const char *fname);
@@ -136,21 +180,66 @@ int hx_array_fwrite (hx_array *x, FILE *fh);
 
 int hx_array_fread (hx_array *x, FILE *fh);
 
+int hx_array_fread_region (hx_array *x, FILE *fh,
+                           hx_index lower, hx_index upper);
+
 int hx_array_save (hx_array *x, const char *fname);
 
 int hx_array_load (hx_array *x, const char *fname);
 
+/* function declarations (hx-array-chunk.c): */
+
+void hx_array_chunk_size (hx_array *x, hx_index csz);
+
+void hx_array_chunk_bounds (int k, hx_index sz, hx_index csz, hx_index nck,
+                            int c, hx_index lower, hx_index upper);
+
+int hx_array_chunk_region (int k, hx_index sz, hx_index lower,
+                           hx_index upper);
+
+size_t hx_array_chunk_encode (const uint8_t *in, size_t n,
+                              unsigned int wordsz, unsigned int codec,
+                              uint8_t *out);
+
+int hx_array_chunk_decode (const uint8_t *in, size_t nin,
+                           unsigned int wordsz, unsigned int codec,
+                           uint8_t *out, size_t n);
+
+int hx_array_fwrite_chunked (hx_array *x, FILE *fh, unsigned int codec);
+
+int hx_array_fread_chunked (hx_array *x, FILE *fh, uint64_t *wd0,
+                            unsigned int swapping,
+                            hx_index lower, hx_index upper);
+
 /* function declarations (hx-array-rawio.c): */
 
+void hx_array_decode_raw (const uint8_t *buf, real *x, size_t n,
+                          enum byteorder endian, unsigned int wordsz,
+                          unsigned int isflt);
+
+int hx_array_encode_raw (const real *x, uint8_t *buf, size_t n,
+                         enum byteorder endian, unsigned int wordsz,
+                         unsigned int isflt);
+
 int hx_array_fread_raw (FILE *fh, hx_array *x, enum byteorder endian,
                         unsigned int wordsz, unsigned int isflt,
                         unsigned int offhead, unsigned int offblk,
                         unsigned int nblks, unsigned int nwords,
                         unsigned int nalign);
 
+int hx_array_fread_tiled (FILE *fh, hx_array *x, enum byteorder endian,
+                          unsigned int wordsz, unsigned int isflt,
+                          unsigned int offhead, int k,
+                          hx_index nt, hx_index szt, int incr,
+                          hx_index lower, hx_index upper);
+
 int hx_array_fwrite_raw (FILE *fh, hx_array *x, enum byteorder endian,
                          unsigned int wordsz, unsigned int isflt);
 
+int hx_array_fwrite_tiled (FILE *fh, hx_array *x, enum byteorder endian,
+                           unsigned int wordsz, unsigned int isflt,
+                           hx_index nt, hx_index szt, int incr);
+
 /* function declarations (hx-array-topo.c): */
 
 int hx_array_nnzdims (hx_array *x);
@@ -228,6 +317,18 @@ int hx_array_sched_slicer (hx_array *x, hx_array *y,
 #define hx_array_store_sched(x, y, off, n, sched) \
   hx_array_sched_slicer(x, y, off, n, sched, HX_ARRAY_SLICER_STORE)
 
+int hx_array_brick_slicer (hx_array *x, hx_array *y,
+                           int k, int loc, int nv,
+                           int dir);
+
+#define hx_array_slice_brick(x, y, k, loc, nv) \
+  hx_array_brick_slicer(x, y, k, loc, nv, HX_ARRAY_SLICER_SLICE)
+
+#define hx_array_store_brick(x, y, k, loc, nv) \
+  hx_array_brick_slicer(x, y, k, loc, nv, HX_ARRAY_SLICER_STORE)
+
+void hx_array_brick_vector (hx_array *y, int v, hx_array *yv);
+
 /* function declarations (hx-array-tile.c): */
 
 int hx_array_tiler (hx_array *x, int k, hx_index nt, hx_index szt,
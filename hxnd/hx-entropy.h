@@ -41,12 +41,15 @@ enum hx_entropy_type {
   HX_ENTROPY_TYPE_HOCH
 };
 
-/* hx_entropy_functional: function prototype for all entropy functionals.
+/* hx_entropy_functional: function prototype for all entropy functionals,
+ * which process a contiguous run of hypercomplex scalars in each call.
  * @x: hypercomplex spectral intensity array raw data.
- * @S: output entropy or entropy derivative pointer.
+ * @S: output entropy sum, or output entropy derivative array, which may
+ *     be the same as @x.
  * @n: number of coefficients per hypercomplex scalar.
+ * @ns: number of hypercomplex scalars in @x.
  */
-typedef void (*hx_entropy_functional) (real *x, real *S, int n);
+typedef void (*hx_entropy_functional) (real *x, real *S, int n, int ns);
 
 /* function declarations: */
 
@@ -56,21 +59,25 @@ int hx_entropy_get_functionals (enum hx_entropy_type type,
                                 hx_entropy_functional *f,
                                 hx_entropy_functional *df);
 
-void hx_entropy_norm_f (real *x, real *S, int n);
+real hx_entropy_sum_functional (hx_array *x, hx_entropy_functional f);
 
-void hx_entropy_norm_df (real *x, real *S, int n);
+real hx_entropy_norm (real *x, int n);
 
-void hx_entropy_shannon_f (real *x, real *S, int n);
+void hx_entropy_norm_f (real *x, real *S, int n, int ns);
 
-void hx_entropy_shannon_df (real *x, real *S, int n);
+void hx_entropy_norm_df (real *x, real *S, int n, int ns);
 
-void hx_entropy_skilling_f (real *x, real *S, int n);
+void hx_entropy_shannon_f (real *x, real *S, int n, int ns);
 
-void hx_entropy_skilling_df (real *x, real *S, int n);
+void hx_entropy_shannon_df (real *x, real *S, int n, int ns);
 
-void hx_entropy_hoch_f (real *x, real *S, int n);
+void hx_entropy_skilling_f (real *x, real *S, int n, int ns);
 
-void hx_entropy_hoch_df (real *x, real *S, int n);
+void hx_entropy_skilling_df (real *x, real *S, int n, int ns);
+
+void hx_entropy_hoch_f (real *x, real *S, int n, int ns);
+
+void hx_entropy_hoch_df (real *x, real *S, int n, int ns);
 
 #endif /* __HXND_HX_ENTROPY_H__ */
 
@@ -37,9 +37,17 @@ unsigned int hx_prevpow2 (unsigned int value);
 
 unsigned int hx_nextpow2 (unsigned int value);
 
+hx_index hx_fft_prune_input (int n, hx_index idx, int nidx);
+
+hx_index hx_fft_prune_output (int n, hx_index idx, int nidx);
+
 int hx_array_fft1d (hx_array *y, int d, real dir,
                     hx_scalar *w, hx_scalar *swp);
 
+int hx_array_fft1d_pruned (hx_array *y, int d, real dir,
+                           hx_scalar *w, hx_scalar *swp,
+                           hx_index first, hx_index last);
+
 int hx_array_fftfn (hx_array *x, int d, int k, real dir);
 
 #define hx_array_fft(x, d, k) \
@@ -34,6 +34,30 @@
  */
 typedef int *hx_index;
 
+/* hx_sched: structure definition for the partition of the points of a
+ * regular grid into the sets sampled and unsampled by a nonuniform
+ * sampling schedule.
+ */
+typedef struct {
+  /* grid parameters:
+   * @k: number of grid dimensions.
+   * @sz: grid dimension sizes.
+   * @len: total number of grid points.
+   */
+  int k, len;
+  hx_index sz;
+
+  /* index sets:
+   * @n: number of sampled grid points.
+   * @nz: number of unsampled grid points.
+   * @on: ascending packed indices of the sampled points.
+   * @off: ascending packed indices of the unsampled points.
+   */
+  int n, nz;
+  hx_index on, off;
+}
+hx_sched;
+
 /* define a print macro that writes the variable name. */
 #define hx_index_print(k, arr) \
   hx_index_printfn(k, arr, #arr)
@@ -91,6 +115,15 @@ hx_index hx_index_scheduled (int k, hx_index sz, int dsched, int nsched,
 hx_index hx_index_unscheduled (int k, hx_index sz, int dsched, int nsched,
                                hx_index sched);
 
+void hx_sched_init (hx_sched *S);
+
+void hx_sched_free (hx_sched *S);
+
+int hx_sched_match (hx_sched *S, int k, hx_index sz);
+
+int hx_sched_build (hx_sched *S, int k, hx_index sz,
+                    int dsched, int nsched, hx_index sched);
+
 void hx_index_printfn (int k, hx_index idx, const char *s);
 
 #endif /* __HXND_HX_INDEX_H__ */
@@ -24,19 +24,180 @@
 #ifndef __HXND_HX_NUS_H__
 #define __HXND_HX_NUS_H__
 
-/* function declarations: */
+/* define string constants for supported ist acceleration schemes.
+ */
+#define HX_IST_ACCEL_NAME_NONE     "none"
+#define HX_IST_ACCEL_NAME_FISTA    "fista"
+#define HX_IST_ACCEL_NAME_RESTART  "restart"
+
+/* hx_ist_accel: enumerated type for ist acceleration schemes.
+ */
+enum hx_ist_accel {
+  HX_IST_ACCEL_UNDEFINED,
+  HX_IST_ACCEL_NONE,
+  HX_IST_ACCEL_FISTA,
+  HX_IST_ACCEL_RESTART
+};
+
+/* define string constants for supported irls linear solvers.
+ */
+#define HX_IRLS_SOLVER_NAME_CHOLESKY  "cholesky"
+#define HX_IRLS_SOLVER_NAME_CG        "cg"
+
+/* hx_irls_solver: enumerated type for irls linear solvers.
+ */
+enum hx_irls_solver {
+  HX_IRLS_SOLVER_UNDEFINED,
+  HX_IRLS_SOLVER_CHOLESKY,
+  HX_IRLS_SOLVER_CG
+};
+
+/* define string constants for supported ffm solvers.
+ */
+#define HX_FFM_SOLVER_NAME_SD  "sd"
+#define HX_FFM_SOLVER_NAME_CG  "cg"
+
+/* hx_ffm_solver: enumerated type for ffm entropy minimization methods.
+ */
+enum hx_ffm_solver {
+  HX_FFM_SOLVER_UNDEFINED,
+  HX_FFM_SOLVER_SD,
+  HX_FFM_SOLVER_CG
+};
+
+/* hx_nus_phase: enumerated type for the timed phases of a reconstruction,
+ * used to index the per-trace phase timings.
+ */
+enum hx_nus_phase {
+  HX_NUS_PHASE_FFT,
+  HX_NUS_PHASE_UPDATE,
+  HX_NUS_PHASE_SOLVE,
+  HX_NUS_PHASE_OTHER,
+  HX_NUS_NPHASE
+};
+
+/* hx_nus_rec: structure definition for the telemetry recorded at a single
+ * iteration of a reconstructed trace.
+ */
+typedef struct {
+  /* @iter: number of iterations performed on the trace.
+   * @res: relative residual norm of the estimate.
+   * @obj: objective value of the estimate.
+   * @par: iteration parameter (threshold, norm p-value or step length).
+   */
+  int iter;
+  real res, obj, par;
+}
+hx_nus_rec;
+
+/* hx_nus_stop: structure definition for the stopping criteria shared by
+ * all nonuniform sampling reconstructions, along with the number of
+ * iterations that each reconstructed trace required.
+ */
+typedef struct {
+  /* stopping criteria, where zero values disable a criterion:
+   * @niter: maximum number of iterations per trace.
+   * @rtol: relative residual norm over the sampled points.
+   * @otol: relative change in the objective between iterations.
+   * @lfloor: thresholding magnitude floor, relative to the noise level.
+   */
+  int niter;
+  real rtol, otol, lfloor;
+
+  /* per-trace results:
+   * @n: number of reconstructed traces.
+   * @iters: number of iterations performed on each trace.
+   */
+  int n;
+  int *iters;
+
+  /* telemetry options:
+   * @log: whether per-trace telemetry is recorded.
+   * @every: spacing of the recorded iterations, or zero to record none.
+   */
+  int log, every;
+
+  /* per-trace telemetry, allocated only when @log is set:
+   * @res, @obj, @par: latest relative residual norm, objective value and
+   *                   iteration parameter of each trace.
+   * @time: seconds spent by each trace in each phase.
+   * @cap: maximum number of iteration records of each trace.
+   * @nrec: number of iteration records stored by each trace.
+   * @rec: iteration records, @cap per trace.
+   */
+  real *res, *obj, *par;
+  double *time;
+  int cap;
+  int *nrec;
+  hx_nus_rec *rec;
+}
+hx_nus_stop;
+
+/* hx_nus_clock: structure definition for the timer that charges the
+ * elapsed time of a reconstructed trace to its phases.
+ */
+typedef struct {
+  /* @tm: phase timings of the current trace, or NULL if not recorded.
+   * @t0: time at which the current phase began.
+   */
+  double *tm;
+  double t0;
+}
+hx_nus_clock;
+
+/* function declarations (hx-nus.c): */
+
+void hx_nus_stop_init (hx_nus_stop *stop, int niter);
+
+int hx_nus_stop_alloc (hx_nus_stop *stop, int n);
+
+void hx_nus_stop_free (hx_nus_stop *stop);
+
+int hx_nus_stop_check (hx_nus_stop *stop);
+
+int hx_nus_chunk (int n, int warm, int nthreads);
+
+real hx_nus_sumsq (hx_array *x, hx_array *y, hx_index idx, int n);
+
+real hx_nus_select (real *v, int n, int m);
+
+real hx_nus_noise (hx_array *X, real *buf);
+
+int hx_nus_converged (hx_nus_stop *stop, real rss, real xss,
+                      real obj, real objprev);
+
+void hx_nus_stop_report (hx_nus_stop *stop, const char *name);
+
+void hx_nus_clock_start (hx_nus_clock *clk, hx_nus_stop *stop, int j);
+
+void hx_nus_clock_lap (hx_nus_clock *clk, enum hx_nus_phase phase);
+
+void hx_nus_log_iter (hx_nus_stop *stop, int j, int iter,
+                      real rss, real xss, real obj, real par);
+
+int hx_nus_log_write (hx_nus_stop *stop, const char *fname,
+                      const char *name, const char *par);
+
+/* function declarations (hx-nus-*.c): */
+
+enum hx_ist_accel hx_ist_lookup_accel (const char *name);
 
 int hx_array_ist (hx_array *x, hx_index dx, hx_index kx,
-                  int dsched, int nsched, hx_index sched,
-                  int niter, real thresh);
+                  hx_sched *S, hx_nus_stop *stop, real thresh,
+                  enum hx_ist_accel accel, int warm);
+
+enum hx_irls_solver hx_irls_lookup_solver (const char *name);
 
 int hx_array_irls (hx_array *x, hx_index dx, hx_index kx,
-                   int dsched, int nsched, hx_index sched,
-                   int niter, real pa, real pb);
+                   hx_sched *S, hx_nus_stop *stop, real pa, real pb,
+                   enum hx_irls_solver solver, int warm);
+
+enum hx_ffm_solver hx_ffm_lookup_solver (const char *name);
 
 int hx_array_ffm (hx_array *x, hx_index dx, hx_index kx,
-                  int dsched, int nsched, hx_index sched,
-                  int niter, enum hx_entropy_type type);
+                  hx_sched *S, hx_nus_stop *stop,
+                  enum hx_entropy_type type,
+                  enum hx_ffm_solver solver, int warm);
 
 #endif /* __HXND_HX_NUS_H__ */
 
@@ -27,10 +27,13 @@
 /* include the n-dimensional math header. */
 #include <hxnd/hx.h>
 
-/* include the byte-level data, string, and nmr datum headers. */
+/* include the byte-level data, string, parameter table and nmr datum
+ * headers.
+ */
 #include <hxnd/nmr-datum.h>
 #include <hxnd/bytes.h>
 #include <hxnd/str.h>
+#include <hxnd/parms.h>
 
 /* function declarations: */
 
@@ -40,7 +43,5 @@ int bruker_decode (datum *D, const char *dname);
 
 int bruker_array (datum *D);
 
-int bruker_post (datum *D);
-
 #endif /* __HXND_NMR_BRUKER_H__ */
 
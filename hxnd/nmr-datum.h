@@ -46,7 +46,12 @@ enum datum_type {
   DATUM_TYPE_PIPE,
   DATUM_TYPE_UCSF,
   DATUM_TYPE_NV,
-  DATUM_TYPE_RNMRTK
+  DATUM_TYPE_RNMRTK,
+  DATUM_TYPE_HXNDC,
+  DATUM_TYPE_TEXTR,
+  DATUM_TYPE_TEXTV,
+  DATUM_TYPE_TEXTRV,
+  DATUM_TYPE_PIPES
 };
 
 /* datum_dim: single dimension of parameters for acquired NMR data.
@@ -117,6 +122,11 @@ typedef struct {
   int d_sched, n_sched;
   int *sched;
 
+  /* @sched_idx: sampled and unsampled index sets of the schedule over
+   *             the grid most recently requested by a processing step.
+   */
+  hx_sched sched_idx;
+
   /* @grpdelay: bruker group delay correction value.
    */
   real grpdelay;
@@ -149,6 +159,9 @@ void datum_free (datum *D);
 
 int datum_load (datum *D, const char *fname);
 
+int datum_load_region (datum *D, const char *fname,
+                       hx_index lower, hx_index upper);
+
 int datum_print (datum *D, const char *fname);
 
 /* function declarations (nmr-datum-dims.c): */
@@ -177,6 +190,10 @@ int datum_array_free (datum *D);
 
 int datum_array_resize (datum *D, hx_index sz);
 
+int datum_array_read_region (datum *D, hx_index lower, hx_index upper);
+
+int datum_array_compact (datum *D);
+
 int datum_array_slice (datum *D, hx_index lower, hx_index upper);
 
 int datum_array_project (datum *D, int dim, hx_array_projector_cb projector);
@@ -187,6 +204,8 @@ int datum_sched_read (datum *D, const char *fname);
 
 int datum_sched_free (datum *D);
 
+hx_sched *datum_sched_index (datum *D, int k, hx_index sz);
+
 /* function declarations (nmr-datum-type.c): */
 
 const char *datum_type_name (enum datum_type typ);
@@ -205,5 +224,10 @@ int datum_type_array (datum *D, enum datum_type typ);
 
 int datum_type_post (datum *D, enum datum_type typ);
 
+int datum_type_has_region (enum datum_type typ);
+
+int datum_type_region (datum *D, enum datum_type typ,
+                       hx_index lower, hx_index upper);
+
 #endif /* __HXND_NMR_DATUM_H__ */
 
@@ -37,9 +37,15 @@ int hxnd_guess (const char *fname);
 
 int hxnd_decode (datum *D, const char *fname);
 
+int hxnd_write (datum *D, const char *fname, int chunked);
+
 int hxnd_encode (datum *D, const char *fname);
 
+int hxnd_encode_chunked (datum *D, const char *fname);
+
 int hxnd_array (datum *D);
 
+int hxnd_region (datum *D, hx_index lower, hx_index upper);
+
 #endif /* __HXND_NMR_HXND_H__ */
 
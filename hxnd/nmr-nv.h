@@ -41,6 +41,8 @@ int nv_encode (datum *D, const char *fname);
 
 int nv_array (datum *D);
 
+int nv_region (datum *D, hx_index lower, hx_index upper);
+
 int nv_post (datum *D);
 
 #endif /* __HXND_NMR_NV_H__ */
@@ -39,7 +39,19 @@ int pipe_decode (datum *D, const char *fname);
 
 int pipe_encode (datum *D, const char *fname);
 
+int pipe_encode_series (datum *D, const char *fname);
+
 int pipe_array (datum *D);
 
+int pipe_stream_open (datum *D, FILE *fh);
+
+int pipe_stream_planes (datum *D);
+
+int pipe_stream_read (datum *D, datum *P, int p, FILE *fh);
+
+int pipe_stream_header (datum *D, FILE *fh);
+
+int pipe_stream_write (datum *P, FILE *fh);
+
 #endif /* __HXND_NMR_PIPE_H__ */
 
@@ -32,9 +32,23 @@
 #include <hxnd/bytes.h>
 #include <hxnd/str.h>
 
+/* TEXT_NO_INDEX, TEXT_REAL_ONLY: flags for text_write() that omit the
+ * index columns and all but the real coefficient of each point.
+ */
+#define TEXT_NO_INDEX   0x01
+#define TEXT_REAL_ONLY  0x02
+
 /* function declarations: */
 
+int text_write (datum *D, const char *fname, int flags);
+
 int text_encode (datum *D, const char *dname);
 
+int text_encode_real (datum *D, const char *fname);
+
+int text_encode_values (datum *D, const char *fname);
+
+int text_encode_real_values (datum *D, const char *fname);
+
 #endif /* __HXND_NMR_TEXT_H__ */
 
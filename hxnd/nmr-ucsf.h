@@ -41,5 +41,7 @@ int ucsf_encode (datum *D, const char *fname);
 
 int ucsf_array (datum *D);
 
+int ucsf_region (datum *D, hx_index lower, hx_index upper);
+
 #endif /* __HXND_NMR_UCSF_H__ */
 
@@ -27,10 +27,13 @@
 /* include the n-dimensional math header. */
 #include <hxnd/hx.h>
 
-/* include the byte-level data, nmr datum, and string headers. */
+/* include the byte-level data, nmr datum, string, and parameter table
+ * headers.
+ */
 #include <hxnd/nmr-datum.h>
 #include <hxnd/bytes.h>
 #include <hxnd/str.h>
+#include <hxnd/parms.h>
 
 /* function declarations: */
 
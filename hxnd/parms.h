@@ -0,0 +1,97 @@
+
+/* hxnd: A framework for n-dimensional hypercomplex calculations for NMR.
+ * Copyright (C) 2014  Bradley Worley  <geekysuavo@gmail.com>.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to:
+ *
+ *   Free Software Foundation, Inc.
+ *   51 Franklin Street, Fifth Floor
+ *   Boston, MA  02110-1301, USA.
+ */
+
+/* ensure once-only inclusion. */
+#ifndef __HXND_PARMS_H__
+#define __HXND_PARMS_H__
+
+/* include required standard c headers. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+/* include the traceback header. */
+#include <hxnd/trace.h>
+
+/* PARMS_N_BUCKET: number of hash buckets in each parameter table.
+ */
+#define PARMS_N_BUCKET  256
+
+/* PARMS_N_CACHE: number of parsed parameter files held in the cache.
+ */
+#define PARMS_N_CACHE  8
+
+/* parms_entry: structure definition for a single key/value pair held
+ * in a parameter table bucket.
+ */
+typedef struct parms_entry {
+  /* @key: parameter name string.
+   * @val: unparsed parameter value string.
+   * @next: next entry in the same bucket.
+   */
+  char *key, *val;
+  struct parms_entry *next;
+}
+parms_entry;
+
+/* parms: structure definition for a table of parameters parsed from
+ * a single file, keyed by parameter name.
+ */
+typedef struct parms {
+  /* file identification:
+   * @fname: name of the parsed file.
+   * @fsz: size of the file when it was parsed.
+   * @mtime: modification time of the file when it was parsed.
+   * @parser: function used to parse the file.
+   */
+  char *fname;
+  long fsz;
+  time_t mtime;
+  int (*parser) (FILE *fh, struct parms *P);
+
+  /* parameter storage:
+   * @tab: array of hash table buckets.
+   * @n: number of stored parameters.
+   */
+  parms_entry *tab[PARMS_N_BUCKET];
+  unsigned int n;
+}
+parms;
+
+/* parms_parser: function pointer type for parsing the contents of an
+ * opened file into a parameter table.
+ */
+typedef int (*parms_parser) (FILE *fh, parms *P);
+
+/* function declarations: */
+
+int parms_set (parms *P, const char *key, const char *val);
+
+const char *parms_get (parms *P, const char *key);
+
+parms *parms_load (const char *fname, parms_parser parser);
+
+void parms_cache_free (void);
+
+#endif /* __HXND_PARMS_H__ */
@@ -20,9 +20,15 @@
  *   Boston, MA  02110-1301, USA.
  */
 
+/* request posix extensions for file status queries. */
+#define _POSIX_C_SOURCE 200809L
+
 /* include the byte-level data header. */
 #include <hxnd/bytes.h>
 
+/* include the posix file status header. */
+#include <sys/stat.h>
+
 /* bytes_conv_real_u64_t: union definition for converting between a real
  * floating point value and its binary representation.
  */
@@ -204,6 +210,30 @@ int bytes_fexist (const char *fname) {
   return ret;
 }
 
+/* bytes_fsame(): return whether two filenames refer to the same existing
+ * file, e.g. through links or different relative paths.
+ * @fa: the first filename to check.
+ * @fb: the second filename to check.
+ */
+int bytes_fsame (const char *fa, const char *fb) {
+  /* declare required variables:
+   * @sa: status of the first file.
+   * @sb: status of the second file.
+   * @err: saved error number, as a missing file is not an error here.
+   */
+  struct stat sa, sb;
+  int err = errno;
+
+  /* check that both files exist. */
+  if (!fa || !fb || stat(fa, &sa) || stat(fb, &sb)) {
+    errno = err;
+    return 0;
+  }
+
+  /* compare the devices and inodes of the files. */
+  return (sa.st_dev == sb.st_dev && sa.st_ino == sb.st_ino);
+}
+
 /* bytes_size(): read the number of bytes in a specified file.
  * @fname: the input filename.
  */
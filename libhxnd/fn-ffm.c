@@ -32,17 +32,22 @@
  */
 int fn_ffm (datum *D, const int dim, const fn_arg *args) {
   /* declare variables to hold argument values. */
-  char *fname;
-  int iters;
+  char *fname, *sname, *lname;
+  real tol, dobj;
+  int iters, report, warm, logstep;
 
   /* declare a few required variables. */
   enum hx_entropy_type ftype;
-  hx_index dv, kv;
+  enum hx_ffm_solver solver;
+  hx_index dv, kv, sz;
   unsigned int d;
+  hx_nus_stop stop;
+  hx_sched *S;
   int ncx, nnus;
 
   /* get the argument values from the argdef array. */
-  if (!fn_args_get_all(args, &fname, &iters))
+  if (!fn_args_get_all(args, &fname, &iters, &tol, &dobj, &report,
+                       &sname, &warm, &lname, &logstep))
     throw("failed to get ffm arguments");
 
   /* check that no dimension was specified. */
@@ -85,12 +90,30 @@ int fn_ffm (datum *D, const int dim, const fn_arg *args) {
     ftype = HX_ENTROPY_TYPE_HOCH;
   }
 
+  /* determine whether to look up the solver from a string. */
+  if (sname) {
+    /* look up the solver enumerated type from the string. */
+    solver = hx_ffm_lookup_solver(sname);
+
+    /* ensure a proper enumerated type was identified. */
+    if (solver == HX_FFM_SOLVER_UNDEFINED)
+      throw("undefined solver '%s'", sname);
+
+    /* free the solver name string. */
+    free(sname);
+  }
+  else {
+    /* use fixed steepest descent steps. */
+    solver = HX_FFM_SOLVER_SD;
+  }
+
   /* allocate the topological and algebraic dimension index arrays. */
   dv = hx_index_alloc(D->nd);
   kv = hx_index_alloc(D->nd);
+  sz = hx_index_alloc(D->nd);
 
   /* ensure the index arrays were allocated. */
-  if (!dv || !kv)
+  if (!dv || !kv || !sz)
     throw("failed to allocate dimension index arrays");
 
   /* store dimension information into the index arrays. */
@@ -100,14 +123,47 @@ int fn_ffm (datum *D, const int dim, const fn_arg *args) {
     kv[d] = D->dims[d].k;
   }
 
+  /* build the doubled reconstruction grid of the indirect dimensions. */
+  for (d = 1; d < D->nd; d++)
+    sz[d - 1] = 2 * D->array.sz[kv[d]];
+
+  /* get the shared schedule index sets over the reconstruction grid. */
+  S = datum_sched_index(D, D->nd - 1, sz);
+  if (!S)
+    throw("failed to index sampling schedule");
+
+  /* build the stopping criteria. */
+  hx_nus_stop_init(&stop, iters);
+  stop.rtol = tol;
+  stop.otol = dobj;
+  stop.log = (lname != NULL);
+  stop.every = logstep;
+
   /* execute the reconstruction. */
-  if (!hx_array_ffm(&D->array, dv, kv, D->d_sched, D->n_sched, D->sched,
-                    iters, ftype))
+  if (!hx_array_ffm(&D->array, dv, kv, S, &stop, ftype, solver, warm))
     throw("failed to perform ffm reconstruction");
 
+  /* report the per-trace iteration counts, if requested. */
+  if (report)
+    hx_nus_stop_report(&stop, FN_NAME_FFM);
+
+  /* write the reconstruction telemetry, if requested. */
+  if (lname) {
+    /* write the telemetry file. */
+    if (!hx_nus_log_write(&stop, lname, FN_NAME_FFM, "step"))
+      throw("failed to write ffm telemetry to '%s'", lname);
+
+    /* free the telemetry filename string. */
+    free(lname);
+  }
+
+  /* free the iteration counts. */
+  hx_nus_stop_free(&stop);
+
   /* free the allocated index arrays. */
   hx_index_free(dv);
   hx_index_free(kv);
+  hx_index_free(sz);
 
   /* return success. */
   return 1;
@@ -32,22 +32,44 @@
  */
 int fn_ist (datum *D, const int dim, const fn_arg *args) {
   /* declare variables to hold argument values. */
-  real thresh;
-  int iters;
+  real thresh, tol, dobj, lfloor;
+  int iters, report, warm, logstep;
+  char *aname, *lname;
 
   /* declare a few required variables. */
-  hx_index dv, kv;
+  hx_index dv, kv, sz;
   unsigned int d;
+  enum hx_ist_accel accel;
+  hx_nus_stop stop;
+  hx_sched *S;
   int ncx, nnus;
 
   /* get the argument values from the argdef array. */
-  if (!fn_args_get_all(args, &thresh, &iters))
+  if (!fn_args_get_all(args, &thresh, &iters, &tol, &dobj, &lfloor,
+                       &report, &aname, &warm, &lname, &logstep))
     throw("failed to get ist arguments");
 
   /* check that no dimension was specified. */
   if (dim >= 0)
     throw("dimension index specification not supported");
 
+  /* determine whether to look up the acceleration scheme from a string. */
+  if (aname) {
+    /* look up the acceleration scheme enumerated type from the string. */
+    accel = hx_ist_lookup_accel(aname);
+
+    /* ensure a proper enumerated type was identified. */
+    if (accel == HX_IST_ACCEL_UNDEFINED)
+      throw("undefined acceleration scheme '%s'", aname);
+
+    /* free the scheme name string. */
+    free(aname);
+  }
+  else {
+    /* use plain iterative soft thresholding. */
+    accel = HX_IST_ACCEL_NONE;
+  }
+
   /* count the number of nonuniform dimensions. */
   for (d = 0, nnus = 0; d < D->nd; d++)
     nnus += (D->dims[d].nus ? 1 : 0);
@@ -70,9 +92,10 @@ int fn_ist (datum *D, const int dim, const fn_arg *args) {
   /* allocate the topological and algebraic dimension index arrays. */
   dv = hx_index_alloc(D->nd);
   kv = hx_index_alloc(D->nd);
+  sz = hx_index_alloc(D->nd);
 
   /* ensure the index arrays were allocated. */
-  if (!dv || !kv)
+  if (!dv || !kv || !sz)
     throw("failed to allocate dimension index arrays");
 
   /* store dimension information into the index arrays. */
@@ -82,14 +105,49 @@ int fn_ist (datum *D, const int dim, const fn_arg *args) {
     kv[d] = D->dims[d].k;
   }
 
+  /* build the doubled reconstruction grid of the indirect dimensions. */
+  for (d = 1; d < D->nd; d++)
+    sz[d - 1] = 2 * D->array.sz[kv[d]];
+
+  /* get the shared schedule index sets over the reconstruction grid. */
+  S = datum_sched_index(D, D->nd - 1, sz);
+  if (!S)
+    throw("failed to index sampling schedule");
+
+  /* build the stopping criteria. */
+  hx_nus_stop_init(&stop, iters);
+  stop.rtol = tol;
+  stop.otol = dobj;
+  stop.lfloor = lfloor;
+  stop.log = (lname != NULL);
+  stop.every = logstep;
+
   /* execute the reconstruction. */
-  if (!hx_array_ist(&D->array, dv, kv, D->d_sched, D->n_sched, D->sched,
-                    iters, thresh))
+  if (!hx_array_ist(&D->array, dv, kv, S, &stop, thresh, accel,
+                    warm))
     throw("failed to perform ist reconstruction");
 
+  /* report the per-trace iteration counts, if requested. */
+  if (report)
+    hx_nus_stop_report(&stop, FN_NAME_IST);
+
+  /* write the reconstruction telemetry, if requested. */
+  if (lname) {
+    /* write the telemetry file. */
+    if (!hx_nus_log_write(&stop, lname, FN_NAME_IST, "lambda"))
+      throw("failed to write ist telemetry to '%s'", lname);
+
+    /* free the telemetry filename string. */
+    free(lname);
+  }
+
+  /* free the iteration counts. */
+  hx_nus_stop_free(&stop);
+
   /* free the allocated index arrays. */
   hx_index_free(dv);
   hx_index_free(kv);
+  hx_index_free(sz);
 
   /* return success. */
   return 1;
@@ -46,6 +46,190 @@ int fn_report_sumsq (datum *D) {
   return 1;
 }
 
+/* fn_report_log(): report a summary of the telemetry file written by a
+ * nonuniform sampling reconstruction.
+ * @fname: telemetry filename.
+ * @top: number of slowest traces to list.
+ * @trace: index of a trace whose iteration records are listed, or -1.
+ */
+int fn_report_log (const char *fname, int top, int trace) {
+  /* declare a few required variables:
+   * @line: current line of the file.
+   * @method: name of the reconstruction method.
+   * @par: name of the iteration parameter.
+   * @fh: input file handle.
+   */
+  char line[1024], method[64], par[64];
+  FILE *fh;
+
+  /* @n: number of traces read.
+   * @nmax: number of traces in the file header.
+   * @limit: iteration limit of the reconstruction.
+   * @every: spacing of the iteration records.
+   * @nrec: number of iteration records read.
+   * @ncap: number of traces that reached the iteration limit.
+   * @imin, @imax: extreme trace iteration counts.
+   * @i, @l: trace loop counters.
+   * @j, @it: index and iteration count of the current line.
+   */
+  int n, nmax, limit, every, nrec, ncap, imin, imax, i, l, j, it;
+
+  /* @res: final relative residual norm of each trace.
+   * @tt: total time spent by each trace.
+   * @iters: iteration count of each trace.
+   * @done: whether each trace has been listed among the slowest.
+   * @tm: phase timings of the current line.
+   * @tsum: total time spent in each phase.
+   * @r, @o, @v: residual, objective and parameter of the current line.
+   * @itsum, @ttot: total iteration count and time.
+   */
+  real *res;
+  double *tt;
+  int *iters, *done;
+  double tm[HX_NUS_NPHASE], tsum[HX_NUS_NPHASE];
+  double r, o, v, itsum, ttot;
+
+  /* open the telemetry file. */
+  fh = fopen(fname, "r");
+  if (!fh)
+    throw("failed to open '%s'", fname);
+
+  /* read the file header. */
+  if (!fgets(line, sizeof(line), fh) ||
+      sscanf(line, "# hx-nus-log method=%63s param=%63s traces=%d "
+                   "limit=%d every=%d",
+             method, par, &nmax, &limit, &every) != 5 || nmax < 1) {
+    fclose(fh);
+    throw("invalid telemetry file '%s'", fname);
+  }
+
+  /* allocate the per-trace summaries. */
+  res = (real*) calloc(nmax, sizeof(real));
+  tt = (double*) calloc(nmax, sizeof(double));
+  iters = (int*) calloc(nmax, sizeof(int));
+  done = (int*) calloc(nmax, sizeof(int));
+  if (!res || !tt || !iters || !done) {
+    /* close the file and free any allocated summaries. */
+    fclose(fh);
+    free(res);
+    free(tt);
+    free(iters);
+    free(done);
+    throw("failed to allocate summaries of %d traces", nmax);
+  }
+
+  /* initialize the totals. */
+  for (l = 0; l < HX_NUS_NPHASE; l++)
+    tsum[l] = 0.0;
+
+  /* read the trace summaries and count the iteration records. */
+  for (n = 0, nrec = 0; fgets(line, sizeof(line), fh);) {
+    /* read the summary lines of the traces. */
+    if (sscanf(line, "trace,%d,%d,%le,%le,%le,%le,%le,%le,%le",
+               &j, &it, &r, &o, &v, tm, tm + 1, tm + 2, tm + 3) == 9 &&
+        j >= 0 && j < nmax) {
+      /* store the trace summary. */
+      iters[j] = it;
+      res[j] = r;
+      for (l = 0, tt[j] = 0.0; l < HX_NUS_NPHASE; l++) {
+        tt[j] += tm[l];
+        tsum[l] += tm[l];
+      }
+
+      /* count the trace. */
+      n++;
+    }
+    else if (strncmp(line, "iter,", 5) == 0)
+      nrec++;
+  }
+
+  /* ensure every trace was read. */
+  if (n != nmax) {
+    /* close the file and free the summaries. */
+    fclose(fh);
+    free(res);
+    free(tt);
+    free(iters);
+    free(done);
+    throw("expected %d traces in '%s', found %d", nmax, fname, n);
+  }
+
+  /* summarize the iteration counts. */
+  imin = imax = iters[0];
+  for (i = 0, ncap = 0, itsum = 0.0; i < n; i++) {
+    /* update the extreme counts. */
+    if (iters[i] < imin) imin = iters[i];
+    if (iters[i] > imax) imax = iters[i];
+
+    /* update the total and limited counts. */
+    ncap += (iters[i] >= limit ? 1 : 0);
+    itsum += (double) iters[i];
+  }
+
+  /* summarize the phase timings. */
+  for (l = 0, ttot = 0.0; l < HX_NUS_NPHASE; l++)
+    ttot += tsum[l];
+
+  /* print the summary of the reconstruction. */
+  fprintf(stdout, "log = %s\n", fname);
+  fprintf(stdout, "  method = %s, traces = %d, limit = %d, "
+                  "records = %d (every %d)\n",
+          method, n, limit, nrec, every);
+  fprintf(stdout, "  iterations: min %d, mean %.1lf, max %d, "
+                  "%d at limit\n", imin, itsum / (double) n, imax, ncap);
+
+  /* print the spread of the final residuals. */
+  fprintf(stdout, "  residual: min %.3le, median %.3le, max %.3le\n",
+          hx_nus_select(res, n, 0), hx_nus_select(res, n, n / 2),
+          hx_nus_select(res, n, n - 1));
+
+  /* print the time spent in each phase. */
+  fprintf(stdout, "  time: %.3lf s, fft %.1lf%%, update %.1lf%%, "
+                  "solve %.1lf%%, other %.1lf%%\n", ttot,
+          100.0 * tsum[HX_NUS_PHASE_FFT] / (ttot > 0.0 ? ttot : 1.0),
+          100.0 * tsum[HX_NUS_PHASE_UPDATE] / (ttot > 0.0 ? ttot : 1.0),
+          100.0 * tsum[HX_NUS_PHASE_SOLVE] / (ttot > 0.0 ? ttot : 1.0),
+          100.0 * tsum[HX_NUS_PHASE_OTHER] / (ttot > 0.0 ? ttot : 1.0));
+
+  /* list the slowest traces. */
+  for (l = 0; l < top && l < n; l++) {
+    /* find the slowest trace not yet listed. */
+    for (i = 0, j = -1; i < n; i++) {
+      if (!done[i] && (j < 0 || tt[i] > tt[j]))
+        j = i;
+    }
+
+    /* print the trace. */
+    done[j] = 1;
+    fprintf(stdout, "  slow trace %d: %.3le s, %d iterations\n",
+            j, tt[j], iters[j]);
+  }
+
+  /* list the iteration records of the requested trace. */
+  if (trace >= 0) {
+    /* return to the start of the file. */
+    rewind(fh);
+    fprintf(stdout, "  trace %d: iter, res, obj, %s\n", trace, par);
+
+    /* print each record of the trace. */
+    while (fgets(line, sizeof(line), fh)) {
+      if (sscanf(line, "iter,%d,%d,%le,%le,%le",
+                 &j, &it, &r, &o, &v) == 5 && j == trace)
+        fprintf(stdout, "    %6d %12.4le %12.4le %12.4le\n", it, r, o, v);
+    }
+  }
+
+  /* close the file and free the summaries. */
+  fclose(fh);
+  free(res);
+  free(tt);
+  free(iters);
+  free(done);
+
+  /* return success. */
+  return 1;
+}
+
 /* fn_report(): report specified statistics pertaining to the array of
  * a datum structure.
  * @D: pointer to the datum to manipulate (in-place).
@@ -54,19 +238,40 @@ int fn_report_sumsq (datum *D) {
  */
 int fn_report (datum *D, const int dim, const fn_arg *args) {
   /* declare variables to hold argument values. */
-  int sumsq;
+  int sumsq, top, trace;
+  char *lname;
 
   /* get the argument values from the argdef array */
-  if (!fn_args_get_all(args, &sumsq))
+  if (!fn_args_get_all(args, &sumsq, &lname, &top, &trace))
     throw("failed to get report arguments");
 
   /* check that no dimension was specified. */
-  if (dim >= 0)
+  if (dim >= 0) {
+    /* free the telemetry filename string and return failure. */
+    free(lname);
     throw("dimension index specification not supported");
+  }
 
   /* check if the sum of squares was requested. */
-  if (sumsq && !fn_report_sumsq(D))
+  if (sumsq && !fn_report_sumsq(D)) {
+    /* free the telemetry filename string and return failure. */
+    free(lname);
     throw("failed to report sum of squares");
+  }
+
+  /* check if a reconstruction telemetry summary was requested. */
+  if (lname) {
+    /* summarize the telemetry file. */
+    if (!fn_report_log(lname, top, trace)) {
+      /* free the telemetry filename string and return failure. */
+      raise("failed to report telemetry of '%s'", lname);
+      free(lname);
+      return 0;
+    }
+
+    /* free the telemetry filename string. */
+    free(lname);
+  }
 
   /* return success. */
   return 1;
@@ -38,10 +38,12 @@ int fn_subsamp (datum *D, const int dim, const fn_arg *args) {
   /* declare a few required variables:
    * @idx: sampling schedule multidimensional index.
    * @pidx: packed linear sampling schedule index.
+   * @S: sampled and unsampled index sets of the schedule.
    * @d: datum dimension index.
    */
-  hx_index idx, sz, zeros;
-  int i, d, pidx, nzeros;
+  hx_sched *S;
+  hx_index idx;
+  int i, d, pidx;
 
   /* get the argument values from the argdef array. */
   if (!fn_args_get_all(args, &fsched))
@@ -63,29 +65,11 @@ int fn_subsamp (datum *D, const int dim, const fn_arg *args) {
   if (D->d_sched != D->nd - 1)
     throw("sampling schedule in '%s' has invalid dimensionality", fsched);
 
-  /* allocate the schedule size array. */
-  sz = hx_index_alloc(D->d_sched);
+  /* get the unscheduled indices over the indirect array dimensions. */
+  S = datum_sched_index(D, D->d_sched, D->array.sz + 1);
 
-  /* check that allocation was successful. */
-  if (!sz)
-    throw("failed to allocate %d indices", D->d_sched);
-
-  /* build the schedule size array. */
-  for (i = 0, nzeros = 1; i < D->d_sched; i++) {
-    /* store the current schedule size and increase the total count. */
-    sz[i] = D->array.sz[i + 1];
-    nzeros *= sz[i];
-  }
-
-  /* compute the number of unscheduled indices. */
-  nzeros -= D->n_sched;
-
-  /* create a list of unscheduled array indices. */
-  zeros = hx_index_unscheduled(D->d_sched, sz, D->d_sched, D->n_sched,
-                               D->sched);
-
-  /* check that creation was successful. */
-  if (!zeros)
+  /* check that the index sets were built. */
+  if (!S)
     throw("failed to compute unscheduled array indices");
 
   /* allocate a multidimensional index. */
@@ -95,8 +79,8 @@ int fn_subsamp (datum *D, const int dim, const fn_arg *args) {
   if (!idx)
     throw("failed to allocate %d indices", D->nd);
 
-  /* loop over the points in the sampling schedule. */
-  for (i = 0; i < nzeros; i++) {
+  /* loop over the unsampled points of the schedule. */
+  for (i = 0; i < S->nz; i++) {
     /* zero the index elements. */
     hx_index_init(D->nd, idx);
 
@@ -104,13 +88,9 @@ int fn_subsamp (datum *D, const int dim, const fn_arg *args) {
      * repack the linear index into a complete-array multidimensional
      * index.
      */
-    hx_index_unpack(D->d_sched, sz, idx + 1, zeros[i]);
+    hx_index_unpack(S->k, S->sz, idx + 1, S->off[i]);
     hx_index_pack(D->array.k, D->array.sz, idx, &pidx);
 
-    /* check that the linear index is in bounds. */
-    if (pidx >= D->array.len / D->array.n)
-      throw("sampling schedule entry #%d out of bounds", i);
-
     /* zero out the trace corresponding to the current index. */
     if (!hx_data_zero(D->array.x + pidx * D->array.n,
                       D->array.sz[0] * D->array.n))
@@ -122,9 +102,7 @@ int fn_subsamp (datum *D, const int dim, const fn_arg *args) {
     D->dims[d].nus = 1;
 
   /* free the array indices and the filename string. */
-  hx_index_free(zeros);
   hx_index_free(idx);
-  hx_index_free(sz);
   free(fsched);
 
   /* return success. */
@@ -33,32 +33,32 @@
  * and argument definitions.
  */
 static fn functions[] = {
-  { FN_NAME_ABS,      (fn_pointer) &fn_abs,      NULL },
-  { FN_NAME_ADD,      (fn_pointer) &fn_add,      fn_args_add },
-  { FN_NAME_BASELINE, (fn_pointer) &fn_baseline, fn_args_baseline },
-  { FN_NAME_COMPLEX,  (fn_pointer) &fn_complex,  NULL },
-  { FN_NAME_CROP,     (fn_pointer) &fn_crop,     fn_args_crop },
-  { FN_NAME_CUT,      (fn_pointer) &fn_cut,      fn_args_cut },
-  { FN_NAME_FFM,      (fn_pointer) &fn_ffm,      fn_args_ffm },
-  { FN_NAME_FFT,      (fn_pointer) &fn_fft,      fn_args_fft },
-  { FN_NAME_FILTER,   (fn_pointer) &fn_filter,   fn_args_filter },
-  { FN_NAME_HT,       (fn_pointer) &fn_ht,       NULL },
-  { FN_NAME_IRLS,     (fn_pointer) &fn_irls,     fn_args_irls },
-  { FN_NAME_IST,      (fn_pointer) &fn_ist,      fn_args_ist },
-  { FN_NAME_MIRROR,   (fn_pointer) &fn_mirror,   NULL },
-  { FN_NAME_MULTIPLY, (fn_pointer) &fn_multiply, fn_args_multiply },
-  { FN_NAME_PHASE,    (fn_pointer) &fn_phase,    fn_args_phase },
-  { FN_NAME_PROJECT,  (fn_pointer) &fn_project,  fn_args_project },
-  { FN_NAME_REAL,     (fn_pointer) &fn_real,     NULL },
-  { FN_NAME_REPORT,   (fn_pointer) &fn_report,   fn_args_report },
-  { FN_NAME_RESIZE,   (fn_pointer) &fn_resize,   fn_args_resize },
-  { FN_NAME_SHIFT,    (fn_pointer) &fn_shift,    fn_args_shift },
-  { FN_NAME_SUBSAMP,  (fn_pointer) &fn_subsamp,  fn_args_subsamp },
-  { FN_NAME_SYMM,     (fn_pointer) &fn_symm,     fn_args_symm },
-  { FN_NAME_TILT,     (fn_pointer) &fn_tilt,     fn_args_tilt },
-  { FN_NAME_WINDOW,   (fn_pointer) &fn_window,   fn_args_window },
-  { FN_NAME_ZEROFILL, (fn_pointer) &fn_zerofill, fn_args_zerofill },
-  { NULL,             NULL,         NULL }
+  { FN_NAME_ABS,      (fn_pointer) &fn_abs,       NULL,             FN_ARRAY },
+  { FN_NAME_ADD,      (fn_pointer) &fn_add,       fn_args_add,      FN_ARRAY },
+  { FN_NAME_BASELINE, (fn_pointer) &fn_baseline,  fn_args_baseline, FN_FIRST },
+  { FN_NAME_COMPLEX,  (fn_pointer) &fn_complex,   NULL,             FN_DIM },
+  { FN_NAME_CROP,     (fn_pointer) &fn_crop,      fn_args_crop,     FN_FIRST },
+  { FN_NAME_CUT,      (fn_pointer) &fn_cut,       fn_args_cut,      FN_ARRAY },
+  { FN_NAME_FFM,      (fn_pointer) &fn_ffm,       fn_args_ffm,      FN_ARRAY },
+  { FN_NAME_FFT,      (fn_pointer) &fn_fft,       fn_args_fft,      FN_DIM },
+  { FN_NAME_FILTER,   (fn_pointer) &fn_filter,    fn_args_filter,   FN_FIRST },
+  { FN_NAME_HT,       (fn_pointer) &fn_ht,        NULL,             FN_DIM },
+  { FN_NAME_IRLS,     (fn_pointer) &fn_irls,      fn_args_irls,     FN_ARRAY },
+  { FN_NAME_IST,      (fn_pointer) &fn_ist,       fn_args_ist,      FN_ARRAY },
+  { FN_NAME_MIRROR,   (fn_pointer) &fn_mirror,    NULL,             FN_DIM },
+  { FN_NAME_MULTIPLY, (fn_pointer) &fn_multiply,  fn_args_multiply, FN_FIRST },
+  { FN_NAME_PHASE,    (fn_pointer) &fn_phase,     fn_args_phase,    FN_DIM },
+  { FN_NAME_PROJECT,  (fn_pointer) &fn_project,   fn_args_project,  FN_ARRAY },
+  { FN_NAME_REAL,     (fn_pointer) &fn_real,      NULL,             FN_DIM },
+  { FN_NAME_REPORT,   (fn_pointer) &fn_report,    fn_args_report,   FN_ARRAY },
+  { FN_NAME_RESIZE,   (fn_pointer) &fn_resize,    fn_args_resize,   FN_DIM },
+  { FN_NAME_SHIFT,    (fn_pointer) &fn_shift,     fn_args_shift,    FN_DIM },
+  { FN_NAME_SUBSAMP,  (fn_pointer) &fn_subsamp,   fn_args_subsamp,  FN_ARRAY },
+  { FN_NAME_SYMM,     (fn_pointer) &fn_symm,      fn_args_symm,     FN_ARRAY },
+  { FN_NAME_TILT,     (fn_pointer) &fn_tilt,      fn_args_tilt,     FN_ARRAY },
+  { FN_NAME_WINDOW,   (fn_pointer) &fn_window,    fn_args_window,   FN_FIRST },
+  { FN_NAME_ZEROFILL, (fn_pointer) &fn_zerofill,  fn_args_zerofill, FN_DIM },
+  { NULL,             NULL,                       NULL,             FN_ARRAY }
 };
 
 /* fn_lookup(): execute a name-lookup of a processing function based on
@@ -168,3 +168,53 @@ int fn_execute_from_strings (void *fndata, const int dim,
   return ret;
 }
 
+
+/* fn_check_scope(): check whether a processing function may be applied
+ * along a given dimension of a datum that holds only a subset of the
+ * dimensions of the data it was read from, e.g. a single plane. functions
+ * that act along an unspecified dimension are assumed to act along the
+ * first dimension.
+ * @fnname: function name string to search with.
+ * @dim: dimension to apply the function along, or -1.
+ * @nd: number of dimensions held by the datum.
+ */
+int fn_check_scope (const char *fnname, const int dim, const int nd) {
+  /* declare a required variable:
+   * @func: function structure pointer.
+   */
+  fn *func;
+
+  /* look up the function address by its name. */
+  func = fn_lookup(fnname);
+
+  /* check if a match was identified. */
+  if (!func)
+    throw("failed to look up function '%s'", fnname);
+
+  /* check the scope of the function. */
+  switch (func->scope) {
+    /* functions that act along the first dimension. */
+    case FN_FIRST:
+      if (dim >= nd)
+        throw("function '%s' is not local to dimension %d", func->name, dim);
+
+      break;
+
+    /* functions that act along a specified dimension. */
+    case FN_DIM:
+      if (dim < 0)
+        throw("function '%s' requires a dimension index", func->name);
+
+      if (dim >= nd)
+        throw("function '%s' is not local to dimension %d", func->name, dim);
+
+      break;
+
+    /* functions that require the complete array. */
+    default:
+      throw("function '%s' requires the complete array", func->name);
+  }
+
+  /* return success. */
+  return 1;
+}
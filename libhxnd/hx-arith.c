@@ -920,6 +920,122 @@ int hx_array_negate_basis (hx_array *x, int dneg) {
   return 1;
 }
 
+/* hx_array_correct(): apply sign alternation, imaginary negation and
+ * leading point removal to a hypercomplex array in a single pass over
+ * its coefficients. alternation parities are taken from the indices that
+ * points held before removal.
+ * @x: the structure pointer to the target array.
+ * @alt: bit mask of topological dimensions to sign-alternate.
+ * @neg: bit mask of algebraic dimensions to negate.
+ * @ncrop: number of leading points to remove from each vector along the
+ *         first topological dimension.
+ */
+int hx_array_correct (hx_array *x, int alt, int neg, int ncrop) {
+  /* declare a few required variables:
+   * @tab: per-coefficient sign table for imaginary negation.
+   * @sznew: new size of the first topological dimension.
+   * @ntr: number of vectors along the first topological dimension.
+   * @t: vector loop counter.
+   * @i: basis element loop counter.
+   */
+  int i, t, sznew, ntr;
+  real *tab;
+
+  /* check that the crop amount is in bounds. */
+  if (ncrop < 0 || ncrop >= x->sz[0])
+    throw("crop amount %d out of bounds [0,%d)", ncrop, x->sz[0]);
+
+  /* return if no correction is required. */
+  if (!alt && !neg && !ncrop)
+    return 1;
+
+  /* coefficients held in file mappings may not be moved. */
+  if (ncrop && x->map)
+    throw("cannot crop a file-mapped array");
+
+  /* allocate the negation sign table. */
+  tab = (real*) malloc(x->n * sizeof(real));
+  if (!tab)
+    throw("failed to allocate %d-element sign table", x->n);
+
+  /* build the negation sign table. each coefficient is negated once for
+   * every negated basis element it carries, so its sign follows the
+   * parity of the overlap between its index and the negation mask.
+   */
+  for (i = 0; i < x->n; i++) {
+    /* count the negated basis elements of the coefficient. */
+    for (t = i & neg, tab[i] = 1.0; t; t &= t - 1)
+      tab[i] = -tab[i];
+  }
+
+  /* compute the new vector length and vector count. */
+  sznew = x->sz[0] - ncrop;
+  ntr = x->len / (x->n * x->sz[0]);
+
+  /* correct the vectors. moving points requires a serial pass, since
+   * each vector is written over the tail of the one before it.
+   */
+  #pragma omp parallel for if (ncrop == 0)
+  for (t = 0; t < ntr; t++) {
+    /* declare a few thread-local variables:
+     * @idx: unpacked index of the current vector.
+     * @src: first source coefficient of the current vector.
+     * @dst: first destination coefficient of the current vector.
+     * @sv: sign of the current vector.
+     * @s: sign of the current point.
+     * @j: point loop counter.
+     * @l: coefficient loop counter.
+     * @ki: dimension loop counter.
+     * @rem: remaining packed vector index.
+     */
+    int j, l, ki, rem, idx;
+    real *src, *dst, sv, s;
+
+    /* compute the vector sign from its indices along each alternated
+     * dimension after the first.
+     */
+    for (ki = 1, rem = t, sv = 1.0; ki < x->k; ki++) {
+      idx = rem % x->sz[ki];
+      rem /= x->sz[ki];
+      if ((alt & (1 << ki)) && (idx & 1))
+        sv = -sv;
+    }
+
+    /* locate the source and destination coefficients. */
+    src = x->x + ((size_t) t * x->sz[0] + ncrop) * x->n;
+    dst = x->x + (size_t) t * sznew * x->n;
+
+    /* loop over the retained points of the vector. */
+    for (j = 0; j < sznew; j++) {
+      /* compute the point sign. */
+      s = ((alt & 1) && ((j + ncrop) & 1) ? -sv : sv);
+
+      /* write the corrected coefficients. */
+      for (l = 0; l < x->n; l++)
+        dst[j * x->n + l] = s * tab[l] * src[j * x->n + l];
+    }
+  }
+
+  /* free the sign table. */
+  free(tab);
+
+  /* return if no points were removed. */
+  if (!ncrop)
+    return 1;
+
+  /* store the new array size. */
+  x->sz[0] = sznew;
+  x->len = ntr * sznew * x->n;
+
+  /* shrink the coefficient storage. */
+  tab = (real*) realloc(x->x, x->len * sizeof(real));
+  if (tab)
+    x->x = tab;
+
+  /* return success. */
+  return 1;
+}
+
 /* hx_array_reorder_bases(): reorders the basis elements of each scalar value
  * in a hypercomplex array.
  * @x: the structure pointer to the target array.
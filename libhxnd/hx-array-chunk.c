@@ -0,0 +1,887 @@
+
+/* hxnd: A framework for n-dimensional hypercomplex calculations for NMR.
+ * Copyright (C) 2014  Bradley Worley  <geekysuavo@gmail.com>.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to:
+ *
+ *   Free Software Foundation, Inc.
+ *   51 Franklin Street, Fifth Floor
+ *   Boston, MA  02110-1301, USA.
+ */
+
+/* enable fseeko() for skipping over unused chunk data. */
+#define _POSIX_C_SOURCE 200809L
+
+/* include the n-dimensional math header. */
+#include <hxnd/hx.h>
+
+/* include the byte-level data header. */
+#include <hxnd/bytes.h>
+
+/* define the number of (u64) members in the fixed portion of the header of
+ * chunked binary array files, and in each of their chunk index entries.
+ */
+#define HX_ARRAY_CHUNK_SZ_HDR  6
+#define HX_ARRAY_CHUNK_SZ_ENT  3
+
+/* define the number of entries in the match-finding hash table of the
+ * chunk compressor, the minimum and maximum match lengths, and the
+ * maximum literal run length.
+ */
+#define HX_ARRAY_LZ_HASH_BITS  14
+#define HX_ARRAY_LZ_MIN         4
+#define HX_ARRAY_LZ_MAX       131
+#define HX_ARRAY_LZ_RUN       128
+
+/* HX_ARRAY_CHUNK_BOUND(): worst-case size of an encoded chunk of @n bytes.
+ */
+#define HX_ARRAY_CHUNK_BOUND(n) \
+  ((n) + (n) / HX_ARRAY_LZ_RUN + 16)
+
+/* hx_array_chunk_size(): choose the chunk shape used to store an array in
+ * chunked form. chunk sizes are doubled along each dimension in turn until
+ * the chunks hold roughly HX_ARRAY_CHUNK_SZ coefficients, which keeps them
+ * as close to cubic as the array allows.
+ * @x: pointer to the array to be chunked.
+ * @csz: output chunk sizes, preallocated to @x->k elements.
+ */
+void hx_array_chunk_size (hx_array *x, hx_index csz) {
+  /* declare a few required variables:
+   * @i: dimension loop counter.
+   * @grown: whether any chunk dimension grew during a pass.
+   * @ncf: number of coefficients per chunk.
+   * @szi: new chunk size along the current dimension.
+   */
+  int i, grown, ncf, szi;
+
+  /* initialize the chunk sizes to single points. */
+  for (i = 0, ncf = x->n; i < x->k; i++)
+    csz[i] = 1;
+
+  /* grow the chunks in round-robin fashion. */
+  do {
+    /* loop over the array dimensions. */
+    for (i = 0, grown = 0; i < x->k; i++) {
+      /* skip dimensions that are already fully spanned. */
+      if (csz[i] >= x->sz[i])
+        continue;
+
+      /* compute the new chunk size along the dimension. */
+      szi = 2 * csz[i];
+      if (szi > x->sz[i])
+        szi = x->sz[i];
+
+      /* stop growing once the chunks become too large. */
+      if ((ncf / csz[i]) * szi > HX_ARRAY_CHUNK_SZ)
+        continue;
+
+      /* store the new chunk size. */
+      ncf = (ncf / csz[i]) * szi;
+      csz[i] = szi;
+      grown = 1;
+    }
+  } while (grown);
+}
+
+/* hx_array_chunk_bounds(): compute the lower and upper index bounds of a
+ * chunk, based on its linear index in the chunk grid of an array.
+ * @k: number of array dimensions.
+ * @sz: array dimension sizes.
+ * @csz: chunk dimension sizes.
+ * @nck: chunk counts along each array dimension.
+ * @c: linear chunk index.
+ * @lower: output lower bounds of the chunk.
+ * @upper: output upper bounds of the chunk.
+ */
+void hx_array_chunk_bounds (int k, hx_index sz, hx_index csz, hx_index nck,
+                            int c, hx_index lower, hx_index upper) {
+  /* declare a required variable:
+   * @i: dimension loop counter.
+   */
+  int i;
+
+  /* unpack the chunk grid index. */
+  hx_index_unpack(k, nck, lower, c);
+
+  /* scale the grid index into array indices, truncating edge chunks. */
+  for (i = 0; i < k; i++) {
+    lower[i] *= csz[i];
+    upper[i] = lower[i] + csz[i] - 1;
+    if (upper[i] >= sz[i])
+      upper[i] = sz[i] - 1;
+  }
+}
+
+/* hx_array_chunk_region(): check that a set of region bounds lies within
+ * the extents of an array.
+ * @k: number of array dimensions.
+ * @sz: array dimension sizes.
+ * @lower: lower region bounds.
+ * @upper: upper region bounds.
+ */
+int hx_array_chunk_region (int k, hx_index sz, hx_index lower,
+                           hx_index upper) {
+  /* declare a required variable:
+   * @i: dimension loop counter.
+   */
+  int i;
+
+  /* check each dimension of the region. */
+  for (i = 0; i < k; i++) {
+    if (lower[i] < 0 || lower[i] > upper[i] || upper[i] >= sz[i])
+      throw("region [%d,%d] out of bounds [0,%d] (#%d)",
+            lower[i], upper[i], sz[i] - 1, i);
+  }
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_chunk_lz(): compress a buffer using a byte-oriented LZ77 scheme.
+ * the output is a sequence of literal runs, each prefixed by a control byte
+ * below 0x80 holding its length minus one, and matches, each stored as a
+ * control byte of 0x80 plus the match length less HX_ARRAY_LZ_MIN, followed
+ * by a little-endian 16-bit backward offset.
+ * @in: input buffer.
+ * @n: number of input bytes.
+ * @out: output buffer of at least HX_ARRAY_CHUNK_BOUND(@n) bytes.
+ */
+size_t hx_array_chunk_lz (const uint8_t *in, size_t n, uint8_t *out) {
+  /* declare a few required variables:
+   * @ht: hash table of recent input positions.
+   * @i: current input position.
+   * @lit: start of the pending literal run.
+   * @cand: candidate match position.
+   * @len: match length.
+   * @run: literal run length.
+   * @nout: number of output bytes.
+   * @h: hash of the four bytes at the current position.
+   */
+  size_t i, lit, cand, len, run, nout;
+  uint32_t h;
+  long *ht;
+
+  /* allocate and initialize the hash table. */
+  ht = (long*) malloc((1 << HX_ARRAY_LZ_HASH_BITS) * sizeof(long));
+  if (!ht)
+    return 0;
+
+  /* mark all hash table entries as empty. */
+  for (i = 0; i < (1 << HX_ARRAY_LZ_HASH_BITS); i++)
+    ht[i] = -1;
+
+  /* loop over the input bytes. */
+  for (i = lit = nout = 0; i + HX_ARRAY_LZ_MIN <= n;) {
+    /* hash the next four bytes. */
+    h = (uint32_t) in[i] | ((uint32_t) in[i + 1] << 8) |
+        ((uint32_t) in[i + 2] << 16) | ((uint32_t) in[i + 3] << 24);
+    h = (h * 2654435761u) >> (32 - HX_ARRAY_LZ_HASH_BITS);
+
+    /* look up and replace the candidate position. */
+    cand = (size_t) ht[h];
+    ht[h] = (long) i;
+
+    /* check for a usable match at the candidate position. */
+    if (cand == (size_t) -1 || i - cand > 0xffff ||
+        memcmp(in + cand, in + i, HX_ARRAY_LZ_MIN)) {
+      i++;
+      continue;
+    }
+
+    /* extend the match as far as possible. */
+    for (len = HX_ARRAY_LZ_MIN;
+         i + len < n && len < HX_ARRAY_LZ_MAX &&
+         in[cand + len] == in[i + len]; len++);
+
+    /* flush the pending literals. */
+    while (lit < i) {
+      run = (i - lit > HX_ARRAY_LZ_RUN ? HX_ARRAY_LZ_RUN : i - lit);
+      out[nout++] = (uint8_t) (run - 1);
+      memcpy(out + nout, in + lit, run);
+      nout += run;
+      lit += run;
+    }
+
+    /* store the match. */
+    out[nout++] = (uint8_t) (0x80 | (len - HX_ARRAY_LZ_MIN));
+    out[nout++] = (uint8_t) ((i - cand) & 0xff);
+    out[nout++] = (uint8_t) ((i - cand) >> 8);
+
+    /* move past the matched bytes. */
+    i += len;
+    lit = i;
+  }
+
+  /* flush the remaining literals. */
+  while (lit < n) {
+    run = (n - lit > HX_ARRAY_LZ_RUN ? HX_ARRAY_LZ_RUN : n - lit);
+    out[nout++] = (uint8_t) (run - 1);
+    memcpy(out + nout, in + lit, run);
+    nout += run;
+    lit += run;
+  }
+
+  /* free the hash table and return the output size. */
+  free(ht);
+  return nout;
+}
+
+/* hx_array_chunk_unlz(): decompress a buffer that was compressed using
+ * hx_array_chunk_lz().
+ * @in: input buffer.
+ * @nin: number of input bytes.
+ * @out: output buffer.
+ * @n: expected number of output bytes.
+ */
+int hx_array_chunk_unlz (const uint8_t *in, size_t nin,
+                         uint8_t *out, size_t n) {
+  /* declare a few required variables:
+   * @ip: input position.
+   * @op: output position.
+   * @len: literal run or match length.
+   * @off: match offset.
+   */
+  size_t ip, op, len, off;
+
+  /* loop over the input tokens. */
+  for (ip = op = 0; ip < nin;) {
+    if (in[ip] < 0x80) {
+      /* literal run: check its bounds and copy it. */
+      len = (size_t) in[ip++] + 1;
+      if (ip + len > nin || op + len > n)
+        throw("corrupt literal run at byte %lu", ip);
+
+      memcpy(out + op, in + ip, len);
+      ip += len;
+      op += len;
+    }
+    else {
+      /* match: check its bounds. */
+      len = (size_t) (in[ip] & 0x7f) + HX_ARRAY_LZ_MIN;
+      if (ip + 3 > nin)
+        throw("truncated match at byte %lu", ip);
+
+      off = (size_t) in[ip + 1] | ((size_t) in[ip + 2] << 8);
+      ip += 3;
+      if (off == 0 || off > op || op + len > n)
+        throw("corrupt match at byte %lu", ip);
+
+      /* copy the (possibly overlapping) match bytes. */
+      for (; len; len--, op++)
+        out[op] = out[op - off];
+    }
+  }
+
+  /* check that the expected amount of data was produced. */
+  if (op != n)
+    throw("decoded %lu bytes, expected %lu", op, n);
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_chunk_encode(): encode a chunk of array coefficients using
+ * a combination of the byte-shuffle, delta and LZ codecs.
+ * @in: input coefficient bytes.
+ * @n: number of input bytes.
+ * @wordsz: number of bytes per coefficient.
+ * @codec: bitwise-or of HX_ARRAY_CODEC_* flags.
+ * @out: output buffer of at least HX_ARRAY_CHUNK_BOUND(@n) bytes.
+ */
+size_t hx_array_chunk_encode (const uint8_t *in, size_t n,
+                              unsigned int wordsz, unsigned int codec,
+                              uint8_t *out) {
+  /* declare a few required variables:
+   * @buf: temporary buffer for shuffled and delta-coded bytes.
+   * @nw: number of coefficients in the chunk.
+   * @i: coefficient or byte loop counter.
+   * @b: byte-within-coefficient loop counter.
+   * @nout: number of output bytes.
+   */
+  size_t i, b, nw, nout;
+  uint8_t *buf;
+
+  /* allocate the temporary buffer. */
+  buf = (uint8_t*) malloc(n);
+  if (!buf)
+    return 0;
+
+  /* shuffle the coefficient bytes by significance, if requested. */
+  nw = n / wordsz;
+  if (codec & HX_ARRAY_CODEC_SHUFFLE) {
+    for (i = 0; i < nw; i++)
+      for (b = 0; b < wordsz; b++)
+        buf[b * nw + i] = in[i * wordsz + b];
+  }
+  else
+    memcpy(buf, in, n);
+
+  /* replace each byte by its difference from the previous byte. */
+  if (codec & HX_ARRAY_CODEC_DELTA) {
+    for (i = n - 1; i > 0; i--)
+      buf[i] -= buf[i - 1];
+  }
+
+  /* compress the bytes, or store them verbatim. */
+  if (codec & HX_ARRAY_CODEC_LZ) {
+    nout = hx_array_chunk_lz(buf, n, out);
+  }
+  else {
+    memcpy(out, buf, n);
+    nout = n;
+  }
+
+  /* free the temporary buffer and return the encoded size. */
+  free(buf);
+  return nout;
+}
+
+/* hx_array_chunk_decode(): decode a chunk of array coefficients that was
+ * encoded using hx_array_chunk_encode().
+ * @in: input encoded bytes.
+ * @nin: number of encoded bytes.
+ * @wordsz: number of bytes per coefficient.
+ * @codec: bitwise-or of HX_ARRAY_CODEC_* flags.
+ * @out: output coefficient bytes.
+ * @n: number of output bytes.
+ */
+int hx_array_chunk_decode (const uint8_t *in, size_t nin,
+                           unsigned int wordsz, unsigned int codec,
+                           uint8_t *out, size_t n) {
+  /* declare a few required variables:
+   * @buf: temporary buffer for shuffled and delta-coded bytes.
+   * @nw: number of coefficients in the chunk.
+   * @i: coefficient or byte loop counter.
+   * @b: byte-within-coefficient loop counter.
+   */
+  size_t i, b, nw;
+  uint8_t *buf;
+
+  /* allocate the temporary buffer. */
+  buf = (uint8_t*) malloc(n);
+  if (!buf)
+    throw("failed to allocate %lu bytes", n);
+
+  /* decompress the bytes, or copy them verbatim. */
+  if (codec & HX_ARRAY_CODEC_LZ) {
+    if (!hx_array_chunk_unlz(in, nin, buf, n)) {
+      free(buf);
+      throw("failed to decompress chunk");
+    }
+  }
+  else if (nin == n) {
+    memcpy(buf, in, n);
+  }
+  else {
+    free(buf);
+    throw("chunk size mismatch (%lu != %lu)", nin, n);
+  }
+
+  /* undo the byte-wise delta coding. */
+  if (codec & HX_ARRAY_CODEC_DELTA) {
+    for (i = 1; i < n; i++)
+      buf[i] += buf[i - 1];
+  }
+
+  /* unshuffle the coefficient bytes. */
+  nw = n / wordsz;
+  if (codec & HX_ARRAY_CODEC_SHUFFLE) {
+    for (i = 0; i < nw; i++)
+      for (b = 0; b < wordsz; b++)
+        out[i * wordsz + b] = buf[b * nw + i];
+  }
+  else
+    memcpy(out, buf, n);
+
+  /* free the temporary buffer and return success. */
+  free(buf);
+  return 1;
+}
+
+/* hx_array_chunk_skip(): move forward over bytes in a file stream. streams
+ * that do not support seeking are read through instead.
+ * @fh: the input file stream.
+ * @n: number of bytes to skip.
+ */
+int hx_array_chunk_skip (FILE *fh, uint64_t n) {
+  /* declare a few required variables:
+   * @buf: scratch buffer for reading through unseekable streams.
+   * @nrd: number of bytes to read in the current pass.
+   */
+  uint8_t buf[4096];
+  size_t nrd;
+
+  /* try to seek over the bytes. */
+  if (n == 0 || fseeko(fh, (off_t) n, SEEK_CUR) == 0)
+    return 1;
+
+  /* read through the bytes. */
+  while (n) {
+    nrd = (n > sizeof(buf) ? sizeof(buf) : (size_t) n);
+    if (fread(buf, 1, nrd, fh) != nrd)
+      throw("failed to skip %lu bytes", n);
+
+    n -= nrd;
+  }
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_fwrite_chunked(): writes a hypercomplex multidimensional array
+ * to an opened file stream in chunked form. the array is broken into a grid
+ * of fixed-size nD chunks that are (optionally) compressed independently
+ * and stored after an index of their offsets, so that any region of the
+ * array may later be read back without decoding the rest of it.
+ * @x: pointer to the source array.
+ * @fh: the output file stream.
+ * @codec: bitwise-or of HX_ARRAY_CODEC_* flags, or zero.
+ */
+int hx_array_fwrite_chunked (hx_array *x, FILE *fh, unsigned int codec) {
+  /* declare a few required variables:
+   * @wd: header words, including the chunk index.
+   * @bufs: encoded chunk data buffers.
+   * @csz: chunk sizes along each dimension.
+   * @nck: chunk counts along each dimension.
+   * @n_wd: number of words in the header.
+   * @nc: total number of chunks.
+   * @ent: first word of the chunk index.
+   * @off: running chunk data offset.
+   * @c: chunk loop counter.
+   * @i: word index in the header.
+   * @k: dimension index.
+   * @ok: whether all chunks were encoded successfully.
+   */
+  uint64_t *wd, *ent, off;
+  hx_index csz, nck;
+  uint8_t **bufs;
+  int c, i, k, nc, n_wd, ok;
+
+  /* arrays without topological dimensions cannot be chunked. */
+  if (x->k < 1)
+    return hx_array_fwrite(x, fh);
+
+  /* allocate the chunk size and count arrays. */
+  csz = hx_index_alloc(x->k);
+  nck = hx_index_alloc(x->k);
+
+  /* check that allocation succeeded. */
+  if (!csz || !nck)
+    throw("failed to allocate %d+%d indices", x->k, x->k);
+
+  /* choose the chunk shape and compute the chunk grid. */
+  hx_array_chunk_size(x, csz);
+  for (k = 0, nc = 1; k < x->k; k++) {
+    nck[k] = (x->sz[k] + csz[k] - 1) / csz[k];
+    nc *= nck[k];
+  }
+
+  /* allocate memory for the header and the chunk buffer pointers. */
+  n_wd = HX_ARRAY_CHUNK_SZ_HDR + 2 * x->k + HX_ARRAY_CHUNK_SZ_ENT * nc;
+  wd = (uint64_t*) calloc(n_wd, sizeof(uint64_t));
+  bufs = (uint8_t**) calloc(nc, sizeof(uint8_t*));
+
+  /* check that allocation succeeded. */
+  if (!wd || !bufs)
+    throw("failed to allocate %d-word header", n_wd);
+
+  /* initialize the word index. */
+  i = 0;
+
+  /* store a magic number into the header: 'HXNDCHNK' */
+  wd[i++] = (uint64_t) HX_ARRAY_MAGIC_CHUNK;
+
+  /* store the array properties into the header. */
+  wd[i++] = (uint64_t) x->d;
+  wd[i++] = (uint64_t) x->n;
+  wd[i++] = (uint64_t) x->k;
+  wd[i++] = (uint64_t) x->len;
+  wd[i++] = (uint64_t) sizeof(real);
+
+  /* store the array and chunk dimension sizes into the header. */
+  for (k = 0; k < x->k; k++)
+    wd[i++] = (uint64_t) x->sz[k];
+
+  for (k = 0; k < x->k; k++)
+    wd[i++] = (uint64_t) csz[k];
+
+  /* locate the chunk index. */
+  ent = wd + i;
+  ok = 1;
+
+  /* encode the chunks in parallel. */
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (c = 0; c < nc; c++) {
+    /* declare a few required variables:
+     * @y: chunk array.
+     * @lower: lower chunk bounds.
+     * @upper: upper chunk bounds.
+     * @nraw: number of bytes in the chunk.
+     * @nenc: number of encoded bytes.
+     */
+    hx_index lower, upper;
+    size_t nraw, nenc;
+    hx_array y;
+
+    /* allocate the bound arrays. */
+    hx_array_init(&y);
+    lower = hx_index_alloc(x->k);
+    upper = hx_index_alloc(x->k);
+
+    /* slice the chunk out of the array. */
+    if (lower && upper) {
+      hx_array_chunk_bounds(x->k, x->sz, csz, nck, c, lower, upper);
+      if (hx_array_slice(x, &y, lower, upper)) {
+        /* allocate the encoded chunk buffer. */
+        nraw = (size_t) y.len * sizeof(real);
+        bufs[c] = (uint8_t*) malloc(HX_ARRAY_CHUNK_BOUND(nraw));
+
+        /* encode the chunk, keeping the encoding only if it is smaller. */
+        nenc = 0;
+        if (bufs[c] && codec)
+          nenc = hx_array_chunk_encode((uint8_t*) y.x, nraw,
+                                       sizeof(real), codec, bufs[c]);
+
+        if (bufs[c] && nenc && nenc < nraw) {
+          ent[HX_ARRAY_CHUNK_SZ_ENT * c + 1] = (uint64_t) nenc;
+          ent[HX_ARRAY_CHUNK_SZ_ENT * c + 2] = (uint64_t) codec;
+        }
+        else if (bufs[c]) {
+          memcpy(bufs[c], y.x, nraw);
+          ent[HX_ARRAY_CHUNK_SZ_ENT * c + 1] = (uint64_t) nraw;
+          ent[HX_ARRAY_CHUNK_SZ_ENT * c + 2] = 0;
+        }
+      }
+    }
+
+    /* check that the chunk was encoded. */
+    if (!bufs[c]) {
+      #pragma omp critical
+      {
+        raise("failed to encode chunk %d", c);
+        ok = 0;
+      }
+    }
+
+    /* free the chunk and its bounds. */
+    hx_array_free(&y);
+    hx_index_free(lower);
+    hx_index_free(upper);
+  }
+
+  /* check that all chunks were encoded. */
+  if (!ok)
+    throw("failed to encode %d chunks", nc);
+
+  /* compute the offset of each chunk from the end of the index. */
+  for (c = 0, off = 0; c < nc; c++) {
+    ent[HX_ARRAY_CHUNK_SZ_ENT * c] = off;
+    off += ent[HX_ARRAY_CHUNK_SZ_ENT * c + 1];
+  }
+
+  /* write the header and chunk index. */
+  if (fwrite(wd, sizeof(uint64_t), n_wd, fh) != n_wd)
+    throw("failed to write %d header words", n_wd);
+
+  /* write the chunk data. */
+  for (c = 0; c < nc; c++) {
+    off = ent[HX_ARRAY_CHUNK_SZ_ENT * c + 1];
+    if (fwrite(bufs[c], 1, off, fh) != off)
+      throw("failed to write chunk %d", c);
+
+    free(bufs[c]);
+  }
+
+  /* free the allocated memory. */
+  hx_index_free(csz);
+  hx_index_free(nck);
+  free(bufs);
+  free(wd);
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_fread_chunked(): reads a chunked hypercomplex multidimensional
+ * array from an opened file stream, after its first header words have been
+ * read by hx_array_fread_region(). only the chunks that overlap the
+ * requested region are read and decoded.
+ * @x: pointer to the destination array.
+ * @fh: the input file stream.
+ * @wd0: the first HX_ARRAY_CHUNK_SZ_HDR header words, in native order.
+ * @swapping: whether the file data must be byte-swapped.
+ * @lower: lower region bounds, or NULL to read the whole array.
+ * @upper: upper region bounds, or NULL to read the whole array.
+ */
+int hx_array_fread_chunked (hx_array *x, FILE *fh, uint64_t *wd0,
+                            unsigned int swapping,
+                            hx_index lower, hx_index upper) {
+  /* declare a few required variables:
+   * @wd: remaining header words, including the chunk index.
+   * @ent: first word of the chunk index.
+   * @pos: current offset into the chunk data.
+   * @nb: number of bytes in the current chunk.
+   * @bufs: encoded chunk data buffers.
+   * @sz: array dimension sizes.
+   * @csz: chunk dimension sizes.
+   * @nck: chunk counts along each dimension.
+   * @lo: lower region bounds.
+   * @hi: upper region bounds.
+   * @szr: region sizes.
+   * @clo: lower chunk bounds.
+   * @chi: upper chunk bounds.
+   * @d: algebraic dimensionality.
+   * @k: topological dimensionality.
+   * @nc: total number of chunks.
+   * @n_wd: number of remaining header words.
+   * @c: chunk loop counter.
+   * @i: dimension loop counter.
+   * @ok: whether all chunks were decoded successfully.
+   */
+  hx_index sz, csz, nck, lo, hi, szr, clo, chi;
+  uint64_t *wd, *ent, pos, nb;
+  int d, k, nc, n_wd, c, i, ok;
+  uint8_t **bufs;
+
+  /* read the array parameters from the header. */
+  d = (int) wd0[1];
+  k = (int) wd0[3];
+
+  /* check that the data type size matches ours. */
+  if (wd0[5] != sizeof(real))
+    throw("word size mismatch (%lu != %lu)", wd0[5], sizeof(real));
+
+  /* check the topological dimensionality. */
+  if (k < 1)
+    throw("invalid topological dimensionality %d", k);
+
+  /* allocate the dimension arrays. */
+  sz = hx_index_alloc(k);
+  csz = hx_index_alloc(k);
+  nck = hx_index_alloc(k);
+  lo = hx_index_alloc(k);
+  hi = hx_index_alloc(k);
+  szr = hx_index_alloc(k);
+  clo = hx_index_alloc(k);
+  chi = hx_index_alloc(k);
+
+  /* check that allocation succeeded. */
+  if (!sz || !csz || !nck || !lo || !hi || !szr || !clo || !chi)
+    throw("failed to allocate %d-element indices", k);
+
+  /* read the array and chunk sizes. */
+  wd = (uint64_t*) calloc(2 * k, sizeof(uint64_t));
+  if (!wd)
+    throw("failed to allocate %d-word header", 2 * k);
+
+  if (fread(wd, sizeof(uint64_t), 2 * k, fh) != 2 * k)
+    throw("failed to read %d header words", 2 * k);
+
+  /* byte-swap, if required. */
+  if (swapping)
+    bytes_swap((uint8_t*) wd, 2 * k, sizeof(uint64_t));
+
+  /* unpack the sizes and compute the chunk grid. */
+  for (i = 0, nc = 1; i < k; i++) {
+    sz[i] = (int) wd[i];
+    csz[i] = (int) wd[k + i];
+    if (sz[i] < 1 || csz[i] < 1)
+      throw("invalid chunk geometry %d/%d (#%d)", csz[i], sz[i], i);
+
+    nck[i] = (sz[i] + csz[i] - 1) / csz[i];
+    nc *= nck[i];
+  }
+
+  /* read the chunk index. */
+  n_wd = HX_ARRAY_CHUNK_SZ_ENT * nc;
+  wd = (uint64_t*) realloc(wd, n_wd * sizeof(uint64_t));
+  bufs = (uint8_t**) calloc(nc, sizeof(uint8_t*));
+  if (!wd || !bufs)
+    throw("failed to allocate %d-entry chunk index", nc);
+
+  if (fread(wd, sizeof(uint64_t), n_wd, fh) != n_wd)
+    throw("failed to read %d-entry chunk index", nc);
+
+  /* byte-swap, if required. */
+  if (swapping)
+    bytes_swap((uint8_t*) wd, n_wd, sizeof(uint64_t));
+
+  /* determine the region to read. */
+  for (i = 0; i < k; i++) {
+    lo[i] = (lower ? lower[i] : 0);
+    hi[i] = (upper ? upper[i] : sz[i] - 1);
+    szr[i] = hi[i] - lo[i] + 1;
+  }
+
+  /* check the region bounds. */
+  if (!hx_array_chunk_region(k, sz, lo, hi))
+    throw("invalid region");
+
+  /* allocate the destination array. */
+  if (!hx_array_alloc(x, d, k, szr))
+    throw("failed to allocate destination array");
+
+  /* read the data of all chunks that overlap the region. */
+  ent = wd;
+  for (c = 0, pos = 0; c < nc; c++) {
+    /* skip chunks that do not overlap the region. */
+    hx_array_chunk_bounds(k, sz, csz, nck, c, clo, chi);
+    for (i = 0; i < k; i++) {
+      if (clo[i] > hi[i] || chi[i] < lo[i])
+        break;
+    }
+
+    if (i < k)
+      continue;
+
+    /* move to the chunk data. */
+    if (ent[HX_ARRAY_CHUNK_SZ_ENT * c] < pos ||
+        !hx_array_chunk_skip(fh, ent[HX_ARRAY_CHUNK_SZ_ENT * c] - pos))
+      throw("failed to locate chunk %d", c);
+
+    /* read the chunk data. */
+    nb = ent[HX_ARRAY_CHUNK_SZ_ENT * c + 1];
+    bufs[c] = (uint8_t*) malloc(nb ? nb : 1);
+    if (!bufs[c])
+      throw("failed to allocate %lu bytes", nb);
+
+    if (fread(bufs[c], 1, nb, fh) != nb)
+      throw("failed to read chunk %d", c);
+
+    /* store the new data offset. */
+    pos = ent[HX_ARRAY_CHUNK_SZ_ENT * c] + nb;
+  }
+
+  /* move past the end of the chunk data. */
+  c = nc - 1;
+  if (!hx_array_chunk_skip(fh, ent[HX_ARRAY_CHUNK_SZ_ENT * c] +
+                               ent[HX_ARRAY_CHUNK_SZ_ENT * c + 1] - pos))
+    throw("failed to skip chunk data");
+
+  /* decode the chunks in parallel. */
+  ok = 1;
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (c = 0; c < nc; c++) {
+    /* declare a few required variables:
+     * @y: decoded chunk array.
+     * @z: sliced portion of the chunk array.
+     * @blo: lower chunk bounds.
+     * @bhi: upper chunk bounds.
+     * @slo: lower bounds within the chunk.
+     * @shi: upper bounds within the chunk.
+     * @ilo: lower intersection bound.
+     * @ihi: upper intersection bound.
+     * @j: dimension loop counter.
+     * @part: whether the chunk only partially overlaps the region.
+     * @good: whether the chunk was decoded successfully.
+     */
+    hx_index blo, bhi, slo, shi;
+    int j, ilo, ihi, part, good;
+    hx_array y, z;
+
+    /* skip chunks that were not read. */
+    if (bufs[c]) {
+      /* allocate the bound arrays. */
+      hx_array_init(&y);
+      hx_array_init(&z);
+      blo = hx_index_alloc(k);
+      bhi = hx_index_alloc(k);
+      slo = hx_index_alloc(k);
+      shi = hx_index_alloc(k);
+      good = (blo && bhi && slo && shi);
+
+      /* compute the chunk bounds and the size of the chunk array. */
+      if (good) {
+        hx_array_chunk_bounds(k, sz, csz, nck, c, blo, bhi);
+        for (j = 0; j < k; j++)
+          shi[j] = bhi[j] - blo[j] + 1;
+
+        good = hx_array_alloc(&y, d, k, shi);
+      }
+
+      /* decode the chunk coefficients. */
+      if (good)
+        good = hx_array_chunk_decode(bufs[c],
+                 ent[HX_ARRAY_CHUNK_SZ_ENT * c + 1], sizeof(real),
+                 ent[HX_ARRAY_CHUNK_SZ_ENT * c + 2], (uint8_t*) y.x,
+                 (size_t) y.len * sizeof(real));
+
+      /* byte-swap, if required. */
+      if (good && swapping)
+        bytes_swap((uint8_t*) y.x, y.len, sizeof(real));
+
+      /* compute the bounds of the intersection of the chunk and the
+       * region, relative to both the chunk and the destination array.
+       */
+      if (good) {
+        for (j = 0, part = 0; j < k; j++) {
+          ilo = (blo[j] > lo[j] ? blo[j] : lo[j]);
+          ihi = (bhi[j] < hi[j] ? bhi[j] : hi[j]);
+          part = (part || ilo != blo[j] || ihi != bhi[j]);
+
+          slo[j] = ilo - blo[j];
+          shi[j] = ihi - blo[j];
+          blo[j] = ilo - lo[j];
+          bhi[j] = ihi - lo[j];
+        }
+      }
+
+      /* store the intersection into the destination array, slicing it
+       * out of the chunk first if the chunk is only partly covered.
+       */
+      if (good && part)
+        good = (hx_array_slice(&y, &z, slo, shi) &&
+                hx_array_store(x, &z, blo, bhi));
+      else if (good)
+        good = hx_array_store(x, &y, blo, bhi);
+
+      /* check that the chunk was decoded. */
+      if (!good) {
+        #pragma omp critical
+        {
+          raise("failed to decode chunk %d", c);
+          ok = 0;
+        }
+      }
+
+      /* free the chunk arrays, bounds and data. */
+      hx_array_free(&y);
+      hx_array_free(&z);
+      hx_index_free(blo);
+      hx_index_free(bhi);
+      hx_index_free(slo);
+      hx_index_free(shi);
+      free(bufs[c]);
+    }
+  }
+
+  /* check that all chunks were decoded. */
+  if (!ok)
+    throw("failed to decode chunked array");
+
+  /* free the allocated memory. */
+  hx_index_free(sz);
+  hx_index_free(csz);
+  hx_index_free(nck);
+  hx_index_free(lo);
+  hx_index_free(hi);
+  hx_index_free(szr);
+  hx_index_free(clo);
+  hx_index_free(chi);
+  free(bufs);
+  free(wd);
+
+  /* return success. */
+  return 1;
+}
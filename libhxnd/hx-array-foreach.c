@@ -24,7 +24,9 @@
 #include <hxnd/hx.h>
 
 /* hx_array_foreach_vector(): perform an operation on each vector of a
- * hypercomplex array using a standardized callback-based scheme.
+ * hypercomplex array using a standardized callback-based scheme. vectors
+ * are sliced from the array in bricks of adjacent vectors, so the callback
+ * function must not reallocate its vector argument.
  * @x: pointer to the array to manipulate.
  * @k: topological dimension (mode) of the vectors.
  * @fn: per-vector callback function pointer.
@@ -33,68 +35,108 @@ int hx_array_foreach_vector (hx_array *x, int k,
                              hx_array_foreach_cb fn, ...) {
   /* declare a few required variables:
    * @idx: the index array for the current position in @x.
+   * @idxv: the index arrays for each vector in the current brick.
    * @pidx: the packed linear index for the current position in @x.
-   * @y: hypercomplex array holding the currently sliced vector values.
+   * @pidx0: the packed linear index of the first vector in the brick.
+   * @sz: the sizes of the brick array.
+   * @stride: the stride of the dimension under operation.
+   * @v: the vector index within the current brick.
+   * @nv: the number of vectors in the current brick.
+   * @more: whether more vectors remain in the array.
+   * @y: hypercomplex array holding the currently sliced brick values.
+   * @yv: hypercomplex array referencing each vector of the brick.
    * @vl: the variable argument list passed to each callback invocation.
    */
-  int pidx, szk, slice;
-  hx_index idx;
-  hx_array y;
+  int pidx, pidx0, sz[2], stride, v, nv, more, slice;
+  hx_index idx, idxv;
+  hx_array y, yv;
   va_list vl;
 
   /* check that the dimension index is in bounds. */
   if (k < 0 || k >= x->k)
     throw("dimension index %d is out of bounds [0,%d)", k, x->k);
 
-  /* retrieve the size of the dimension under operation. */
-  szk = x->sz[k];
+  /* retrieve the size of the dimension under operation. vectors along
+   * the first dimension are only adjacent when it holds a single point,
+   * so bricks along it hold one vector.
+   */
+  sz[0] = x->sz[k];
+  sz[1] = (k > 0 ? HX_ARRAY_BRICK_SZ : 1);
+
+  /* compute the stride of the dimension under operation. bricks may not
+   * span multiple runs of vectors between strides, which are adjacent
+   * whenever the dimension holds a single point.
+   */
+  for (v = 0, stride = 1; v < k; v++)
+    stride *= x->sz[v];
 
-  /* allocate an index array. */
+  /* allocate the index arrays. */
   idx = hx_index_alloc(x->k);
+  idxv = hx_index_alloc(x->k * HX_ARRAY_BRICK_SZ);
 
   /* check that allocation was successful. */
-  if (!idx)
-    throw("failed to allocate %d indices", x->k);
+  if (!idx || !idxv)
+    throw("failed to allocate %d indices", x->k * (HX_ARRAY_BRICK_SZ + 1));
 
-  /* allocate a temporary array to store each sliced vector. */
-  if (!hx_array_alloc(&y, x->d, 1, &szk))
-    throw("failed to allocate slice (%d, 1)-array", x->d);
+  /* allocate a temporary array to store each sliced brick. */
+  if (!hx_array_alloc(&y, x->d, 2, sz))
+    throw("failed to allocate brick (%d, 2)-array", x->d);
 
   /* initialize the linear indices. */
   pidx = slice = 0;
+  more = 1;
 
   /* iterate over the elements of the array. */
-  do {
-    /* pack the index array into a linear index. */
-    hx_index_pack(x->k, x->sz, idx, &pidx);
-
-    /* slice the currently indexed vector from the array. */
-    if (!hx_array_slice_vector(x, &y, k, pidx))
-      throw("failed to slice vector %d", slice);
-
-    /* initialize the variable arguments list. */
-    va_start(vl, fn);
-
-    /* execute the callback function. */
-    if (!fn(x, &y, idx, pidx, &vl))
-      throw("failed to execute callback %d", slice);
-
-    /* free the variable arguments list. */
-    va_end(vl);
-
-    /* store the modified sliced vector back into the array. */
-    if (!hx_array_store_vector(x, &y, k, pidx))
-      throw("failed to store vector %d", slice);
-
-    /* increment the slice index. */
-    slice++;
-  } while (hx_index_skip(x->k, x->sz, idx, k));
+  while (more) {
+    /* pack the index array into the linear index of the brick origin. */
+    hx_index_pack(x->k, x->sz, idx, &pidx0);
+
+    /* gather vectors into the brick while they remain adjacent, fit
+     * within the allocated brick and lie within the current stride.
+     */
+    nv = 0;
+    do {
+      /* store the index array of the current vector. */
+      memcpy(idxv + x->k * nv, idx, x->k * sizeof(int));
+      nv++;
+
+      /* move to the next vector and compute its linear index. */
+      more = hx_index_skip(x->k, x->sz, idx, k);
+      hx_index_pack(x->k, x->sz, idx, &pidx);
+    } while (more && nv < sz[1] && pidx == pidx0 + nv &&
+             pidx % stride != 0);
+
+    /* slice the currently indexed brick from the array. */
+    if (!hx_array_slice_brick(x, &y, k, pidx0, nv))
+      throw("failed to slice brick at vector %d", slice);
+
+    /* loop over the vectors of the brick. */
+    for (v = 0; v < nv; v++, slice++) {
+      /* reference the current vector of the brick. */
+      hx_array_brick_vector(&y, v, &yv);
+
+      /* initialize the variable arguments list. */
+      va_start(vl, fn);
+
+      /* execute the callback function. */
+      if (!fn(x, &yv, idxv + x->k * v, pidx0 + v, &vl))
+        throw("failed to execute callback %d", slice);
+
+      /* free the variable arguments list. */
+      va_end(vl);
+    }
+
+    /* store the modified sliced brick back into the array. */
+    if (!hx_array_store_brick(x, &y, k, pidx0, nv))
+      throw("failed to store brick at vector %d", slice);
+  }
 
   /* free the temporary array. */
   hx_array_free(&y);
 
-  /* free the multidimensional index. */
+  /* free the multidimensional indices. */
   hx_index_free(idx);
+  hx_index_free(idxv);
 
   /* return success. */
   return 1;
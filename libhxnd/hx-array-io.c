@@ -114,12 +114,12 @@ int hx_array_check_magic (const char *fname) {
   fclose(fh);
 
   /* check the magic word, without swapping. */
-  if (wd == HX_ARRAY_MAGIC)
+  if (wd == HX_ARRAY_MAGIC || wd == HX_ARRAY_MAGIC_CHUNK)
     return 1;
 
   /* swap the word and check again. */
   bytes_swap_u64(&wd);
-  if (wd == HX_ARRAY_MAGIC)
+  if (wd == HX_ARRAY_MAGIC || wd == HX_ARRAY_MAGIC_CHUNK)
     return 1;
 
   /* no match. */
@@ -188,14 +188,33 @@ int hx_array_fwrite (hx_array *x, FILE *fh) {
  * @fh: the input file stream.
  */
 int hx_array_fread (hx_array *x, FILE *fh) {
+  /* read the entire array. */
+  return hx_array_fread_region(x, fh, NULL, NULL);
+}
+
+/* hx_array_fread_region(): reads a region of a hypercomplex multidimensional
+ * array from an opened file stream, with hx_array_slice() semantics. when
+ * the stream holds a chunked array, only the chunks that overlap the region
+ * are decoded. otherwise, when the stream is a regular file holding data in
+ * native byte order, the coefficients are mapped copy-on-write from the
+ * file instead of being read (see hx_array_map()).
+ * @x: pointer to the destination array.
+ * @fh: the input file stream.
+ * @lower: lower region bounds, or NULL to read the whole array.
+ * @upper: upper region bounds, or NULL to read the whole array.
+ */
+int hx_array_fread_region (hx_array *x, FILE *fh,
+                           hx_index lower, hx_index upper) {
   /* declare a few required variables:
    * @wd: header that contains all array properties.
    * @i: word index in the header.
    * @k: dimension index.
+   * @y: region sliced from the whole array.
    */
   unsigned int swapping;
   uint64_t *wd1, wd0[HX_ARRAY_FWRITE_SZ_HDR];
   int i, k, n_read;
+  hx_array y;
 
   /* read the first six words from the file. */
   n_read = fread(wd0, sizeof(uint64_t), HX_ARRAY_FWRITE_SZ_HDR, fh);
@@ -205,12 +224,12 @@ int hx_array_fread (hx_array *x, FILE *fh) {
   /* check the first word in the header. if it does not match, then
    * byte-swap the data.
    */
-  if (wd0[0] != HX_ARRAY_MAGIC) {
+  if (wd0[0] != HX_ARRAY_MAGIC && wd0[0] != HX_ARRAY_MAGIC_CHUNK) {
     /* no match. swap the bytes of each word. */
     bytes_swap((uint8_t*) wd0, HX_ARRAY_FWRITE_SZ_HDR, sizeof(uint64_t));
 
     /* now check the magic word. */
-    if (wd0[0] != HX_ARRAY_MAGIC)
+    if (wd0[0] != HX_ARRAY_MAGIC && wd0[0] != HX_ARRAY_MAGIC_CHUNK)
       throw("invalid magic number 0x%016lx", wd0[0]);
 
     /* set the swapping flag. */
@@ -221,6 +240,16 @@ int hx_array_fread (hx_array *x, FILE *fh) {
     swapping = 0;
   }
 
+  /* chunked arrays are read using their own routine. */
+  if (wd0[0] == HX_ARRAY_MAGIC_CHUNK) {
+    /* read the overlapping chunks of the array. */
+    if (!hx_array_fread_chunked(x, fh, wd0, swapping, lower, upper))
+      throw("failed to read chunked array");
+
+    /* return success. */
+    return 1;
+  }
+
   /* initialize the word index. */
   i = 1;
 
@@ -261,20 +290,33 @@ int hx_array_fread (hx_array *x, FILE *fh) {
   for (k = 0, i = 0; k < x->k; k++)
     x->sz[k] = wd1[i++];
 
-  /* allocate memory for the array data. */
-  x->x = (real*) calloc(x->len, sizeof(real));
+  /* check the region bounds before reading any array data. */
+  if (lower && upper && !hx_array_chunk_region(x->k, x->sz, lower, upper))
+    throw("invalid region");
 
-  /* ensure the allocation was successful. */
-  if (!x->x)
-    throw("failed to allocate %d reals", x->len);
+  /* indicate that the coefficients are not (yet) mapped. */
+  x->map = NULL;
+  x->nmap = 0;
 
-  /* read the array data from the file. */
-  if (fread(x->x, sizeof(real), x->len, fh) != x->len)
-    throw("failed to read %d reals", x->len);
+  /* native-order array data is mapped directly from the file, if possible.
+   * otherwise, it is read into the heap.
+   */
+  if (swapping || !hx_array_map(x, fh)) {
+    /* allocate memory for the array data. */
+    x->x = (real*) calloc(x->len, sizeof(real));
 
-  /* byte-swap, if required. */
-  if (swapping)
-    bytes_swap((uint8_t*) x->x, x->len, sizeof(real));
+    /* ensure the allocation was successful. */
+    if (!x->x)
+      throw("failed to allocate %d reals", x->len);
+
+    /* read the array data from the file. */
+    if (fread(x->x, sizeof(real), x->len, fh) != x->len)
+      throw("failed to read %d reals", x->len);
+
+    /* byte-swap, if required. */
+    if (swapping)
+      bytes_swap((uint8_t*) x->x, x->len, sizeof(real));
+  }
 
   /* ensure that the d-dimensional shared multiplication table has been
    * initialized, and return failure if not.
@@ -285,6 +327,19 @@ int hx_array_fread (hx_array *x, FILE *fh) {
   /* free the header array. */
   free(wd1);
 
+  /* slice the region out of the array, if requested. */
+  if (lower && upper) {
+    /* slice the region into a local array. */
+    hx_array_init(&y);
+    if (!hx_array_slice(x, &y, lower, upper))
+      throw("failed to slice array region");
+
+    /* replace the array with the local array. */
+    hx_array_free(x);
+    hx_array_copy(x, &y);
+    hx_array_free(&y);
+  }
+
   /* and return success. */
   return 1;
 }
@@ -20,9 +20,18 @@
  *   Boston, MA  02110-1301, USA.
  */
 
+/* request posix extensions for memory-mapped file access. */
+#define _POSIX_C_SOURCE 200809L
+
 /* include the n-dimensional math header. */
 #include <hxnd/hx.h>
 
+/* include the posix memory-mapping and file status headers. */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 /* hx_array_init(): initialize the elements of a hypercomplex array.
  * @x: pointer to the array structure to initialize.
  */
@@ -39,6 +48,10 @@ void hx_array_init (hx_array *x) {
   /* initialize the coefficient array. */
   x->x = NULL;
 
+  /* initialize the mapping information. */
+  x->map = NULL;
+  x->nmap = 0;
+
   /* initialize the table pointer. */
   x->tbl = NULL;
 }
@@ -91,6 +104,10 @@ int hx_array_alloc (hx_array *x, int d, int k, hx_index sz) {
   if (x->x == NULL)
     throw("failed to allocate coefficient array");
 
+  /* indicate that the coefficients are not mapped. */
+  x->map = NULL;
+  x->nmap = 0;
+
   /* store the array total coefficient count. */
   x->len = len;
 
@@ -155,8 +172,10 @@ void hx_array_free (hx_array *x) {
   if (x == NULL)
     return;
 
-  /* free the coefficient array. */
-  if (x->x)
+  /* free or unmap the coefficient array. */
+  if (x->map)
+    munmap(x->map, x->nmap);
+  else if (x->x)
     free(x->x);
 
   /* free the size array. */
@@ -166,3 +185,100 @@ void hx_array_free (hx_array *x) {
   hx_array_init(x);
 }
 
+
+/* hx_array_map(): point the coefficients of an array directly into a
+ * private, copy-on-write mapping of the native-order coefficients found
+ * at the current position of an input file stream. the array properties
+ * (d, n, k, sz, len) must already be set. on success, the stream is left
+ * positioned just after the coefficients. zero is returned without raising
+ * an error when the stream cannot be mapped (e.g. pipes), so callers may
+ * fall back to reading the coefficients.
+ *
+ * NOTE: the mapped file must not be truncated while the array is alive,
+ * so arrays must be unmapped before overwriting their source file.
+ *
+ * @x: pointer to the destination array.
+ * @fh: the input file stream.
+ */
+int hx_array_map (hx_array *x, FILE *fh) {
+  /* declare a few required variables:
+   * @st: file status structure.
+   * @pos: byte offset of the coefficients in the file.
+   * @skew: distance of @pos from the previous page boundary.
+   * @nbytes: number of coefficient bytes.
+   * @map: address of the new mapping.
+   * @fd: input file descriptor.
+   */
+  struct stat st;
+  off_t pos, skew;
+  size_t nbytes;
+  void *map;
+  int fd;
+
+  /* get the file descriptor and the current stream position. */
+  fd = fileno(fh);
+  pos = ftello(fh);
+
+  /* only regular files large enough to hold the coefficients are mapped. */
+  nbytes = (size_t) x->len * sizeof(real);
+  if (fd < 0 || pos < 0 || fstat(fd, &st) || !S_ISREG(st.st_mode) ||
+      st.st_size < pos + (off_t) nbytes || nbytes == 0)
+    return 0;
+
+  /* mappings must begin on a page boundary. */
+  skew = pos % sysconf(_SC_PAGESIZE);
+
+  /* map the coefficients privately, so that writes are copied on demand. */
+  map = mmap(NULL, nbytes + skew, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+             fd, pos - skew);
+
+  /* check that the mapping succeeded. */
+  if (map == MAP_FAILED)
+    return 0;
+
+  /* move the stream past the coefficients. */
+  if (fseeko(fh, pos + (off_t) nbytes, SEEK_SET)) {
+    munmap(map, nbytes + skew);
+    return 0;
+  }
+
+  /* store the mapping into the array. */
+  x->map = map;
+  x->nmap = nbytes + skew;
+  x->x = (real*) ((uint8_t*) map + skew);
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_unmap(): move the coefficients of a mapped array onto the heap,
+ * releasing the mapping. arrays that are not mapped are left untouched.
+ * @x: pointer to the array to unmap.
+ */
+int hx_array_unmap (hx_array *x) {
+  /* declare a required variable:
+   * @xnew: new heap coefficient array.
+   */
+  real *xnew;
+
+  /* return if the array is not mapped. */
+  if (!x->map)
+    return 1;
+
+  /* allocate the heap coefficient array. */
+  xnew = (real*) malloc(x->len * sizeof(real));
+  if (!xnew)
+    throw("failed to allocate %d reals", x->len);
+
+  /* copy the coefficients and release the mapping. */
+  memcpy(xnew, x->x, x->len * sizeof(real));
+  munmap(x->map, x->nmap);
+
+  /* store the heap coefficients. */
+  x->x = xnew;
+  x->map = NULL;
+  x->nmap = 0;
+
+  /* return success. */
+  return 1;
+}
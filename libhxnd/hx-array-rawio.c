@@ -20,18 +20,132 @@
  *   Boston, MA  02110-1301, USA.
  */
 
+/* request posix extensions for memory-mapped file access. */
+#define _POSIX_C_SOURCE 200809L
+
 /* include the n-dimensional math header. */
 #include <hxnd/hx.h>
 
 /* include the byte-level data header. */
 #include <hxnd/bytes.h>
 
+/* include the posix memory-mapping and file status headers. */
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
 /* define the size of the data buffer for raw file reading, in bytes.
  */
 #define HX_ARRAY_FREAD_SZ_BUF  33554432
 
+/* define the number of words per independently converted chunk of raw
+ * file data. chunks are the unit of work shared between threads.
+ */
+#define HX_ARRAY_FREAD_SZ_CHUNK  262144
+
+/* hx_array_decode_raw(): convert a run of raw data words into real array
+ * coefficients. the word format is resolved once per run, and each common
+ * format is handled by a dedicated loop that the compiler may vectorize.
+ * @buf: input array of raw bytes.
+ * @x: output array of real coefficients.
+ * @n: number of words to convert.
+ * @endian: raw word byte ordering.
+ * @wordsz: number of bytes per word.
+ * @isflt: whether the words are floats.
+ */
+void hx_array_decode_raw (const uint8_t *buf, real *x, size_t n,
+                          enum byteorder endian, unsigned int wordsz,
+                          unsigned int isflt) {
+  /* declare a few required variables:
+   * @i: word loop counter.
+   * @swap: whether byte swaps are required.
+   * @u32, @u64: raw unsigned words.
+   * @i32: signed 32-bit word.
+   * @f32, @f64: floating-point words.
+   * @w: scratch copy of a single word for generic conversion.
+   */
+  size_t i;
+  int swap;
+  uint32_t u32;
+  uint64_t u64;
+  int32_t i32;
+  float f32;
+  double f64;
+  uint8_t w[8];
+
+  /* determine whether byte swaps are required. */
+  swap = (!bytes_native(endian) && wordsz > 1);
+
+  /* convert 32-bit floats. */
+  if (isflt && wordsz == sizeof(float)) {
+    if (swap) {
+      for (i = 0; i < n; i++) {
+        memcpy(&u32, buf + i * sizeof(float), sizeof(float));
+        u32 = BYTES_BSWAP32(u32);
+        memcpy(&f32, &u32, sizeof(float));
+        x[i] = (real) f32;
+      }
+    }
+    else {
+      for (i = 0; i < n; i++) {
+        memcpy(&f32, buf + i * sizeof(float), sizeof(float));
+        x[i] = (real) f32;
+      }
+    }
+  }
+  else if (isflt && wordsz == sizeof(double)) {
+    /* convert 64-bit floats. */
+    if (swap) {
+      for (i = 0; i < n; i++) {
+        memcpy(&u64, buf + i * sizeof(double), sizeof(double));
+        u64 = BYTES_BSWAP64(u64);
+        memcpy(&f64, &u64, sizeof(double));
+        x[i] = (real) f64;
+      }
+    }
+    else {
+      for (i = 0; i < n; i++) {
+        memcpy(&f64, buf + i * sizeof(double), sizeof(double));
+        x[i] = (real) f64;
+      }
+    }
+  }
+  else if (!isflt && wordsz == sizeof(int32_t)) {
+    /* convert 32-bit signed integers. */
+    if (swap) {
+      for (i = 0; i < n; i++) {
+        memcpy(&u32, buf + i * sizeof(int32_t), sizeof(int32_t));
+        u32 = BYTES_BSWAP32(u32);
+        memcpy(&i32, &u32, sizeof(int32_t));
+        x[i] = (real) i32;
+      }
+    }
+    else {
+      for (i = 0; i < n; i++) {
+        memcpy(&i32, buf + i * sizeof(int32_t), sizeof(int32_t));
+        x[i] = (real) i32;
+      }
+    }
+  }
+  else if (wordsz <= sizeof(w)) {
+    /* convert all other formats one word at a time. */
+    for (i = 0; i < n; i++) {
+      /* copy and byte-swap the current word. */
+      memcpy(w, buf + i * wordsz, wordsz);
+      if (swap)
+        bytes_swap(w, 1, wordsz);
+
+      /* unpack the word into a real coefficient. */
+      x[i] = bytes_unpack(w, wordsz, isflt);
+    }
+  }
+}
+
 /* hx_array_fread_raw(): read raw bytes from a file out of a given format
- * and into a linear hypercomplex array.
+ * and into a linear hypercomplex array. when the input file may be mapped
+ * into memory, all blocks are converted in parallel directly from the
+ * mapping. otherwise, blocks are read through a bounded buffer.
  * @fh: input file handle.
  * @x: output array structure pointer.
  * @endian: raw word byte ordering.
@@ -48,138 +162,444 @@ int hx_array_fread_raw (FILE *fh, hx_array *x, enum byteorder endian,
                         unsigned int offhead, unsigned int offblk,
                         unsigned int nblks, unsigned int nwords,
                         unsigned int nalign) {
-  /* declare variables required for buffered reading:
+  /* declare variables required for block addressing:
    * @pos: current file position, in bytes.
-   * @i: main block loop counter.
-   * @n: number of blocks to read.
+   * @end: file position just past the final block, in bytes.
+   * @offs: array of absolute block data offsets, in bytes.
    * @nbytes: number of bytes per block.
-   * @nbuf: number of buffer bytes.
-   * @nask: number to requested bytes.
-   * @nread: number of read bytes.
-   * @nrem: number of bytes remaining.
-   * @ialign: number of alignment offsets.
-   * @buf: array of buffer bytes.
-   */
-  unsigned int pos, i, n, nbytes, nbuf, nask, nread, nrem, ialign;
-  uint8_t *buf;
-
-  /* declare variables required for coefficient allocation and access:
-   * @k: raw buffer byte index for conversion into array words.
-   * @xi: current array coefficient pointer.
+   * @i: main block loop counter.
    * @len: total number of words.
    */
-  unsigned int k;
-  real *xi;
+  size_t pos, end, *offs, nbytes;
+  unsigned int i;
   int len;
 
-  /* compute the number of bytes per block, and the total byte count. */
-  nbytes = nwords * wordsz;
-  nrem = nbytes * nblks;
+  /* declare variables required for chunked conversion:
+   * @c: chunk loop counter.
+   * @nchk: number of chunks per block.
+   * @nchks: total number of chunks.
+   * @fd: input file descriptor.
+   * @st: input file status.
+   * @map: memory-mapped file contents.
+   */
+  int c, nchk, nchks, fd;
+  struct stat st;
+  uint8_t *map;
 
-  /* compute the total number of data words. */
+  /* declare variables required for buffered reading:
+   * @nbuf: number of buffer bytes.
+   * @nask: number of requested bytes.
+   * @buf: array of buffer bytes.
+   */
+  size_t nbuf, nask;
+  uint8_t *buf;
+
+  /* compute the number of bytes per block and the total word count. */
+  nbytes = (size_t) nwords * (size_t) wordsz;
   len = nblks * nwords;
 
-  /* initialize the block count and size. */
-  nbuf = nbytes;
-  n = nblks;
+  /* allocate the array of block offsets. */
+  offs = (size_t*) malloc(nblks * sizeof(size_t));
+  if (!offs)
+    throw("failed to allocate %u block offsets", nblks);
 
-  /* determine whether block alignment is specified. */
-  if (nalign) {
-    /* check for the special case in which the reads may be lumped:
-     * 1. the blocks fall on the alignment boundaries.
-     * 2. no block header exists.
-     * 3. no file header exists.
-     */
-    if (offhead == 0 && offblk == 0 && nbytes % nalign == 0) {
-      /* in this special case, we can increase the buffer size. */
-      nbuf *= n;
-      n = 1;
-    }
-  }
-
-  /* determine whether logical blocking must be done. */
-  if (n == 1 && nbuf > HX_ARRAY_FREAD_SZ_BUF) {
-    /* logical blocking is needed. determine the number of logical blocks:
-     *  - if the buffer is evenly divided by the max size, use that ratio.
-     *  - if not, add one to the ratio, where the last read will be partial.
-     */
-    n = (nbuf % HX_ARRAY_FREAD_SZ_BUF ?
-         nbuf / HX_ARRAY_FREAD_SZ_BUF + 1 :
-         nbuf / HX_ARRAY_FREAD_SZ_BUF);
+  /* compute the absolute file offset of the data in each block. */
+  for (i = 0, pos = offhead; i < nblks; i++) {
+    /* align to the next boundary. */
+    if (nalign && pos % nalign)
+      pos += nalign - pos % nalign;
 
-    /* use the maximum allowed read buffer size. */
-    nbuf = HX_ARRAY_FREAD_SZ_BUF;
+    /* move past the block header, store the offset and skip the data. */
+    pos += offblk;
+    offs[i] = pos;
+    pos += nbytes;
   }
 
-  /* allocate memory for the buffer bytes. */
-  buf = (uint8_t*) calloc(nbuf, sizeof(uint8_t));
-
-  /* check that memory was allocated. */
-  if (!buf)
-    throw("failed to allocate %u buffer bytes", nbytes);
+  /* store the end of the final block. */
+  end = pos;
 
   /* allocate the destination array structure. */
   if (!hx_array_alloc(x, 0, 1, &len))
     throw("failed to allocate %d array coefficients", len);
 
-  /* move past the file header. */
-  if (offhead && fseek(fh, offhead, SEEK_SET))
-    throw("failed to seek %u bytes past file header", offhead);
-
-  /* initialize the file position and the alignment offset. */
-  pos = offhead;
-  ialign = 0;
+  /* compute the number of chunks per block and the total chunk count. */
+  nchk = (nwords + HX_ARRAY_FREAD_SZ_CHUNK - 1) / HX_ARRAY_FREAD_SZ_CHUNK;
+  nchks = nchk * nblks;
+
+  /* attempt to map regular input files into memory. */
+  fd = fileno(fh);
+  map = NULL;
+  if (len && fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    /* check that the file contains every block. */
+    if ((size_t) st.st_size < end)
+      throw("failed to read data block #%u", nblks - 1);
+
+    /* map the file contents. */
+    map = (uint8_t*) mmap(NULL, end, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == (uint8_t*) MAP_FAILED)
+      map = NULL;
+    else
+      posix_madvise(map, end, POSIX_MADV_SEQUENTIAL);
+  }
 
-  /* loop over the data blocks. */
-  for (i = 0, xi = x->x; i < n; i++) {
-    /* check if alignment is required. */
-    if (nalign) {
-      /* align to the next boundary. */
-      ialign = pos / nalign;
-      while (pos % nalign)
-        pos = ++ialign * nalign;
+  /* check if the file was mapped. */
+  if (map) {
+    /* convert the chunks of every block in parallel. */
+    #pragma omp parallel for
+    for (c = 0; c < nchks; c++) {
+      /* declare required thread-local variables:
+       * @ib: block index of the chunk.
+       * @iw: first block word index of the chunk.
+       * @nw: number of words in the chunk.
+       */
+      size_t ib, iw, nw;
+
+      /* locate the chunk within its block. */
+      ib = c / nchk;
+      iw = (size_t) (c % nchk) * HX_ARRAY_FREAD_SZ_CHUNK;
+      nw = nwords - iw;
+      nw = (nw < HX_ARRAY_FREAD_SZ_CHUNK ? nw : HX_ARRAY_FREAD_SZ_CHUNK);
+
+      /* convert the chunk words into the final array. */
+      hx_array_decode_raw(map + offs[ib] + iw * wordsz,
+                          x->x + ib * nwords + iw, nw,
+                          endian, wordsz, isflt);
+    }
 
-      /* move to the new aligned location. */
-      if (fseek(fh, pos, SEEK_SET))
-        throw("failed to seek to %u-byte alignment boundary", nalign);
+    /* unmap the file contents. */
+    munmap(map, end);
+  }
+  else {
+    /* compute the buffer size as a whole number of words. */
+    nbuf = (nbytes < HX_ARRAY_FREAD_SZ_BUF ? nbytes : HX_ARRAY_FREAD_SZ_BUF);
+    nbuf -= nbuf % wordsz;
+
+    /* allocate memory for the buffer bytes. */
+    buf = (uint8_t*) malloc(nbuf ? nbuf : 1);
+
+    /* check that memory was allocated. */
+    if (!buf)
+      throw("failed to allocate %lu buffer bytes", (unsigned long) nbuf);
+
+    /* loop over the data blocks. */
+    for (i = 0; i < nblks; i++) {
+      /* move to the start of the block data. */
+      if (fseek(fh, offs[i], SEEK_SET))
+        throw("failed to seek to data block #%u", i);
+
+      /* read the block through the buffer. */
+      for (pos = 0; pos < nbytes; pos += nask) {
+        /* determine how many bytes to ask for. */
+        nask = (nbytes - pos < nbuf ? nbytes - pos : nbuf);
+
+        /* read the current portion of the data block. */
+        if (fread(buf, sizeof(uint8_t), nask, fh) != nask)
+          throw("failed to read data block #%u", i);
+
+        /* convert the read words into the final array. */
+        hx_array_decode_raw(buf, x->x + (size_t) i * nwords + pos / wordsz,
+                            nask / wordsz, endian, wordsz, isflt);
+      }
     }
 
-    /* move past the block header. */
-    pos += offblk;
-    if (offblk && fseek(fh, offblk, SEEK_CUR))
-      throw("failed to seek %u bytes past block header", offblk);
+    /* free the allocated buffer memory. */
+    free(buf);
+  }
+
+  /* free the array of block offsets. */
+  free(offs);
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_fread_tiled(): read a region of raw tiled data from a file
+ * directly into a real linear array, as from hx_array_fread_raw() followed
+ * by hx_array_tiler() and hx_array_slice(). only the tiles that overlap the
+ * region are read, and each one is scattered into its final position as
+ * soon as it is decoded.
+ * @fh: input file handle.
+ * @x: destination array structure pointer.
+ * @endian: raw word byte ordering.
+ * @wordsz: number of bytes per word.
+ * @isflt: whether the words are floats.
+ * @offhead: file header offset in bytes.
+ * @k: number of tile topological dimensions.
+ * @nt: array of tile counts.
+ * @szt: array of tile sizes.
+ * @incr: tile ordering, either HX_ARRAY_INCR_NORMAL or _REVERSE.
+ * @lower: lower region bounds, or NULL to read every tile.
+ * @upper: upper region bounds, or NULL to read every tile.
+ */
+int hx_array_fread_tiled (FILE *fh, hx_array *x, enum byteorder endian,
+                          unsigned int wordsz, unsigned int isflt,
+                          unsigned int offhead, int k,
+                          hx_index nt, hx_index szt, int incr,
+                          hx_index lower, hx_index upper) {
+  /* declare variables required for region addressing:
+   * @sz: full array sizes.
+   * @lo: lower region bounds.
+   * @hi: upper region bounds.
+   * @szr: region sizes.
+   * @tlo: index of the first tile overlapping the region.
+   * @ntr: number of tiles overlapping the region.
+   * @sin: in-tile point strides.
+   * @sout: output array strides.
+   * @stf: file tile strides.
+   */
+  hx_index sz, lo, hi, szr, tlo, ntr, sin, sout, stf;
+
+  /* declare variables required for tile reading:
+   * @ntw: number of words per tile.
+   * @nbytes: number of bytes per tile.
+   * @i: dimension loop counter.
+   * @t: tile loop counter.
+   * @ntiles: number of tiles overlapping the region.
+   * @fd: input file descriptor.
+   * @ok: whether every tile was read.
+   */
+  size_t ntw, nbytes;
+  int i, t, ntiles, fd, ok;
+
+  /* allocate the index arrays. */
+  sz = hx_index_alloc(k);
+  lo = hx_index_alloc(k);
+  hi = hx_index_alloc(k);
+  szr = hx_index_alloc(k);
+  tlo = hx_index_alloc(k);
+  ntr = hx_index_alloc(k);
+  sin = hx_index_alloc(k);
+  sout = hx_index_alloc(k);
+  stf = hx_index_alloc(k);
+
+  /* check that allocation succeeded. */
+  if (!sz || !lo || !hi || !szr || !tlo || !ntr || !sin || !sout || !stf)
+    throw("failed to allocate %d-element indices", k);
+
+  /* determine the region to read. */
+  for (i = 0; i < k; i++) {
+    sz[i] = nt[i] * szt[i];
+    lo[i] = (lower ? lower[i] : 0);
+    hi[i] = (upper ? upper[i] : sz[i] - 1);
+  }
 
-    /* determine how many bytes to ask for. */
-    nask = (nrem > nbuf ? nbuf : nrem);
+  /* check the region bounds. */
+  if (!hx_array_chunk_region(k, sz, lo, hi))
+    throw("invalid region");
+
+  /* compute the region sizes and the range of overlapping tiles. */
+  for (i = 0, ntiles = 1, ntw = 1; i < k; i++) {
+    szr[i] = hi[i] - lo[i] + 1;
+    tlo[i] = lo[i] / szt[i];
+    ntr[i] = hi[i] / szt[i] - tlo[i] + 1;
+    ntiles *= ntr[i];
+    ntw *= (size_t) szt[i];
+  }
 
-    /* read the current data block. */
-    nread = fread(buf, sizeof(uint8_t), nask, fh);
+  /* compute the output strides, which always run first-dimension fastest,
+   * and the in-tile and tile strides, which follow the file ordering.
+   */
+  for (i = 0; i < k; i++) {
+    sout[i] = (i ? sout[i - 1] * szr[i - 1] : 1);
+    if (incr == HX_ARRAY_INCR_REVERSE) {
+      sin[k - i - 1] = (i ? sin[k - i] * szt[k - i] : 1);
+      stf[k - i - 1] = (i ? stf[k - i] * nt[k - i] : 1);
+    }
+    else {
+      sin[i] = (i ? sin[i - 1] * szt[i - 1] : 1);
+      stf[i] = (i ? stf[i - 1] * nt[i - 1] : 1);
+    }
+  }
 
-    /* check that the read succeeded. */
-    if (nread != nask)
-      throw("failed to read data block #%u", i);
+  /* allocate the destination array structure. */
+  if (!hx_array_alloc(x, 0, k, szr))
+    throw("failed to allocate destination array");
+
+  /* get the input file descriptor. */
+  nbytes = ntw * wordsz;
+  fd = fileno(fh);
+  if (fd < 0)
+    throw("invalid input file descriptor");
+
+  /* read and scatter the overlapping tiles in parallel. */
+  ok = 1;
+  #pragma omp parallel for schedule(dynamic, 1) reduction(&&:ok)
+  for (t = 0; t < ntiles; t++) {
+    /* declare required thread-local variables:
+     * @it: tile index.
+     * @ip: point index within the tile.
+     * @a: lower in-tile bounds of the region.
+     * @b: upper in-tile bounds of the region.
+     * @buf: raw tile bytes.
+     * @w: decoded tile words.
+     * @off: file offset of the tile.
+     * @pin: in-tile linear index.
+     * @pout: output linear index.
+     * @j: dimension loop counter.
+     */
+    hx_index it, ip, a, b;
+    size_t off, pin, pout;
+    uint8_t *buf;
+    real *w;
+    int j;
+
+    /* allocate the thread-local indices and buffers. */
+    it = hx_index_alloc(k);
+    ip = hx_index_alloc(k);
+    a = hx_index_alloc(k);
+    b = hx_index_alloc(k);
+    buf = (uint8_t*) malloc(nbytes);
+    w = (real*) malloc(ntw * sizeof(real));
+
+    /* check that allocation succeeded. */
+    if (it && ip && a && b && buf && w) {
+      /* locate the tile in the file. */
+      hx_index_unpack(k, ntr, it, t);
+      for (j = 0, off = 0; j < k; j++) {
+        it[j] += tlo[j];
+        off += (size_t) it[j] * (size_t) stf[j];
+      }
+
+      /* read and decode the tile words. */
+      off = (size_t) offhead + off * nbytes;
+      if (pread(fd, buf, nbytes, (off_t) off) == (ssize_t) nbytes) {
+        hx_array_decode_raw(buf, w, ntw, endian, wordsz, isflt);
+
+        /* compute the bounds of the region within the tile. */
+        for (j = 0; j < k; j++) {
+          a[j] = lo[j] - it[j] * szt[j];
+          b[j] = hi[j] - it[j] * szt[j];
+          a[j] = (a[j] > 0 ? a[j] : 0);
+          b[j] = (b[j] < szt[j] - 1 ? b[j] : szt[j] - 1);
+          ip[j] = a[j];
+        }
+
+        /* scatter the region points, one first-dimension run at a time. */
+        do {
+          /* locate the start of the run. */
+          for (j = 0, pin = pout = 0; j < k; j++) {
+            pin += (size_t) ip[j] * (size_t) sin[j];
+            pout += (size_t) (it[j] * szt[j] + ip[j] - lo[j]) *
+                    (size_t) sout[j];
+          }
+
+          /* copy the run. */
+          for (j = a[0]; j <= b[0]; j++, pin += sin[0], pout++)
+            x->x[pout] = w[pin];
+        } while (hx_index_incr_bounded(k - 1, a + 1, b + 1, ip + 1));
+      }
+      else
+        ok = 0;
+    }
+    else
+      ok = 0;
+
+    /* free the thread-local indices and buffers. */
+    hx_index_free(it);
+    hx_index_free(ip);
+    hx_index_free(a);
+    hx_index_free(b);
+    free(buf);
+    free(w);
+  }
 
-    /* subtract the read bytes from the bytes remaining. */
-    nrem -= nread;
+  /* check that every tile was read. */
+  if (!ok)
+    throw("failed to read %d tiles", ntiles);
+
+  /* free the allocated index arrays. */
+  hx_index_free(sz);
+  hx_index_free(lo);
+  hx_index_free(hi);
+  hx_index_free(szr);
+  hx_index_free(tlo);
+  hx_index_free(ntr);
+  hx_index_free(sin);
+  hx_index_free(sout);
+  hx_index_free(stf);
 
-    /* check if byte swaps are required. */
-    if (!bytes_native(endian) && wordsz > 1)
-      bytes_swap(buf, nbuf / wordsz, wordsz);
+  /* return success. */
+  return 1;
+}
 
-    /* copy the read words into the final array. */
-    for (k = 0; k < nread; k += wordsz)
-      *(xi++) = bytes_unpack(buf + k, wordsz, isflt);
+/* hx_array_encode_raw(): convert a run of real array coefficients into raw
+ * data words. this is the reverse of hx_array_decode_raw().
+ * @x: input array of real coefficients.
+ * @buf: output array of raw bytes.
+ * @n: number of words to convert.
+ * @endian: raw word byte ordering.
+ * @wordsz: number of bytes per word.
+ * @isflt: whether the words are floats.
+ */
+int hx_array_encode_raw (const real *x, uint8_t *buf, size_t n,
+                         enum byteorder endian, unsigned int wordsz,
+                         unsigned int isflt) {
+  /* declare a few required variables:
+   * @i: word loop counter.
+   * @swap: whether byte swaps are required.
+   * @u32, @u64: raw unsigned words.
+   * @i32: signed 32-bit word.
+   * @f32, @f64: floating-point words.
+   */
+  size_t i;
+  int swap;
+  uint32_t u32;
+  uint64_t u64;
+  int32_t i32;
+  float f32;
+  double f64;
+
+  /* determine whether byte swaps are required. */
+  swap = (!bytes_native(endian) && wordsz > 1);
+
+  /* convert 32-bit floats. */
+  if (isflt && wordsz == sizeof(float)) {
+    for (i = 0; i < n; i++) {
+      f32 = (float) x[i];
+      memcpy(&u32, &f32, sizeof(float));
+      u32 = (swap ? BYTES_BSWAP32(u32) : u32);
+      memcpy(buf + i * sizeof(float), &u32, sizeof(float));
+    }
   }
+  else if (isflt && wordsz == sizeof(double)) {
+    /* convert 64-bit floats. */
+    for (i = 0; i < n; i++) {
+      f64 = (double) x[i];
+      memcpy(&u64, &f64, sizeof(double));
+      u64 = (swap ? BYTES_BSWAP64(u64) : u64);
+      memcpy(buf + i * sizeof(double), &u64, sizeof(double));
+    }
+  }
+  else if (!isflt && wordsz == sizeof(int32_t)) {
+    /* convert 32-bit signed integers. */
+    for (i = 0; i < n; i++) {
+      i32 = (int32_t) x[i];
+      memcpy(&u32, &i32, sizeof(int32_t));
+      u32 = (swap ? BYTES_BSWAP32(u32) : u32);
+      memcpy(buf + i * sizeof(int32_t), &u32, sizeof(int32_t));
+    }
+  }
+  else {
+    /* convert all other formats one word at a time. */
+    for (i = 0; i < n; i++) {
+      /* pack the coefficient into the byte array. */
+      if (!bytes_pack(x[i], buf + i * wordsz, wordsz, isflt))
+        throw("failed to pack coefficient %lu", (unsigned long) i);
+    }
 
-  /* free the allocated buffer memory. */
-  free(buf);
+    /* swap the bytes of the packed words. */
+    if (swap)
+      bytes_swap(buf, n, wordsz);
+  }
 
   /* return success. */
   return 1;
 }
 
 /* hx_array_fwrite_raw(): write a hypercomplex array into a raw output format
- * that differs from the internal storage format of the hx_array.
+ * that differs from the internal storage format of the hx_array. coefficients
+ * are converted in parallel into a large buffer, which is then written out
+ * in a single call.
  * @fh: output file handle.
  * @x: source array structure pointer.
  * @endian: raw word byte ordering.
@@ -189,11 +609,17 @@ int hx_array_fread_raw (FILE *fh, hx_array *x, enum byteorder endian,
 int hx_array_fwrite_raw (FILE *fh, hx_array *x, enum byteorder endian,
                          unsigned int wordsz, unsigned int isflt) {
   /* declare a few required variables:
-   * @bytes: raw array of bytes, size of a word.
-   * @i: general-purpose loop counter.
+   * @buf: raw array of bytes, holding a whole number of words.
+   * @nbuf: number of words per buffer.
+   * @nask: number of words in the current buffer.
+   * @pos: array coefficient offset of the current buffer.
+   * @c: chunk loop counter.
+   * @nchks: number of chunks in the current buffer.
+   * @ok: whether every chunk was converted.
    */
-  uint8_t *bytes;
-  int i;
+  size_t nbuf, nask, pos;
+  int c, nchks, ok;
+  uint8_t *buf;
 
   /* check if the requested parameters match the internal storage. */
   if (bytes_native(endian) && wordsz == sizeof(real) && isflt) {
@@ -208,31 +634,215 @@ int hx_array_fwrite_raw (FILE *fh, hx_array *x, enum byteorder endian,
     return 1;
   }
 
+  /* compute the number of words per buffer. */
+  nbuf = HX_ARRAY_FREAD_SZ_BUF / wordsz;
+  nbuf = ((size_t) x->len < nbuf ? (size_t) x->len : nbuf);
+
   /* allocate the raw byte array. */
-  bytes = (uint8_t*) malloc(wordsz * sizeof(uint8_t));
+  buf = (uint8_t*) malloc((nbuf ? nbuf : 1) * wordsz);
 
   /* check that allocation was successful. */
-  if (!bytes)
-    throw("failed to allocate a %u-byte storage array", wordsz);
+  if (!buf)
+    throw("failed to allocate %lu-word storage array", (unsigned long) nbuf);
+
+  /* loop over the array coefficients, one buffer at a time. */
+  for (pos = 0; pos < (size_t) x->len; pos += nask) {
+    /* determine the number of words in the current buffer. */
+    nask = (size_t) x->len - pos;
+    nask = (nask < nbuf ? nask : nbuf);
+
+    /* determine the number of chunks in the current buffer. */
+    nchks = (nask + HX_ARRAY_FREAD_SZ_CHUNK - 1) / HX_ARRAY_FREAD_SZ_CHUNK;
+    ok = 1;
+
+    /* convert the chunks of the buffer in parallel. */
+    #pragma omp parallel for reduction(&&:ok)
+    for (c = 0; c < nchks; c++) {
+      /* declare required thread-local variables:
+       * @iw: first buffer word index of the chunk.
+       * @nw: number of words in the chunk.
+       */
+      size_t iw, nw;
+
+      /* locate the chunk within the buffer. */
+      iw = (size_t) c * HX_ARRAY_FREAD_SZ_CHUNK;
+      nw = nask - iw;
+      nw = (nw < HX_ARRAY_FREAD_SZ_CHUNK ? nw : HX_ARRAY_FREAD_SZ_CHUNK);
+
+      /* pack the chunk coefficients into raw words. */
+      ok = ok && hx_array_encode_raw(x->x + pos + iw, buf + iw * wordsz, nw,
+                                     endian, wordsz, isflt);
+    }
 
-  /* loop over the array coefficients. */
-  for (i = 0; i < x->len; i++) {
-    /* pack the coefficient into the byte array. */
-    if (!bytes_pack(x->x[i], bytes, wordsz, isflt))
-      throw("failed to pack coefficient %d", i);
+    /* check that every chunk was converted. */
+    if (!ok)
+      throw("failed to pack coefficients %lu..%lu", (unsigned long) pos,
+            (unsigned long) (pos + nask - 1));
 
     /* write the raw bytes out to the file. */
-    if (fwrite(bytes, sizeof(uint8_t), wordsz, fh) != 1)
-      throw("failed to write %cE %u-byte %s #%d",
+    if (fwrite(buf, wordsz, nask, fh) != nask)
+      throw("failed to write %cE %u-byte %ss at #%lu",
             endian == BYTES_ENDIAN_LITTLE ? 'L' :
             endian == BYTES_ENDIAN_BIG ? 'B' : 'U',
-            wordsz, isflt ? "float" : "integer", i);
+            wordsz, isflt ? "float" : "integer", (unsigned long) pos);
   }
 
   /* free the raw byte array. */
-  free(bytes);
+  free(buf);
 
   /* return success. */
   return 1;
 }
 
+/* hx_array_fwrite_tiled(): write the real coefficients of an array to a
+ * file as raw tiled data, as from hx_array_copy_real() followed by
+ * hx_array_tiler() and hx_array_fwrite_raw(). each tile is gathered from
+ * the linear array directly into the output buffer, in parallel. points
+ * of the tiling that lie outside the array are written as zeros.
+ * @fh: output file handle.
+ * @x: source array structure pointer.
+ * @endian: raw word byte ordering.
+ * @wordsz: number of bytes per word.
+ * @isflt: whether the words are floats.
+ * @nt: array of tile counts.
+ * @szt: array of tile sizes.
+ * @incr: tile ordering, either HX_ARRAY_INCR_NORMAL or _REVERSE.
+ */
+int hx_array_fwrite_tiled (FILE *fh, hx_array *x, enum byteorder endian,
+                           unsigned int wordsz, unsigned int isflt,
+                           hx_index nt, hx_index szt, int incr) {
+  /* declare a few required variables:
+   * @sx: array point strides.
+   * @ntw: number of words per tile.
+   * @nbytes: number of bytes per tile.
+   * @nbuf: number of tiles per buffer.
+   * @nask: number of tiles in the current buffer.
+   * @buf: raw array of bytes, holding a whole number of tiles.
+   * @i: dimension loop counter.
+   * @t0: first tile of the current buffer.
+   * @t: tile loop counter.
+   * @ntiles: total number of tiles.
+   * @ok: whether every tile was gathered.
+   */
+  size_t ntw, nbytes, nbuf, nask;
+  int i, t0, t, ntiles, ok;
+  uint8_t *buf;
+  hx_index sx;
+
+  /* allocate the array stride index. */
+  sx = hx_index_alloc(x->k);
+  if (!sx)
+    throw("failed to allocate %d indices", x->k);
+
+  /* compute the tile counts and the array point strides. */
+  for (i = 0, ntiles = 1, ntw = 1; i < x->k; i++) {
+    /* check that the tiling covers the array. */
+    if (nt[i] * szt[i] < x->sz[i])
+      throw("tiling %dx%d does not cover size %d (#%d)",
+            nt[i], szt[i], x->sz[i], i);
+
+    /* store the tile counts and strides. */
+    sx[i] = (i ? sx[i - 1] * x->sz[i - 1] : 1);
+    ntiles *= nt[i];
+    ntw *= (size_t) szt[i];
+  }
+
+  /* compute the number of tiles per buffer. */
+  nbytes = ntw * wordsz;
+  nbuf = HX_ARRAY_FREAD_SZ_BUF / nbytes;
+  nbuf = (nbuf ? nbuf : 1);
+  nbuf = ((size_t) ntiles < nbuf ? (size_t) ntiles : nbuf);
+
+  /* allocate the raw byte array. */
+  buf = (uint8_t*) malloc((nbuf ? nbuf : 1) * nbytes);
+  if (!buf)
+    throw("failed to allocate %lu-tile storage array", (unsigned long) nbuf);
+
+  /* loop over the tiles, one buffer at a time. */
+  for (t0 = 0; t0 < ntiles; t0 += nask) {
+    /* determine the number of tiles in the current buffer. */
+    nask = (size_t) (ntiles - t0);
+    nask = (nask < nbuf ? nask : nbuf);
+    ok = 1;
+
+    /* gather the tiles of the buffer in parallel. */
+    #pragma omp parallel for reduction(&&:ok)
+    for (t = t0; t < t0 + (int) nask; t++) {
+      /* declare required thread-local variables:
+       * @it: tile index.
+       * @ip: point index within the tile.
+       * @w: gathered tile words.
+       * @pin: in-tile linear index.
+       * @px: array point linear index.
+       * @j: dimension loop counter.
+       * @d: dimension index in file order.
+       * @r: remaining packed tile index.
+       * @g: array point index along the current dimension.
+       * @res: result of in-tile index incrementation.
+       */
+      hx_index it, ip;
+      size_t pin, px;
+      int j, d, r, g, res;
+      real *w;
+
+      /* allocate the thread-local indices and words. */
+      it = hx_index_alloc(x->k);
+      ip = hx_index_alloc(x->k);
+      w = (real*) malloc(ntw * sizeof(real));
+
+      /* check that allocation succeeded. */
+      if (it && ip && w) {
+        /* unpack the tile index, following the file ordering. */
+        for (j = 0, r = t; j < x->k; j++) {
+          d = (incr == HX_ARRAY_INCR_REVERSE ? x->k - j - 1 : j);
+          it[d] = r % nt[d];
+          r /= nt[d];
+        }
+
+        /* gather the tile points in file order. */
+        pin = 0;
+        do {
+          /* locate the point in the array. */
+          for (j = 0, px = 0, g = 1; j < x->k && g; j++) {
+            g = (it[j] * szt[j] + ip[j] < x->sz[j]);
+            px += (size_t) (it[j] * szt[j] + ip[j]) * (size_t) sx[j];
+          }
+
+          /* store the real coefficient, or zero outside the array. */
+          w[pin++] = (g ? x->x[px * x->n] : 0.0);
+
+          /* move to the next point. */
+          res = (incr == HX_ARRAY_INCR_REVERSE ?
+                 hx_index_incr_rev(x->k, szt, ip) :
+                 hx_index_incr(x->k, szt, ip));
+        } while (res);
+
+        /* pack the tile words into the buffer. */
+        ok = ok && hx_array_encode_raw(w, buf + (size_t) (t - t0) * nbytes,
+                                       ntw, endian, wordsz, isflt);
+      }
+      else
+        ok = 0;
+
+      /* free the thread-local indices and words. */
+      hx_index_free(it);
+      hx_index_free(ip);
+      free(w);
+    }
+
+    /* check that every tile was gathered. */
+    if (!ok)
+      throw("failed to gather tiles %d..%d", t0, t0 + (int) nask - 1);
+
+    /* write the raw bytes out to the file. */
+    if (fwrite(buf, nbytes, nask, fh) != nask)
+      throw("failed to write tiles %d..%d", t0, t0 + (int) nask - 1);
+  }
+
+  /* free the allocated memory. */
+  hx_index_free(sx);
+  free(buf);
+
+  /* return success. */
+  return 1;
+}
@@ -20,9 +20,15 @@
  *   Boston, MA  02110-1301, USA.
  */
 
+/* request posix extensions for memory-mapped file access. */
+#define _POSIX_C_SOURCE 200809L
+
 /* include the n-dimensional math header. */
 #include <hxnd/hx.h>
 
+/* include the posix memory-mapping header. */
+#include <sys/mman.h>
+
 /* hx_array_is_real(): return whether a specified hypercomplex array contains
  * only real data.
  * @x: a pointer to the array to query.
@@ -52,6 +58,10 @@ int hx_array_resize_d (hx_array *x, int d) {
   if (d < 0)
     throw("algebraic dimensionality %d is invalid", d);
 
+  /* move mapped coefficients onto the heap before reallocation. */
+  if (!hx_array_unmap(x))
+    throw("failed to unmap coefficient array");
+
   /* compute the new number of coefficients. */
   n = 1 << d;
 
@@ -216,8 +226,15 @@ int hx_array_resize (hx_array *x, int d, int k, hx_index sz) {
   /* free the allocated index array. */
   hx_index_free(idx);
 
-  /* store the new data array. */
-  free(x->x);
+  /* release the old coefficients and store the new data array. */
+  if (x->map) {
+    munmap(x->map, x->nmap);
+    x->map = NULL;
+    x->nmap = 0;
+  }
+  else
+    free(x->x);
+
   x->x = xnew;
 
   /* resize the size array, if the new size is different. */
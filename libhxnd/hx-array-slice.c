@@ -41,13 +41,14 @@ int hx_array_slicer (hx_array *x, hx_array *y,
    * @xycmp: set high if @y needs allocation.
    * @n: number of coefficients per scalar.
    * @ncpy: number of bytes per scalar.
+   * @nrun: number of bytes per contiguous run of scalars.
    * @pidx: input array packed linear index.
    * @pidxy: output array packed linear index.
    * @idx: input array index set.
    * @idxy: output array index set.
    * @sznew: output array sizes.
    */
-  int i, xycmp, n, ncpy, pidx, pidxy;
+  int i, xycmp, n, ncpy, nrun, pidx, pidxy;
   hx_index idx, idxy, sznew;
 
   /* store the number of coefficients and bytes per hypercomplex scalar. */
@@ -93,7 +94,12 @@ int hx_array_slicer (hx_array *x, hx_array *y,
       !hx_array_alloc(y, x->d, x->k, sznew))
     throw("failed to allocate slice destination array");
 
-  /* iterate over the array indices to copy. */
+  /* compute the number of bytes in each contiguous run of scalars along
+   * the first array dimension.
+   */
+  nrun = sznew[0] * ncpy;
+
+  /* iterate over the runs of array indices to copy. */
   do {
     /* pack the i/o array indices into linear indices. */
     hx_index_pack(x->k, x->sz, idx, &pidx);
@@ -103,12 +109,12 @@ int hx_array_slicer (hx_array *x, hx_array *y,
     switch (dir) {
       /* slice: x ==> y */
       case HX_ARRAY_SLICER_SLICE:
-        memcpy(y->x + n * pidxy, x->x + n * pidx, ncpy);
+        memcpy(y->x + n * pidxy, x->x + n * pidx, nrun);
         break;
 
       /* store: x <== y */
       case HX_ARRAY_SLICER_STORE:
-        memcpy(x->x + n * pidx, y->x + n * pidxy, ncpy);
+        memcpy(x->x + n * pidx, y->x + n * pidxy, nrun);
         break;
 
       /* other: no-op. */
@@ -116,9 +122,9 @@ int hx_array_slicer (hx_array *x, hx_array *y,
         break;
     }
 
-    /* increment the output array index. */
-    hx_index_incr(x->k, sznew, idxy);
-  } while (hx_index_incr_bounded(x->k, lower, upper, idx));
+    /* increment the output array index, skipping the first dimension. */
+    hx_index_incr(x->k - 1, sznew + 1, idxy + 1);
+  } while (hx_index_incr_bounded(x->k - 1, lower + 1, upper + 1, idx + 1));
 
   /* free the allocated index arrays. */
   hx_index_free(idx);
@@ -194,6 +200,116 @@ int hx_array_vector_slicer (hx_array *x, hx_array *y,
   return 1;
 }
 
+/* hx_array_brick_slicer(): slice or store a brick of @nv adjacent vectors
+ * from an array, each running along the extents of a given dimension. the
+ * vectors are stored as the columns of an (n, nv)-matrix. for any dimension
+ * but the first, each row of the brick is read from (or written to) a single
+ * contiguous run of scalars in the input array.
+ * @x: pointer to the input array.
+ * @y: pointer to the output array.
+ * @k: array dimension to slice along.
+ * @loc: off-dimension slice origin of the first vector.
+ * @nv: number of vectors in the brick.
+ * @dir: either HX_ARRAY_SLICER_SLICE or HX_ARRAY_SLICER_STORE.
+ */
+int hx_array_brick_slicer (hx_array *x, hx_array *y,
+                           int k, int loc, int nv,
+                           int dir) {
+  /* declare a few required variables:
+   * @i: a loop counter used during slicing and index setup.
+   * @v: a loop counter over the vectors in the brick.
+   * @n: size of the sliced dimension, row count of the output array.
+   * @sz: required sizes of the output array.
+   * @ncpy: number of bytes per hypercomplex scalar value.
+   * @idx: linear index of the input array.
+   * @stride: stride of the input array.
+   * @xi: pointer to the first coefficient of the current input run.
+   * @yi: pointer to the first coefficient of the current output row.
+   */
+  int i, v, n, sz[2], ncpy, idx, stride;
+  real *xi, *yi;
+
+  /* check that the slice dimension in within bounds. */
+  if (k < 0 || k >= x->k)
+    throw("slice dimension %d out of bounds [0,%d)", k, x->k);
+
+  /* compute the number of bytes per scalar
+   * and the size of the output array.
+   */
+  ncpy = x->n * sizeof(real);
+  n = x->sz[k];
+
+  /* compute the stride for passing along the slice dimension. */
+  for (i = 0, stride = 1; i < k; i++)
+    stride *= x->sz[i];
+
+  /* check that the brick does not span multiple slice origins. */
+  if (nv < 1 || loc % stride + nv > stride)
+    throw("brick of %d vectors at %d exceeds stride %d", nv, loc, stride);
+
+  /* allocate the output array, if its configuration does not match
+   * the required configuration.
+   */
+  sz[0] = n;
+  sz[1] = nv;
+  if ((y->d != x->d || y->k != 2 || y->sz[0] != n || y->sz[1] < nv) &&
+      !hx_array_alloc(y, x->d, 2, sz))
+    throw("failed to allocate brick destination array");
+
+  /* loop over the rows of the brick. */
+  for (i = 0, idx = loc; i < n; i++, idx += stride) {
+    /* locate the input run and the output row. */
+    xi = x->x + x->n * idx;
+    yi = y->x + y->n * i;
+
+    /* copy the coefficient memory. */
+    switch (dir) {
+      /* slice: x ==> y */
+      case HX_ARRAY_SLICER_SLICE:
+        for (v = 0; v < nv; v++)
+          memcpy(yi + y->n * n * v, xi + x->n * v, ncpy);
+        break;
+
+      /* store: x <== y */
+      case HX_ARRAY_SLICER_STORE:
+        for (v = 0; v < nv; v++)
+          memcpy(xi + x->n * v, yi + y->n * n * v, ncpy);
+        break;
+
+      /* other: no-op. */
+      default:
+        break;
+    }
+  }
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_brick_vector(): configure an array structure to reference a
+ * single vector (column) of a brick filled by hx_array_slice_brick(). the
+ * resulting array shares memory with the brick, and must not be freed.
+ * @y: pointer to the brick array.
+ * @v: index of the vector in the brick.
+ * @yv: pointer to the output vector array structure.
+ */
+void hx_array_brick_vector (hx_array *y, int v, hx_array *yv) {
+  /* copy the algebraic configuration of the brick. */
+  yv->d = y->d;
+  yv->n = y->n;
+  yv->tbl = y->tbl;
+
+  /* share the (leading) brick size as the vector size. */
+  yv->k = 1;
+  yv->sz = y->sz;
+  yv->len = y->n * y->sz[0];
+
+  /* point into the coefficients of the indexed column. */
+  yv->x = y->x + yv->len * v;
+  yv->map = NULL;
+  yv->nmap = 0;
+}
+
 /* hx_array_matrix_slicer(): slice or store a planar section from an array,
  * similar to hx_array_vector_slicer().
  * @x: pointer to the input array.
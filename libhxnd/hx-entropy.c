@@ -132,141 +132,191 @@ int hx_entropy_get_functionals (enum hx_entropy_type type,
  * @f: functional to compute on the array.
  */
 real hx_entropy_sum_functional (hx_array *x, hx_entropy_functional f) {
-  /* declare a few required variables:
+  /* declare a required variable:
    * @fsum: sum of all computed functional values.
-   * @fi: currently computed functional value.
-   * @i: array scalar index.
    */
-  real fsum, fi;
-  int i;
+  real fsum;
 
-  /* loop over the array elements. */
-  for (i = 0, fsum = 0.0; i < x->len; i += x->n) {
-    /* compute the current functional value. */
-    f(x->x + i, &fi, x->n);
-
-    /* sum the computed value into the result. */
-    fsum += fi;
-  }
+  /* compute the functional over every scalar of the array at once. */
+  f(x->x, &fsum, x->n, x->len / x->n);
 
   /* return the computed result. */
   return fsum;
 }
 
-/* hx_entropy_norm_f(): compute the scalar entropy of a hypercomplex scalar
- * using an l1-norm functional.
+/* hx_entropy_norm(): compute the norm of a hypercomplex scalar, exactly as
+ * hx_data_real_norm() does, but inlined into the functional loops below.
+ * @x: the raw array data of the scalar.
+ * @n: the number of array elements of the scalar.
+ */
+inline real hx_entropy_norm (real *x, int n) {
+  /* declare a few required variables:
+   * @nrm: sum of squared coefficients.
+   * @i: coefficient loop counter.
+   */
+  real nrm;
+  int i;
+
+  /* sum the squared coefficients. */
+  for (i = 0, nrm = 0.0; i < n; i++)
+    nrm += x[i] * x[i];
+
+  /* return the norm. */
+  return sqrt(nrm);
+}
+
+/* hx_entropy_norm_f(): compute the summed entropy of a run of hypercomplex
+ * scalars using an l1-norm functional.
  */
-void hx_entropy_norm_f (real *x, real *S, int n) {
-  /* compute the norm of the hypercomplex input. */
-  *S = hx_data_real_norm(x, n);
+void hx_entropy_norm_f (real *x, real *S, int n, int ns) {
+  /* declare required variables. */
+  real sum;
+  int j;
+
+  /* sum the norms of the hypercomplex inputs. */
+  for (j = 0, sum = 0.0; j < ns; j++, x += n)
+    sum += hx_entropy_norm(x, n);
+
+  /* store the result. */
+  *S = sum;
 }
 
-/* hx_entropy_norm_df(): compute the complex partial derivative of the
- * entropy of a hypercomplex scalar using an l1-norm functional.
+/* hx_entropy_norm_df(): compute the complex partial derivatives of the
+ * entropy of a run of hypercomplex scalars using an l1-norm functional.
  */
-void hx_entropy_norm_df (real *x, real *S, int n) {
+void hx_entropy_norm_df (real *x, real *S, int n, int ns) {
   /* declare required variables. */
   real Snrm;
-  int i;
+  int i, j;
 
-  /* compute the norm of the hypercomplex input. */
-  Snrm = -hx_data_real_norm(x, n);
+  /* loop over the hypercomplex inputs. */
+  for (j = 0; j < ns; j++, x += n, S += n) {
+    /* compute the norm of the hypercomplex input. */
+    Snrm = -hx_entropy_norm(x, n);
 
-  /* compute the array elements of the complex derivative. */
-  for (i = 0; i < n; i++)
-    S[i] = x[i] / Snrm;
+    /* compute the array elements of the complex derivative. */
+    for (i = 0; i < n; i++)
+      S[i] = x[i] / Snrm;
+  }
 }
 
-/* hx_entropy_shannon_f(): compute the scalar entropy of a hypercomplex
- * scalar using a negated shannon entropy functional.
+/* hx_entropy_shannon_f(): compute the summed entropy of a run of
+ * hypercomplex scalars using a negated shannon entropy functional.
  */
-void hx_entropy_shannon_f (real *x, real *S, int n) {
+void hx_entropy_shannon_f (real *x, real *S, int n, int ns) {
   /* declare required variables. */
-  real Snrm;
+  real Snrm, sum;
+  int j;
 
-  /* compute the entropy of the hypercomplex input. */
-  Snrm = hx_data_real_norm(x, n);
-  *S = Snrm * log(Snrm);
+  /* sum the entropies of the hypercomplex inputs. */
+  for (j = 0, sum = 0.0; j < ns; j++, x += n) {
+    Snrm = hx_entropy_norm(x, n);
+    sum += Snrm * log(Snrm);
+  }
+
+  /* store the result. */
+  *S = sum;
 }
 
-/* hx_entropy_shannon_df(): compute the complex partial derivative of the
- * entropy of a hypercomplex scalar using a negated shannon entropy
+/* hx_entropy_shannon_df(): compute the complex partial derivatives of the
+ * entropy of a run of hypercomplex scalars using a negated shannon entropy
  * functional.
  */
-void hx_entropy_shannon_df (real *x, real *S, int n) {
+void hx_entropy_shannon_df (real *x, real *S, int n, int ns) {
   /* declare required variables. */
   real Snrm;
-  int i;
+  int i, j;
 
-  /* compute the norm of the hypercomplex input. */
-  Snrm = hx_data_real_norm(x, n);
-  Snrm = -(log(Snrm) + 1.0) / Snrm;
+  /* loop over the hypercomplex inputs. */
+  for (j = 0; j < ns; j++, x += n, S += n) {
+    /* compute the norm of the hypercomplex input. */
+    Snrm = hx_entropy_norm(x, n);
+    Snrm = -(log(Snrm) + 1.0) / Snrm;
 
-  /* compute the array elements of the complex derivative. */
-  for (i = 0; i < n; i++)
-    S[i] = Snrm * x[i];
+    /* compute the array elements of the complex derivative. */
+    for (i = 0; i < n; i++)
+      S[i] = Snrm * x[i];
+  }
 }
 
-/* hx_entropy_skilling_f(): compute the scalar entropy of a hypercomplex
- * scalar using a negated skilling entropy functional.
+/* hx_entropy_skilling_f(): compute the summed entropy of a run of
+ * hypercomplex scalars using a negated skilling entropy functional.
  */
-void hx_entropy_skilling_f (real *x, real *S, int n) {
+void hx_entropy_skilling_f (real *x, real *S, int n, int ns) {
   /* declare required variables. */
-  real Snrm;
+  real Snrm, sum;
+  int j;
 
-  /* compute the entropy of the hypercomplex input. */
-  Snrm = hx_data_real_norm(x, n);
-  *S = Snrm * log(Snrm) - Snrm;
+  /* sum the entropies of the hypercomplex inputs. */
+  for (j = 0, sum = 0.0; j < ns; j++, x += n) {
+    Snrm = hx_entropy_norm(x, n);
+    sum += Snrm * log(Snrm) - Snrm;
+  }
+
+  /* store the result. */
+  *S = sum;
 }
 
-/* hx_entropy_skilling_df(): compute the complex partial derivative of the
- * entropy of a hypercomplex scalar using a negated skilling entropy
- * functional.
+/* hx_entropy_skilling_df(): compute the complex partial derivatives of the
+ * entropy of a run of hypercomplex scalars using a negated skilling
+ * entropy functional.
  */
-void hx_entropy_skilling_df (real *x, real *S, int n) {
+void hx_entropy_skilling_df (real *x, real *S, int n, int ns) {
   /* declare required variables. */
   real Snrm;
-  int i;
+  int i, j;
 
-  /* compute the norm of the hypercomplex input. */
-  Snrm = hx_data_real_norm(x, n);
-  Snrm = -log(Snrm) / Snrm;
+  /* loop over the hypercomplex inputs. */
+  for (j = 0; j < ns; j++, x += n, S += n) {
+    /* compute the norm of the hypercomplex input. */
+    Snrm = hx_entropy_norm(x, n);
+    Snrm = -log(Snrm) / Snrm;
 
-  /* compute the array elements of the complex derivative. */
-  for (i = 0; i < n; i++)
-    S[i] = Snrm * x[i];
+    /* compute the array elements of the complex derivative. */
+    for (i = 0; i < n; i++)
+      S[i] = Snrm * x[i];
+  }
 }
 
-/* hx_entropy_hoch_f(): compute the scalar entropy of a hypercomplex scalar
- * using a negated hoch/hore spin-half entropy functional.
+/* hx_entropy_hoch_f(): compute the summed entropy of a run of hypercomplex
+ * scalars using a negated hoch/hore spin-half entropy functional.
  */
-void hx_entropy_hoch_f (real *x, real *S, int n) {
+void hx_entropy_hoch_f (real *x, real *S, int n, int ns) {
   /* declare required variables. */
-  real Snrm;
+  real Snrm, sum;
+  int j;
 
-  /* compute the norm of the hypercomplex input. */
-  Snrm = hx_data_real_norm(x, n);
+  /* sum the entropies of the hypercomplex inputs. */
+  for (j = 0, sum = 0.0; j < ns; j++, x += n) {
+    /* compute the norm of the hypercomplex input. */
+    Snrm = hx_entropy_norm(x, n);
+
+    /* compute the entropy of the hypercomplex input. */
+    sum += Snrm * log(Snrm / 2.0 + sqrt(1.0 + Snrm * Snrm / 4.0))
+         - sqrt(4.0 + Snrm * Snrm);
+  }
 
-  /* compute the entropy of the hypercomplex input. */
-  *S = Snrm * log(Snrm / 2.0 + sqrt(1.0 + Snrm * Snrm / 4.0))
-     - sqrt(4.0 + Snrm * Snrm);
+  /* store the result. */
+  *S = sum;
 }
 
-/* hx_entropy_hoch_df(): compute the complex partial derivative of the
- * entropy of a hypercomplex scalar using a negated hoch/hore spin-half
- * entropy functional.
+/* hx_entropy_hoch_df(): compute the complex partial derivatives of the
+ * entropy of a run of hypercomplex scalars using a negated hoch/hore
+ * spin-half entropy functional.
  */
-void hx_entropy_hoch_df (real *x, real *S, int n) {
+void hx_entropy_hoch_df (real *x, real *S, int n, int ns) {
   /* declare required variables. */
   real Snrm;
-  int i;
+  int i, j;
 
-  /* compute the norm of the hypercomplex input. */
-  Snrm = hx_data_real_norm(x, n);
-  Snrm = -log(Snrm / 2.0 + sqrt(1.0 + Snrm * Snrm / 4.0)) / Snrm;
+  /* loop over the hypercomplex inputs. */
+  for (j = 0; j < ns; j++, x += n, S += n) {
+    /* compute the norm of the hypercomplex input. */
+    Snrm = hx_entropy_norm(x, n);
+    Snrm = -log(Snrm / 2.0 + sqrt(1.0 + Snrm * Snrm / 4.0)) / Snrm;
 
-  /* compute the array elements of the complex derivative. */
-  for (i = 0; i < n; i++)
-    S[i] = Snrm * x[i];
+    /* compute the array elements of the complex derivative. */
+    for (i = 0; i < n; i++)
+      S[i] = Snrm * x[i];
+  }
 }
-
@@ -76,6 +76,144 @@ unsigned int hx_nextpow2 (unsigned int value) {
   return pow2;
 }
 
+/* hx_fft_prune_stages(): count the butterfly stages of a radix-2 fast
+ * fourier transform.
+ * @n: number of transform points.
+ */
+int hx_fft_prune_stages (int n) {
+  /* declare a required variable:
+   * @nst: stage counter.
+   */
+  int nst;
+
+  /* count the doublings required to reach the point count. */
+  for (nst = 0; (1 << nst) < n; nst++);
+
+  /* return the computed count. */
+  return nst;
+}
+
+/* hx_fft_prune_input(): build the input pruning table of a radix-2 fast
+ * fourier transform whose only nonzero inputs lie at a known set of
+ * points, e.g. the sampled points of a zero-filled nonuniform trace.
+ * the table holds, for each bit-reversed point, the number of butterfly
+ * stages after which its value may become nonzero. butterflies that only
+ * combine zeros are skipped, and those that combine a value with a zero
+ * are reduced to copies or single multiplications.
+ * @n: number of transform points.
+ * @idx: indices of the nonzero input points.
+ * @nidx: number of indices in @idx.
+ */
+hx_index hx_fft_prune_input (int n, hx_index idx, int nidx) {
+  /* declare a few required variables:
+   * @i: point loop counter.
+   * @j: bit-reversed point index.
+   * @b: bit loop counter.
+   * @m: remaining bits of the input point index.
+   * @k: butterfly span of the current stage.
+   * @s: stage loop counter.
+   * @nst: number of butterfly stages.
+   * @first: output pruning table.
+   */
+  int i, j, b, m, k, s, nst;
+  hx_index first;
+
+  /* count the butterfly stages of the transform. */
+  nst = hx_fft_prune_stages(n);
+
+  /* allocate the pruning table. */
+  first = hx_index_alloc(n);
+  if (!first) {
+    /* raise an error and return nothing. */
+    raise("failed to allocate %d-point pruning table", n);
+    return NULL;
+  }
+
+  /* initially mark every point as zero throughout the transform. */
+  for (i = 0; i < n; i++)
+    first[i] = nst + 1;
+
+  /* mark the bit-reversed location of each nonzero input point. */
+  for (i = 0; i < nidx; i++) {
+    for (b = 0, j = 0, m = idx[i]; b < nst; b++, m >>= 1)
+      j = (j << 1) | (m & 1);
+
+    first[j] = 0;
+  }
+
+  /* propagate the nonzero points through the butterflies of each stage. */
+  for (s = 0, k = 1; k < n; s++, k <<= 1) {
+    for (i = 0; i < n; i++) {
+      /* skip the upper point of each butterfly. */
+      if (i & k)
+        continue;
+
+      /* both outputs are nonzero if either input is nonzero. */
+      if (first[i] <= s || first[i + k] <= s) {
+        first[i] = (first[i] < s + 1 ? first[i] : s + 1);
+        first[i + k] = (first[i + k] < s + 1 ? first[i + k] : s + 1);
+      }
+    }
+  }
+
+  /* return the pruning table. */
+  return first;
+}
+
+/* hx_fft_prune_output(): build the output pruning table of a radix-2 fast
+ * fourier transform whose outputs are only read at a known set of points,
+ * e.g. the sampled points of a nonuniform trace. the table holds, for
+ * each point, the number of butterfly stages through which its value is
+ * required. butterflies whose outputs are never read are skipped.
+ * @n: number of transform points.
+ * @idx: indices of the required output points.
+ * @nidx: number of indices in @idx.
+ */
+hx_index hx_fft_prune_output (int n, hx_index idx, int nidx) {
+  /* declare a few required variables:
+   * @i: point loop counter.
+   * @k: butterfly span of the current stage.
+   * @s: stage loop counter.
+   * @nst: number of butterfly stages.
+   * @last: output pruning table.
+   */
+  int i, k, s, nst;
+  hx_index last;
+
+  /* count the butterfly stages of the transform. */
+  nst = hx_fft_prune_stages(n);
+
+  /* allocate the pruning table, initially marking no point as required. */
+  last = hx_index_alloc(n);
+  if (!last) {
+    /* raise an error and return nothing. */
+    raise("failed to allocate %d-point pruning table", n);
+    return NULL;
+  }
+
+  /* mark each required output point. */
+  for (i = 0; i < nidx; i++)
+    last[idx[i]] = nst;
+
+  /* propagate the required points backwards through each stage. */
+  for (s = nst - 1, k = n >> 1; s > 0; s--, k >>= 1) {
+    for (i = 0; i < n; i++) {
+      /* skip the upper point of each butterfly. */
+      if (i & k)
+        continue;
+
+      /* both inputs are required if either output is required. */
+      if (last[i] > s || last[i + k] > s) {
+        last[i] = (last[i] > s ? last[i] : s);
+        last[i + k] = (last[i + k] > s ? last[i + k] : s);
+      }
+    }
+  }
+
+  /* return the pruning table. */
+  return last;
+}
+
 /* hx_array_fft1d(): computes an in-place radix-2 fast fourier transform
  * of a hypercomplex one-dimensional (vector) array.
  * @y: pointer to the array structure to transform.
@@ -86,16 +224,39 @@ unsigned int hx_nextpow2 (unsigned int value) {
  */
 int hx_array_fft1d (hx_array *y, int d, real dir,
                     hx_scalar *w, hx_scalar *swp) {
+  /* execute the transform without pruning. */
+  return hx_array_fft1d_pruned(y, d, dir, w, swp, NULL, NULL);
+}
+
+/* hx_array_fft1d_pruned(): computes an in-place radix-2 fast fourier
+ * transform of a hypercomplex one-dimensional (vector) array, skipping
+ * the butterflies that only involve known zeros or unread outputs. the
+ * values of pruned input points are never read, and need not be zero,
+ * and the values of pruned output points are left undefined.
+ * @y: pointer to the array structure to transform.
+ * @d: dimension to transform.
+ * @dir: direction of transformation.
+ * @w: preallocated hypercomplex scalar.
+ * @swp: preallocated hypercomplex scalar.
+ * @first: input pruning table from hx_fft_prune_input(), or NULL.
+ * @last: output pruning table from hx_fft_prune_output(), or NULL.
+ */
+int hx_array_fft1d_pruned (hx_array *y, int d, real dir,
+                           hx_scalar *w, hx_scalar *swp,
+                           hx_index first, hx_index last) {
   /* declare a few required variables:
    * @i, @j, @k, @m: loop counters.
+   * @s: butterfly stage index.
    * @n: array (scalar) element count.
    * @ncpy: number of bytes per scalar.
    * @step: loop stride.
+   * @zi, @zik: whether the butterfly inputs are known to be zero.
+   * @tw: whether the twiddle factor of the current segment is computed.
    * @phi: twiddle factor angle.
    * @pxxi: first coefficient data memory address.
    * @pxxik: second coefficient data memory address.
    */
-  int i, j, k, m, n, ncpy, step;
+  int i, j, k, m, s, n, ncpy, step, zi, zik, tw;
   real phi, *pxxi, *pxxik;
 
   /* compute the number of bytes per scalar and the number of scalars. */
@@ -128,6 +289,7 @@ int hx_array_fft1d (hx_array *y, int d, real dir,
 
   /* initialize the transform outer loop counter. */
   k = 1;
+  s = 0;
 
   /* loop through the sorted data points. */
   do {
@@ -135,26 +297,59 @@ int hx_array_fft1d (hx_array *y, int d, real dir,
     step = 2 * k;
 
     /* loop through the current segment of the array. */
-    for (m = 0; m < k; m++) {
-      /* compute the twiddle factor. */
-      phi = -M_PI * dir * (real) m / (real) k;
-      hx_scalar_phasor(w, d, phi);
-
+    for (m = 0, tw = 0; m < k; m++, tw = 0) {
       /* loop through the other segment of the array. */
       for (i = m; i < n; i += step) {
+        /* skip butterflies whose outputs are never read. */
+        if (last && last[i] <= s && last[i + k] <= s)
+          continue;
+
         /* identify the memory addresses of the coefficients at
          * the (i) and (i+k) indices.
          */
         pxxi = y->x + y->n * i;
         pxxik = y->x + y->n * (i + k);
 
+        /* determine which inputs are known to be zero. */
+        zi = (first && first[i] > s);
+        zik = (first && first[i + k] > s);
+
+        /* with a zero at (i+k), both outputs equal x[i]. */
+        if (zik) {
+          if (!zi)
+            memcpy(pxxik, pxxi, ncpy);
+
+          continue;
+        }
+
+        /* compute the twiddle factor, unless every butterfly that
+         * required it has been pruned.
+         */
+        if (!tw) {
+          phi = -M_PI * dir * (real) m / (real) k;
+          hx_scalar_phasor(w, d, phi);
+          tw = 1;
+        }
+
+        /* compute the twiddled value: swp <- w * x[i+k] */
+        hx_scalar_zero(swp);
+        hx_data_mul(w->x, pxxik, swp->x, y->d, y->n, y->tbl);
+
+        /* with a zero at (i), the outputs are the twiddled value
+         * and its negation:
+         * x[i+k] <- -swp;
+         * x[i] <- swp;
+         */
+        if (zi) {
+          hx_data_add(NULL, swp->x, pxxik, -1.0, y->d, y->n);
+          memcpy(pxxi, swp->x, ncpy);
+          continue;
+        }
+
         /* compute the new values at the current memory locations:
-         * swp <- w * x[i+k]
          * x[i+k] <- x[i] - swp;
          * x[i] <- x[i] + swp;
          */
-        hx_scalar_zero(swp);
-        hx_data_mul(w->x, pxxik, swp->x, y->d, y->n, y->tbl);
         hx_data_add(pxxi, swp->x, pxxik, -1.0, y->d, y->n);
         hx_data_add(pxxi, swp->x, pxxi, 1.0, y->d, y->n);
       }
@@ -162,6 +357,7 @@ int hx_array_fft1d (hx_array *y, int d, real dir,
 
     /* set (double) the loop counter value. */
     k = step;
+    s++;
   } while (k < n);
 
   /* for inverse transforms, scale each value in the vector. */
@@ -185,8 +381,11 @@ int hx_array_fftfn (hx_array *x, int d, int k, real dir) {
    * @ja: small array stride for skipped iteration.
    * @jb: large array stride for skipped iteration.
    * @jmax: maximum loop control value.
+   * @nvb: maximum number of vectors per brick.
+   * @nbr: number of bricks per run of adjacent vectors.
+   * @nb: total number of bricks.
    */
-  int ja, jb, jmax;
+  int ja, jb, jmax, nvb, nbr, nb;
 
   /* check that the dimensions are in bounds. */
   if (d < 0 || d >= x->d)
@@ -203,17 +402,33 @@ int hx_array_fftfn (hx_array *x, int d, int k, real dir) {
   /* initialize the skipped iteration control variables. */
   hx_index_jump_init(x->k, x->sz, k, &ja, &jb, &jmax);
 
-  /* create a team of threads to execute multiple parallel transforms. */
-  #pragma omp parallel
+  /* compute the number of vectors per brick, the number of bricks that
+   * span each run of adjacent vectors, and the total brick count.
+   */
+  nvb = (ja < HX_ARRAY_BRICK_SZ ? ja : HX_ARRAY_BRICK_SZ);
+  nbr = (ja + nvb - 1) / nvb;
+  nb = (jmax / ja) * nbr;
+
+  /* create a team of threads to execute multiple parallel transforms.
+   * transforms requested from within an active team, e.g. by parallel
+   * reconstructions over array slices, run on the calling thread.
+   */
+  #pragma omp parallel if (!omp_in_parallel())
   {
     /* declare a few required thread-local variables:
-     * @j: array skipped iteration master index.
+     * @b: array brick loop index.
+     * @j: array skipped iteration index of the first brick vector.
+     * @v: vector index within the current brick.
+     * @nv: number of vectors in the current brick.
      * @pidx: packed linear array index.
+     * @sz: sizes of the brick array.
+     * @xb: brick of sliced vectors.
+     * @xv: array referencing each vector in the brick.
      * @w: temporary array of twiddle factors.
      * @swp: temporary array of intermediate results, swapped values.
      */
-    int j, pidx;
-    hx_array xv;
+    int b, j, v, nv, pidx, sz[2];
+    hx_array xb, xv;
     hx_scalar w, swp;
 
     /* allocate temporary scalars for use in every transformation. */
@@ -221,31 +436,42 @@ int hx_array_fftfn (hx_array *x, int d, int k, real dir) {
         !hx_scalar_alloc(&swp, x->d))
       raise("failed to allocate temporary %d-scalars", x->d);
 
-    /* allocate the slice destination vector array. */
-    if (!hx_array_alloc(&xv, x->d, 1, &(x->sz[k])))
-      raise("failed to allocate temporary (%d,1)-array", x->d);
+    /* allocate the slice destination brick array. */
+    sz[0] = x->sz[k];
+    sz[1] = nvb;
+    if (!hx_array_alloc(&xb, x->d, 2, sz))
+      raise("failed to allocate temporary (%d,2)-array", x->d);
 
     /* distribute tasks to the team of threads. */
     #pragma omp for
-    for (j = 0; j < jmax; j++) {
-      /* compute the linear array index of the current vector. */
+    for (b = 0; b < nb; b++) {
+      /* compute the first vector index and vector count of the brick. */
+      j = (b / nbr) * ja + (b % nbr) * nvb;
+      nv = ja - (b % nbr) * nvb;
+      nv = (nv < nvb ? nv : nvb);
+
+      /* compute the linear array index of the first brick vector. */
       pidx = hx_index_jump(j, ja, jb);
 
-      /* slice the currently indexed vector from the array. */
-      if (!hx_array_slice_vector(x, &xv, k, pidx))
-        raise("failed to slice vector %d", j);
+      /* slice the currently indexed brick from the array. */
+      if (!hx_array_slice_brick(x, &xb, k, pidx, nv))
+        raise("failed to slice brick %d", b);
 
-      /* fourier transform the sliced vector array. */
-      if (!hx_array_fft1d(&xv, d, dir, &w, &swp))
-        raise("failed to execute vector fft %d", j);
+      /* loop over the vectors of the brick. */
+      for (v = 0; v < nv; v++) {
+        /* fourier transform the referenced vector array. */
+        hx_array_brick_vector(&xb, v, &xv);
+        if (!hx_array_fft1d(&xv, d, dir, &w, &swp))
+          raise("failed to execute vector fft %d", j + v);
+      }
 
-      /* store the modified sliced vector back into the array. */
-      if (!hx_array_store_vector(x, &xv, k, pidx))
-        raise("failed to store vector %d", j);
+      /* store the modified sliced brick back into the array. */
+      if (!hx_array_store_brick(x, &xb, k, pidx, nv))
+        raise("failed to store brick %d", b);
     }
 
     /* free the slice destination array. */
-    hx_array_free(&xv);
+    hx_array_free(&xb);
 
     /* free the temporary scalars. */
     hx_scalar_free(&w);
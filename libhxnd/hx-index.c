@@ -689,8 +689,9 @@ hx_index hx_index_scheduled (int k, hx_index sz, int dsched, int nsched,
 hx_index hx_index_unscheduled (int k, hx_index sz, int dsched, int nsched,
                                hx_index sched) {
   /* declare a few required variables. */
-  int i, iadj, j, ntotal, nidx;
+  int i, iadj, ntotal, nidx;
   hx_index idx, idxinv;
+  char *mask;
 
   /* get the number of total elements. */
   for (i = 0, ntotal = 1; i < k; i++)
@@ -699,37 +700,164 @@ hx_index hx_index_unscheduled (int k, hx_index sz, int dsched, int nsched,
   /* get the number of unscheduled elements. */
   nidx = ntotal - nsched;
 
-  /* allocate the array of indices and a temporary array. */
+  /* allocate the array of indices and a sampling mask. */
   idx = hx_index_alloc(nidx);
+  mask = (char*) calloc(ntotal, sizeof(char));
 
   /* build the array of scheduled indices. */
   idxinv = hx_index_scheduled(k, sz, dsched, nsched, sched);
 
   /* check that allocation was successful. */
-  if (!idx || !idxinv)
+  if (!idx || !mask || !idxinv)
     return NULL;
 
-  /* build the array of unsampled indices. */
-  for (i = 0, iadj = 0; i < ntotal; i++) {
-    /* search for the index in the sampled array. */
-    for (j = 0; j < nsched; j++) {
-      /* break if we find the index. */
-      if (idxinv[j] == i)
-        break;
-    }
+  /* mark each sampled index that lies within the array. */
+  for (i = 0; i < nsched; i++) {
+    if (idxinv[i] >= 0 && idxinv[i] < ntotal)
+      mask[idxinv[i]] = 1;
+  }
 
-    /* check if the index has not been sampled. */
-    if (j >= nsched) {
-      /* store the index and increment the counter. */
+  /* build the array of unsampled indices. */
+  for (i = 0, iadj = 0; i < ntotal && iadj < nidx; i++) {
+    /* store the index if it has not been sampled. */
+    if (!mask[i])
       idx[iadj++] = i;
-    }
   }
 
-  /* free the scheduled array and return the indices. */
+  /* free the temporary arrays and return the indices. */
   hx_index_free(idxinv);
+  free(mask);
   return idx;
 }
 
+/* hx_sched_init(): initialize the contents of a schedule index set.
+ * @S: pointer to the set to initialize.
+ */
+void hx_sched_init (hx_sched *S) {
+  /* initialize the grid and both index lists. */
+  S->k = S->len = 0;
+  S->n = S->nz = 0;
+  S->sz = S->on = S->off = NULL;
+}
+
+/* hx_sched_free(): free all memory held by a schedule index set.
+ * @S: pointer to the set to free.
+ */
+void hx_sched_free (hx_sched *S) {
+  /* free the grid size and index lists. */
+  hx_index_free(S->sz);
+  hx_index_free(S->on);
+  hx_index_free(S->off);
+
+  /* re-initialize the set. */
+  hx_sched_init(S);
+}
+
+/* hx_sched_match(): check whether a schedule index set was built over
+ * a given grid.
+ * @S: pointer to the set to check.
+ * @k: number of grid dimensions.
+ * @sz: grid dimension sizes.
+ */
+int hx_sched_match (hx_sched *S, int k, hx_index sz) {
+  /* compare the grid dimensionality and sizes. */
+  return (S->sz && S->k == k && hx_index_cmp(k, S->sz, sz) == 0);
+}
+
+/* hx_sched_build(): partition the points of a grid into sorted lists of
+ * packed sampled and unsampled indices, using a single pass over a mask
+ * of the grid. duplicated schedule entries are counted once. returns 0
+ * if any schedule entry lies outside the grid.
+ * @S: pointer to the output set.
+ * @k: number of grid dimensions.
+ * @sz: grid dimension sizes.
+ * @dsched: number of values per schedule entry.
+ * @nsched: number of schedule entries.
+ * @sched: array of @nsched unpacked @dsched-dimensional entries.
+ */
+int hx_sched_build (hx_sched *S, int k, hx_index sz,
+                    int dsched, int nsched, hx_index sched) {
+  /* declare a few required variables:
+   * @i: schedule entry and grid point loop counter.
+   * @j: schedule entry value loop counter.
+   * @pidx: packed linear index of a schedule entry.
+   * @stride: grid stride of the current entry value.
+   * @mask: sampling status of each grid point.
+   */
+  int i, j, pidx, stride;
+  char *mask;
+
+  /* release any previously built lists. */
+  hx_sched_free(S);
+
+  /* check that the schedule covers the grid dimensionality. */
+  if (k < 1 || dsched < k || nsched < 1 || !sched)
+    return 0;
+
+  /* store the grid sizes and compute the grid point count. */
+  S->k = k;
+  S->sz = hx_index_copy(k, sz);
+  for (i = 0, S->len = 1; i < k; i++)
+    S->len *= sz[i];
+
+  /* allocate the sampling mask. */
+  mask = (char*) calloc(S->len, sizeof(char));
+
+  /* check that allocation succeeded. */
+  if (!S->sz || !mask) {
+    free(mask);
+    hx_sched_free(S);
+    return 0;
+  }
+
+  /* mark the packed index of each schedule entry. */
+  for (i = 0; i < nsched; i++) {
+    /* pack the entry, checking each value against the grid. */
+    for (j = 0, pidx = 0, stride = 1; j < k; j++) {
+      /* fail on out-of-bounds entry values. */
+      if (sched[i * dsched + j] < 0 || sched[i * dsched + j] >= sz[j]) {
+        free(mask);
+        hx_sched_free(S);
+        return 0;
+      }
+
+      /* add the value into the packed index. */
+      pidx += sched[i * dsched + j] * stride;
+      stride *= sz[j];
+    }
+
+    /* count the entry once. */
+    if (!mask[pidx]) {
+      mask[pidx] = 1;
+      S->n++;
+    }
+  }
+
+  /* allocate the sampled and unsampled index lists. */
+  S->nz = S->len - S->n;
+  S->on = hx_index_alloc(S->n);
+  S->off = hx_index_alloc(S->nz ? S->nz : 1);
+
+  /* check that allocation succeeded. */
+  if (!S->on || !S->off) {
+    free(mask);
+    hx_sched_free(S);
+    return 0;
+  }
+
+  /* scan the mask once to fill both lists in ascending order. */
+  for (i = 0, S->n = S->nz = 0; i < S->len; i++) {
+    if (mask[i])
+      S->on[S->n++] = i;
+    else
+      S->off[S->nz++] = i;
+  }
+
+  /* free the mask and return success. */
+  free(mask);
+  return 1;
+}
+
 /* hx_index_printfn(): core function used by hx_index_print() to write the
  * contents of a multidimensional index to standard error.
  * @k: the array size.
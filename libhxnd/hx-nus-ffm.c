@@ -23,26 +23,526 @@
 /* include the n-dimensional math header. */
 #include <hxnd/hx.h>
 
+/* declare a few fixed constants used during optimization:
+ * @HX_FFM_SEARCH_ITERS: maximum number of slope evaluations made by the
+ *                       line search of each conjugate gradient iteration.
+ * @HX_FFM_SEARCH_TOL: fraction of the initial slope magnitude at which a
+ *                     line search step is accepted.
+ */
+#define HX_FFM_SEARCH_ITERS  4
+#define HX_FFM_SEARCH_TOL    0.1
+
+/* hx_ffm_work: structure definition for the transform definition and
+ * scratch arrays used by each iteration of a fast forward maximum entropy
+ * reconstruction.
+ */
+typedef struct {
+  /* operator definition:
+   * @solver: method used to minimize the entropy.
+   * @dx: array of algebraic transform dimensions.
+   * @kx: array of topological transform dimensions.
+   * @S: schedule index sets of the reconstruction.
+   * @f: entropy functional.
+   * @df: entropy functional derivative.
+   * @alpha: number of points in each trace, which scales inverse
+   *         transforms into adjoint transforms.
+   */
+  enum hx_ffm_solver solver;
+  hx_index dx, kx;
+  hx_sched *S;
+  hx_entropy_functional f, df;
+  real alpha;
+
+  /* one-dimensional transform scalars:
+   * @w: temporary twiddle-factor scalar.
+   * @swp: temporary swap value scalar.
+   */
+  hx_scalar w, swp;
+
+  /* conjugate gradient arrays:
+   * @X: spectral estimate, equal to the transform of the time-domain
+   *     estimate.
+   * @r: negated gradient over the unsampled time-domain points.
+   * @p, @P: time-domain and spectral search directions.
+   * @T: spectral scratch array used during line searches.
+   */
+  hx_array X, r, p, P, T;
+
+  /* conjugate gradient state:
+   * @rr: squared norm of @r.
+   * @t: length of the latest step.
+   */
+  real rr, t;
+
+  /* telemetry:
+   * @clk: phase timer of the current trace.
+   */
+  hx_nus_clock clk;
+}
+hx_ffm_work;
+
+/* hx_ffm_lookup_solver(): return the enumerated ffm solver based on a
+ * specified string representation.
+ * @name: the solver name string.
+ */
+enum hx_ffm_solver hx_ffm_lookup_solver (const char *name) {
+  /* return an undefined solver if the name is null. */
+  if (!name)
+    return HX_FFM_SOLVER_UNDEFINED;
+
+  /* compare the name against each supported solver. */
+  if (strcmp(name, HX_FFM_SOLVER_NAME_SD) == 0)
+    return HX_FFM_SOLVER_SD;
+  else if (strcmp(name, HX_FFM_SOLVER_NAME_CG) == 0)
+    return HX_FFM_SOLVER_CG;
+
+  /* return an undefined solver. */
+  return HX_FFM_SOLVER_UNDEFINED;
+}
+
+/* hx_array_ffm_converged(): check whether a fast forward maximum entropy
+ * reconstruction has converged. the measured points are held fixed, so the
+ * residual criterion is applied to the size of the update made to the
+ * unsampled points, relative to the size of the current estimate.
+ * @stop: pointer to the stopping criteria, which receive the telemetry.
+ * @j: index of the reconstructed trace.
+ * @iter: number of iterations performed on the trace.
+ * @x: current time-domain estimate.
+ * @g: masked gradient used in the latest update.
+ * @S: schedule index sets of the reconstruction.
+ * @alpha: step scale factor of the latest update.
+ * @obj, @objprev: current and previous entropy values.
+ */
+int hx_array_ffm_converged (hx_nus_stop *stop, int j, int iter,
+                            hx_array *x, hx_array *g,
+                            hx_sched *S, real alpha,
+                            real obj, real objprev) {
+  /* declare a few required variables:
+   * @uss: sum of squares of the update.
+   * @xss: sum of squares of the estimate.
+   */
+  real uss, xss;
+
+  /* compute the residual measures, if required. */
+  uss = xss = 0.0;
+  if (stop->rtol > 0.0 || stop->log) {
+    uss = alpha * alpha * hx_nus_sumsq(g, NULL, S->off, S->nz);
+    xss = hx_nus_sumsq(x, NULL, NULL, 0);
+  }
+
+  /* record the update, entropy and step length of the trace. */
+  hx_nus_log_iter(stop, j, iter, uss, xss, obj, alpha);
+
+  /* check the criteria. */
+  return hx_nus_converged(stop, uss, xss, obj, objprev);
+}
+
+/* hx_array_ffm_work_init(): initialize the operator definition and
+ * scratch arrays of a fast forward maximum entropy reconstruction.
+ * @W: pointer to the structure to initialize.
+ * @solver: method used to minimize the entropy.
+ * @dx: array of algebraic transform dimensions.
+ * @kx: array of topological transform dimensions.
+ * @S: schedule index sets of the reconstruction.
+ * @f: entropy functional.
+ * @df: entropy functional derivative.
+ * @alpha: number of points in each trace.
+ */
+void hx_array_ffm_work_init (hx_ffm_work *W, enum hx_ffm_solver solver,
+                             hx_index dx, hx_index kx, hx_sched *S,
+                             hx_entropy_functional f,
+                             hx_entropy_functional df,
+                             real alpha) {
+  /* store the operator definition. */
+  W->solver = solver;
+  W->dx = dx;
+  W->kx = kx;
+  W->S = S;
+  W->f = f;
+  W->df = df;
+  W->alpha = alpha;
+
+  /* initialize the transform scalars. */
+  W->w.x = W->swp.x = NULL;
+
+  /* initialize the conjugate gradient arrays. */
+  hx_array_init(&W->X);
+  hx_array_init(&W->r);
+  hx_array_init(&W->p);
+  hx_array_init(&W->P);
+  hx_array_init(&W->T);
+
+  /* initialize the conjugate gradient state. */
+  W->rr = 0.0;
+  W->t = alpha;
+
+  /* leave the phase timer idle until a trace is started. */
+  W->clk.tm = NULL;
+}
+
+/* hx_array_ffm_work_alloc(): allocate the scratch arrays of a fast forward
+ * maximum entropy reconstruction.
+ * @W: pointer to the initialized structure.
+ * @d: algebraic dimensionality of each trace.
+ * @k: topological dimensionality of each trace.
+ * @sz: sizes of each trace.
+ */
+int hx_array_ffm_work_alloc (hx_ffm_work *W, int d, int k, hx_index sz) {
+  /* allocate the transform scalars. */
+  if (!hx_scalar_alloc(&W->w, d) ||
+      !hx_scalar_alloc(&W->swp, d))
+    throw("failed to allocate temporary %d-scalars", d);
+
+  /* allocate the conjugate gradient arrays, if required. */
+  if (W->solver == HX_FFM_SOLVER_CG &&
+      (!hx_array_alloc(&W->X, d, k, sz) ||
+       !hx_array_alloc(&W->r, d, k, sz) ||
+       !hx_array_alloc(&W->p, d, k, sz) ||
+       !hx_array_alloc(&W->P, d, k, sz) ||
+       !hx_array_alloc(&W->T, d, k, sz)))
+    throw("failed to allocate conjugate gradient arrays");
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_ffm_work_free(): free the scratch arrays of a fast forward
+ * maximum entropy reconstruction.
+ * @W: pointer to the structure to free.
+ */
+void hx_array_ffm_work_free (hx_ffm_work *W) {
+  /* free the transform scalars. */
+  hx_scalar_free(&W->w);
+  hx_scalar_free(&W->swp);
+
+  /* free the conjugate gradient arrays. */
+  hx_array_free(&W->X);
+  hx_array_free(&W->r);
+  hx_array_free(&W->p);
+  hx_array_free(&W->P);
+  hx_array_free(&W->T);
+}
+
+/* hx_array_ffm_xform(): fourier transform every reconstructed dimension of
+ * a trace. one-dimensional traces are transformed on the calling thread.
+ * @W: pointer to the operator definition and scratch arrays.
+ * @g: pointer to the trace to transform in place.
+ * @dir: direction of transformation.
+ */
+int hx_array_ffm_xform (hx_ffm_work *W, hx_array *g, real dir) {
+  /* declare a required variable:
+   * @j: transform dimension loop counter.
+   */
+  int j;
+
+  /* charge the preceding work to the update phase. */
+  hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_UPDATE);
+
+  /* transform one-dimensional traces directly. */
+  if (g->k == 1) {
+    if (!hx_array_fft1d(g, W->dx[1], dir, &W->w, &W->swp))
+      throw("failed to apply fft");
+  }
+  else {
+    /* loop over the sliced dimensions. */
+    for (j = 1; j < g->k; j++) {
+      /* fourier transform the current dimension. */
+      if (!hx_array_fftfn(g, W->dx[j], W->kx[j], dir))
+        throw("failed to apply fft");
+    }
+  }
+
+  /* charge the transform to the fft phase and return success. */
+  hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_FFT);
+  return 1;
+}
+
+/* hx_array_ffm_dot(): compute the real inner product of all coefficients
+ * of two arrays having the same configuration.
+ * @a: first array operand.
+ * @b: second array operand.
+ */
+real hx_array_ffm_dot (hx_array *a, hx_array *b) {
+  /* declare a few required variables:
+   * @i: coefficient loop counter.
+   * @sum: inner product value.
+   */
+  real sum;
+  int i;
+
+  /* sum the coefficient products. */
+  for (i = 0, sum = 0.0; i < a->len; i++)
+    sum += a->x[i] * b->x[i];
+
+  /* return the computed result. */
+  return sum;
+}
+
+/* hx_array_ffm_grad(): compute the negated entropy gradient of a spectral
+ * estimate with respect to the unsampled time-domain points, divided by
+ * the number of points in each trace.
+ * @W: pointer to the operator definition and scratch arrays.
+ * @X: spectral estimate.
+ * @g: output time-domain array.
+ */
+int hx_array_ffm_grad (hx_ffm_work *W, hx_array *X, hx_array *g) {
+  /* declare a few required variables:
+   * @l: sampled point loop counter.
+   * @nbytes: number of bytes per hypercomplex scalar.
+   */
+  int l, nbytes;
+
+  /* compute the gradient of the entropy. */
+  W->df(X->x, g->x, g->n, g->len / g->n);
+
+  /* inverse fourier transform the gradient. */
+  if (!hx_array_ffm_xform(W, g, HX_FFT_REVERSE))
+    throw("failed to inverse transform gradient");
+
+  /* reset the sampled time-domain points in the gradient. */
+  nbytes = g->n * sizeof(real);
+  for (l = 0; l < W->S->n; l++)
+    memset(g->x + g->n * W->S->on[l], 0, nbytes);
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_ffm_sd(): perform one steepest descent iteration of a fast
+ * forward maximum entropy reconstruction, using a fixed step size.
+ * @W: pointer to the operator definition and scratch arrays.
+ * @x: time-domain estimate to update.
+ * @g: output step direction.
+ * @obj: output entropy of the estimate prior to the step, or NULL.
+ */
+int hx_array_ffm_sd (hx_ffm_work *W, hx_array *x, hx_array *g,
+                     real *obj) {
+  /* fourier transform the time-domain estimate. */
+  memcpy(g->x, x->x, x->len * sizeof(real));
+  if (!hx_array_ffm_xform(W, g, HX_FFT_FORWARD))
+    throw("failed to transform estimate");
+
+  /* compute the entropy of the spectral estimate. */
+  if (obj)
+    *obj = hx_entropy_sum_functional(g, W->f);
+
+  /* compute the masked gradient of the entropy. */
+  if (!hx_array_ffm_grad(W, g, g))
+    throw("failed to compute gradient");
+
+  /* update the time-domain estimate. */
+  W->t = W->alpha;
+  if (!hx_array_add_array(x, g, W->t, x))
+    throw("failed to update estimate");
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_ffm_slope(): compute the derivative of the entropy along the
+ * current search direction, at a given distance from the estimate. as
+ * the fourier transform is linear, no transforms are required.
+ * @W: pointer to the operator definition and scratch arrays.
+ * @t: distance along the search direction.
+ */
+real hx_array_ffm_slope (hx_ffm_work *W, real t) {
+  /* compute the spectrum at the requested point. */
+  hx_array_add_array(&W->X, &W->P, t, &W->T);
+
+  /* compute the negated entropy gradient at the point. */
+  W->df(W->T.x, W->T.x, W->T.n, W->T.len / W->T.n);
+
+  /* project the gradient onto the search direction. */
+  return -hx_array_ffm_dot(&W->T, &W->P);
+}
+
+/* hx_array_ffm_search(): find the step length along the current search
+ * direction at which the entropy is approximately minimized, using a few
+ * secant iterations on the derivative of the entropy.
+ * @W: pointer to the operator definition and scratch arrays.
+ * @s0: derivative of the entropy at the current estimate.
+ */
+real hx_array_ffm_search (hx_ffm_work *W, real s0) {
+  /* declare a few required variables:
+   * @i: slope evaluation loop counter.
+   * @ta, @sa: previous step length and slope.
+   * @tb, @sb: current step length and slope.
+   * @tn: next step length.
+   */
+  real ta, sa, tb, sb, tn;
+  int i;
+
+  /* start from the latest step length. */
+  ta = 0.0;
+  sa = s0;
+  tb = (W->t > 0.0 ? W->t : W->alpha);
+
+  /* loop over the slope evaluations. */
+  for (i = 0; i < HX_FFM_SEARCH_ITERS; i++) {
+    /* accept the step once the slope has mostly vanished. */
+    sb = hx_array_ffm_slope(W, tb);
+    if (fabs(sb) <= HX_FFM_SEARCH_TOL * fabs(s0))
+      break;
+
+    /* accept the step if the entropy shows no curvature. */
+    if ((sb - sa) * (tb - ta) <= 0.0)
+      break;
+
+    /* move to the zero of the secant, growing by at most fourfold. */
+    tn = tb - sb * (tb - ta) / (sb - sa);
+    tn = (tn > 4.0 * tb ? 4.0 * tb : tn);
+    tn = (tn > 0.0 ? tn : 0.5 * tb);
+
+    /* store the current step for the next secant. */
+    ta = tb;
+    sa = sb;
+    tb = tn;
+  }
+
+  /* return the final step length. */
+  return tb;
+}
+
+/* hx_array_ffm_cg(): perform one nonlinear conjugate gradient iteration
+ * of a fast forward maximum entropy reconstruction. search directions are
+ * combined using the polak-ribiere formula, restarting from the steepest
+ * descent direction when the combination is not a descent direction.
+ * @W: pointer to the operator definition and scratch arrays.
+ * @x: time-domain estimate to update.
+ * @g: output step direction.
+ * @iiter: iteration index, which is zero for the first iteration.
+ * @obj: output entropy of the estimate prior to the step, or NULL.
+ */
+int hx_array_ffm_cg (hx_ffm_work *W, hx_array *x, hx_array *g,
+                     int iiter, real *obj) {
+  /* declare a few required variables:
+   * @nbytes: number of bytes in each trace.
+   * @rr: squared norm of the new negated gradient.
+   * @beta: conjugate direction update factor.
+   * @s0: derivative of the entropy along the search direction.
+   */
+  real rr, beta, s0;
+  int nbytes;
+
+  /* get the byte count of each trace. */
+  nbytes = x->len * sizeof(real);
+
+  /* transform the estimate on the first iteration. afterwards, the
+   * spectral estimate is updated alongside the time-domain estimate.
+   */
+  if (iiter == 0) {
+    memcpy(W->X.x, x->x, nbytes);
+    if (!hx_array_ffm_xform(W, &W->X, HX_FFT_FORWARD))
+      throw("failed to transform estimate");
+
+    /* reset the search state. */
+    W->rr = 0.0;
+    W->t = W->alpha;
+  }
+
+  /* compute the entropy of the spectral estimate. */
+  if (obj)
+    *obj = hx_entropy_sum_functional(&W->X, W->f);
+
+  /* compute the masked negated gradient. */
+  if (!hx_array_ffm_grad(W, &W->X, g))
+    throw("failed to compute gradient");
+
+  /* compute the polak-ribiere factor, which is never negative. */
+  rr = hx_array_ffm_dot(g, g);
+  beta = (iiter && W->rr > 0.0 ?
+          (rr - hx_array_ffm_dot(g, &W->r)) / W->rr : 0.0);
+  beta = (beta > 0.0 ? beta : 0.0);
+
+  /* store the new negated gradient. */
+  memcpy(W->r.x, g->x, nbytes);
+  W->rr = rr;
+
+  /* combine the negated gradient with the previous search direction. */
+  if (beta > 0.0) {
+    if (!hx_array_add_array(&W->r, &W->p, beta, &W->p))
+      throw("failed to update search direction");
+  }
+  else
+    memcpy(W->p.x, W->r.x, nbytes);
+
+  /* compute the derivative of the entropy along the direction. the
+   * inverse transform is scaled to its adjoint by the point count.
+   */
+  s0 = -W->alpha * hx_array_ffm_dot(&W->r, &W->p);
+
+  /* fall back to steepest descent if the entropy does not decrease along
+   * the combined direction.
+   */
+  if (beta > 0.0 && s0 >= 0.0) {
+    memcpy(W->p.x, W->r.x, nbytes);
+    s0 = -W->alpha * rr;
+  }
+
+  /* do not move from a stationary point. */
+  if (s0 >= 0.0) {
+    hx_array_zero(g);
+    W->t = 0.0;
+    return 1;
+  }
+
+  /* transform the search direction. */
+  memcpy(W->P.x, W->p.x, nbytes);
+  if (!hx_array_ffm_xform(W, &W->P, HX_FFT_FORWARD))
+    throw("failed to transform search direction");
+
+  /* search for the step length along the direction. */
+  W->t = hx_array_ffm_search(W, s0);
+
+  /* update the time-domain and spectral estimates. */
+  if (!hx_array_add_array(x, &W->p, W->t, x) ||
+      !hx_array_add_array(&W->X, &W->P, W->t, &W->X))
+    throw("failed to update estimate");
+
+  /* return the step direction. */
+  memcpy(g->x, W->p.x, nbytes);
+  return 1;
+}
+
+/* hx_array_ffm_iter(): perform one iteration of a fast forward maximum
+ * entropy reconstruction. on return, the update made to the estimate is
+ * the step direction scaled by the step length in the work structure.
+ * @W: pointer to the operator definition and scratch arrays.
+ * @x: time-domain estimate to update.
+ * @g: output step direction.
+ * @iiter: iteration index, which is zero for the first iteration.
+ * @obj: output entropy of the estimate prior to the step, or NULL.
+ */
+int hx_array_ffm_iter (hx_ffm_work *W, hx_array *x, hx_array *g,
+                       int iiter, real *obj) {
+  /* apply the requested method. */
+  if (W->solver == HX_FFM_SOLVER_CG)
+    return hx_array_ffm_cg(W, x, g, iiter, obj);
+
+  /* otherwise, take a fixed steepest descent step. */
+  return hx_array_ffm_sd(W, x, g, obj);
+}
+
 /* hx_array_ffm1d(): perform a set of one-dimensional fast forward
  * maximum entropy reconstructions over a two-dimensional array.
  * see hx_array_ffm() for details.
  */
 int hx_array_ffm1d (hx_array *x, hx_index dx, hx_index kx,
-                    int nsched, hx_index sched, int niter,
+                    hx_sched *S, hx_nus_stop *stop,
                     hx_entropy_functional f,
-                    hx_entropy_functional df) {
+                    hx_entropy_functional df,
+                    enum hx_ffm_solver solver, int warm) {
   /* declare a few required variables:
    * @d: slice algebraic dimension index.
    * @k: slice topological dimension index.
    * @sz: twice the current slice topological size.
    * @ja, @jb, @jmax: skipped iteration control variables.
-   * @nzeros: number of unscheduled elements in @xj.
    * @nbytes: number of bytes per hypercomplex scalar.
-   * @zeros: linear indices of all unscheduled elements in @xj.
    * @alpha: fixed iteration step scale factor.
+   * @nc: number of adjacent traces handed to each thread at once.
    */
   int d, k, sz, ja, jb, jmax;
-  int nbytes;
+  int nbytes, nc;
   real alpha;
 
   /* get the slice dimensionalities. */
@@ -59,28 +559,38 @@ int hx_array_ffm1d (hx_array *x, hx_index dx, hx_index kx,
   /* initialize the skipped iteration control variables. */
   hx_index_jump_init(x->k, x->sz, kx[1], &ja, &jb, &jmax);
 
-  /* create a team of threads to execute multiple parallel reconstructions. */
+  /* allocate the per-trace iteration counts. */
+  if (!hx_nus_stop_alloc(stop, jmax))
+    throw("failed to allocate iteration counts");
+
+  /* determine how many adjacent traces each thread receives at once. */
+  nc = hx_nus_chunk(jmax, warm, omp_get_max_threads());
+
+  /* create a team of threads to execute multiple parallel reconstructions.
+   * traces stop after differing numbers of iterations, so they are handed
+   * out dynamically.
+   */
   #pragma omp parallel
   {
     /* declare a few thread-local variables:
      * @j: array skipped iteration master index.
-     * @l: unscheduled array loop index.
+     * @l: sampled array loop index.
      * @pidx: packed linear array index.
      * @iiter: ffm iteration loop counter.
      * @xj: currently sliced sub-array.
-     * @g: current gradient sub-array.
-     * @w: temporary twiddle-factor scalar.
-     * @swp: temporary swap value scalar.
-     * @beta: conjugate gradient step factor.
+     * @g: current step direction sub-array.
+     * @W: transform definition and scratch arrays.
+     * @obj, @objprev: current and previous entropy values.
      */
     int j, l, pidx, iiter;
-    hx_scalar w, swp;
     hx_array xj, g;
+    hx_ffm_work W;
+    real obj, objprev;
 
-    /* allocate temporary scalars to use in the fft. */
-    if (!hx_scalar_alloc(&w, d) ||
-        !hx_scalar_alloc(&swp, d))
-      raise("failed to allocate temporary %d-scalars", d);
+    /* allocate the iteration scratch space. */
+    hx_array_ffm_work_init(&W, solver, dx, kx, S, f, df, alpha);
+    if (!hx_array_ffm_work_alloc(&W, d, k, &sz))
+      raise("failed to allocate iteration scratch space");
 
     /* allocate the scratch-space arrays. */
     if (!hx_array_alloc(&g, d, k, &sz) ||
@@ -88,49 +598,73 @@ int hx_array_ffm1d (hx_array *x, hx_index dx, hx_index kx,
       raise("failed to allocate temporary (%d, 1)-arrays", d);
 
     /* distribute tasks to the team of threads. */
-    #pragma omp for
+    #pragma omp for schedule(dynamic, nc)
     for (j = 0; j < jmax; j++) {
-      /* compute the linear array index of the current vector. */
-      pidx = hx_index_jump(j, ja, jb);
-
-      /* slice the currently indexed vector from the array. */
-      if (!hx_array_slice_vector(x, &xj, kx[1], pidx))
-        raise("failed to slice vector %d", j);
+      /* start timing the phases of the trace. */
+      hx_nus_clock_start(&W.clk, stop, j);
 
-      /* loop over the iterations. */
-      for (iiter = 0; iiter < niter; iiter++) {
-        /* initialize the gradient vector. */
-        memcpy(g.x, xj.x, xj.len * sizeof(real));
+      /* initialize the objective. */
+      obj = objprev = INFINITY;
 
-        /* fourier transform the time-domain vector. */
-        if (!hx_array_fft1d(&g, dx[1], HX_FFT_FORWARD, &w, &swp))
-          raise("failed to execute forward fft");
-
-        /* compute the gradient of the entropy. */
-        for (l = 0; l < g.len; l += g.n)
-          df(g.x + l, g.x + l, g.n);
+      /* compute the linear array index of the current vector. */
+      pidx = hx_index_jump(j, ja, jb);
 
-        /* inverse fourier transform the gradient vector. */
-        if (!hx_array_fft1d(&g, dx[1], HX_FFT_REVERSE, &w, &swp))
-          raise("failed to execute inverse fft");
+      /* check whether to warm-start from the preceding trace. */
+      if (warm && j % nc) {
+        /* slice the vector and replace only the measured points of the
+         * preceding estimate.
+         */
+        if (!hx_array_slice_vector(x, &g, kx[1], pidx))
+          raise("failed to slice vector %d", j);
 
-        /* reset the sampled time-domain points in the gradient. */
-        for (l = 0; l < nsched; l++)
-          memset(g.x + g.n * sched[l], 0, nbytes);
+        for (l = 0; l < S->n; l++)
+          memcpy(xj.x + xj.n * S->on[l], g.x + g.n * S->on[l], nbytes);
+      }
+      else {
+        /* clear the zero-filled points left by the previous trace, which
+         * would otherwise make the result depend on the trace order.
+         */
+        hx_array_zero(&xj);
+
+        /* slice the currently indexed vector from the array. */
+        if (!hx_array_slice_vector(x, &xj, kx[1], pidx))
+          raise("failed to slice vector %d", j);
+      }
 
+      /* loop over the iterations. */
+      for (iiter = 0; iiter < stop->niter; iiter++) {
         /* update the time-domain vector. */
-        if (!hx_array_add_array(&xj, &g, alpha, &xj))
+        objprev = obj;
+        if (!hx_array_ffm_iter(&W, &xj, &g, iiter,
+                               stop->otol > 0.0 || stop->log ?
+                               &obj : NULL))
           raise("failed to update time-domain vector");
+
+        /* check the relative update and the entropy for convergence. */
+        hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_UPDATE);
+        if (hx_array_ffm_converged(stop, j, iiter + 1, &xj, &g, S, W.t,
+                                   obj, objprev)) {
+          iiter++;
+          break;
+        }
+
+        /* charge the check to the remaining phase. */
+        hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_OTHER);
       }
 
+      /* store the iteration count of the trace. */
+      stop->iters[j] = iiter;
+
       /* store the reconstructed vector back into the array. */
       if (!hx_array_store_vector(x, &xj, kx[1], pidx))
         raise("failed to store vector %d", j);
+
+      /* charge the remaining work of the trace. */
+      hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_OTHER);
     }
 
-    /* free the temporary scalars. */
-    hx_scalar_free(&w);
-    hx_scalar_free(&swp);
+    /* free the iteration scratch space. */
+    hx_array_ffm_work_free(&W);
 
     /* free the scratch-space arrays. */
     hx_array_free(&g);
@@ -143,32 +677,30 @@ int hx_array_ffm1d (hx_array *x, hx_index dx, hx_index kx,
 
 /* hx_array_ffmnd(): perform a set of multidimensional fast forward
  * maximum entropy reconstructions over an array having at least
- * three dimensions.
+ * three dimensions. slices are distributed over a team of threads,
+ * unless there are fewer slices than threads, in which case each slice
+ * is reconstructed in turn using parallel fourier transforms.
  * see hx_array_ffm() for details.
  */
 int hx_array_ffmnd (hx_array *x, hx_index dx, hx_index kx,
-                    int dsched, int nsched, hx_index sched, int niter,
+                    hx_sched *S, hx_nus_stop *stop,
                     hx_entropy_functional f,
-                    hx_entropy_functional df) {
+                    hx_entropy_functional df,
+                    enum hx_ffm_solver solver, int warm) {
   /* declare a few required variables:
    * @sz: size of the temporary arrays.
-   * @lower: slice lower-bound index array.
-   * @upper: slice upper-bound index array.
-   * @iiter: iteration loop counter.
-   */
-  hx_index sz, lower, upper;
-  int i, j, n, d, k, iiter;
-
-  /* @xi: currently sliced sub-array.
-   * @g: current gradient sub-array.
-   */
-  hx_array xi, g;
-
-  /* @nbytes: number of bytes per hypercomplex scalar.
+   * @i: general-purpose loop counter.
+   * @n: number of slices to reconstruct.
+   * @d: number of array algebraic dimensions.
+   * @k: number of array topological dimensions.
+   * @nbytes: number of bytes per hypercomplex scalar.
+   * @par: whether slices are distributed over threads.
+   * @nc: number of adjacent slices handed to each thread at once.
    * @alpha: fixed iteration step scale factor.
    */
+  int i, n, d, k, nbytes, par, nc;
+  hx_index sz;
   real alpha;
-  int nbytes;
 
   /* get the number of reconstructions required. */
   n = x->sz[kx[0]];
@@ -188,87 +720,148 @@ int hx_array_ffmnd (hx_array *x, hx_index dx, hx_index kx,
     throw("failed to allocate %d indices", k);
 
   /* build the slice size array. */
-  for (i = 0, sz[0] = 1; i < k; i++)
+  for (i = 1, sz[0] = 1; i < k; i++)
     sz[i] = 2 * x->sz[kx[i]];
 
-  /* allocate the bounding array indices. */
-  lower = hx_index_alloc(k);
-  upper = hx_index_alloc(k);
+  /* compute the scale factor. */
+  for (i = 1, alpha = 1.0; i < k; i++)
+    alpha *= (real) sz[i];
 
-  /* check that the bounding arrays were allocated. */
-  if (!lower || !upper)
-    throw("failed to allocate bounding arrays");
+  /* allocate the per-trace iteration counts. */
+  if (!hx_nus_stop_alloc(stop, n))
+    throw("failed to allocate iteration counts");
 
-  /* allocate the scratch-space arrays. */
-  if (!hx_array_alloc(&g, d, k, sz) ||
-      !hx_array_alloc(&xi, d, k, sz))
-    throw("failed to allocate temporary (%d, %d)-arrays", d, k);
+  /* determine whether to distribute the slices over threads, and how
+   * many adjacent slices each thread receives at once.
+   */
+  par = (n >= omp_get_max_threads());
+  nc = hx_nus_chunk(n, warm, par ? omp_get_max_threads() : 1);
 
-  /* store the elements of the bounding arrays. */
-  for (i = 1; i < k; i++) {
-    /* store the upper and lower bound. */
-    upper[i] = x->sz[kx[i]] - 1;
-    lower[i] = 0;
-  }
+  /* create a team of threads to reconstruct multiple slices in parallel. */
+  #pragma omp parallel if (par)
+  {
+    /* declare a few required thread-local variables:
+     * @is: slice loop counter.
+     * @j: general-purpose loop counter.
+     * @iiter: iteration loop counter.
+     * @lower: slice lower-bound index array.
+     * @upper: slice upper-bound index array.
+     * @xi: currently sliced sub-array.
+     * @g: current step direction sub-array.
+     * @W: transform definition and scratch arrays.
+     * @obj, @objprev: current and previous entropy values.
+     */
+    int is, j, iiter;
+    hx_index lower, upper;
+    hx_array xi, g;
+    hx_ffm_work W;
+    real obj, objprev;
 
-  /* compute the scale factor. */
-  for (i = 1, alpha = 1.0; i < k; i++)
-    alpha *= (real) sz[i];
+    /* allocate the bounding array indices. */
+    lower = hx_index_alloc(k);
+    upper = hx_index_alloc(k);
+
+    /* check that the bounding arrays were allocated. */
+    if (!lower || !upper)
+      raise("failed to allocate bounding arrays");
 
-  /* loop serially over the slices. */
-  for (i = 0; i < n; i++) {
-    /* store the direct dimension bounds. */
-    upper[0] = i;
-    lower[0] = i;
-
-    /* slice the indirect dimensions from the input array. */
-    if (!hx_array_slice(x, &xi, lower, upper))
-      throw("failed to slice out sub-array %d", i);
-
-    /* loop over the iterations. */
-    for (iiter = 0; iiter < niter; iiter++) {
-      /* initialize the gradient array. */
-      memcpy(g.x, xi.x, xi.len * sizeof(real));
-
-      /* loop over the sliced dimensions. */
-      for (j = 1; j < k; j++) {
-        /* forward fourier transform the slice. */
-        if (!hx_array_fft(&g, dx[j], kx[j]))
-          throw("failed to apply forward fft");
+    /* allocate the iteration scratch space. */
+    hx_array_ffm_work_init(&W, solver, dx, kx, S, f, df, alpha);
+    if (!hx_array_ffm_work_alloc(&W, d, k, sz))
+      raise("failed to allocate iteration scratch space");
+
+    /* allocate the scratch-space arrays. */
+    if (!hx_array_alloc(&g, d, k, sz) ||
+        !hx_array_alloc(&xi, d, k, sz))
+      raise("failed to allocate temporary (%d, %d)-arrays", d, k);
+
+    /* store the elements of the bounding arrays. */
+    for (j = 1; j < k; j++) {
+      /* store the upper and lower bound. */
+      upper[j] = x->sz[kx[j]] - 1;
+      lower[j] = 0;
+    }
+
+    /* distribute the slices to the team of threads. */
+    #pragma omp for schedule(dynamic, nc)
+    for (is = 0; is < n; is++) {
+      /* start timing the phases of the slice. */
+      hx_nus_clock_start(&W.clk, stop, is);
+
+      /* store the direct dimension bounds. */
+      upper[0] = is;
+      lower[0] = is;
+
+      /* check whether to warm-start from the preceding slice. */
+      if (warm && is % nc) {
+        /* slice the indirect dimensions and replace only the measured
+         * points of the preceding estimate.
+         */
+        if (!hx_array_slice(x, &g, lower, upper))
+          raise("failed to slice out sub-array %d", is);
+
+        for (j = 0; j < S->n; j++)
+          memcpy(xi.x + xi.n * S->on[j], g.x + g.n * S->on[j], nbytes);
+      }
+      else {
+        /* clear the zero-filled points left by the previous slice, which
+         * would otherwise make the result depend on the slice order.
+         */
+        hx_array_zero(&xi);
+
+        /* slice the indirect dimensions from the input array. */
+        if (!hx_array_slice(x, &xi, lower, upper))
+          raise("failed to slice out sub-array %d", is);
       }
 
-      /* compute the gradient of the entropy. */
-      for (j = 0; j < g.len; j += g.n)
-        df(g.x + j, g.x + j, g.n);
+      /* initialize the objective. */
+      obj = objprev = INFINITY;
 
-      /* loop over the sliced dimensions. */
-      for (j = 1; j < k; j++) {
-        /* inverse fourier transform the slice. */
-        if (!hx_array_ifft(&g, dx[j], kx[j]))
-          throw("failed to apply forward fft");
+      /* loop over the iterations. */
+      for (iiter = 0; iiter < stop->niter; iiter++) {
+        /* update the time-domain array. */
+        objprev = obj;
+        if (!hx_array_ffm_iter(&W, &xi, &g, iiter,
+                               stop->otol > 0.0 || stop->log ?
+                               &obj : NULL))
+          raise("failed to update time-domain array");
+
+        /* check the relative update and the entropy for convergence. */
+        hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_UPDATE);
+        if (hx_array_ffm_converged(stop, is, iiter + 1, &xi, &g, S, W.t,
+                                   obj, objprev)) {
+          iiter++;
+          break;
+        }
+
+        /* charge the check to the remaining phase. */
+        hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_OTHER);
       }
 
-      /* reset the sampled time-domain points in the gradient */
-      for (j = 0; j < nsched; j++)
-        memset(g.x + g.n * sched[j], 0, nbytes);
+      /* store the iteration count of the slice. */
+      stop->iters[is] = iiter;
 
-      /* update the time-domain vector. */
-      if (!hx_array_add_array(&xi, &g, alpha, &xi))
-        throw("failed to update time-domain array");
+      /* store the reconstructed slice back into the input array. */
+      if (!hx_array_store(x, &xi, lower, upper))
+        raise("failed to store in sub-array %d", is);
+
+      /* charge the remaining work of the slice. */
+      hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_OTHER);
     }
 
-    /* store the reconstructed slice back into the input array. */
-    if (!hx_array_store(x, &xi, lower, upper))
-      throw("failed to store in sub-array %d", i);
-  }
+    /* free the iteration scratch space. */
+    hx_array_ffm_work_free(&W);
 
-  /* free the scratch-space arrays. */
-  hx_array_free(&g);
-  hx_array_free(&xi);
+    /* free the scratch-space arrays. */
+    hx_array_free(&g);
+    hx_array_free(&xi);
 
-  /* free the allocated multidimensional indices. */
-  hx_index_free(lower);
-  hx_index_free(upper);
+    /* free the bounding arrays. */
+    hx_index_free(lower);
+    hx_index_free(upper);
+  }
+
+  /* free the slice size array. */
   hx_index_free(sz);
 
   /* return success. */
@@ -281,49 +874,56 @@ int hx_array_ffmnd (hx_array *x, hx_index dx, hx_index kx,
  * @x: pointer to the array to reconstruct.
  * @dx: array of algebraic dimension indices in @x.
  * @kx: array of topological dimension indices in @x.
- * @dsched: number of reconstruction dimensions.
- * @nsched: number of sampled @dsched-dimensional points.
- * @niter: maximum number of iterations to perform.
+ * @S: schedule index sets over the doubled indirect sizes of @x.
+ * @stop: stopping criteria, which receive the per-trace iteration counts.
  * @type: entropy functional type to utilize..
+ * @solver: method used to minimize the entropy of each trace.
+ * @warm: whether each trace starts from the estimate of the preceding
+ *        trace along the direct dimension. each thread then reconstructs
+ *        one contiguous run of traces.
  */
 int hx_array_ffm (hx_array *x, hx_index dx, hx_index kx,
-                  int dsched, int nsched, hx_index sched,
-                  int niter, enum hx_entropy_type type) {
+                  hx_sched *S, hx_nus_stop *stop,
+                  enum hx_entropy_type type,
+                  enum hx_ffm_solver solver, int warm) {
   /* declare a few required variables:
    * @f: function pointer for the entropy functional.
    * @df: function pointer for the entropy derivative.
+   * @i: dimension loop counter.
    */
   hx_entropy_functional f, df;
+  int i;
+
+  /* ensure the schedule index sets match the array. */
+  if (!S || S->n < 1 || S->k != x->k - 1)
+    throw("invalid schedule configuration");
 
-  /* ensure the schedule is allocated and properly sized. */
-  if (!sched || dsched < 1 || nsched < 1)
-    throw("invalid schedule configuration (%dx%d)", dsched, nsched);
+  /* ensure the schedule grid matches the reconstruction size. */
+  for (i = 1; i < x->k; i++) {
+    if (S->sz[i - 1] != 2 * x->sz[kx[i]])
+      throw("schedule grid mismatch in dimension %d", i);
+  }
 
-  /* ensure the iteration count is in bounds. */
-  if (niter < 1)
-    throw("iteration count %d out of bounds [1,inf)", niter);
+  /* ensure the stopping criteria are in bounds. */
+  if (!hx_nus_stop_check(stop))
+    throw("invalid stopping criteria");
 
   /* retrieve the entropy functional function pointers. */
   if (!hx_entropy_get_functionals(type, &f, &df))
     throw("failed to retrieve entropy functionals");
 
   /* determine which reconstruction function to use. */
-  if (dsched == 1) {
+  if (S->k == 1) {
     /* execute the one-dimensional function. */
-    if (!hx_array_ffm1d(x, dx, kx, nsched, sched, niter, f, df))
+    if (!hx_array_ffm1d(x, dx, kx, S, stop, f, df, solver, warm))
       throw("failed to execute one-dimensional reconstruction");
   }
-  else if (dsched > 1) {
+  else {
     /* execute the multidimensional function. */
-    if (!hx_array_ffmnd(x, dx, kx, dsched, nsched, sched, niter, f, df))
+    if (!hx_array_ffmnd(x, dx, kx, S, stop, f, df, solver, warm))
       throw("failed to execute n-dimensional reconstruction");
   }
-  else {
-    /* throw an exception. */
-    throw("invalid schedule configuration (%dx%d)", dsched, nsched);
-  }
 
   /* return success. */
   return 1;
 }
-
@@ -28,6 +28,62 @@
 #define HX_IRLS_EPSILON     0.0001
 #define HX_IRLS_LAMBDA_MIN  1.0e-3
 #define HX_IRLS_LAMBDA_MAX  1.0e+9
+#define HX_IRLS_CG_TOL      1.0e-6
+#define HX_IRLS_BLOCK       32
+
+/* hx_irls_work: structure definition for the transform operators and
+ * scratch arrays used to solve the weighted least squares problem of each
+ * irls iteration.
+ */
+typedef struct {
+  /* operator definition:
+   * @solver: linear solver applied to the normal equations.
+   * @k: number of array topological dimensions.
+   * @dx: array of algebraic transform dimensions.
+   * @kx: array of topological transform dimensions.
+   * @sched: packed scheduled indices within each slice.
+   */
+  enum hx_irls_solver solver;
+  int k;
+  hx_index dx, kx, sched;
+
+  /* dense solver arrays:
+   * @F: discrete Fourier transform matrix, shared between threads.
+   * @A: regression coefficient matrix.
+   */
+  hx_array F, A;
+
+  /* matrix-free solver arrays:
+   * @T: complete frequency-domain scratch array.
+   * @r, @p, @q: conjugate gradient residual, direction and product.
+   */
+  hx_array T, r, p, q;
+
+  /* telemetry:
+   * @clk: phase timer of the current slice.
+   */
+  hx_nus_clock clk;
+}
+hx_irls_work;
+
+/* hx_irls_lookup_solver(): return the enumerated irls linear solver
+ * based on a specified string representation.
+ * @name: the linear solver name string.
+ */
+enum hx_irls_solver hx_irls_lookup_solver (const char *name) {
+  /* return an undefined solver if the name is null. */
+  if (!name)
+    return HX_IRLS_SOLVER_UNDEFINED;
+
+  /* compare the name against each supported solver. */
+  if (strcmp(name, HX_IRLS_SOLVER_NAME_CHOLESKY) == 0)
+    return HX_IRLS_SOLVER_CHOLESKY;
+  else if (strcmp(name, HX_IRLS_SOLVER_NAME_CG) == 0)
+    return HX_IRLS_SOLVER_CG;
+
+  /* return an undefined solver. */
+  return HX_IRLS_SOLVER_UNDEFINED;
+}
 
 /* hx_array_irls_dftmatrix(): compute the matrix form of the multidimensional
  * inverse discrete Fourier transform (IDFT) matrix of a nonuniformly sampled
@@ -180,7 +236,7 @@ int hx_array_irls_dft (hx_array *F, hx_array *X, hx_array *x, real dir) {
     hx_array_zero(X);
 
     /* create a team of threads to compute each inner product. */
-    #pragma omp parallel private(i, k, idxf)
+    #pragma omp parallel private(i, k, idxf) if (!omp_in_parallel())
     {
       /* declare a few required thread-local variables:
        * @Fh: conjugated copy of the current matrix element.
@@ -219,7 +275,7 @@ int hx_array_irls_dft (hx_array *F, hx_array *X, hx_array *x, real dir) {
     hx_array_zero(x);
 
     /* loop over the transform inner products. */
-    #pragma omp parallel for private(i, k, idxf)
+    #pragma omp parallel for private(i, k, idxf) if (!omp_in_parallel())
     for (i = 0; i < n; i++) {
       /* loop over the inner product terms. */
       for (k = 0; k < N; k++) {
@@ -272,9 +328,12 @@ int hx_array_irls_reweight (hx_array *X, hx_array *w, real p) {
  * @x: vector of time-domain acquired values.
  * @z: vector of time-domain estimated values.
  * @w: vector of real weights.
+ * @rss: pointer to the output sum of squared residuals.
+ * @obj: pointer to the output value of the minimized objective.
  */
 int hx_array_irls_sumsq (hx_array *X, hx_array *x,
-                         hx_array *z, hx_array *w) {
+                         hx_array *z, hx_array *w,
+                         real *rss, real *obj) {
   /* declare a few required variables:
    * @rx: sum of squares of the residuals.
    * @wx: sum of squares of the weighted spectrum.
@@ -316,6 +375,10 @@ int hx_array_irls_sumsq (hx_array *X, hx_array *x,
   if (lambda > HX_IRLS_LAMBDA_MAX)
     lambda = HX_IRLS_LAMBDA_MAX;
 
+  /* store the residual and the balanced objective. */
+  *rss = rx;
+  *obj = rx + lambda * wx;
+
   /* scale the vector of weights by the lagrange multiplier and then
    * invert the vector element such that the weight vector contains
    * diag(inv(W)).
@@ -351,7 +414,7 @@ int hx_array_irls_gramian (hx_array *F, hx_array *w, hx_array *A) {
   hx_array_zero(A);
 
   /* create a team of threads to compute matrix elements in parallel. */
-  #pragma omp parallel
+  #pragma omp parallel if (!omp_in_parallel())
   {
     /* declare a few required thread-local variables:
      * @i, @j, @k: matrix-matrix product loop counters.
@@ -407,92 +470,178 @@ int hx_array_irls_gramian (hx_array *F, hx_array *w, hx_array *A) {
   return 1;
 }
 
-/* hx_array_irls_solve(): solve the linear system of equations,
- *   A * x = L * L^T * x = b
+/* hx_array_irls_axpy(): subtract the product of one column of a lower
+ * triangular factor and the conjugate of one of its elements from a
+ * second column, over a range of rows,
+ *   A(i,j) -= L(i,k) * conj(L(j,k)),  i = i0 .. n-1
+ * the diagonal element, when included, only receives the real norm.
+ * @A: square matrix holding both columns.
+ * @j: index of the updated column.
+ * @k: index of the factor column.
+ * @i0: first updated row index.
+ * @Lh: preallocated hypercomplex scalar.
  */
-int hx_array_irls_solve (hx_array *A, hx_array *x, hx_array *b) {
+void hx_array_irls_axpy (hx_array *A, int j, int k, int i0, hx_scalar *Lh) {
   /* declare a few required variables:
+   * @i: row loop counter.
+   * @n: number of matrix rows.
+   * @Lnrm: norm of the conjugated factor element.
+   * @pa, @pl: coefficient pointers of the updated and factor columns.
    */
-  int i, j, k, n, idxjj;
-  hx_scalar tmp, Lh;
-  real Anrm, diag;
+  real Lnrm, *pa, *pl;
+  int i, n;
 
   /* store the problem size locally. */
   n = A->sz[0];
 
-  /* allocate the temporary substitution scalar. */
-  if (!hx_scalar_alloc(&tmp, A->d) ||
-      !hx_scalar_alloc(&Lh, A->d))
-    throw("failed to allocate temporary %d-scalars", A->d);
+  /* build the negated conjugate of the factor element. */
+  hx_data_conj(A->x + (j + k * n) * A->n, Lh->x, A->n);
+  hx_data_add(NULL, Lh->x, Lh->x, -1.0, A->d, A->n);
 
-  /* loop serially over the rows of the matrix. */
-  for (j = idxjj = 0; j < n; j++, idxjj += A->n * (n + 1)) {
-    /* initialize the value of the new diagonal. */
-    diag = A->x[idxjj];
-
-    /* loop to compute the new diagonal element. */
-    for (k = 0; k < j; k++) {
-      /* compute the norm of the preceeding off-diagonals. */
-      Anrm = hx_data_real_norm(A->x + (j + k * n) * A->n, A->n);
-      diag -= Anrm * Anrm;
-    }
+  /* update the real diagonal element, if included. */
+  if (i0 == j) {
+    Lnrm = hx_data_real_norm(Lh->x, Lh->n);
+    A->x[(j + j * n) * A->n] -= Lnrm * Lnrm;
+    i0++;
+  }
 
-    /* ensure the new diagonal element is positive. */
-    if (diag <= 0.0)
-      throw("pivot %d is %.3le", j, diag);
+  /* locate the first updated coefficients of each column. */
+  pa = A->x + (i0 + j * n) * A->n;
+  pl = A->x + (i0 + k * n) * A->n;
 
-    /* store the newly computed diagonal element. */
-    hx_data_zero(A->x + idxjj, A->n);
-    A->x[idxjj] = sqrt(diag);
-    diag = A->x[idxjj];
+  /* update the remaining column elements. */
+  for (i = i0; i < n; i++, pa += A->n, pl += A->n)
+    hx_data_mul(pl, Lh->x, pa, A->d, A->n, A->tbl);
+}
 
-    /* create a team of threads to execute the inner loop. */
-    #pragma omp parallel private(i, k)
-    {
-      /* declare a few required variables:
-       * @sum: temporary hypercomplex summand.
-       * @Ah: conjugated matrix element.
-       */
-      int idxij, idxik, idxjk;
-      hx_scalar sum, Ah;
+/* hx_array_irls_chol(): compute the lower triangular cholesky factor of a
+ * hermitian positive definite matrix in place, using a right-looking
+ * blocked factorization. each panel of columns is factored by a single
+ * thread, and the trailing submatrix is then updated by the whole team,
+ * with every update running down contiguous matrix columns.
+ * @A: matrix to factor, whose lower triangle receives the factor.
+ */
+int hx_array_irls_chol (hx_array *A) {
+  /* declare a few required variables:
+   * @n: number of matrix rows and columns.
+   * @piv: index of the first non-positive pivot, or -1.
+   * @pval: value of the first non-positive pivot.
+   */
+  int n, piv;
+  real pval;
 
-      /* allocate the temporary scalars. */
-      if (!hx_scalar_alloc(&sum, A->d) ||
-          !hx_scalar_alloc(&Ah, A->d))
-        raise("failed to allocate %d-scalars", A->d);
+  /* store the problem size locally. */
+  n = A->sz[0];
+  piv = -1;
+  pval = 0.0;
 
-      /* loop over the elements of the column update. */
-      #pragma omp for
-      for (i = j + 1; i < n; i++) {
-        /* build the output matrix element index. */
-        idxij = (i + j * n) * A->n;
+  /* create a team of threads to factor the matrix. factorizations
+   * requested from within an active team run on the calling thread.
+   */
+  #pragma omp parallel if (!omp_in_parallel())
+  {
+    /* declare a few required thread-local variables:
+     * @jb: first column of the current panel.
+     * @je: first column after the current panel.
+     * @i, @j, @k: matrix element loop counters.
+     * @diag: current pivot value.
+     * @Lh: negated conjugate factor element.
+     */
+    int i, j, k, jb, je;
+    hx_scalar Lh;
+    real diag;
+
+    /* allocate the temporary scalar. */
+    if (!hx_scalar_alloc(&Lh, A->d))
+      raise("failed to allocate %d-scalar", A->d);
+
+    /* loop over the column panels. */
+    for (jb = 0; jb < n; jb = je) {
+      /* compute the end of the current panel. */
+      je = (jb + HX_IRLS_BLOCK < n ? jb + HX_IRLS_BLOCK : n);
+
+      /* factor the current panel on a single thread. */
+      #pragma omp single
+      {
+        /* loop over the panel columns. */
+        for (j = jb; j < je && piv < 0; j++) {
+          /* apply the preceding panel columns. */
+          for (k = jb; k < j; k++)
+            hx_array_irls_axpy(A, j, k, j, &Lh);
+
+          /* check that the new pivot is positive. */
+          diag = A->x[(j + j * n) * A->n];
+          if (diag <= 0.0) {
+            piv = j;
+            pval = diag;
+            break;
+          }
+
+          /* store the new diagonal element. */
+          diag = sqrt(diag);
+          hx_data_zero(A->x + (j + j * n) * A->n, A->n);
+          A->x[(j + j * n) * A->n] = diag;
+
+          /* scale the column below the diagonal. */
+          for (i = j + 1; i < n; i++)
+            hx_data_add(NULL, A->x + (i + j * n) * A->n,
+                        A->x + (i + j * n) * A->n,
+                        1.0 / diag, A->d, A->n);
+        }
+      }
 
-        /* initialize the sum of the off-diagonals. */
-        hx_scalar_zero(&sum);
+      /* stop if the panel was not positive definite. */
+      if (piv >= 0)
+        break;
 
-        /* compute the sum of the off-diagonals. */
-        for (k = 0; k < j; k++) {
-          /* build the two required matrix coefficient indices. */
-          idxik = (i + k * n) * A->n;
-          idxjk = (j + k * n) * A->n;
+      /* update the trailing submatrix by the factored panel. */
+      #pragma omp for schedule(dynamic)
+      for (j = je; j < n; j++) {
+        for (k = jb; k < je; k++)
+          hx_array_irls_axpy(A, j, k, j, &Lh);
+      }
+    }
 
-          /* copy-conjugate the second matrix element. */
-          hx_data_conj(A->x + idxjk, Ah.x, Ah.n);
+    /* free the temporary scalar. */
+    hx_scalar_free(&Lh);
+  }
 
-          /* compute the current product term. */
-          hx_data_mul(A->x + idxik, Ah.x, sum.x, sum.d, sum.n, sum.tbl);
-        }
+  /* ensure the matrix was positive definite. */
+  if (piv >= 0)
+    throw("pivot %d is %.3le", piv, pval);
 
-        /* compute the final matrix element. */
-        hx_data_add(A->x + idxij, sum.x, A->x + idxij, -1.0, A->d, A->n);
-        hx_data_add(NULL, A->x + idxij, A->x + idxij, 1.0 / diag, A->d, A->n);
-      }
+  /* return success. */
+  return 1;
+}
 
-      /* free the allocated scalars. */
-      hx_scalar_free(&sum);
-      hx_scalar_free(&Ah);
-    }
-  }
+/* hx_array_irls_solve(): solve the linear system of equations,
+ *   A * x = L * L^H * x = b
+ * @A: hermitian positive definite matrix, which receives its factor.
+ * @x: output solution vector.
+ * @b: right-hand side vector.
+ */
+int hx_array_irls_solve (hx_array *A, hx_array *x, hx_array *b) {
+  /* declare a few required variables:
+   * @j, @k: substitution loop counters.
+   * @n: number of matrix rows and columns.
+   * @idxjj: coefficient index of the current diagonal element.
+   * @tmp: temporary substitution sum.
+   * @Lh: conjugated factor element.
+   */
+  int j, k, n, idxjj;
+  hx_scalar tmp, Lh;
+
+  /* store the problem size locally. */
+  n = A->sz[0];
+
+  /* allocate the temporary substitution scalar. */
+  if (!hx_scalar_alloc(&tmp, A->d) ||
+      !hx_scalar_alloc(&Lh, A->d))
+    throw("failed to allocate temporary %d-scalars", A->d);
+
+  /* decompose the matrix into its cholesky factor. */
+  if (!hx_array_irls_chol(A))
+    throw("failed to factor linear system");
 
   /* initialize the output vector. */
   hx_array_zero(x);
@@ -562,39 +711,308 @@ int hx_array_irls_weight_spect (hx_array *X, hx_array *w) {
   return 1;
 }
 
+/* hx_array_irls_fft(): compute the discrete Fourier transform, or its
+ * inverse, between a nonuniformly sampled time-domain array and a
+ * complete frequency-domain array using zero-filled fast Fourier
+ * transforms. the result equals that of hx_array_irls_dft().
+ * @W: pointer to the irls operators and scratch arrays.
+ * @X: vector of frequency-domain values.
+ * @z: vector of time-domain values.
+ * @dir: transform direction.
+ */
+int hx_array_irls_fft (hx_irls_work *W, hx_array *X, hx_array *z,
+                       real dir) {
+  /* declare a few required variables:
+   * @i: scheduled point loop counter.
+   * @j: transform dimension loop counter.
+   * @n: number of scheduled time-domain points.
+   * @scale: square root of the number of frequency-domain points.
+   */
+  int i, j, n;
+  real scale;
+
+  /* compute the point count and the unitary transform scale. */
+  n = z->len / z->n;
+  scale = sqrt((real) (X->len / X->n));
+
+  /* determine the transform direction. */
+  if (dir == HX_FFT_FORWARD) {
+    /* zero-fill the scheduled points into the frequency-domain array. */
+    hx_array_zero(X);
+    for (i = 0; i < n; i++)
+      hx_data_copy(z->x + i * z->n, X->x + W->sched[i] * X->n, X->n);
+
+    /* forward fourier transform each sliced dimension. */
+    for (j = 1; j < W->k; j++) {
+      if (!hx_array_fft(X, W->dx[j], W->kx[j]))
+        throw("failed to apply forward fft");
+    }
+
+    /* scale the transformed values. */
+    if (!hx_array_scale(X, 1.0 / scale, X))
+      throw("failed to scale forward fft");
+  }
+  else {
+    /* copy the frequency-domain values into the scratch array. */
+    if (!hx_data_copy(X->x, W->T.x, X->len))
+      throw("failed to copy frequency-domain vector");
+
+    /* inverse fourier transform each sliced dimension. */
+    for (j = 1; j < W->k; j++) {
+      if (!hx_array_ifft(&W->T, W->dx[j], W->kx[j]))
+        throw("failed to apply inverse fft");
+    }
+
+    /* gather and scale the scheduled points. */
+    for (i = 0; i < n; i++)
+      hx_data_add(NULL, W->T.x + W->sched[i] * W->T.n, z->x + i * z->n,
+                  scale, z->d, z->n);
+  }
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_irls_xform(): compute the discrete Fourier transform, or its
+ * inverse, using the operator form required by the linear solver.
+ * @W: pointer to the irls operators and scratch arrays.
+ * @X: vector of frequency-domain values.
+ * @z: vector of time-domain values.
+ * @dir: transform direction.
+ */
+int hx_array_irls_xform (hx_irls_work *W, hx_array *X, hx_array *z,
+                         real dir) {
+  /* use fast transforms for the matrix-free solver. */
+  if (W->solver == HX_IRLS_SOLVER_CG)
+    return hx_array_irls_fft(W, X, z, dir);
+
+  /* otherwise, apply the dense transform matrix. */
+  return hx_array_irls_dft(&W->F, X, z, dir);
+}
+
+/* hx_array_irls_normal(): apply the regression coefficient matrix to a
+ * time-domain vector without forming the matrix,
+ *   q = (F * inv(W) * F^H + I) * p
+ * @W: pointer to the irls operators and scratch arrays.
+ * @w: vector of (inverted) weights.
+ * @p: input time-domain vector.
+ * @q: output time-domain vector.
+ */
+int hx_array_irls_normal (hx_irls_work *W, hx_array *w,
+                          hx_array *p, hx_array *q) {
+  /* declare a few required variables:
+   * @i: scheduled point loop counter.
+   * @j: transform dimension loop counter.
+   * @n: number of scheduled time-domain points.
+   */
+  int i, j, n;
+
+  /* zero-fill the scheduled points into the scratch array. */
+  n = p->len / p->n;
+  hx_array_zero(&W->T);
+  for (i = 0; i < n; i++)
+    hx_data_copy(p->x + i * p->n, W->T.x + W->sched[i] * W->T.n, p->n);
+
+  /* forward fourier transform each sliced dimension. the unitary scale
+   * factors of the forward and inverse transforms cancel.
+   */
+  for (j = 1; j < W->k; j++) {
+    if (!hx_array_fft(&W->T, W->dx[j], W->kx[j]))
+      throw("failed to apply forward fft");
+  }
+
+  /* weight the frequency-domain values. */
+  hx_array_irls_weight_spect(&W->T, w);
+
+  /* inverse fourier transform each sliced dimension. */
+  for (j = 1; j < W->k; j++) {
+    if (!hx_array_ifft(&W->T, W->dx[j], W->kx[j]))
+      throw("failed to apply inverse fft");
+  }
+
+  /* gather the scheduled points and add the identity term. */
+  for (i = 0; i < n; i++)
+    hx_data_add(p->x + i * p->n, W->T.x + W->sched[i] * W->T.n,
+                q->x + i * q->n, 1.0, q->d, q->n);
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_irls_dot(): compute the real inner product of all coefficients
+ * of two arrays having the same configuration.
+ * @a: first array operand.
+ * @b: second array operand.
+ */
+real hx_array_irls_dot (hx_array *a, hx_array *b) {
+  /* declare a few required variables:
+   * @i: coefficient loop counter.
+   * @sum: inner product value.
+   */
+  real sum;
+  int i;
+
+  /* sum the coefficient products. */
+  for (i = 0, sum = 0.0; i < a->len; i++)
+    sum += a->x[i] * b->x[i];
+
+  /* return the computed result. */
+  return sum;
+}
+
+/* hx_array_irls_cg(): solve the linear system of equations,
+ *   (F * inv(W) * F^H + I) * z = x
+ * by conjugate gradients. the regression coefficient matrix is symmetric
+ * positive definite when hypercomplex vectors are treated as real vectors
+ * of their coefficients.
+ * @W: pointer to the irls operators and scratch arrays.
+ * @w: vector of (inverted) weights.
+ * @z: vector holding the initial guess and receiving the solution.
+ * @x: vector of time-domain acquired values.
+ */
+int hx_array_irls_cg (hx_irls_work *W, hx_array *w,
+                      hx_array *z, hx_array *x) {
+  /* declare a few required variables:
+   * @it: iteration loop counter.
+   * @bb: sum of squares of the right-hand side.
+   * @rr, @rrprev: current and previous residual sums of squares.
+   * @alpha: step length along the search direction.
+   */
+  real bb, rr, rrprev, alpha;
+  int it;
+
+  /* compute the initial residual and search direction. */
+  if (!hx_array_irls_normal(W, w, z, &W->q) ||
+      !hx_data_add(x->x, W->q.x, W->r.x, -1.0, 0, x->len) ||
+      !hx_blas_copy(&W->r, &W->p))
+    throw("failed to compute initial residual");
+
+  /* compute the initial sums of squares. */
+  bb = hx_nus_sumsq(x, NULL, NULL, 0);
+  rr = hx_nus_sumsq(&W->r, NULL, NULL, 0);
+
+  /* iterate until the relative residual norm is small enough. the
+   * iteration count never exceeds the number of unknowns.
+   */
+  for (it = 0; it < x->len && rr > HX_IRLS_CG_TOL * HX_IRLS_CG_TOL * bb;
+       it++) {
+    /* apply the coefficient matrix to the search direction. */
+    if (!hx_array_irls_normal(W, w, &W->p, &W->q))
+      throw("failed to apply coefficient matrix");
+
+    /* compute the step length, which only fails to be positive once the
+     * residual has vanished into roundoff.
+     */
+    alpha = hx_array_irls_dot(&W->p, &W->q);
+    if (alpha <= 0.0)
+      break;
+
+    /* update the solution and the residual. */
+    alpha = rr / alpha;
+    hx_blas_axpy(alpha, &W->p, z);
+    hx_blas_axpy(-alpha, &W->q, &W->r);
+
+    /* compute the new residual sum of squares. */
+    rrprev = rr;
+    rr = hx_nus_sumsq(&W->r, NULL, NULL, 0);
+
+    /* compute the new search direction. */
+    hx_blas_scal(rr / rrprev, &W->p);
+    hx_blas_axpy(1.0, &W->r, &W->p);
+  }
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_array_irls_update(): solve for the new time-domain regression
+ * solution using the requested linear solver.
+ * @W: pointer to the irls operators and scratch arrays.
+ * @w: vector of (inverted) weights.
+ * @z: vector of time-domain estimates, which receives the solution.
+ * @x: vector of time-domain acquired values.
+ */
+int hx_array_irls_update (hx_irls_work *W, hx_array *w,
+                          hx_array *z, hx_array *x) {
+  /* check if the matrix-free solver was requested. */
+  if (W->solver == HX_IRLS_SOLVER_CG) {
+    /* the solution z satisfies x - z = F * inv(W) * F^H * z, so the
+     * residual of the previous estimate is a close initial guess.
+     */
+    if (!hx_data_add(x->x, z->x, z->x, -1.0, 0, x->len))
+      throw("failed to compute initial guess");
+
+    /* solve the linear system by conjugate gradients. */
+    if (!hx_array_irls_cg(W, w, z, x))
+      throw("failed to solve linear system");
+
+    /* return success. */
+    return 1;
+  }
+
+  /* compute the regression coefficient matrix. */
+  if (!hx_array_irls_gramian(&W->F, w, &W->A))
+    throw("failed to compute gram matrix");
+
+  /* decompose the design matrix and solve for the time-domain vector. */
+  if (!hx_array_irls_solve(&W->A, z, x))
+    throw("failed to solve linear system");
+
+  /* return success. */
+  return 1;
+}
+
 /* hx_array_irlsfn(): compute a single irls reconstruction.
- * @F: matrix of Fourier coefficients.
+ * @W: pointer to the irls operators and scratch arrays.
  * @X: vector of frequency-domain spectral estimates.
  * @x: vector of time-domain acquired values.
  * @w: vector of real spectral weights.
  * @z: vector of time-domain estimates.
- * @A: hermitian positive definite array of regression factors.
- * @niter, @pa, @pb: see hx_array_irls().
+ * @X0: initial spectral estimate, or NULL to start from the transform
+ *       of the acquired values.
+ * @stop, @pa, @pb: see hx_array_irls().
+ * @is: index of the slice, which receives its iteration count and
+ *      telemetry in @stop.
  */
-int hx_array_irlsfn (hx_array *F, hx_array *X, hx_array *x,
-                     hx_array *w, hx_array *z, hx_array *A,
-                     int niter, real pa, real pb) {
+int hx_array_irlsfn (hx_irls_work *W, hx_array *X, hx_array *x,
+                     hx_array *w, hx_array *z,
+                     hx_array *X0, hx_nus_stop *stop,
+                     real pa, real pb, int is) {
   /* declare a few required variables:
    * @p: current iteration norm p-value.
    * @dp: change in p-value per iteration.
    * @iiter: iteration loop counter.
+   * @xss: sum of squared measured values.
+   * @rss: sum of squared residuals of the current estimate.
+   * @obj, @objprev: current and previous objective values.
    */
-  real p, dp;
+  real p, dp, xss, rss, obj, objprev;
   int iiter;
 
   /* compute the change in norm p-value per iteration. */
-  dp = (pb - pa) / (real) niter;
+  dp = (pb - pa) / (real) stop->niter;
 
-  /* compute the initial spectral estimate. */
-  if (!hx_array_irls_dft(F, X, x, HX_FFT_FORWARD))
+  /* compute the norm of the measured values. */
+  xss = hx_nus_sumsq(x, NULL, NULL, 0);
+  objprev = INFINITY;
+
+  /* compute the initial spectral estimate, or copy it if provided. */
+  if (X0) {
+    if (!hx_data_copy(X0->x, X->x, X->len))
+      throw("failed to copy initial spectral estimate");
+  }
+  else if (!hx_array_irls_xform(W, X, x, HX_FFT_FORWARD))
     throw("failed to compute initial dft");
 
   /* store the initial time-domain estimate. */
   if (!hx_data_copy(x->x, z->x, x->len))
     throw("failed to initialize time-domain vector");
 
+  /* charge the initial estimate to the fft phase. */
+  hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_FFT);
+
   /* loop over the reconstruction iterations. */
-  for (iiter = 0; iiter < niter; iiter++) {
+  for (iiter = 0; iiter < stop->niter; iiter++) {
     /* compute the current norm p-value. */
     p = pa + (real) iiter * dp;
 
@@ -603,28 +1021,62 @@ int hx_array_irlsfn (hx_array *F, hx_array *X, hx_array *x,
       throw("failed to compute new weights");
 
     /* adjust the weights to equalize the terms of the minimization. */
-    if (!hx_array_irls_sumsq(X, x, z, w))
+    if (!hx_array_irls_sumsq(X, x, z, w, &rss, &obj))
       throw("failed to adjust new weights");
 
-    /* compute the regression coefficient matrix. */
-    if (!hx_array_irls_gramian(F, w, A))
-      throw("failed to compute gram matrix");
+    /* record the estimate and charge the reweighting to its phase. */
+    hx_nus_log_iter(stop, is, iiter, rss, xss, obj, p);
+    hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_UPDATE);
 
-    /* decompose the design matrix and solve for the time-domain vector. */
-    if (!hx_array_irls_solve(A, z, x))
-      throw("failed to solve linear system");
+    /* check the current estimate for convergence. the initial estimate
+     * reproduces the measured values, and is never accepted.
+     */
+    if (iiter && hx_nus_converged(stop, rss, xss, obj, objprev))
+      break;
+
+    /* store the objective for the next check. */
+    objprev = obj;
+
+    /* solve for the new time-domain regression solution. */
+    if (!hx_array_irls_update(W, w, z, x))
+      throw("failed to solve for time-domain vector");
+
+    /* charge the linear solve to its phase. */
+    hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_SOLVE);
 
     /* compute the unweighted frequency-domain estimate. */
-    if (!hx_array_irls_dft(F, X, z, HX_FFT_FORWARD))
+    if (!hx_array_irls_xform(W, X, z, HX_FFT_FORWARD))
       throw("failed to compute forward dft");
+    hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_FFT);
 
     /* weight the spectral estimate. */
     if (!hx_array_irls_weight_spect(X, w))
       throw("failed to weight spectral estimate");
+    hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_UPDATE);
 
     /* compute the new time-domain estimate. */
-    if (!hx_array_irls_dft(F, X, z, HX_FFT_REVERSE))
+    if (!hx_array_irls_xform(W, X, z, HX_FFT_REVERSE))
       throw("failed to compute inverse dft");
+
+    /* charge the inverse transform to its phase. */
+    hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_FFT);
+  }
+
+  /* store the iteration count. */
+  stop->iters[is] = iiter;
+
+  /* record the final estimate of slices that reached the limit, whose
+   * weights are no longer required.
+   */
+  if (stop->log && iiter == stop->niter) {
+    p = pa + (real) iiter * dp;
+    if (!hx_array_irls_reweight(X, w, p) ||
+        !hx_array_irls_sumsq(X, x, z, w, &rss, &obj))
+      throw("failed to measure final estimate");
+
+    /* record the estimate and charge it to the update phase. */
+    hx_nus_log_iter(stop, is, iiter, rss, xss, obj, p);
+    hx_nus_clock_lap(&W->clk, HX_NUS_PHASE_UPDATE);
   }
 
   /* return success. */
@@ -637,47 +1089,62 @@ int hx_array_irlsfn (hx_array *F, hx_array *X, hx_array *x,
  * @x: pointer to the array to reconstruct.
  * @dx: array of algebraic dimension indices in @x.
  * @kx: array of topological dimension indices in @x.
- * @dsched: number of reconstruction dimensions.
- * @nsched: number of sampled @dsched-dimensional points.
- * @niter: number of iterations to perform.
+ * @S: schedule index sets over the doubled indirect sizes of @x.
+ * @stop: stopping criteria, which receive the per-trace iteration counts.
+ *        the norm p-value schedule spans the maximum iteration count.
  * @pa: starting norm p-value.
  * @pb: ending norm p-value.
+ * @solver: linear solver used in each iteration. the cholesky solver
+ *          forms dense transform and regression matrices, while the
+ *          conjugate gradient solver applies them using fast transforms.
+ * @warm: whether each slice starts from the spectral estimate, and thus
+ *        the weights, of the preceding slice along the direct dimension.
+ *        each thread then reconstructs one contiguous run of slices.
+ *
+ * slices are distributed over a team of threads, each holding its own
+ * regression matrix and vectors while sharing the transform matrix,
+ * unless there are fewer slices than threads, in which case each slice
+ * is reconstructed in turn using parallel matrix operations.
  */
 int hx_array_irls (hx_array *x, hx_index dx, hx_index kx,
-                   int dsched, int nsched, hx_index sched,
-                   int niter, real pa, real pb) {
+                   hx_sched *S, hx_nus_stop *stop, real pa, real pb,
+                   enum hx_irls_solver solver, int warm) {
   /* declare a few required variables:
    * @Asz: size index of the regression coefficient matrix.
    * @sz: size of each slice to be reconstructed.
+   * @idx: unpacked schedule index within each slice.
    * @xsched: array of packed schedule indices within @x.
-   * @ysched: array of packed schedule indices within @y.
-   * @lower: reconstruction slice lower bound index.
-   * @upper: reconstruction slice upper bound index.
-   * @A: regression coefficient matrix.
-   * @F: discrete Fourier transform matrix.
-   * @Y: spectral estimate vector.
-   * @y: time-domain data vector.
-   * @w: real spectral weight vector.
-   * @z: time-domain estimate vector.
+   * @F: discrete Fourier transform matrix shared by all slices.
    * @d: number of array/slice algebraic dimensions.
    * @k: number of array/slice topological dimensions.
    * @i: general purpose loop counter.
-   * @is: loop counter of reconstruction slices.
    * @ns: number of slices to reconstruct.
    * @n: total number of sampled time-domain points per slice.
    * @N: total number of frequency-domain points per slice.
+   * @par: whether slices are distributed over threads.
+   * @nc: number of adjacent slices handed to each thread at once.
    */
-  hx_index Asz, sz, xsched, ysched, lower, upper;
-  hx_array A, F, Y, y, w, z;
-  int d, k, i, is, ns, n, N;
-
-  /* ensure the schedule is allocated and properly sized. */
-  if (!sched || dsched < 1 || nsched < 1)
-    throw("invalid schedule configuration (%dx%d)", dsched, nsched);
+  hx_index Asz, sz, idx, xsched;
+  hx_array F;
+  int d, k, i, ns, n, N, par, nc;
+
+  /* ensure the linear solver is defined. */
+  if (solver != HX_IRLS_SOLVER_CHOLESKY && solver != HX_IRLS_SOLVER_CG)
+    throw("invalid linear solver %d", solver);
+
+  /* ensure the schedule index sets match the array. */
+  if (!S || S->n < 1 || S->k != x->k - 1)
+    throw("invalid schedule configuration");
+
+  /* ensure the schedule grid matches the reconstruction size. */
+  for (i = 1; i < x->k; i++) {
+    if (S->sz[i - 1] != 2 * x->sz[kx[i]])
+      throw("schedule grid mismatch in dimension %d", i);
+  }
 
-  /* ensure the iteration count is in bounds. */
-  if (niter < 1)
-    throw("iteration count %d out of bounds [1,inf)", niter);
+  /* ensure the stopping criteria are in bounds. */
+  if (!hx_nus_stop_check(stop))
+    throw("invalid stopping criteria");
 
   /* ensure the starting p-value is in bounds. */
   if (pa < 0.0 || pa > 1.0)
@@ -709,43 +1176,24 @@ int hx_array_irls (hx_array *x, hx_index dx, hx_index kx,
   for (i = 1, sz[0] = 1; i < k; i++)
     sz[i] = 2 * x->sz[kx[i]];
 
-  /* allocate the bounding array indices. */
-  lower = hx_index_alloc(k);
-  upper = hx_index_alloc(k);
-
-  /* ensure the bounding arrays were allocated. */
-  if (!lower || !upper)
-    throw("failed to allocate bounding arrays");
-
-  /* store the elements of the bounding arrays. */
-  for (i = 1; i < k; i++) {
-    /* store the upper and lower bound. */
-    upper[i] = x->sz[kx[i]] - 1;
-    lower[i] = 0;
-  }
-
-  /* build a list of packed schedule indices for each slice. */
-  ysched = hx_index_scheduled(k - 1, sz + 1, dsched, nsched, sched);
+  /* allocate a list of packed schedule indices for the input array. */
+  idx = hx_index_alloc(k - 1);
+  xsched = hx_index_alloc(S->n);
 
-  /* build a list of packed schedule indices for the input array. */
-  xsched = hx_index_scheduled(k - 1, x->sz + 1, dsched, nsched, sched);
-
-  /* ensure the schedule lists were built successfully. */
-  if (!xsched || !ysched)
+  /* ensure the schedule list was allocated successfully. */
+  if (!idx || !xsched)
     throw("failed to build packed schedule arrays");
 
-  /* adjust the elements of the input array's schedule. */
-  for (i = 0; i < nsched; i++)
+  /* repack the shared slice schedule indices into the input array. */
+  for (i = 0; i < S->n; i++) {
+    hx_index_unpack(k - 1, S->sz, idx, S->on[i]);
+    hx_index_pack(k - 1, x->sz + 1, idx, xsched + i);
     xsched[i] *= ns;
+  }
 
-  /* compute the discrete Fourier transform matrix. */
-  hx_array_init(&F);
-  if (!hx_array_irls_dftmatrix(d, k, nsched, sz, dx, kx, ysched, &F))
-    throw("failed to compute dft matrix");
-
-  /* store the dft matrix row and column sizes. */
-  n = F.sz[0];
-  N = F.sz[1];
+  /* store the sampled and complete point counts. */
+  for (i = 1, n = S->n, N = 1; i < k; i++)
+    N *= sz[i];
 
   /* allocate a size index for the normal matrix. */
   Asz = hx_index_build(2, n, n);
@@ -754,57 +1202,167 @@ int hx_array_irls (hx_array *x, hx_index dx, hx_index kx,
   if (!Asz)
     throw("failed to allocate matrix size index");
 
-  /* allocate temporary vectors for use during reconstruction. */
-  if (!hx_array_alloc(&z, d, 1, &n) ||
-      !hx_array_alloc(&y, d, 1, &n) ||
-      !hx_array_alloc(&Y, d, k, sz) ||
-      !hx_array_alloc(&w, 0, 1, &N) ||
-      !hx_array_alloc(&A, d, 2, Asz))
-    throw("failed to allocate reconstruction arrays");
-
-  /* loop over each reconstruction to be performed. */
-  for (is = 0; is < ns; is++) {
-    /* store the direct dimension bounds. */
-    upper[0] = is;
-    lower[0] = is;
-
-    /* slice the indirect dimensions from the input array. */
-    if (!hx_array_slice_sched(x, &y, is, nsched, xsched))
-      throw("failed to slice sub-matrix %d", is);
-
-    /* reconstruct the current slice. */
-    if (!hx_array_irlsfn(&F, &Y, &y, &w, &z, &A, niter, pa, pb))
-      throw("failed to reconstruct sub-matrix %d", is);
-
-    /* inverse fourier transform the shifted result. */
-    for (i = 1; i < k; i++) {
-      /* fourier transform the current dimension. */
-      if (!hx_array_ifft(&Y, dx[i], kx[i]))
-        throw("failed to apply final inverse fft");
+  /* compute the discrete Fourier transform matrix, if required. */
+  hx_array_init(&F);
+  if (solver == HX_IRLS_SOLVER_CHOLESKY &&
+      !hx_array_irls_dftmatrix(d, k, n, sz, dx, kx, S->on, &F))
+    throw("failed to compute dft matrix");
+
+  /* allocate the per-trace iteration counts. */
+  if (!hx_nus_stop_alloc(stop, ns))
+    throw("failed to allocate iteration counts");
+
+  /* determine whether to distribute the slices over threads, and how
+   * many adjacent slices each thread receives at once.
+   */
+  par = (ns >= omp_get_max_threads());
+  nc = hx_nus_chunk(ns, warm, par ? omp_get_max_threads() : 1);
+
+  /* create a team of threads to reconstruct multiple slices in parallel. */
+  #pragma omp parallel if (par)
+  {
+    /* declare a few required thread-local variables:
+     * @is: loop counter of reconstruction slices.
+     * @j: general purpose loop counter.
+     * @lower: reconstruction slice lower bound index.
+     * @upper: reconstruction slice upper bound index.
+     * @W: transform operators and solver scratch arrays.
+     * @Y: spectral estimate vector.
+     * @y: time-domain data vector.
+     * @w: real spectral weight vector.
+     * @z: time-domain estimate vector.
+     * @Yw: final spectral estimate of the preceding slice.
+     */
+    int is, j;
+    hx_index lower, upper;
+    hx_array Y, y, w, z, Yw;
+    hx_irls_work W;
+
+    /* store the operator definition and the shared transform matrix. */
+    W.solver = solver;
+    W.k = k;
+    W.dx = dx;
+    W.kx = kx;
+    W.sched = S->on;
+    W.F = F;
+
+    /* initialize the solver arrays. */
+    hx_array_init(&W.A);
+    hx_array_init(&W.T);
+    hx_array_init(&W.r);
+    hx_array_init(&W.p);
+    hx_array_init(&W.q);
+
+    /* allocate the bounding array indices. */
+    lower = hx_index_alloc(k);
+    upper = hx_index_alloc(k);
+
+    /* ensure the bounding arrays were allocated. */
+    if (!lower || !upper)
+      raise("failed to allocate bounding arrays");
+
+    /* store the elements of the bounding arrays. */
+    for (j = 1; j < k; j++) {
+      /* store the upper and lower bound. */
+      upper[j] = x->sz[kx[j]] - 1;
+      lower[j] = 0;
+    }
+
+    /* check which linear solver was requested. */
+    if (solver == HX_IRLS_SOLVER_CG) {
+      /* allocate the matrix-free solver arrays. */
+      if (!hx_array_alloc(&W.T, d, k, sz) ||
+          !hx_array_alloc(&W.r, d, 1, &n) ||
+          !hx_array_alloc(&W.p, d, 1, &n) ||
+          !hx_array_alloc(&W.q, d, 1, &n))
+        raise("failed to allocate conjugate gradient arrays");
+    }
+    else if (!hx_array_alloc(&W.A, d, 2, Asz)) {
+      /* raise an error if the regression matrix was not allocated. */
+      raise("failed to allocate regression matrix");
     }
 
-    /* store the reconstructed slice back into the input array. */
-    if (!hx_array_store(x, &Y, lower, upper))
-      throw("failed to store sub-matrix %d", is);
+    /* allocate temporary vectors for use during reconstruction. */
+    if (!hx_array_alloc(&z, d, 1, &n) ||
+        !hx_array_alloc(&y, d, 1, &n) ||
+        !hx_array_alloc(&Y, d, k, sz) ||
+        !hx_array_alloc(&w, 0, 1, &N))
+      raise("failed to allocate reconstruction arrays");
+
+    /* allocate the warm-start spectral estimate, if required. */
+    hx_array_init(&Yw);
+    if (warm && !hx_array_alloc(&Yw, d, k, sz))
+      raise("failed to allocate warm-start array");
+
+    /* distribute the slices to the team of threads. */
+    #pragma omp for schedule(dynamic, nc)
+    for (is = 0; is < ns; is++) {
+      /* start timing the phases of the slice. */
+      hx_nus_clock_start(&W.clk, stop, is);
+
+      /* store the direct dimension bounds. */
+      upper[0] = is;
+      lower[0] = is;
+
+      /* slice the indirect dimensions from the input array. */
+      if (!hx_array_slice_sched(x, &y, is, S->n, xsched))
+        raise("failed to slice sub-matrix %d", is);
+      hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_OTHER);
+
+      /* reconstruct the current slice. */
+      if (!hx_array_irlsfn(&W, &Y, &y, &w, &z,
+                           warm && is % nc ? &Yw : NULL,
+                           stop, pa, pb, is))
+        raise("failed to reconstruct sub-matrix %d", is);
+
+      /* keep the spectral estimate for the following slice. */
+      if (warm)
+        memcpy(Yw.x, Y.x, Y.len * sizeof(real));
+
+      /* inverse fourier transform the shifted result. */
+      for (j = 1; j < k; j++) {
+        /* fourier transform the current dimension. */
+        if (!hx_array_ifft(&Y, dx[j], kx[j]))
+          raise("failed to apply final inverse fft");
+      }
+      hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_FFT);
+
+      /* store the reconstructed slice back into the input array. */
+      if (!hx_array_store(x, &Y, lower, upper))
+        raise("failed to store sub-matrix %d", is);
+
+      /* charge the remaining work of the slice. */
+      hx_nus_clock_lap(&W.clk, HX_NUS_PHASE_OTHER);
+    }
+
+    /* free the solver arrays. */
+    hx_array_free(&W.A);
+    hx_array_free(&W.T);
+    hx_array_free(&W.r);
+    hx_array_free(&W.p);
+    hx_array_free(&W.q);
+
+    /* free the allocated arrays. */
+    hx_array_free(&Y);
+    hx_array_free(&y);
+    hx_array_free(&w);
+    hx_array_free(&z);
+    hx_array_free(&Yw);
+
+    /* free the bounding arrays. */
+    hx_index_free(lower);
+    hx_index_free(upper);
   }
 
-  /* free the allocated arrays. */
-  hx_array_free(&A);
+  /* free the shared transform matrix. */
   hx_array_free(&F);
-  hx_array_free(&Y);
-  hx_array_free(&y);
-  hx_array_free(&w);
-  hx_array_free(&z);
 
   /* free the allocated indices. */
   hx_index_free(xsched);
-  hx_index_free(ysched);
-  hx_index_free(lower);
-  hx_index_free(upper);
+  hx_index_free(idx);
   hx_index_free(Asz);
   hx_index_free(sz);
 
   /* return success. */
   return 1;
 }
-
@@ -23,40 +23,59 @@
 /* include the n-dimensional math header. */
 #include <hxnd/hx.h>
 
+/* hx_array_ist_maxnorm(): compute the largest scalar norm of an array.
+ * @x: pointer to the hypercomplex array.
+ */
+real hx_array_ist_maxnorm (hx_array *x) {
+  /* declare a few required variables:
+   * @i: hypercomplex scalar first coefficient index.
+   * @norm: current scalar norm value.
+   * @nmax: largest scalar norm value.
+   */
+  real norm, nmax;
+  int i;
+
+  /* loop over the elements to compute the maximum norm. */
+  for (i = 0, nmax = 0.0; i < x->len; i += x->n) {
+    /* compute the current norm. */
+    norm = hx_data_real_norm(x->x + i, x->n);
+
+    /* check if the current norm exceeds the current maximum. */
+    if (norm > nmax)
+      nmax = norm;
+  }
+
+  /* return the maximum norm. */
+  return nmax;
+}
+
 /* hx_array_ist_thresh(): soft-threshold the values of an array in place.
  * @x: pointer to the hypercomplex array to threshold.
  * @lambda: pointer to the current thresholding magnitude, which should be
  *          zero on the first iteration to force an initialization.
+ * @l1: pointer to the output l1-norm of the thresholded array, or NULL.
  */
-int hx_array_ist_thresh (hx_array *x, real *lambda) {
+int hx_array_ist_thresh (hx_array *x, real *lambda, real *l1) {
   /* declare a few required variables:
    * @i: hypercomplex scalar first coefficient index.
    * @xd: number of algebraic dimensions per scalar.
    * @xn: number of real coefficients per scalar.
    * @norm: current scalar norm value.
+   * @sum: sum of thresholded scalar norms.
    */
   int i, xd, xn;
-  real norm;
+  real norm, sum;
 
   /* locally store some array features. */
   xd = x->d;
   xn = x->n;
 
-  /* check if the thresholding magnitude has been initialized. */
-  if (*lambda <= 0.0) {
-    /* loop over the elements to compute the maximum norm. */
-    for (i = 0; i < x->len; i += xn) {
-      /* compute the current norm. */
-      norm = hx_data_real_norm(x->x + i, xn);
-
-      /* check if the current norm exceeds the current maximum. */
-      if (norm > *lambda)
-        *lambda = norm;
-    }
-  }
+  /* initialize the thresholding magnitude, if required. */
+  if (*lambda <= 0.0)
+    *lambda = hx_array_ist_maxnorm(x);
 
   /* loop over the elements to apply the soft thresholding operation. */
-  for (i = 0; i < x->len; i += xn) {
+  for (i = 0, sum = 0.0; i < x->len; i += xn) {
     /* compute the current norm. */
     norm = hx_data_real_norm(x->x + i, xn);
 
@@ -64,6 +83,7 @@ int hx_array_ist_thresh (hx_array *x, real *lambda) {
     if (norm > *lambda) {
       /* scale the element by the threshold ratio. */
       hx_data_add(NULL, x->x + i, x->x + i, 1.0 - *lambda / norm, xd, xn);
+      sum += norm - *lambda;
     }
     else {
       /* zero the element. */
@@ -71,6 +91,80 @@ int hx_array_ist_thresh (hx_array *x, real *lambda) {
     }
   }
 
+  /* store the l1-norm, if requested. */
+  if (l1)
+    *l1 = sum;
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_ist_lookup_accel(): return the enumerated ist acceleration scheme
+ * based on a specified string representation.
+ * @name: the acceleration scheme name string.
+ */
+enum hx_ist_accel hx_ist_lookup_accel (const char *name) {
+  /* return an undefined scheme if the name is null. */
+  if (!name)
+    return HX_IST_ACCEL_UNDEFINED;
+
+  /* compare the name against each supported scheme. */
+  if (strcmp(name, HX_IST_ACCEL_NAME_NONE) == 0)
+    return HX_IST_ACCEL_NONE;
+  else if (strcmp(name, HX_IST_ACCEL_NAME_FISTA) == 0)
+    return HX_IST_ACCEL_FISTA;
+  else if (strcmp(name, HX_IST_ACCEL_NAME_RESTART) == 0)
+    return HX_IST_ACCEL_RESTART;
+
+  /* return an undefined scheme. */
+  return HX_IST_ACCEL_UNDEFINED;
+}
+
+/* hx_array_ist_momentum(): replace a newly thresholded spectral estimate
+ * by its extrapolation along the direction of the previous step, as in
+ * the fast iterative shrinkage-thresholding algorithm (FISTA).
+ * @Y: new thresholded estimate, which receives the extrapolated point.
+ * @Yp: previous thresholded estimate, which receives the new estimate.
+ * @Z: previous extrapolated point, which receives the new one.
+ * @t: pointer to the momentum sequence value.
+ * @restart: whether to reset the momentum when the step reverses the
+ *           direction of the previous step.
+ */
+int hx_array_ist_momentum (hx_array *Y, hx_array *Yp, hx_array *Z,
+                           real *t, int restart) {
+  /* declare a few required variables:
+   * @i: coefficient loop counter.
+   * @tn: next momentum sequence value.
+   * @beta: extrapolation factor.
+   * @dot: inner product of the latest step and gradient mapping.
+   * @yi: current new coefficient value.
+   */
+  real tn, beta, dot, yi;
+  int i;
+
+  /* reset the momentum if the new estimate moved against the previous
+   * extrapolation (adaptive gradient restart).
+   */
+  if (restart) {
+    for (i = 0, dot = 0.0; i < Y->len; i++)
+      dot += (Z->x[i] - Y->x[i]) * (Y->x[i] - Yp->x[i]);
+
+    if (dot > 0.0)
+      *t = 1.0;
+  }
+
+  /* compute the next momentum sequence value and extrapolation factor. */
+  tn = 0.5 * (1.0 + sqrt(1.0 + 4.0 * (*t) * (*t)));
+  beta = (*t - 1.0) / tn;
+  *t = tn;
+
+  /* extrapolate each coefficient and keep the new estimate. */
+  for (i = 0; i < Y->len; i++) {
+    yi = Y->x[i];
+    Y->x[i] = Z->x[i] = yi + beta * (yi - Yp->x[i]);
+    Yp->x[i] = yi;
+  }
+
   /* return success. */
   return 1;
 }
@@ -80,20 +174,23 @@ int hx_array_ist_thresh (hx_array *x, real *lambda) {
  * see hx_array_ist() for details.
  */
 int hx_array_ist1d (hx_array *x, hx_index dx, hx_index kx,
-                    int nsched, hx_index sched,
-                    int niter, real thresh) {
+                    hx_sched *S, hx_nus_stop *stop, real thresh,
+                    enum hx_ist_accel accel, int warm) {
   /* declare a few required variables:
    * @d: slice algebraic dimension index.
    * @k: slice topological dimension index.
    * @sz: twice the current slice topological size.
    * @ja, @jb, @jmax: skipped iteration control variables.
-   * @nzeros: number of unscheduled elements in @xj.
-   * @nbytes: number of bytes per hypercomplex scalar.
-   * @zeros: linear indices of all unscheduled elements in @xj.
+   * @track: whether residuals and objectives are computed, either for
+   *         the stopping criteria or for telemetry.
+   * @mom: whether momentum is applied to the iterates.
+   * @nc: number of adjacent traces handed to each thread at once.
+   * @first: forward fft pruning table of the sampled inputs.
+   * @last: inverse fft pruning table of the sampled outputs.
    */
   int d, k, sz, ja, jb, jmax;
-  int nzeros, nbytes;
-  hx_index zeros;
+  int track, mom, nc;
+  hx_index first, last;
 
   /* get the slice dimensionalities. */
   d = x->d;
@@ -102,28 +199,37 @@ int hx_array_ist1d (hx_array *x, hx_index dx, hx_index kx,
   /* get the slice length. */
   sz = 2 * x->sz[kx[1]];
 
-  /* get the byte count per hypercomplex scalar. */
-  nbytes = x->n * sizeof(real);
-
-  /* get the number of unscheduled scalars. */
-  nzeros = sz - nsched;
+  /* initialize the skipped iteration control variables. */
+  hx_index_jump_init(x->k, x->sz, kx[1], &ja, &jb, &jmax);
 
-  /* allocate an array of unscheduled indices in each trace. */
-  zeros = hx_index_unscheduled(k, &sz, 1, nsched, sched);
+  /* allocate the per-trace iteration counts. */
+  if (!hx_nus_stop_alloc(stop, jmax))
+    throw("failed to allocate iteration counts");
 
-  /* check that allocation succeeded. */
-  if (!zeros)
-    throw("failed to allocate %d indices", nzeros);
+  /* determine which convergence measures are required. */
+  track = (stop->rtol > 0.0 || stop->otol > 0.0 || stop->log);
+  mom = (accel == HX_IST_ACCEL_FISTA || accel == HX_IST_ACCEL_RESTART);
 
-  /* initialize the skipped iteration control variables. */
-  hx_index_jump_init(x->k, x->sz, kx[1], &ja, &jb, &jmax);
+  /* determine how many adjacent traces each thread receives at once. */
+  nc = hx_nus_chunk(jmax, warm, omp_get_max_threads());
 
-  /* create a team of threads to execute multiple parallel reconstructions. */
+  /* build the fft pruning tables. only the sampled points of each residual
+   * are nonzero, and only the sampled points of each inverse transform are
+   * read by the following iteration.
+   */
+  first = hx_fft_prune_input(sz, S->on, S->n);
+  last = hx_fft_prune_output(sz, S->on, S->n);
+  if (!first || !last)
+    throw("failed to build fft pruning tables");
+
+  /* create a team of threads to execute multiple parallel reconstructions.
+   * traces stop after differing numbers of iterations, so they are handed
+   * out dynamically.
+   */
   #pragma omp parallel
   {
     /* declare a few required thread-local variables:
      * @j: array skipped iteration master index.
-     * @l: unscheduled array loop index.
      * @pidx: packed linear array index.
      * @iiter: ist iteration loop counter.
      * @xj: currently sliced sub-array.
@@ -132,11 +238,21 @@ int hx_array_ist1d (hx_array *x, hx_index dx, hx_index kx,
      * @w: temporary twiddle-factor scalar.
      * @swp: temporary swap value scalar.
      * @lambda: current iteration thresholding magnitude.
+     * @noise: noise level of the initial spectral estimate.
+     * @xss: sum of squared measured values.
+     * @l1: weighted l1-norm of the current spectral estimate.
+     * @obj, @objprev: current and previous objective values.
+     * @buf: scratch space for estimating the noise level.
+     * @Yp, @Z, @t: previous estimate, extrapolated point and momentum
+     *              sequence value of accelerated iterations.
+     * @clk: phase timer of the current trace.
      */
-    int j, l, pidx, iiter;
-    hx_array xj, y, Y;
+    int j, pidx, iiter;
+    hx_array xj, y, Y, Yp, Z;
     hx_scalar w, swp;
-    real lambda;
+    real lambda, noise, xss, l1, obj, objprev, t;
+    hx_nus_clock clk;
+    real *buf;
 
     /* allocate temporary scalars for use in the fft. */
     if (!hx_scalar_alloc(&w, d) ||
@@ -149,11 +265,34 @@ int hx_array_ist1d (hx_array *x, hx_index dx, hx_index kx,
         !hx_array_alloc(&xj, d, k, &sz))
       raise("failed to allocate temporary (%d, 1)-arrays", d);
 
+    /* allocate the momentum arrays, if required. */
+    hx_array_init(&Yp);
+    hx_array_init(&Z);
+    if (mom && (!hx_array_alloc(&Yp, d, k, &sz) ||
+                !hx_array_alloc(&Z, d, k, &sz)))
+      raise("failed to allocate momentum (%d, 1)-arrays", d);
+
+    /* allocate the noise estimation scratch space. */
+    buf = (real*) malloc(sz * sizeof(real));
+    if (!buf)
+      raise("failed to allocate noise estimation buffer");
+
     /* distribute tasks to the team of threads. */
-    #pragma omp for
+    #pragma omp for schedule(dynamic, nc)
     for (j = 0; j < jmax; j++) {
-      /* initialize the thresholding magnitude. */
-      lambda = 0.0;
+      /* start timing the phases of the trace. */
+      hx_nus_clock_start(&clk, stop, j);
+
+      /* start from zero, unless warm-starting from the preceding trace. */
+      if (!warm || j % nc == 0) {
+        hx_array_zero(&y);
+        hx_array_zero(&Y);
+      }
+
+      /* initialize the thresholding magnitude and objective. */
+      lambda = noise = l1 = 0.0;
+      objprev = INFINITY;
+      t = 1.0;
 
       /* compute the linear array index of the current vector. */
       pidx = hx_index_jump(j, ja, jb);
@@ -162,46 +301,121 @@ int hx_array_ist1d (hx_array *x, hx_index dx, hx_index kx,
       if (!hx_array_slice_vector(x, &xj, kx[1], pidx))
         raise("failed to slice vector %d", j);
 
+      /* compute the norm of the measured values. */
+      xss = (track ? hx_nus_sumsq(&xj, NULL, S->on, S->n) : 0.0);
+
       /* loop over the iterations. */
-      for (iiter = 0; iiter < niter; iiter++) {
+      for (iiter = 0; iiter < stop->niter; iiter++) {
+        /* check the current estimate for convergence. */
+        if (iiter && track) {
+          /* compute the residual and objective of the estimate. */
+          obj = hx_nus_sumsq(&xj, &y, S->on, S->n);
+          hx_nus_log_iter(stop, j, iiter, obj, xss, 0.5 * obj + l1, lambda);
+          if (hx_nus_converged(stop, obj, xss, 0.5 * obj + l1, objprev))
+            break;
+
+          /* store the objective for the next check. */
+          objprev = 0.5 * obj + l1;
+        }
+
+        /* charge the convergence check to the remaining phase. */
+        hx_nus_clock_lap(&clk, HX_NUS_PHASE_OTHER);
+
+        /* stop once the threshold falls into the noise. */
+        if (iiter && lambda < stop->lfloor * noise)
+          break;
+
         /* compute the new residual vector. */
         if (!hx_array_add_array(&xj, &y, -1.0, &y))
           raise("failed to compute residual");
 
-        /* reset the unsampled time-domain points in the residual. */
-        for (l = 0; l < nzeros; l++)
-          memset(y.x + y.n * zeros[l], 0, nbytes);
-
-        /* fourier transform the sliced vector array. */
-        if (!hx_array_fft1d(&y, dx[1], HX_FFT_FORWARD, &w, &swp))
+        /* fourier transform the sliced vector array. the unsampled
+         * time-domain points of the residual are treated as zeros.
+         */
+        if (!hx_array_fft1d_pruned(&y, dx[1], HX_FFT_FORWARD, &w, &swp,
+                                   first, NULL))
           raise("failed to execute forward fft");
 
+        /* charge the residual and its transform to the fft phase. */
+        hx_nus_clock_lap(&clk, HX_NUS_PHASE_FFT);
+
+        /* start the threshold at the largest correction required by the
+         * initial estimate, which is zero unless warm-started.
+         */
+        if (iiter == 0)
+          lambda = hx_array_ist_maxnorm(&y);
+
         /* sum the result into the frequency-domain output vector. */
         if (!hx_array_add_array(&Y, &y, 1.0, &Y))
           raise("failed to perform replacement");
 
+        /* estimate the noise level from the initial spectrum. */
+        if (iiter == 0 && stop->lfloor > 0.0)
+          noise = hx_nus_noise(&Y, buf);
+
         /* threshold the frequency-domain vector. */
-        if (!hx_array_ist_thresh(&Y, &lambda))
+        if (!hx_array_ist_thresh(&Y, &lambda, &l1))
           raise("failed to threshold sub-array %d", j);
 
+        /* weight the l1-norm for the objective. */
+        l1 *= lambda;
+
+        /* extrapolate the estimate, if requested. */
+        if (mom)
+          hx_array_ist_momentum(&Y, &Yp, &Z, &t,
+                                accel == HX_IST_ACCEL_RESTART);
+
         /* copy the thresholded frequency-domain data. */
         memcpy(y.x, Y.x, y.len * sizeof(real));
+        hx_nus_clock_lap(&clk, HX_NUS_PHASE_UPDATE);
 
-        /* inverse fourier transform the sliced vector array. */
-        if (!hx_array_fft1d(&y, dx[1], HX_FFT_REVERSE, &w, &swp))
+        /* inverse fourier transform the sampled time-domain points. */
+        if (!hx_array_fft1d_pruned(&y, dx[1], HX_FFT_REVERSE, &w, &swp,
+                                   NULL, last))
           raise("failed to execute inverse fft");
 
+        /* charge the inverse transform to the fft phase. */
+        hx_nus_clock_lap(&clk, HX_NUS_PHASE_FFT);
+
         /* scale down the threshold magnitude. */
         lambda *= thresh;
       }
 
+      /* store the iteration count of the trace. */
+      stop->iters[j] = iiter;
+
+      /* return from the extrapolated point to the latest estimate. */
+      if (mom)
+        memcpy(Y.x, Yp.x, Y.len * sizeof(real));
+
+      /* inverse fourier transform every time-domain point of the final
+       * estimate.
+       */
+      memcpy(y.x, Y.x, y.len * sizeof(real));
+      if (!hx_array_fft1d(&y, dx[1], HX_FFT_REVERSE, &w, &swp))
+        raise("failed to execute inverse fft");
+
+      /* charge the final transform to the fft phase. */
+      hx_nus_clock_lap(&clk, HX_NUS_PHASE_FFT);
+
+      /* record the final estimate of traces that reached the limit. */
+      if (stop->log && iiter == stop->niter) {
+        obj = hx_nus_sumsq(&xj, &y, S->on, S->n);
+        hx_nus_log_iter(stop, j, iiter, obj, xss, 0.5 * obj + l1, lambda);
+      }
+
+      /* re-initialize the momentum arrays. */
+      if (mom) {
+        hx_array_zero(&Yp);
+        hx_array_zero(&Z);
+      }
+
       /* store the reconstructed vector back into the array. */
       if (!hx_array_store_vector(x, &y, kx[1], pidx))
         raise("failed to store vector %d", j);
 
-      /* re-initialize the contents of the temporary vectors. */
-      hx_array_zero(&y);
-      hx_array_zero(&Y);
+      /* charge the remaining work of the trace. */
+      hx_nus_clock_lap(&clk, HX_NUS_PHASE_OTHER);
     }
 
     /* free the temporary scalars. */
@@ -212,10 +426,14 @@ int hx_array_ist1d (hx_array *x, hx_index dx, hx_index kx,
     hx_array_free(&y);
     hx_array_free(&Y);
     hx_array_free(&xj);
+    hx_array_free(&Yp);
+    hx_array_free(&Z);
+    free(buf);
   }
 
-  /* free the array of unscheduled indices. */
-  hx_index_free(zeros);
+  /* free the fft pruning tables. */
+  hx_index_free(first);
+  hx_index_free(last);
 
   /* return success. */
   return 1;
@@ -223,34 +441,29 @@ int hx_array_ist1d (hx_array *x, hx_index dx, hx_index kx,
 
 /* hx_array_istnd(): perform a set of multidimensional reconstructions over
  * an array having at least three dimensions using iterative soft
- * thresholding.
+ * thresholding. slices are distributed over a team of threads, unless
+ * there are fewer slices than threads, in which case each slice is
+ * reconstructed in turn using parallel fourier transforms.
  * see hx_array_ist() for details.
  */
 int hx_array_istnd (hx_array *x, hx_index dx, hx_index kx,
-                    int dsched, int nsched, hx_index sched,
-                    int niter, real thresh) {
+                    hx_sched *S, hx_nus_stop *stop, real thresh,
+                    enum hx_ist_accel accel, int warm) {
   /* declare a few required variables:
    * @sz: size of the temporary arrays.
-   * @lower: slice lower-bound index array.
-   * @upper: slice upper-bound index array.
-   * @iiter: iteration loop counter.
-   */
-  hx_index sz, lower, upper;
-  int i, j, n, d, k, iiter;
-
-  /* @xi: currently sliced sub-array.
-   * @y: final output result sub-array.
-   * @Y: intermediate result sub-array.
-   */
-  hx_array xi, y, Y;
-
-  /* @nzeros: number of unscheduled elements @y.
-   * @zeros: linear indices of all unschedules elements in @y.
-   * @lambda: current iteration thresholding magnitude.
+   * @i: general-purpose loop counter.
+   * @n: number of slices to reconstruct.
+   * @d: number of array algebraic dimensions.
+   * @k: number of array topological dimensions.
+   * @nbytes: number of bytes per hypercomplex scalar.
+   * @track: whether residuals and objectives are computed, either for
+   *         the stopping criteria or for telemetry.
+   * @mom: whether momentum is applied to the iterates.
+   * @par: whether slices are distributed over threads.
+   * @nc: number of adjacent slices handed to each thread at once.
    */
-  int nbytes, nzeros;
-  hx_index zeros;
-  real lambda;
+  int i, n, d, k, nbytes, track, mom, par, nc;
+  hx_index sz;
 
   /* get the number of reconstructions required. */
   n = x->sz[kx[0]];
@@ -273,105 +486,242 @@ int hx_array_istnd (hx_array *x, hx_index dx, hx_index kx,
   for (i = 1, sz[0] = 1; i < k; i++)
     sz[i] = 2 * x->sz[kx[i]];
 
-  /* allocate the bounding array indices. */
-  lower = hx_index_alloc(k);
-  upper = hx_index_alloc(k);
-
-  /* check that the bounding arrays were allocated. */
-  if (!lower || !upper)
-    throw("failed to allocate bounding arrays");
-
-  /* allocate the scratch-space arrays. */
-  if (!hx_array_alloc(&y, d, k, sz) ||
-      !hx_array_alloc(&Y, d, k, sz) ||
-      !hx_array_alloc(&xi, d, k, sz))
-    throw("failed to allocate (%d, %d)-arrays", d, k);
-
-  /* determine the number of un-scheduled elements in each slice. */
-  nzeros = y.len / y.n - nsched;
-  zeros = hx_index_unscheduled(k - 1, sz + 1, dsched, nsched, sched);
-
-  /* check that the array of zero indices was allocated. */
-  if (!zeros)
-    throw("failed to allocate %d indices", nzeros);
-
-  /* store the elements of the bounding arrays. */
-  for (i = 1; i < k; i++) {
-    /* store the upper and lower bound. */
-    upper[i] = x->sz[kx[i]] - 1;
-    lower[i] = 0;
-  }
+  /* allocate the per-trace iteration counts. */
+  if (!hx_nus_stop_alloc(stop, n))
+    throw("failed to allocate iteration counts");
+
+  /* determine which convergence measures are required. */
+  track = (stop->rtol > 0.0 || stop->otol > 0.0 || stop->log);
+  mom = (accel == HX_IST_ACCEL_FISTA || accel == HX_IST_ACCEL_RESTART);
+
+  /* determine whether to distribute the slices over threads, and how
+   * many adjacent slices each thread receives at once.
+   */
+  par = (n >= omp_get_max_threads());
+  nc = hx_nus_chunk(n, warm, par ? omp_get_max_threads() : 1);
+
+  /* create a team of threads to reconstruct multiple slices in parallel. */
+  #pragma omp parallel if (par)
+  {
+    /* declare a few required thread-local variables:
+     * @is: slice loop counter.
+     * @j: general-purpose loop counter.
+     * @iiter: iteration loop counter.
+     * @lower: slice lower-bound index array.
+     * @upper: slice upper-bound index array.
+     * @xi: currently sliced sub-array.
+     * @y: final output result sub-array.
+     * @Y: intermediate result sub-array.
+     */
+    int is, j, iiter;
+    hx_index lower, upper;
+    hx_array xi, y, Y;
+
+    /* @lambda: current iteration thresholding magnitude.
+     * @noise: noise level of the initial spectral estimate.
+     * @xss: sum of squared measured values.
+     * @l1: weighted l1-norm of the current spectral estimate.
+     * @obj, @objprev: current and previous objective values.
+     * @buf: scratch space for estimating the noise level.
+     * @Yp, @Z, @t: previous estimate, extrapolated point and momentum
+     *              sequence value of accelerated iterations.
+     * @clk: phase timer of the current slice.
+     */
+    real lambda, noise, xss, l1, obj, objprev, t;
+    hx_array Yp, Z;
+    hx_nus_clock clk;
+    real *buf;
+
+    /* allocate the bounding array indices. */
+    lower = hx_index_alloc(k);
+    upper = hx_index_alloc(k);
+
+    /* check that the bounding arrays were allocated. */
+    if (!lower || !upper)
+      raise("failed to allocate bounding arrays");
+
+    /* allocate the scratch-space arrays. */
+    if (!hx_array_alloc(&y, d, k, sz) ||
+        !hx_array_alloc(&Y, d, k, sz) ||
+        !hx_array_alloc(&xi, d, k, sz))
+      raise("failed to allocate (%d, %d)-arrays", d, k);
+
+    /* allocate the momentum arrays, if required. */
+    hx_array_init(&Yp);
+    hx_array_init(&Z);
+    if (mom && (!hx_array_alloc(&Yp, d, k, sz) ||
+                !hx_array_alloc(&Z, d, k, sz)))
+      raise("failed to allocate momentum (%d, %d)-arrays", d, k);
+
+    /* allocate the noise estimation scratch space. */
+    buf = (real*) malloc((y.len / y.n) * sizeof(real));
+    if (!buf)
+      raise("failed to allocate noise estimation buffer");
+
+    /* store the elements of the bounding arrays. */
+    for (j = 1; j < k; j++) {
+      /* store the upper and lower bound. */
+      upper[j] = x->sz[kx[j]] - 1;
+      lower[j] = 0;
+    }
 
-  /* loop serially over the slices. */
-  for (i = 0; i < n; i++) {
-    /* initialize the thresholding magnitude. */
-    lambda = 0.0;
-
-    /* store the direct dimension bounds. */
-    upper[0] = i;
-    lower[0] = i;
-
-    /* slice the indirect dimensions from the input array. */
-    if (!hx_array_slice(x, &xi, lower, upper))
-      throw("failed to slice out sub-array %d", i);
-
-    /* loop over the iterations. */
-    for (iiter = 0; iiter < niter; iiter++) {
-      /* compute the new residual array. */
-      if (!hx_array_add_array(&xi, &y, -1.0, &y))
-        throw("failed to compute residual");
-
-      /* reset the unsampled time-domain points in the residual. */
-      for (j = 0; j < nzeros; j++)
-        memset(y.x + y.n * zeros[j], 0, nbytes);
-
-      /* loop over the sliced dimensions. */
-      for (j = 1; j < k; j++) {
-        /* forward fourier transform the slice. */
-        if (!hx_array_fft(&y, dx[j], kx[j]))
-          throw("failed to apply forward fft");
+    /* distribute the slices to the team of threads. */
+    #pragma omp for schedule(dynamic, nc)
+    for (is = 0; is < n; is++) {
+      /* start timing the phases of the slice. */
+      hx_nus_clock_start(&clk, stop, is);
+
+      /* start from zero, unless warm-starting from the preceding slice. */
+      if (!warm || is % nc == 0) {
+        hx_array_zero(&y);
+        hx_array_zero(&Y);
       }
 
-      /* sum the result into the frequency-domain output array. */
-      if (!hx_array_add_array(&Y, &y, 1.0, &Y))
-        throw("failed to perform replacement");
+      /* initialize the thresholding magnitude and objective. */
+      lambda = noise = l1 = 0.0;
+      objprev = INFINITY;
+      t = 1.0;
 
-      /* threshold the frequency-domain array. */
-      if (!hx_array_ist_thresh(&Y, &lambda))
-        throw("failed to threshold sub-array %d", i);
+      /* store the direct dimension bounds. */
+      upper[0] = is;
+      lower[0] = is;
 
-      /* copy the thresholded frequency-domain data. */
-      memcpy(y.x, Y.x, y.len * sizeof(real));
+      /* slice the indirect dimensions from the input array. */
+      if (!hx_array_slice(x, &xi, lower, upper))
+        raise("failed to slice out sub-array %d", is);
+
+      /* compute the norm of the measured values. */
+      xss = (track ? hx_nus_sumsq(&xi, NULL, S->on, S->n) : 0.0);
+
+      /* loop over the iterations. */
+      for (iiter = 0; iiter < stop->niter; iiter++) {
+        /* check the current estimate for convergence. */
+        if (iiter && track) {
+          /* compute the residual and objective of the estimate. */
+          obj = hx_nus_sumsq(&xi, &y, S->on, S->n);
+          hx_nus_log_iter(stop, is, iiter, obj, xss, 0.5 * obj + l1, lambda);
+          if (hx_nus_converged(stop, obj, xss, 0.5 * obj + l1, objprev))
+            break;
+
+          /* store the objective for the next check. */
+          objprev = 0.5 * obj + l1;
+        }
+
+        /* charge the convergence check to the remaining phase. */
+        hx_nus_clock_lap(&clk, HX_NUS_PHASE_OTHER);
+
+        /* stop once the threshold falls into the noise. */
+        if (iiter && lambda < stop->lfloor * noise)
+          break;
+
+        /* compute the new residual array. */
+        if (!hx_array_add_array(&xi, &y, -1.0, &y))
+          raise("failed to compute residual");
+
+        /* reset the unsampled time-domain points in the residual. */
+        for (j = 0; j < S->nz; j++)
+          memset(y.x + y.n * S->off[j], 0, nbytes);
+
+        /* loop over the sliced dimensions. */
+        for (j = 1; j < k; j++) {
+          /* forward fourier transform the slice. */
+          if (!hx_array_fft(&y, dx[j], kx[j]))
+            raise("failed to apply forward fft");
+        }
+
+        /* charge the residual and its transform to the fft phase. */
+        hx_nus_clock_lap(&clk, HX_NUS_PHASE_FFT);
+
+        /* start the threshold at the largest correction required by the
+         * initial estimate, which is zero unless warm-started.
+         */
+        if (iiter == 0)
+          lambda = hx_array_ist_maxnorm(&y);
+
+        /* sum the result into the frequency-domain output array. */
+        if (!hx_array_add_array(&Y, &y, 1.0, &Y))
+          raise("failed to perform replacement");
+
+        /* estimate the noise level from the initial spectrum. */
+        if (iiter == 0 && stop->lfloor > 0.0)
+          noise = hx_nus_noise(&Y, buf);
+
+        /* threshold the frequency-domain array. */
+        if (!hx_array_ist_thresh(&Y, &lambda, &l1))
+          raise("failed to threshold sub-array %d", is);
+
+        /* weight the l1-norm for the objective. */
+        l1 *= lambda;
+
+        /* extrapolate the estimate, if requested. */
+        if (mom)
+          hx_array_ist_momentum(&Y, &Yp, &Z, &t,
+                                accel == HX_IST_ACCEL_RESTART);
+
+        /* copy the thresholded frequency-domain data. */
+        memcpy(y.x, Y.x, y.len * sizeof(real));
+        hx_nus_clock_lap(&clk, HX_NUS_PHASE_UPDATE);
+
+        /* loop over the sliced dimensions. */
+        for (j = 1; j < k; j++) {
+          /* inverse fourier transform the slice. */
+          if (!hx_array_ifft(&y, dx[j], kx[j]))
+            raise("failed to apply inverse fft");
+        }
+
+        /* charge the inverse transform to the fft phase. */
+        hx_nus_clock_lap(&clk, HX_NUS_PHASE_FFT);
+
+        /* scale down the threshold magnitude. */
+        lambda *= thresh;
+      }
 
-      /* loop over the sliced dimensions. */
-      for (j = 1; j < k; j++) {
-        /* inverse fourier transform the slice. */
-        if (!hx_array_ifft(&y, dx[j], kx[j]))
-          throw("failed to apply inverse fft");
+      /* store the iteration count of the slice. */
+      stop->iters[is] = iiter;
+
+      /* return from the extrapolated point to the latest estimate. */
+      if (mom) {
+        memcpy(Y.x, Yp.x, Y.len * sizeof(real));
+        memcpy(y.x, Yp.x, y.len * sizeof(real));
+        for (j = 1; j < k; j++) {
+          if (!hx_array_ifft(&y, dx[j], kx[j]))
+            raise("failed to apply inverse fft");
+        }
+
+        /* re-initialize the momentum arrays. */
+        hx_array_zero(&Yp);
+        hx_array_zero(&Z);
       }
 
-      /* scale down the threshold magnitude. */
-      lambda *= thresh;
-    }
+      /* record the final estimate of slices that reached the limit. */
+      hx_nus_clock_lap(&clk, HX_NUS_PHASE_FFT);
+      if (stop->log && iiter == stop->niter) {
+        obj = hx_nus_sumsq(&xi, &y, S->on, S->n);
+        hx_nus_log_iter(stop, is, iiter, obj, xss, 0.5 * obj + l1, lambda);
+      }
 
-    /* store the reconstructed slice back into the input array. */
-    if (!hx_array_store(x, &y, lower, upper))
-      throw("failed to store in sub-array %d", i);
+      /* store the reconstructed slice back into the input array. */
+      if (!hx_array_store(x, &y, lower, upper))
+        raise("failed to store in sub-array %d", is);
 
-    /* re-initialize the contents of the temporary arrays. */
-    hx_array_zero(&y);
-    hx_array_zero(&Y);
-  }
+      /* charge the remaining work of the slice. */
+      hx_nus_clock_lap(&clk, HX_NUS_PHASE_OTHER);
+    }
 
-  /* free the scratch-space arrays. */
-  hx_array_free(&y);
-  hx_array_free(&Y);
-  hx_array_free(&xi);
+    /* free the scratch-space arrays. */
+    hx_array_free(&y);
+    hx_array_free(&Y);
+    hx_array_free(&xi);
+    hx_array_free(&Yp);
+    hx_array_free(&Z);
+    free(buf);
+
+    /* free the bounding arrays. */
+    hx_index_free(lower);
+    hx_index_free(upper);
+  }
 
-  /* free the allocated multidimensional indices. */
-  hx_index_free(zeros);
-  hx_index_free(lower);
-  hx_index_free(upper);
+  /* free the slice size array. */
   hx_index_free(sz);
 
   /* return success. */
@@ -383,38 +733,56 @@ int hx_array_istnd (hx_array *x, hx_index dx, hx_index kx,
  * @x: pointer to the array to reconstruct.
  * @dx: array of algebraic dimension indices in @x.
  * @kx: array of topological dimension indices in @x.
- * @dsched: number of reconstruction dimensions.
- * @nsched: number of sampled @dsched-dimensional points.
- * @sched: array of @nsched @nnus-dimensional indices.
- * @niter: number of iterations to perform.
+ * @S: schedule index sets over the doubled indirect sizes of @x.
+ * @stop: stopping criteria, which receive the per-trace iteration counts.
  * @thresh: threshold magnitude.
+ * @accel: acceleration scheme applied to the iterates.
+ * @warm: whether each trace starts from the estimate of the preceding
+ *        trace along the direct dimension, with the threshold starting at
+ *        the largest remaining correction. each thread then reconstructs
+ *        one contiguous run of traces.
  */
 int hx_array_ist (hx_array *x, hx_index dx, hx_index kx,
-                  int dsched, int nsched, hx_index sched,
-                  int niter, real thresh) {
-  /* ensure the iteration count is in bounds. */
-  if (niter < 1)
-    throw("iteration count %d out of bounds [1,inf)", niter);
+                  hx_sched *S, hx_nus_stop *stop, real thresh,
+                  enum hx_ist_accel accel, int warm) {
+  /* declare a required variable:
+   * @i: dimension loop counter.
+   */
+  int i;
+
+  /* ensure the schedule index sets match the array. */
+  if (!S || S->n < 1 || S->k != x->k - 1)
+    throw("invalid schedule configuration");
+
+  /* ensure the schedule grid matches the reconstruction size. */
+  for (i = 1; i < x->k; i++) {
+    if (S->sz[i - 1] != 2 * x->sz[kx[i]])
+      throw("schedule grid mismatch in dimension %d", i);
+  }
+
+  /* ensure the stopping criteria are in bounds. */
+  if (!hx_nus_stop_check(stop))
+    throw("invalid stopping criteria");
 
   /* ensure the threshold is in bounds. */
   if (thresh <= 0.0 || thresh >= 1.0)
     throw("threshold %.2f out of bounds (0,1)", thresh);
 
+  /* ensure the acceleration scheme is supported. */
+  if (accel == HX_IST_ACCEL_UNDEFINED)
+    throw("undefined acceleration scheme");
+
   /* determine which reconstruction function to use. */
-  if (dsched == 1) {
+  if (S->k == 1) {
     /* execute the one-dimensional function. */
-    if (!hx_array_ist1d(x, dx, kx, nsched, sched, niter, thresh))
+    if (!hx_array_ist1d(x, dx, kx, S, stop, thresh, accel, warm))
       throw("failed to execute one-dimensional reconstruction");
   }
-  else if (dsched > 1) {
+  else {
     /* execute the multidimensional function. */
-    if (!hx_array_istnd(x, dx, kx, dsched, nsched, sched, niter, thresh))
+    if (!hx_array_istnd(x, dx, kx, S, stop, thresh, accel, warm))
       throw("failed to execute n-dimensional reconstruction");
   }
-  else {
-    /* throw an exception. */
-    throw("invalid schedule configuration (%dx%d)", dsched, nsched);
-  }
 
   /* return success. */
   return 1;
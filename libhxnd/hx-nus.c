@@ -0,0 +1,479 @@
+
+/* hxnd: A framework for n-dimensional hypercomplex calculations for NMR.
+ * Copyright (C) 2014-2015  Bradley Worley  <geekysuavo@gmail.com>.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to:
+ *
+ *   Free Software Foundation, Inc.
+ *   51 Franklin Street, Fifth Floor
+ *   Boston, MA  02110-1301, USA.
+ */
+
+/* include the n-dimensional math header. */
+#include <hxnd/hx.h>
+
+/* hx_nus_stop_init(): initialize the stopping criteria of a nonuniform
+ * sampling reconstruction to a fixed number of iterations per trace.
+ * @stop: pointer to the stopping criteria to initialize.
+ * @niter: maximum number of iterations per trace.
+ */
+void hx_nus_stop_init (hx_nus_stop *stop, int niter) {
+  /* store the iteration limit and disable all other criteria. */
+  stop->niter = niter;
+  stop->rtol = 0.0;
+  stop->otol = 0.0;
+  stop->lfloor = 0.0;
+
+  /* initialize the per-trace results. */
+  stop->n = 0;
+  stop->iters = NULL;
+
+  /* disable telemetry, recording every iteration once enabled. */
+  stop->log = 0;
+  stop->every = 1;
+
+  /* initialize the per-trace telemetry. */
+  stop->res = stop->obj = stop->par = NULL;
+  stop->time = NULL;
+  stop->cap = 0;
+  stop->nrec = NULL;
+  stop->rec = NULL;
+}
+
+/* hx_nus_stop_alloc(): allocate the per-trace iteration counts of a set
+ * of stopping criteria.
+ * @stop: pointer to the stopping criteria to modify.
+ * @n: number of traces to be reconstructed.
+ */
+int hx_nus_stop_alloc (hx_nus_stop *stop, int n) {
+  /* declare a required variable:
+   * @nt: number of traces to allocate for.
+   */
+  int nt;
+
+  /* free any existing per-trace results. */
+  hx_nus_stop_free(stop);
+
+  /* allocate the new iteration counts. */
+  nt = (n > 0 ? n : 1);
+  stop->iters = (int*) calloc(nt, sizeof(int));
+  if (!stop->iters)
+    throw("failed to allocate %d iteration counts", n);
+
+  /* store the trace count. */
+  stop->n = n;
+
+  /* return if no telemetry was requested. */
+  if (!stop->log)
+    return 1;
+
+  /* allocate the per-trace telemetry. */
+  stop->res = (real*) calloc(nt, sizeof(real));
+  stop->obj = (real*) calloc(nt, sizeof(real));
+  stop->par = (real*) calloc(nt, sizeof(real));
+  stop->time = (double*) calloc(nt * HX_NUS_NPHASE, sizeof(double));
+  stop->nrec = (int*) calloc(nt, sizeof(int));
+  if (!stop->res || !stop->obj || !stop->par ||
+      !stop->time || !stop->nrec)
+    throw("failed to allocate telemetry of %d traces", n);
+
+  /* allocate the iteration records, which span every recorded
+   * iteration index from zero to the iteration limit.
+   */
+  stop->cap = (stop->every > 0 ? stop->niter / stop->every + 1 : 0);
+  if (stop->cap) {
+    stop->rec = (hx_nus_rec*)
+      malloc((size_t) nt * stop->cap * sizeof(hx_nus_rec));
+
+    if (!stop->rec)
+      throw("failed to allocate %d iteration records", nt * stop->cap);
+  }
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_nus_stop_free(): free the per-trace iteration counts of a set of
+ * stopping criteria.
+ * @stop: pointer to the stopping criteria to free.
+ */
+void hx_nus_stop_free (hx_nus_stop *stop) {
+  /* free the iteration counts. */
+  free(stop->iters);
+  stop->iters = NULL;
+  stop->n = 0;
+
+  /* free the per-trace telemetry. */
+  free(stop->res);
+  free(stop->obj);
+  free(stop->par);
+  free(stop->time);
+  free(stop->nrec);
+  free(stop->rec);
+
+  /* reset the telemetry pointers. */
+  stop->res = stop->obj = stop->par = NULL;
+  stop->time = NULL;
+  stop->cap = 0;
+  stop->nrec = NULL;
+  stop->rec = NULL;
+}
+
+/* hx_nus_stop_check(): ensure the stopping criteria of a reconstruction
+ * are in bounds.
+ * @stop: pointer to the stopping criteria to check.
+ */
+int hx_nus_stop_check (hx_nus_stop *stop) {
+  /* ensure the criteria were provided. */
+  if (!stop)
+    throw("invalid stopping criteria");
+
+  /* ensure the iteration count is in bounds. */
+  if (stop->niter < 1)
+    throw("iteration count %d out of bounds [1,inf)", stop->niter);
+
+  /* ensure the tolerances are in bounds. */
+  if (stop->rtol < 0.0 || stop->otol < 0.0 || stop->lfloor < 0.0)
+    throw("stopping tolerances must be non-negative");
+
+  /* ensure the telemetry spacing is in bounds. */
+  if (stop->every < 0)
+    throw("telemetry spacing %d out of bounds [0,inf)", stop->every);
+
+  /* return success. */
+  return 1;
+}
+
+/* hx_nus_chunk(): compute the number of adjacent traces handed to each
+ * thread in a single block. warm-started traces begin from the result of
+ * the preceding trace, which must have been reconstructed on the same
+ * thread, so each thread receives one contiguous run of traces.
+ * @n: number of traces to be reconstructed.
+ * @warm: whether traces are warm-started.
+ * @nthreads: number of threads sharing the traces.
+ */
+int hx_nus_chunk (int n, int warm, int nthreads) {
+  /* hand out single traces when every trace starts from zero. */
+  if (!warm || nthreads < 1)
+    return 1;
+
+  /* divide the traces evenly among the threads. */
+  return (n + nthreads - 1) / nthreads;
+}
+
+/* hx_nus_sumsq(): compute the sum of squared norms of a list of scalars
+ * of an array, or of their differences from the scalars of a second
+ * array having the same configuration.
+ * @x: pointer to the first array.
+ * @y: pointer to the second array, or NULL.
+ * @idx: linear scalar indices to sum over, or NULL for all scalars.
+ * @n: number of indices in @idx.
+ */
+real hx_nus_sumsq (hx_array *x, hx_array *y, hx_index idx, int n) {
+  /* declare a few required variables:
+   * @i: index loop counter.
+   * @j: current coefficient offset.
+   * @l: coefficient loop counter.
+   * @v: current coefficient value.
+   * @ss: sum of squares.
+   */
+  int i, j, l;
+  real v, ss;
+
+  /* sum over all scalars if no index list was provided. */
+  if (!idx)
+    n = x->len / x->n;
+
+  /* loop over the scalars. */
+  for (i = 0, ss = 0.0; i < n; i++) {
+    /* compute the offset of the current scalar. */
+    j = (idx ? idx[i] : i) * x->n;
+
+    /* sum the squared coefficients. */
+    for (l = 0; l < x->n; l++) {
+      v = x->x[j + l] - (y ? y->x[j + l] : 0.0);
+      ss += v * v;
+    }
+  }
+
+  /* return the computed sum. */
+  return ss;
+}
+
+/* hx_nus_select(): partially sort an array of reals such that the
+ * element at a given position is in its sorted location, and return it.
+ * @v: array of values to partially sort.
+ * @n: number of values in @v.
+ * @m: position of the element to select.
+ */
+real hx_nus_select (real *v, int n, int m) {
+  /* declare a few required variables:
+   * @lo, @hi: current partition bounds.
+   * @i, @j: partition scan indices.
+   * @piv: partition pivot value.
+   * @swp: temporary swap value.
+   */
+  int lo, hi, i, j;
+  real piv, swp;
+
+  /* loop until the partition holds only the selected element. */
+  for (lo = 0, hi = n - 1; lo < hi;) {
+    /* partition about the middle element. */
+    piv = v[(lo + hi) / 2];
+    for (i = lo, j = hi; i <= j;) {
+      /* find an out-of-place pair of elements. */
+      while (v[i] < piv) i++;
+      while (v[j] > piv) j--;
+
+      /* swap the pair. */
+      if (i <= j) {
+        swp = v[i];
+        v[i++] = v[j];
+        v[j--] = swp;
+      }
+    }
+
+    /* narrow the bounds to the partition holding the element. */
+    if (m <= j)
+      hi = j;
+    else if (m >= i)
+      lo = i;
+    else
+      break;
+  }
+
+  /* return the selected element. */
+  return v[m];
+}
+
+/* hx_nus_noise(): estimate the noise level of a frequency-domain array as
+ * the median of its scalar norms, which is robust to the few large
+ * signals of a sparse spectrum.
+ * @X: pointer to the frequency-domain array.
+ * @buf: scratch space holding at least one real per scalar of @X.
+ */
+real hx_nus_noise (hx_array *X, real *buf) {
+  /* declare a few required variables:
+   * @i: scalar loop counter.
+   * @n: number of scalars.
+   */
+  int i, n;
+
+  /* compute the norm of each scalar. */
+  n = X->len / X->n;
+  for (i = 0; i < n; i++)
+    buf[i] = hx_data_real_norm(X->x + i * X->n, X->n);
+
+  /* return the median norm. */
+  return hx_nus_select(buf, n, n / 2);
+}
+
+/* hx_nus_converged(): check whether the residual or objective criteria
+ * of a reconstruction have been satisfied by its current estimate.
+ * @stop: pointer to the stopping criteria.
+ * @rss: sum of squared residuals over the sampled points.
+ * @xss: sum of squared measured values over the sampled points.
+ * @obj: current objective value.
+ * @objprev: objective value at the previous check.
+ */
+int hx_nus_converged (hx_nus_stop *stop, real rss, real xss,
+                      real obj, real objprev) {
+  /* check the relative residual norm. */
+  if (stop->rtol > 0.0 && rss <= stop->rtol * stop->rtol * xss)
+    return 1;
+
+  /* check the relative change in the objective. */
+  if (stop->otol > 0.0 && fabs(obj - objprev) <= stop->otol * fabs(obj))
+    return 1;
+
+  /* not converged. */
+  return 0;
+}
+
+/* hx_nus_stop_report(): print a summary of the per-trace iteration counts
+ * of a reconstruction to standard error.
+ * @stop: pointer to the completed stopping criteria.
+ * @name: name of the reconstruction method.
+ */
+void hx_nus_stop_report (hx_nus_stop *stop, const char *name) {
+  /* declare a few required variables:
+   * @imin: minimum trace iteration count.
+   * @imax: maximum trace iteration count.
+   * @ncap: number of traces that reached the iteration limit.
+   * @sum: total iteration count.
+   * @i: trace loop counter.
+   */
+  int i, imin, imax, ncap;
+  double sum;
+
+  /* return if no traces were reconstructed. */
+  if (!stop->iters || stop->n < 1)
+    return;
+
+  /* loop over the traces to summarize the iteration counts. */
+  imin = imax = stop->iters[0];
+  for (i = 0, ncap = 0, sum = 0.0; i < stop->n; i++) {
+    /* update the extreme counts. */
+    if (stop->iters[i] < imin) imin = stop->iters[i];
+    if (stop->iters[i] > imax) imax = stop->iters[i];
+
+    /* update the total and limited counts. */
+    ncap += (stop->iters[i] >= stop->niter ? 1 : 0);
+    sum += (double) stop->iters[i];
+  }
+
+  /* print the summary. */
+  fprintf(stderr, "%s: %d traces, iterations min %d, mean %.1lf, max %d, "
+                  "%d at limit %d\n", name, stop->n, imin,
+          sum / (double) stop->n, imax, ncap, stop->niter);
+  fflush(stderr);
+}
+
+/* hx_nus_clock_start(): start the phase timer of a reconstructed trace.
+ * the timer does nothing unless telemetry is recorded.
+ * @clk: pointer to the timer to start.
+ * @stop: pointer to the stopping criteria holding the telemetry.
+ * @j: index of the reconstructed trace.
+ */
+void hx_nus_clock_start (hx_nus_clock *clk, hx_nus_stop *stop, int j) {
+  /* point the timer at the phase timings of the trace. */
+  clk->tm = (stop->log ? stop->time + j * HX_NUS_NPHASE : NULL);
+  clk->t0 = (clk->tm ? omp_get_wtime() : 0.0);
+}
+
+/* hx_nus_clock_lap(): charge the time elapsed since the last lap of a
+ * phase timer to a phase of its trace.
+ * @clk: pointer to the timer to lap.
+ * @phase: phase that has just completed.
+ */
+void hx_nus_clock_lap (hx_nus_clock *clk, enum hx_nus_phase phase) {
+  /* declare a required variable:
+   * @t: current wall-clock time.
+   */
+  double t;
+
+  /* return if the trace is not being timed. */
+  if (!clk->tm)
+    return;
+
+  /* charge the elapsed time and begin the next phase. */
+  t = omp_get_wtime();
+  clk->tm[phase] += t - clk->t0;
+  clk->t0 = t;
+}
+
+/* hx_nus_log_iter(): record the residual, objective and iteration
+ * parameter of the estimate of a trace. the values are kept as the latest
+ * of the trace, and stored as an iteration record if the iteration count
+ * falls on the telemetry spacing.
+ * @stop: pointer to the stopping criteria holding the telemetry.
+ * @j: index of the reconstructed trace.
+ * @iter: number of iterations performed on the trace.
+ * @rss: sum of squared residuals of the estimate.
+ * @xss: sum of squares that the residuals are relative to.
+ * @obj: objective value of the estimate.
+ * @par: iteration parameter of the estimate.
+ */
+void hx_nus_log_iter (hx_nus_stop *stop, int j, int iter,
+                      real rss, real xss, real obj, real par) {
+  /* declare a required variable:
+   * @r: iteration record to fill.
+   */
+  hx_nus_rec *r;
+
+  /* return if no telemetry is recorded. */
+  if (!stop->log)
+    return;
+
+  /* store the latest values of the trace. */
+  stop->res[j] = sqrt(xss > 0.0 ? rss / xss : rss);
+  stop->obj[j] = obj;
+  stop->par[j] = par;
+
+  /* return if the iteration is not recorded or no space remains. */
+  if (!stop->cap || iter % stop->every || stop->nrec[j] >= stop->cap)
+    return;
+
+  /* fill the next record of the trace. */
+  r = stop->rec + (size_t) j * stop->cap + stop->nrec[j]++;
+  r->iter = iter;
+  r->res = stop->res[j];
+  r->obj = obj;
+  r->par = par;
+}
+
+/* hx_nus_log_write(): write the telemetry of a reconstruction to a comma
+ * separated text file. lines beginning with '#' describe the columns of
+ * the 'trace' lines, which summarize each trace, and the 'iter' lines,
+ * which hold the iteration records of each trace.
+ * @stop: pointer to the completed stopping criteria.
+ * @fname: output filename.
+ * @name: name of the reconstruction method.
+ * @par: name of the iteration parameter of the method.
+ */
+int hx_nus_log_write (hx_nus_stop *stop, const char *fname,
+                      const char *name, const char *par) {
+  /* declare a few required variables:
+   * @j: trace loop counter.
+   * @l: record loop counter.
+   * @tm: phase timings of the current trace.
+   * @r: current iteration record.
+   * @fh: output file handle.
+   */
+  int j, l;
+  double *tm;
+  hx_nus_rec *r;
+  FILE *fh;
+
+  /* ensure telemetry was recorded. */
+  if (!stop->log || !stop->res)
+    throw("no telemetry was recorded");
+
+  /* open the output file. */
+  fh = fopen(fname, "w");
+  if (!fh)
+    throw("failed to open '%s'", fname);
+
+  /* write the header lines. */
+  fprintf(fh, "# hx-nus-log method=%s param=%s traces=%d limit=%d "
+              "every=%d\n", name, par, stop->n, stop->niter, stop->every);
+  fprintf(fh, "# trace,index,iters,res,obj,%s,fft,update,solve,other\n",
+          par);
+  fprintf(fh, "# iter,index,iter,res,obj,%s\n", par);
+
+  /* write the summary of each trace. */
+  for (j = 0; j < stop->n; j++) {
+    tm = stop->time + j * HX_NUS_NPHASE;
+    fprintf(fh, "trace,%d,%d,%.6le,%.6le,%.6le,%.6le,%.6le,%.6le,%.6le\n",
+            j, stop->iters[j], stop->res[j], stop->obj[j], stop->par[j],
+            tm[HX_NUS_PHASE_FFT], tm[HX_NUS_PHASE_UPDATE],
+            tm[HX_NUS_PHASE_SOLVE], tm[HX_NUS_PHASE_OTHER]);
+  }
+
+  /* write the iteration records of each trace. */
+  for (j = 0; j < stop->n && stop->cap; j++) {
+    for (l = 0; l < stop->nrec[j]; l++) {
+      r = stop->rec + (size_t) j * stop->cap + l;
+      fprintf(fh, "iter,%d,%d,%.6le,%.6le,%.6le\n",
+              j, r->iter, r->res, r->obj, r->par);
+    }
+  }
+
+  /* close the output file. */
+  if (fclose(fh))
+    throw("failed to write '%s'", fname);
+
+  /* return success. */
+  return 1;
+}
@@ -61,24 +61,72 @@ enum bruker_aqseq {
   BRUKER_AQSEQ_312
 };
 
+/* bruker_parse_parms(): parse every key/value pair of a bruker parameter
+ * file into a parameter table, leaving the values unparsed.
+ * @fh: the opened parameter file.
+ * @P: the destination parameter table.
+ */
+int bruker_parse_parms (FILE *fh, parms *P) {
+  /* declare required variables for file/string parsing:
+   * @buf: buffer string for each line of the file.
+   * @attr: string array of parameter key/value pairs.
+   * @nattr: length of @attr.
+   * @ok: whether the pair was stored.
+   */
+  char buf[N_BUF], **attr;
+  unsigned int nattr;
+  int ok;
+
+  /* loop until we've read the entire file. */
+  while (!feof(fh)) {
+    /* read a new line from the file. */
+    if (fgets(buf, N_BUF, fh)) {
+      /* trim trailing newlines from the string. */
+      strnltrim((char*) buf);
+
+      /* check if the current line can contain a key/value pair. */
+      if (strlen(buf) <= 3 || strncmp(buf, "##$", 3) || !strstr(buf, "= "))
+        continue;
+
+      /* split the string by an equals sign. */
+      attr = strsplit(buf + 3, "= ", &nattr);
+      if (!attr)
+        throw("failed to split parameter line");
+
+      /* store the key and its unparsed value. */
+      ok = parms_set(P, attr[0], nattr > 1 ? attr[1] : "");
+
+      /* free the string array. */
+      strvfree(attr, nattr);
+
+      /* check that the pair was stored. */
+      if (!ok)
+        throw("failed to store parameter");
+    }
+  }
+
+  /* return success. */
+  return 1;
+}
+
 /* bruker_read_parms(): read any number of parameters from a bruker
  * 'acqu', 'acqus', 'proc' or 'procs' file. each parameter requested
  * must be provided as a type char, a key string, and a result pointer.
+ * the file is parsed once into a cached table, so repeated calls on
+ * the same file only perform table lookups.
  * @fname: the parameter filename.
  * @n: the number of parameters to read.
  * @...: the parameters requested.
  */
 int bruker_read_parms (const char *fname, unsigned int n, ...) {
-  /* declare required variables for file/string parsing:
-   * @buf: buffer string for each line of the file.
-   * @attr: string array of parameter key/value pairs.
-   * @ncpy: number of chars to copy for key/value pairs.
-   * @nattr: length of @attr.
-   * @fh: the input file handle.
+  /* declare required variables for parameter lookup:
+   * @P: the parsed parameter table.
+   * @str: unparsed value of the current parameter.
+   * @ncpy: number of chars to copy for string values.
    */
-  char buf[N_BUF], **attr;
-  unsigned int ncpy, nattr;
-  FILE *fh;
+  const char *str;
+  unsigned int ncpy;
+  parms *P;
 
   /* declare required variables for variable arguments parsing:
    * @i: parameter index, out of @n.
@@ -89,124 +137,68 @@ int bruker_read_parms (const char *fname, unsigned int n, ...) {
   va_list vl;
 
   /* declare required variables for key/value pair parsing:
-   * @keys: key string array.
-   * @typs: value type char array.
-   * @vals: result pointer array.
+   * @typ: currently parsed value type char.
    * @key: currently parsed key.
    * @val: currently parsed pointer.
    */
-  char **keys, *typs;
-  void **vals;
-  char *key;
+  char typ, *key;
   void *val;
 
-  /* open the file for reading. */
-  fh = fopen(fname, "rb");
+  /* get the parameter table of the file. */
+  P = parms_load(fname, bruker_parse_parms);
 
-  /* check that the file was opened. */
-  if (!fh)
-    throw("failed to open '%s'", fname);
+  /* check that the table was loaded. */
+  if (!P)
+    throw("failed to load parameters from '%s'", fname);
 
-  /* initialize the variable arguments list. */
+  /* initialize the variable arguments list and the number of read
+   * parameters.
+   */
   va_start(vl, n);
-
-  /* allocate memory to store the search options for each parameter. */
-  keys = (char**) malloc(n * sizeof(char*));
-  vals = (void**) malloc(n * sizeof(void*));
-  typs = (char*) malloc(n * sizeof(char));
-
-  /* check that the memory was allocated successfully. */
-  if (!keys || !vals || !typs)
-    throw("failed to allocate option arrays");
+  nid = 0;
 
   /* loop through the expected number of parameters. */
   for (i = 0; i < n; i++) {
     /* read a type, a key and a pointer from the arguments list. */
-    typs[i] = (char) va_arg(vl, int);
+    typ = (char) va_arg(vl, int);
     key = va_arg(vl, char*);
     val = va_arg(vl, void*);
 
-    /* allocate memory to hold the key string. */
-    keys[i] = (char*) malloc((strlen(key) + 1) * sizeof(char));
-
-    /* check that key string memory was allocated. */
-    if (!keys[i])
-      throw("failed to allocate key string %d", i);
-
-    /* copy the key string and pointer into their arrays. */
-    strcpy(keys[i], key);
-    vals[i] = val;
-  }
-
-  /* free the variable arguments list and initialize the number
-   * of read parameters.
-   */
-  va_end(vl);
-  nid = 0;
-
-  /* loop until we've read the entire file. */
-  while (!feof(fh)) {
-    /* read a new line from the file. */
-    if (fgets(buf, N_BUF, fh)) {
-      /* trim trailing newlines from the string. */
-      strnltrim((char*) buf);
-
-      /* check if the current line can contain a key/value pair. */
-      if (strlen(buf) <= 3 || strncmp(buf, "##$", 3) || !strstr(buf, "= "))
-        continue;
-
-      /* split the string by an equals sign. */
-      attr = strsplit(buf + 3, "= ", &nattr);
-
-      /* loop through the parameters to search for. */
-      for (i = 0; i < n; i++) {
-        /* check if the current parameter key is a match. */
-        if (strcmp(keys[i], attr[0]) == 0) {
-          /* yep! increment the number of identified parameters. */
-          nid++;
-
-          /* act based on the parameter type. */
-          switch (typs[i]) {
-            /* integer. */
-            case BRUKER_PARMTYPE_INT:
-              *((int*) vals[i]) = atol(attr[1]);
-              break;
-
-            /* float */
-            case BRUKER_PARMTYPE_FLOAT:
-              *((float*) vals[i]) = atof(attr[1]);
-              break;
-
-            /* string */
-            case BRUKER_PARMTYPE_STRING:
-              ncpy = strlen(attr[1]) - 2;
-              strncpy(vals[i], attr[1] + 1, ncpy);
-              ((char*) vals[i])[ncpy] = '\0';
-              break;
-
-            /* other. */
-            default:
-              break;
-          }
-        }
-      }
-
-      /* free the string array. */
-      strvfree(attr, nattr);
+    /* look up the parameter, skipping it if it was not found. */
+    str = parms_get(P, key);
+    if (!str)
+      continue;
+
+    /* increment the number of identified parameters. */
+    nid++;
+
+    /* act based on the parameter type. */
+    switch (typ) {
+      /* integer. */
+      case BRUKER_PARMTYPE_INT:
+        *((int*) val) = atol(str);
+        break;
+
+      /* float */
+      case BRUKER_PARMTYPE_FLOAT:
+        *((float*) val) = atof(str);
+        break;
+
+      /* string */
+      case BRUKER_PARMTYPE_STRING:
+        ncpy = (strlen(str) >= 2 ? strlen(str) - 2 : 0);
+        strncpy(val, str + (ncpy ? 1 : 0), ncpy);
+        ((char*) val)[ncpy] = '\0';
+        break;
+
+      /* other. */
+      default:
+        break;
     }
   }
 
-  /* close the input file. */
-  fclose(fh);
-
-  /* free each key string in the array. */
-  for (i = 0; i < n; i++)
-    free(keys[i]);
-
-  /* free the temporary search option arrays. */
-  free(keys);
-  free(vals);
-  free(typs);
+  /* free the variable arguments list. */
+  va_end(vl);
 
   /* return the number of read parameters. */
   return nid;
@@ -502,84 +494,3 @@ int bruker_array (datum *D) {
   return 1;
 }
 
-/* bruker_post(): correct a hypercomplex array loaded from a bruker raw data
- * file for group delay.
- * @D: pointer to the datum structure.
- */
-int bruker_post (datum *D) {
-  /* declare a few required variables:
-   * @A: current absolute intensity value.
-   * @Are: current real intensity value.
-   * @Aim: current imaginary intensity value.
-   * @Amax: maximum absolute intensity value.
-   * @gd: local variable used for group delay correction.
-   * @gdmax: first trace index having maximal absolute intensity.
-   * @sznew: array of new size values.
-   * @i: dimension loop counter.
-   * @x: datum array structure pointer.
-   */
-  real A, Are, Aim, Amax;
-  int i, gd, gdmax;
-  hx_index sznew;
-  hx_array *x;
-
-  /* store the group delay value and array pointer locally. */
-  gd = (int) D->grpdelay;
-  x = &D->array;
-
-  /* check if the group delay value needs autodetection. */
-  if (gd == -1) {
-    /* loop until the trace intensity maximum is located. */
-    for (gd = 0, gdmax = 0, Amax = 0.0; gd < x->sz[0]; gd++) {
-      /* get the real and imaginary components of the trace. */
-      Are = x->x[0 + gd * x->n];
-      Aim = x->x[1 + gd * x->n];
-
-      /* compute the trace magnitude. */
-      A = sqrt(Are * Are + Aim * Aim);
-
-      /* check if the current point has greater intensity than @Imax. */
-      if (A > Amax) {
-        /* store the new value. */
-        gdmax = gd;
-        Amax = A;
-      }
-    }
-
-    /* store the autodetected group delay. */
-    gd = gdmax;
-  }
-
-  /* allocate the new size array. */
-  sznew = hx_index_alloc(x->k);
-
-  /* check that the size array was allocated. */
-  if (!sznew)
-    throw("failed to allocate %d indices", x->k);
-
-  /* fill the new size array. */
-  for (i = 0; i < x->k; i++)
-    sznew[i] = x->sz[i];
-
-  /* left-shift each trace based on the group delay value. */
-  if (!hx_array_shift(x, 0, -gd))
-    throw("failed to correct bruker group delay");
-
-  /* correct the first dimension of the size array. */
-  sznew[0] -= gd;
-
-  /* crop the shifted array. */
-  if (!hx_array_resize(x, x->d, x->k, sznew))
-    throw("failed to crop bruker group delay points");
-
-  /* free the allocated size array. */
-  hx_index_free(sznew);
-
-  /* correct the datum fields. */
-  D->dims[0].sz -= gd;
-  D->grpdelay = 0.0;
-
-  /* return success. */
-  return 1;
-}
-
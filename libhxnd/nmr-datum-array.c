@@ -139,6 +139,56 @@ int datum_array_infill (datum *D) {
   return 1;
 }
 
+/* datum_array_grpdelay(): return the number of leading points to remove
+ * from each direct-dimension trace of a freshly loaded datum array to
+ * correct its digital filter group delay. a group delay of -1 requests
+ * autodetection from the first trace intensity maximum, which sign
+ * corrections do not move.
+ * @D: pointer to the datum to examine.
+ */
+int datum_array_grpdelay (datum *D) {
+  /* declare a few required variables:
+   * @A: current absolute intensity value.
+   * @Are: current real intensity value.
+   * @Aim: current imaginary intensity value.
+   * @Amax: maximum absolute intensity value.
+   * @gd: group delay loop counter.
+   * @gdmax: first trace index having maximal absolute intensity.
+   * @x: datum array structure pointer.
+   */
+  real A, Are, Aim, Amax;
+  int gd, gdmax;
+  hx_array *x;
+
+  /* store the group delay value and array pointer locally. */
+  gd = (int) D->grpdelay;
+  x = &D->array;
+
+  /* return the stored value if no autodetection is needed. */
+  if (gd != -1)
+    return (gd > 0 ? gd : 0);
+
+  /* loop until the trace intensity maximum is located. */
+  for (gd = 0, gdmax = 0, Amax = 0.0; gd < x->sz[0]; gd++) {
+    /* get the real and imaginary components of the trace. */
+    Are = x->x[0 + gd * x->n];
+    Aim = x->x[1 + gd * x->n];
+
+    /* compute the trace magnitude. */
+    A = sqrt(Are * Are + Aim * Aim);
+
+    /* check if the current point has greater intensity than @Amax. */
+    if (A > Amax) {
+      /* store the new value. */
+      gdmax = gd;
+      Amax = A;
+    }
+  }
+
+  /* return the autodetected group delay. */
+  return gdmax;
+}
+
 /* datum_array_refactor(): repack, infill and deinterlace the core array
  * structure of an NMR datum until it's dimensionality and complexity agree
  * with the dimension parameter values.
@@ -147,7 +197,11 @@ int datum_array_infill (datum *D) {
 int datum_array_refactor (datum *D) {
   /* declare a few required variables:
    * @d: dimension loop counter.
+   * @alt: mask of sign-alternated topological dimensions.
+   * @neg: mask of imaginary-negated algebraic dimensions.
+   * @gd: number of group delay points to remove.
    */
+  int alt, neg, gd;
   unsigned int d;
 
   /* check that the array has been allocated. */
@@ -182,23 +236,35 @@ int datum_array_refactor (datum *D) {
     D->dims[d].k = (int) d;
   }
 
-  /* handle post-refactor array tweaking operations. */
-  for (d = 0; d < D->nd; d++) {
-    /* check if sign alternation is needed. */
-    if (D->dims[d].alt) {
-      /* apply sign alternation. */
-      if (!hx_array_alternate_sign(&D->array, D->dims[d].k))
-        throw("failed to sign-alternate dimension %d", D->dims[d].k);
-    }
+  /* resolve the group delay correction of the datum. */
+  gd = datum_array_grpdelay(D);
+
+  /* build the masks of sign-alternated and imaginary-negated dimensions. */
+  for (d = 0, alt = neg = 0; d < D->nd; d++) {
+    /* include dimensions needing sign alternation. */
+    if (D->dims[d].alt)
+      alt |= (1 << D->dims[d].k);
 
-    /* check if imaginary negation is needed. */
+    /* include dimensions needing imaginary negation. */
     if (D->dims[d].neg) {
-      /* apply imaginary negation. */
-      if (!hx_array_negate_basis(&D->array, D->dims[d].d))
-        throw("failed to negate imaginary dimension %d", D->dims[d].d);
+      /* check that the dimension is complex. */
+      if (D->dims[d].d < 0 || D->dims[d].d >= D->array.d)
+        throw("algebraic dimension %d out of bounds [0,%d)",
+              D->dims[d].d, D->array.d);
+
+      /* include the algebraic dimension. */
+      neg |= (1 << D->dims[d].d);
     }
   }
 
+  /* apply the sign and group delay corrections in a single pass. */
+  if (!hx_array_correct(&D->array, alt, neg, gd))
+    throw("failed to apply array corrections");
+
+  /* remove the group delay points from the datum. */
+  D->dims[0].sz -= gd;
+  D->grpdelay = 0.0;
+
   /* return success. */
   return 1;
 }
@@ -283,7 +349,8 @@ int datum_array_read (datum *D) {
   /* refactor the core array, but only if it's *not* already in
    * the native hxnd format.
    */
-  if (D->type != DATUM_TYPE_HXND && !datum_array_refactor(D))
+  if (D->type != DATUM_TYPE_HXND && D->type != DATUM_TYPE_HXNDC &&
+      !datum_array_refactor(D))
     throw("failed to refactor array");
 
   /* post-process the array using format-specific routines. */
@@ -346,25 +413,73 @@ int datum_array_resize (datum *D, hx_index sz) {
   return 1;
 }
 
+/* datum_array_read_region(): read a region of the array data of an NMR
+ * datum, with datum_array_slice() semantics. formats that support region
+ * reads only load the portion of the array data that overlaps the region,
+ * and all others are read completely and then sliced.
+ * @D: pointer to the datum to manipulate.
+ * @lower: lower bound index array.
+ * @upper: upper bound index array.
+ */
+int datum_array_read_region (datum *D, hx_index lower, hx_index upper) {
+  /* declare a few required variables:
+   * @d: dimension loop counter.
+   * @plain: whether the array needs no refactoring after being read.
+   */
+  unsigned int d, plain;
+
+  /* arrays of formats other than hx are refactored after being read, which
+   * region reads cannot do. such arrays may only be read by region when
+   * refactoring would leave them unchanged.
+   */
+  plain = 1;
+  if (D->type != DATUM_TYPE_HXND && D->type != DATUM_TYPE_HXNDC) {
+    /* check for complex, nonuniform or sign-corrected dimensions. */
+    for (d = 0; d < D->nd; d++) {
+      if (D->dims[d].cx || D->dims[d].nus ||
+          D->dims[d].alt || D->dims[d].neg)
+        plain = 0;
+    }
+  }
+
+  /* read the entire array if the format cannot read regions. */
+  if (D->array_alloc || !plain || !datum_type_has_region(D->type)) {
+    /* read and slice the array. */
+    if (!datum_array_read(D) || !datum_array_slice(D, lower, upper))
+      throw("failed to read array region");
+
+    /* return success. */
+    return 1;
+  }
+
+  /* check that the filename is non-null and non-empty. */
+  if (D->fname == NULL || strlen(D->fname) == 0)
+    throw("filename is invalid");
+
+  /* load the array region using format-specific routines. */
+  if (!datum_type_region(D, D->type, lower, upper))
+    throw("failed to read array region");
+
+  /* indicate that the array has been allocated. */
+  D->array_alloc = 1;
+
+  /* remove any dimensions that were sliced down to a single point. */
+  if (!datum_array_compact(D))
+    throw("failed to compact array region");
+
+  /* return success. */
+  return 1;
+}
+
 /* datum_array_slice(): slice out a portion of the array from an NMR datum.
  * @D: pointer to the datum to manipulate.
  * @lower: lower bound index array.
  * @upper: upper bound index array.
  */
 int datum_array_slice (datum *D, hx_index lower, hx_index upper) {
-  /* declare a few required variables:
-   * @dim: datum dimension index.
-   * @k: previous topological dimension count.
-   * @dnew: new number of algebraic dimensions.
-   * @knew: new number of topological dimensions.
-   * @drm: number of removed algebraic dimensions.
-   * @krm: number of removed topological dimensions.
-   * @ordd: algebraic dimension reordering array.
-   * @ordk: topological dimension reordering array.
+  /* declare a required variable:
    * @arrnew: destination slice array.
    */
-  int dim, d, k, dnew, knew, drm, krm, dadj, kadj;
-  hx_index ordd, ordk;
   hx_array arrnew;
 
   /* initialize the local array values, just to be safe. */
@@ -379,6 +494,29 @@ int datum_array_slice (datum *D, hx_index lower, hx_index upper) {
   hx_array_copy(&D->array, &arrnew);
   hx_array_free(&arrnew);
 
+  /* update the datum dimensions to match the sliced array. */
+  return datum_array_compact(D);
+}
+
+/* datum_array_compact(): update the dimensions of an NMR datum after its
+ * core array has been sliced, removing all dimensions that were reduced to
+ * a single point.
+ * @D: pointer to the datum to manipulate.
+ */
+int datum_array_compact (datum *D) {
+  /* declare a few required variables:
+   * @dim: datum dimension index.
+   * @k: previous topological dimension count.
+   * @dnew: new number of algebraic dimensions.
+   * @knew: new number of topological dimensions.
+   * @drm: number of removed algebraic dimensions.
+   * @krm: number of removed topological dimensions.
+   * @ordd: algebraic dimension reordering array.
+   * @ordk: topological dimension reordering array.
+   */
+  int dim, d, k, dnew, knew, drm, krm, dadj, kadj;
+  hx_index ordd, ordk;
+
   /* get the current dimensionalities of the datum array. */
   d = D->array.d;
   k = D->array.k;
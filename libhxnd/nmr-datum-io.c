@@ -60,6 +60,43 @@ int datum_load (datum *D, const char *fname) {
   return 1;
 }
 
+/* datum_load_region(): read a region of a file (of any supported format)
+ * into a datum structure, with datum_array_slice() semantics.
+ * @D: pointer to the destination datum structure.
+ * @fname: the input filename.
+ * @lower: lower bound index array.
+ * @upper: upper bound index array.
+ */
+int datum_load_region (datum *D, const char *fname,
+                       hx_index lower, hx_index upper) {
+  /* initialize the datum contents. */
+  datum_init(D);
+
+  /* check the input filename. */
+  if (!fname)
+    throw("invalid input filename");
+
+  /* determine the type of the datum. */
+  D->type = datum_type_guess(fname);
+
+  /* check that the type is supported. */
+  if (D->type == DATUM_TYPE_UNDEFINED)
+    throw("failed to identify format of '%s'", fname);
+
+  /* decode the file parameters. */
+  if (!datum_type_decode(D, fname, D->type))
+    throw("failed to decode %s-format parameters from '%s'",
+          datum_type_name(D->type), fname);
+
+  /* read the array region from the file. */
+  if (!datum_array_read_region(D, lower, upper))
+    throw("failed to read %s-format array region from '%s'",
+          datum_type_name(D->type), fname);
+
+  /* return success. */
+  return 1;
+}
+
 /* datum_print(): print the metadata associated with an acquired NMR datum.
  * @D: the datum to print data from.
  * @fname: the output filename.
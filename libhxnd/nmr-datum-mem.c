@@ -45,6 +45,7 @@ void datum_init (datum *D) {
   D->sched = NULL;
   D->d_sched = 0;
   D->n_sched = 0;
+  hx_sched_init(&D->sched_idx);
 
   /* initialize the group delay value. */
   D->grpdelay = 0.0;
@@ -70,6 +71,9 @@ void datum_free (datum *D) {
   if (D->sched)
     free(D->sched);
 
+  /* free the schedule index sets. */
+  hx_sched_free(&D->sched_idx);
+
   /* free the array data. */
   datum_array_free(D);
 
@@ -23,87 +23,144 @@
 /* include the nmr data header. */
 #include <hxnd/nmr-datum.h>
 
-/* declare a buffer size for reading bruker/varian schedule files.
- */
-#define N_BUF  256
-
 /* datum_sched_read(): read a bruker/varian schedule file into the schedule
- * array of a datum structure.
+ * array of a datum structure. the file is read in a single block and
+ * parsed in one pass, with geometric growth of the schedule array.
  * @D: pointer to the datum structure to manipulate.
  * @fname: the input filename.
  */
 int datum_sched_read (datum *D, const char *fname) {
   /* declare required variables:
-   * @buf: character buffer for reading lines.
-   * @tokv: array of token strings.
-   * @tokc: number of strings in @tokc.
+   * @buf: contents of the input file.
+   * @nbuf: number of bytes in @buf.
+   * @pos: current parsing position in @buf.
+   * @line: current line number in @buf.
    * @d: number of schedule columns.
    * @n: number of schedule rows.
-   * @i: general purpose loop index.
+   * @i: number of values in the current row.
+   * @nv: number of parsed schedule values.
+   * @nmax: number of values allocated in @sched.
+   * @val: currently parsed value.
+   * @nd: number of digits in the currently parsed value.
+   * @neg: whether the currently parsed value is negative.
    * @sched: output schedule array.
-   * @fh: input file handle.
    */
-  char buf[N_BUF], **tokv;
-  unsigned int toki, tokc;
+  unsigned int nbuf, pos;
+  int d, n, i, nv, nmax, val, nd, neg, line;
   hx_index sched;
-  int d, n, i;
-  FILE *fh;
-
-  /* initialize the results. */
-  sched = NULL;
-  d = n = 0;
-
-  /* open the input file. */
-  fh = fopen(fname, "rb");
+  uint8_t *buf;
 
-  /* check that the input file was opened. */
-  if (!fh)
+  /* check that the schedule file exists. */
+  if (!bytes_fexist(fname))
     throw("failed to open '%s'", fname);
 
-  /* initialize the array index. */
-  i = 0;
+  /* read the entire schedule file. empty files hold empty schedules. */
+  nbuf = bytes_size(fname);
+  buf = (nbuf ? bytes_read_block(fname, 0, nbuf) : NULL);
 
-  /* loop until we've read the entire file. */
-  while (!feof(fh)) {
-    /* read a new line from the file. */
-    if (fgets(buf, N_BUF, fh)) {
-      /* split the read line into tokens. */
-      tokv = strsplit(buf, " ", &tokc);
+  /* check that the file was read. */
+  if (nbuf && !buf)
+    throw("failed to read '%s'", fname);
 
-      /* check that the split was successful. */
-      if (!tokv || tokc < 1)
-        throw("failed to split string '%s'", buf);
+  /* initialize the results. */
+  nmax = 256;
+  sched = hx_index_alloc(nmax);
+  d = n = i = nv = 0;
+  line = 1;
+
+  /* check that allocation succeeded. */
+  if (!sched) {
+    /* free the file contents and return failure. */
+    free(buf);
+    throw("failed to allocate schedule array");
+  }
 
-      /* trim the token strings. */
-      strvtrim(tokv, tokc);
+  /* loop over the characters of the file. */
+  for (pos = 0; pos <= nbuf; pos++) {
+    /* check for the end of a line. */
+    if (pos == nbuf || buf[pos] == '\n') {
+      /* skip empty lines. */
+      if (i == 0) {
+        line++;
+        continue;
+      }
+
+      /* store/check the number of row elements. */
+      if (n == 0)
+        d = i;
+      else if (i != d) {
+        /* free the allocated arrays and return failure. */
+        free(buf);
+        free(sched);
+        throw("unexpected token count %d on line %d of '%s'",
+              i, line, fname);
+      }
+
+      /* increment the row and line counts and reset the row value
+       * count.
+       */
+      n++;
+      line++;
+      i = 0;
+      continue;
+    }
 
-      /* store/check the number of array elements. */
-      if (i == 0)
-        d = tokc;
-      else if (tokc != d)
-        throw("unexpected token count %d", tokc);
+    /* skip whitespace between values. */
+    if (isspace(buf[pos]))
+      continue;
+
+    /* read the sign of the value. */
+    neg = (buf[pos] == '-');
+    if (neg)
+      pos++;
+
+    /* accumulate the digits of the value. */
+    for (val = 0, nd = 0; pos < nbuf && isdigit(buf[pos]); pos++, nd++)
+      val = 10 * val + (buf[pos] - '0');
+
+    /* check that the value is an integer, terminated by whitespace or the
+     * end of the file.
+     */
+    if (nd == 0 || (pos < nbuf && !isspace(buf[pos]))) {
+      /* free the allocated arrays and return failure. */
+      free(buf);
+      free(sched);
+      throw("invalid schedule value on line %d of '%s'", line, fname);
+    }
 
-      /* increment the row count. */
-      n++;
+    /* step back so the terminating character is examined. */
+    pos--;
 
-      /* reallocate the schedule array. */
-      sched = (hx_index) realloc(sched, d * n * sizeof(int));
+    /* grow the schedule array, if required. */
+    if (nv == nmax) {
+      nmax *= 2;
+      sched = (hx_index) realloc(sched, nmax * sizeof(int));
 
       /* check that the reallocation succeeded. */
-      if (!sched)
+      if (!sched) {
+        /* free the file contents and return failure. */
+        free(buf);
         throw("failed to reallocate schedule array");
+      }
+    }
 
-      /* loop over the tokens. */
-      for (toki = 0; toki < tokc; toki++, i++)
-        sched[i] = atoi(tokv[toki]);
+    /* store the value. */
+    sched[nv++] = (neg ? -val : val);
+    i++;
+  }
 
-      /* free the string array. */
-      strvfree(tokv, tokc);
-    }
+  /* free the file contents. */
+  free(buf);
+
+  /* store no schedule array for empty files. */
+  if (nv == 0) {
+    free(sched);
+    sched = NULL;
   }
 
-  /* close the input file. */
-  fclose(fh);
+  /* replace any existing schedule. */
+  free(D->sched);
+  hx_sched_free(&D->sched_idx);
 
   /* store the identified array parameters. */
   D->d_sched = d;
@@ -116,6 +173,38 @@ int datum_sched_read (datum *D, const char *fname) {
   return 1;
 }
 
+/* datum_sched_index(): return the sampled and unsampled index sets of the
+ * schedule of a datum over a grid. the sets are built once and shared by
+ * all later requests over the same grid.
+ * @D: pointer to the datum holding the schedule.
+ * @k: number of grid dimensions.
+ * @sz: grid dimension sizes.
+ */
+hx_sched *datum_sched_index (datum *D, int k, hx_index sz) {
+  /* check that the datum holds a schedule. */
+  if (!D->sched || D->d_sched < 1 || D->n_sched < 1) {
+    /* raise an error and return nothing. */
+    raise("datum contains no schedule array");
+    return NULL;
+  }
+
+  /* return the current sets if they were built over the same grid. */
+  if (hx_sched_match(&D->sched_idx, k, sz))
+    return &D->sched_idx;
+
+  /* build the sets over the requested grid. */
+  if (!hx_sched_build(&D->sched_idx, k, sz,
+                      D->d_sched, D->n_sched, D->sched)) {
+    /* raise an error and return nothing. */
+    raise("schedule (%dx%d) does not fit its %d-dimensional grid",
+          D->d_sched, D->n_sched, k);
+    return NULL;
+  }
+
+  /* return the new sets. */
+  return &D->sched_idx;
+}
+
 /* datum_sched_free(): free the nonuniform schedule information contained
  * within a datum structure, if any exists.
  * @D: pointer to the datum to manipulate.
@@ -130,6 +219,9 @@ int datum_sched_free (datum *D) {
   if (D->sched)
     free(D->sched);
 
+  /* free the schedule index sets. */
+  hx_sched_free(&D->sched_idx);
+
   /* re-initialize the datum schedule information. */
   D->sched = NULL;
   D->d_sched = 0;
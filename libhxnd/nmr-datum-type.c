@@ -42,12 +42,14 @@ struct datum_type_def {
    * @decfn: pointer to the function for formatted parameter reading.
    * @arrayfn: pointer to the function for formatted array reading.
    * @postfn: pointer to the function for post-array read fixes.
+   * @regionfn: pointer to the function for formatted region reading.
    */
   int (*guessfn) (const char *fname);
   int (*encfn) (datum *D, const char *fname);
   int (*decfn) (datum *D, const char *fname);
   int (*arrayfn) (datum *D);
   int (*postfn) (datum *D);
+  int (*regionfn) (datum *D, hx_index lower, hx_index upper);
 };
 
 /* datum_types: local table of all available datum type names, values
@@ -60,13 +62,47 @@ static const struct datum_type_def datum_types[] = {
     &hxnd_encode,
     &hxnd_decode,
     &hxnd_array,
-    NULL },
+    NULL,
+    &hxnd_region },
+  { DATUM_TYPE_HXNDC, "hxc",
+    "Chunked native hypercomplex",
+    NULL,
+    &hxnd_encode_chunked,
+    &hxnd_decode,
+    &hxnd_array,
+    NULL,
+    &hxnd_region },
   { DATUM_TYPE_TEXT, "text",
     "Plain text",
     NULL,
     &text_encode,
     NULL,
     NULL,
+    NULL,
+    NULL },
+  { DATUM_TYPE_TEXTR, "textr",
+    "Plain text, real coefficients",
+    NULL,
+    &text_encode_real,
+    NULL,
+    NULL,
+    NULL,
+    NULL },
+  { DATUM_TYPE_TEXTV, "textv",
+    "Plain text, no indices",
+    NULL,
+    &text_encode_values,
+    NULL,
+    NULL,
+    NULL,
+    NULL },
+  { DATUM_TYPE_TEXTRV, "textrv",
+    "Plain text, real coefficients, no indices",
+    NULL,
+    &text_encode_real_values,
+    NULL,
+    NULL,
+    NULL,
     NULL },
   { DATUM_TYPE_BRUKER, "bruker",
     "Bruker unprocessed",
@@ -74,13 +110,15 @@ static const struct datum_type_def datum_types[] = {
     NULL,
     &bruker_decode,
     &bruker_array,
-    &bruker_post },
+    NULL,
+    NULL },
   { DATUM_TYPE_VARIAN, "varian",
     "Varian/Agilent unprocessed",
     &varian_guess,
     NULL,
     &varian_decode,
     &varian_array,
+    NULL,
     NULL },
   { DATUM_TYPE_PIPE, "pipe",
     "NMRPipe",
@@ -88,6 +126,15 @@ static const struct datum_type_def datum_types[] = {
     &pipe_encode,
     &pipe_decode,
     &pipe_array,
+    NULL,
+    NULL },
+  { DATUM_TYPE_PIPES, "pipeseries",
+    "NMRPipe plane series",
+    NULL,
+    &pipe_encode_series,
+    NULL,
+    NULL,
+    NULL,
     NULL },
   { DATUM_TYPE_UCSF, "ucsf",
     "UCSF/Sparky",
@@ -95,22 +142,26 @@ static const struct datum_type_def datum_types[] = {
     &ucsf_encode,
     &ucsf_decode,
     &ucsf_array,
-    NULL },
+    NULL,
+    &ucsf_region },
   { DATUM_TYPE_NV, "nv",
     "NMRView/NMRViewJ",
     &nv_guess,
     &nv_encode,
     &nv_decode,
     &nv_array,
-    &nv_post },
+    &nv_post,
+    &nv_region },
   { DATUM_TYPE_RNMRTK, "rnmrtk",
     "Rowland NMR Toolkit",
     &rnmrtk_guess,
     &rnmrtk_encode,
     &rnmrtk_decode,
     &rnmrtk_array,
+    NULL,
     NULL },
-  { DATUM_TYPE_UNDEFINED, NULL, NULL, NULL, NULL, NULL, NULL, NULL }
+  { DATUM_TYPE_UNDEFINED, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+    NULL }
 };
 
 /* datum_type_name(): return the string short name of an enumerated datum
@@ -297,3 +348,49 @@ int datum_type_post (datum *D, enum datum_type typ) {
   return 1;
 }
 
+/* datum_type_has_region(): check whether a datum format supports reading
+ * regions of its array data directly from files.
+ * @typ: the input format type.
+ */
+int datum_type_has_region (enum datum_type typ) {
+  /* declare a required variable. */
+  unsigned int i;
+
+  /* loop over all supported datum types. */
+  for (i = 0; datum_types[i].name; i++) {
+    /* check the region function if the type matches. */
+    if (typ == datum_types[i].type)
+      return (datum_types[i].regionfn ? 1 : 0);
+  }
+
+  /* no match. */
+  return 0;
+}
+
+/* datum_type_region(): read a region of array data into an NMR datum
+ * structure from a file that follows a specified format.
+ * @D: pointer to the destination datum structure.
+ * @typ: the input format type.
+ * @lower: lower region bounds.
+ * @upper: upper region bounds.
+ */
+int datum_type_region (datum *D, enum datum_type typ,
+                       hx_index lower, hx_index upper) {
+  /* declare a required variable. */
+  unsigned int i;
+
+  /* loop over all supported datum types. */
+  for (i = 0; datum_types[i].name; i++) {
+    /* skip formats with no available region function. */
+    if (!datum_types[i].regionfn)
+      continue;
+
+    /* run the region function if the type matches. */
+    if (typ == datum_types[i].type)
+      return datum_types[i].regionfn(D, lower, upper);
+  }
+
+  /* return failure. */
+  throw("datum format '%s' does not support region reading",
+        datum_type_name(typ));
+}
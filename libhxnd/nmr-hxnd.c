@@ -43,6 +43,268 @@
 #define HXND_S_NEG      0x0000000000000010
 #define HXND_S_GENH     0x0000000000000020
 
+/* define a flag set in the schedule dimensionality word of binary datum
+ * files whose schedule is stored in compact form, along with the forms of
+ * compact schedule storage.
+ */
+#define HXND_SCHED_PACKED  0x0000000100000000
+#define HXND_SCHED_BITMAP  1
+#define HXND_SCHED_SORTED  2
+
+/* define the number of (u64) members that lead a compact schedule.
+ */
+#define HXND_SZ_SCHED  2
+
+/* hxnd_sched_cmp(): compare two packed schedule indices for qsort().
+ * @a: pointer to the first index.
+ * @b: pointer to the second index.
+ */
+int hxnd_sched_cmp (const void *a, const void *b) {
+  /* compare the index values. */
+  const uint32_t va = *((const uint32_t*) a);
+  const uint32_t vb = *((const uint32_t*) b);
+  return (va > vb) - (va < vb);
+}
+
+/* hxnd_sched_pack(): build the compact form of a datum schedule, which
+ * holds the schedule grid size followed by either a bitmap of sampled grid
+ * points or a sorted list of 32-bit packed grid indices, whichever is
+ * smaller. returns NULL if the schedule can not be stored compactly.
+ * @D: pointer to the datum holding the schedule.
+ * @n_buf: pointer to the output number of words in the compact form.
+ */
+uint64_t *hxnd_sched_pack (datum *D, unsigned int *n_buf) {
+  /* declare a few required variables:
+   * @buf: output compact schedule words.
+   * @v: sorted packed grid indices of the schedule entries.
+   * @len: number of points in the schedule grid.
+   * @stride: grid stride of the current schedule column.
+   * @nbit: number of bitmap payload words.
+   * @nsrt: number of sorted-list payload words.
+   * @npay: number of payload words in the chosen form.
+   * @pidx: packed grid index of the current entry.
+   * @i, @j: schedule row and column loop counters.
+   * @d, @n: schedule column and row counts.
+   * @dup: whether any grid index is scheduled more than once.
+   */
+  uint64_t *buf, len, stride, nbit, nsrt, npay, pidx;
+  unsigned int i, j, d, n, dup;
+  uint32_t *v;
+
+  /* get the schedule dimensions. */
+  d = (unsigned int) D->d_sched;
+  n = (unsigned int) D->n_sched;
+
+  /* allocate the array of packed grid indices. */
+  v = (uint32_t*) malloc(n * sizeof(uint32_t));
+  buf = (uint64_t*) calloc(HXND_SZ_SCHED + d, sizeof(uint64_t));
+
+  /* check that allocation succeeded. */
+  if (!v || !buf) {
+    free(v);
+    free(buf);
+    return NULL;
+  }
+
+  /* compute the grid size from the largest value in each column. */
+  for (j = 0; j < d; j++) {
+    for (i = 0; i < n; i++) {
+      /* refuse to pack negative values. */
+      if (D->sched[i * d + j] < 0) {
+        free(v);
+        free(buf);
+        return NULL;
+      }
+
+      /* update the column size. */
+      if ((uint64_t) D->sched[i * d + j] + 1 > buf[HXND_SZ_SCHED + j])
+        buf[HXND_SZ_SCHED + j] = (uint64_t) D->sched[i * d + j] + 1;
+    }
+  }
+
+  /* compute the number of grid points. */
+  for (j = 0, len = 1; j < d; j++) {
+    len *= buf[HXND_SZ_SCHED + j];
+
+    /* refuse to pack grids that overflow a 32-bit index. */
+    if (len > UINT32_MAX) {
+      free(v);
+      free(buf);
+      return NULL;
+    }
+  }
+
+  /* pack each schedule entry into a grid index. */
+  for (i = 0; i < n; i++) {
+    for (j = 0, pidx = 0, stride = 1; j < d; j++) {
+      pidx += (uint64_t) D->sched[i * d + j] * stride;
+      stride *= buf[HXND_SZ_SCHED + j];
+    }
+
+    /* store the packed index. */
+    v[i] = (uint32_t) pidx;
+  }
+
+  /* sort the packed indices and check for duplicates. */
+  qsort(v, n, sizeof(uint32_t), hxnd_sched_cmp);
+  for (i = 1, dup = 0; i < n; i++)
+    dup = (dup || v[i] == v[i - 1]);
+
+  /* determine the payload sizes of each form. bitmaps can not hold
+   * duplicated entries.
+   */
+  nbit = (len + 63) / 64;
+  nsrt = ((uint64_t) n + 1) / 2;
+
+  /* store the chosen form and payload size. */
+  npay = (!dup && nbit < nsrt ? nbit : nsrt);
+  buf[0] = (npay == nsrt ? HXND_SCHED_SORTED : HXND_SCHED_BITMAP);
+  buf[1] = npay;
+
+  /* reallocate the output buffer to hold the payload. */
+  *n_buf = HXND_SZ_SCHED + d + (unsigned int) npay;
+  buf = (uint64_t*) realloc(buf, *n_buf * sizeof(uint64_t));
+
+  /* check that reallocation succeeded. */
+  if (!buf) {
+    free(v);
+    return NULL;
+  }
+
+  /* zero and fill the payload words. */
+  memset(buf + HXND_SZ_SCHED + d, 0, npay * sizeof(uint64_t));
+  for (i = 0; i < n; i++) {
+    /* set a bit or store a half-word. */
+    if (buf[0] == HXND_SCHED_BITMAP)
+      buf[HXND_SZ_SCHED + d + v[i] / 64] |= (uint64_t) 1 << (v[i] % 64);
+    else
+      buf[HXND_SZ_SCHED + d + i / 2] |= (uint64_t) v[i] << (32 * (i % 2));
+  }
+
+  /* free the packed indices and return the compact form. */
+  free(v);
+  return buf;
+}
+
+/* hxnd_sched_unpack(): rebuild the schedule array of a datum from the
+ * compact form read from a file. the rebuilt schedule entries are in
+ * ascending order of packed grid index.
+ * @D: pointer to the datum to receive the schedule.
+ * @buf: compact schedule words.
+ */
+int hxnd_sched_unpack (datum *D, uint64_t *buf) {
+  /* declare a few required variables:
+   * @pay: payload words of the compact form.
+   * @sz: schedule grid size.
+   * @len: number of points in the schedule grid.
+   * @pidx: packed grid index of the current entry.
+   * @i: schedule row loop counter.
+   * @j: schedule column loop counter.
+   * @d, @n: schedule column and row counts.
+   */
+  uint64_t *pay, len, pidx;
+  int i, j, d, n;
+  hx_index sz;
+
+  /* get the schedule dimensions and payload. */
+  d = D->d_sched;
+  n = D->n_sched;
+  pay = buf + HXND_SZ_SCHED + d;
+
+  /* allocate the schedule array and grid size. */
+  D->sched = hx_index_alloc(n * d);
+  sz = hx_index_alloc(d);
+
+  /* check that allocation succeeded. */
+  if (!D->sched || !sz)
+    throw("failed to allocate %d schedule indices", n * d);
+
+  /* store the grid size. */
+  for (j = 0, len = 1; j < d; j++) {
+    sz[j] = (int) buf[HXND_SZ_SCHED + j];
+    len *= buf[HXND_SZ_SCHED + j];
+  }
+
+  /* check that the payload agrees with its form. */
+  if ((buf[0] == HXND_SCHED_BITMAP && buf[1] != (len + 63) / 64) ||
+      (buf[0] == HXND_SCHED_SORTED && buf[1] != ((uint64_t) n + 1) / 2) ||
+      (buf[0] != HXND_SCHED_BITMAP && buf[0] != HXND_SCHED_SORTED))
+    throw("invalid compact schedule (form %u)", (unsigned int) buf[0]);
+
+  /* loop over the payload to unpack each entry. */
+  for (i = 0, pidx = 0; i < n; i++) {
+    /* locate the next scheduled grid index. */
+    if (buf[0] == HXND_SCHED_BITMAP) {
+      /* scan for the next set bit. */
+      while (pidx < len && !(pay[pidx / 64] & ((uint64_t) 1 << (pidx % 64))))
+        pidx++;
+
+      /* check that the bitmap holds enough entries. */
+      if (pidx >= len)
+        throw("compact schedule holds fewer than %d entries", n);
+    }
+    else {
+      /* read the next half-word. */
+      pidx = (pay[i / 2] >> (32 * (i % 2))) & UINT32_MAX;
+    }
+
+    /* unpack the grid index into the schedule row. */
+    hx_index_unpack(d, sz, D->sched + i * d, (int) pidx);
+    pidx++;
+  }
+
+  /* free the grid size and return success. */
+  hx_index_free(sz);
+  return 1;
+}
+
+/* hxnd_offset(): compute the byte offset of the array data in an opened
+ * hx-format file by reading its header.
+ * @fh: the input file handle, positioned at the start of the file.
+ * @offset: pointer to the output byte offset.
+ */
+int hxnd_offset (FILE *fh, long *offset) {
+  /* declare a few required variables:
+   * @buf: header words.
+   * @nw: number of header words preceding the array.
+   * @swapping: whether the file words must be byte-swapped.
+   */
+  uint64_t buf[HXND_SZ_HDR], nw;
+  int swapping;
+
+  /* read the file header. */
+  if (fread(buf, sizeof(uint64_t), HXND_SZ_HDR, fh) != HXND_SZ_HDR)
+    throw("failed to read header");
+
+  /* swap the header bytes, if required. */
+  swapping = (buf[0] != HXND_MAGIC);
+  if (swapping)
+    bytes_swap((uint8_t*) buf, HXND_SZ_HDR, sizeof(uint64_t));
+
+  /* count the header and dimension words. */
+  nw = HXND_SZ_HDR + buf[4] * HXND_SZ_DIM;
+
+  /* count the schedule words. */
+  if (buf[5] & HXND_SCHED_PACKED) {
+    /* read the leading compact schedule words. */
+    if (fread(buf, sizeof(uint64_t), HXND_SZ_SCHED, fh) != HXND_SZ_SCHED)
+      throw("failed to read compact schedule");
+
+    /* swap the words, if required. */
+    if (swapping)
+      bytes_swap((uint8_t*) buf, HXND_SZ_SCHED, sizeof(uint64_t));
+
+    /* add the grid size and payload words. */
+    nw += HXND_SZ_SCHED + (buf[5] & UINT32_MAX) + buf[1];
+  }
+  else
+    nw += buf[5] * buf[6];
+
+  /* return the byte offset. */
+  *offset = (long) (nw * sizeof(uint64_t));
+  return 1;
+}
+
 /* hxnd_guess(): check whether a file contains hx-native nmr data.
  * @fname: the input filename.
  */
@@ -94,8 +356,11 @@ int hxnd_decode (datum *D, const char *fname) {
    * @buf: output header/dimension buffer.
    * @status: status word value.
    * @fh: input file handle.
+   * @n_sched: number of stored schedule values.
+   * @swapping: whether the file words must be byte-swapped.
+   * @packed: whether the schedule is stored in compact form.
    */
-  unsigned int i, d, nd, n_buf, n_sched, swapping;
+  unsigned int i, d, nd, n_buf, n_sched, swapping, packed;
   uint64_t *buf, status;
   FILE *fh;
 
@@ -146,12 +411,44 @@ int hxnd_decode (datum *D, const char *fname) {
   D->type = (enum datum_type) buf[i++];
   D->epoch = (time_t) buf[i++];
   nd = (unsigned int) buf[i++];
-  D->d_sched = (int) buf[i++];
+  packed = (buf[i] & HXND_SCHED_PACKED ? 1 : 0);
+  D->d_sched = (int) (buf[i++] & UINT32_MAX);
   D->n_sched = (int) buf[i++];
 
   /* check if any schedule was stored in the file. */
   n_sched = D->n_sched * D->d_sched;
-  if (n_sched) {
+  if (n_sched && packed) {
+    /* read the leading compact schedule words. */
+    n_buf = HXND_SZ_SCHED;
+    if (fread(buf, sizeof(uint64_t), n_buf, fh) != n_buf)
+      throw("failed to read compact schedule");
+
+    /* swap the bytes, if required. */
+    if (swapping)
+      bytes_swap((uint8_t*) buf, n_buf, sizeof(uint64_t));
+
+    /* reallocate the buffer to hold the grid size and payload. */
+    n_buf = HXND_SZ_SCHED + D->d_sched + (unsigned int) buf[1];
+    buf = (uint64_t*) realloc(buf, n_buf * sizeof(uint64_t));
+
+    /* check that allocation succeeded. */
+    if (!buf)
+      throw("failed to allocate schedule buffer");
+
+    /* read the grid size and payload. */
+    n_buf -= HXND_SZ_SCHED;
+    if (fread(buf + HXND_SZ_SCHED, sizeof(uint64_t), n_buf, fh) != n_buf)
+      throw("failed to read compact schedule");
+
+    /* swap the bytes, if required. */
+    if (swapping)
+      bytes_swap((uint8_t*) (buf + HXND_SZ_SCHED), n_buf, sizeof(uint64_t));
+
+    /* rebuild the schedule array. */
+    if (!hxnd_sched_unpack(D, buf))
+      throw("failed to unpack compact schedule");
+  }
+  else if (n_sched) {
     /* allocate the schedule array. */
     D->sched = hx_index_alloc(n_sched);
 
@@ -262,11 +559,13 @@ int hxnd_decode (datum *D, const char *fname) {
   return 1;
 }
 
-/* hxnd_encode(): write a datum structure to a file.
+/* hxnd_write(): write a datum structure to a file, storing its core array
+ * either as a single block or as a grid of compressed chunks.
  * @D: pointer to the source datum structure.
  * @fname: the output filename.
+ * @chunked: whether to write the core array in chunked form.
  */
-int hxnd_encode (datum *D, const char *fname) {
+int hxnd_write (datum *D, const char *fname, int chunked) {
   /* declare a few required variables:
    * @i: buffer index.
    * @d: dimension loop counter.
@@ -274,11 +573,22 @@ int hxnd_encode (datum *D, const char *fname) {
    * @buf: output header/dimension buffer.
    * @status: status word value.
    * @fh: output file handle.
+   * @n_sched: number of stored schedule values.
+   * @n_pack: number of words in the compact schedule.
+   * @pack: compact schedule words.
    */
-  unsigned int i, j, d, n_buf, n_sched;
-  uint64_t *buf, status;
+  unsigned int i, j, d, n_buf, n_sched, n_pack;
+  uint64_t *buf, *pack, status;
   FILE *fh;
 
+  /* build the compact form of the schedule, if one exists. */
+  n_sched = D->n_sched * D->d_sched;
+  pack = (n_sched && D->sched ? hxnd_sched_pack(D, &n_pack) : NULL);
+
+  /* store the schedule values in compact form, if possible. */
+  if (pack)
+    n_sched = n_pack;
+
   /* open the output file. */
   if (fname)
     fh = fopen(fname, "wb");
@@ -290,7 +600,6 @@ int hxnd_encode (datum *D, const char *fname) {
     throw("failed to open '%s'", fname);
 
   /* allocate the header buffer. */
-  n_sched = D->n_sched * D->d_sched;
   n_buf = HXND_SZ_HDR + n_sched;
   buf = (uint64_t*) calloc(n_buf, sizeof(uint64_t));
 
@@ -305,12 +614,15 @@ int hxnd_encode (datum *D, const char *fname) {
   buf[i++] = (uint64_t) DATUM_TYPE_HXND;
   buf[i++] = (uint64_t) D->epoch;
   buf[i++] = (uint64_t) D->nd;
-  buf[i++] = (uint64_t) D->d_sched;
+  buf[i++] = (uint64_t) D->d_sched | (pack ? HXND_SCHED_PACKED : 0);
   buf[i++] = (uint64_t) D->n_sched;
 
-  /* add the schedule values into the header. */
+  /* add the compact or unpacked schedule values into the header. */
   for (j = 0; j < n_sched; j++)
-    buf[i++] = (uint64_t) D->sched[j];
+    buf[i++] = (pack ? pack[j] : (uint64_t) D->sched[j]);
+
+  /* free the compact schedule. */
+  free(pack);
 
   /* write the file header. */
   if (fwrite(buf, sizeof(uint64_t), n_buf, fh) != n_buf)
@@ -368,7 +680,10 @@ int hxnd_encode (datum *D, const char *fname) {
   free(buf);
 
   /* write the core array content to the end of the file stream. */
-  if (D->array_alloc && !hx_array_fwrite(&D->array, fh))
+  if (D->array_alloc && chunked &&
+      !hx_array_fwrite_chunked(&D->array, fh, HX_ARRAY_CODEC_ALL))
+    throw("failed to write chunked core array");
+  else if (D->array_alloc && !chunked && !hx_array_fwrite(&D->array, fh))
     throw("failed to write core array");
 
   /* close the output file. */
@@ -379,15 +694,46 @@ int hxnd_encode (datum *D, const char *fname) {
   return 1;
 }
 
+/* hxnd_encode(): write a datum structure to a file.
+ * @D: pointer to the source datum structure.
+ * @fname: the output filename.
+ */
+int hxnd_encode (datum *D, const char *fname) {
+  /* write the core array as a single block. */
+  return hxnd_write(D, fname, 0);
+}
+
+/* hxnd_encode_chunked(): write a datum structure to a file, with its core
+ * array stored in compressed chunks that support region reads.
+ * @D: pointer to the source datum structure.
+ * @fname: the output filename.
+ */
+int hxnd_encode_chunked (datum *D, const char *fname) {
+  /* write the core array in chunked form. */
+  return hxnd_write(D, fname, 1);
+}
+
 /* hxnd_array(): read hx-native array data into a datum structure.
  * @D: pointer to the destination datum structure.
  */
 int hxnd_array (datum *D) {
+  /* read the entire array. */
+  return hxnd_region(D, NULL, NULL);
+}
+
+/* hxnd_region(): read a region of hx-native array data into a datum
+ * structure, with hx_array_slice() semantics. only the array chunks that
+ * overlap the region are decoded from chunked files.
+ * @D: pointer to the destination datum structure.
+ * @lower: lower region bounds, or NULL to read the whole array.
+ * @upper: upper region bounds, or NULL to read the whole array.
+ */
+int hxnd_region (datum *D, hx_index lower, hx_index upper) {
   /* declare a few required variables:
    * @offset: byte offset designating the start of point data.
    * @fh: input file handle.
    */
-  unsigned int offset;
+  long offset;
   FILE *fh;
 
   /* open the input file. */
@@ -396,18 +742,20 @@ int hxnd_array (datum *D) {
   else
     throw("invalid input filename");
 
-  /* compute the offset. */
-  offset = HXND_SZ_HDR;
-  offset += D->d_sched * D->n_sched;
-  offset += D->nd * HXND_SZ_DIM;
-  offset *= sizeof(uint64_t);
+  /* check that the file was opened. */
+  if (!fh)
+    throw("failed to open '%s'", D->fname);
+
+  /* compute the offset from the stored header. */
+  if (!hxnd_offset(fh, &offset))
+    throw("failed to read header of '%s'", D->fname);
 
   /* seek past the header bytes. */
   if (fseek(fh, offset, SEEK_SET))
     throw("failed to seek to array in '%s'", D->fname);
 
   /* read the array data from the hx-format file. */
-  if (!hx_array_fread(&D->array, fh))
+  if (!hx_array_fread_region(&D->array, fh, lower, upper))
     throw("failed to read array from '%s'", D->fname);
 
   /* close the input file. */
@@ -416,4 +764,3 @@ int hxnd_array (datum *D) {
   /* return success. */
   return 1;
 }
-
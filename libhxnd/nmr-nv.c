@@ -20,6 +20,9 @@
  *   Boston, MA  02110-1301, USA.
  */
 
+/* request posix extensions for reentrant time conversion. */
+#define _POSIX_C_SOURCE 200809L
+
 /* include the nmrview header. */
 #include <hxnd/nmr-nv.h>
 
@@ -274,36 +277,20 @@ int nv_adjust_header (const char *fname, struct nv_header *hdr) {
   return 1;
 }
 
-/* nv_tiler(): redo or undo the tiling inherent in nmrview-format files,
- * effectively mapping between tiled array data and a real linear
- * array suitable for refactoring.
- * @x: pointer to the array to linearize.
+/* nv_tiling(): compute the tile counts and sizes of nmrview-format data
+ * from the file header.
  * @hdr: pointer to the file header.
- * @dir: direction, either 0 (linearize) or 1 (tileize).
+ * @nt: output array of tile counts.
+ * @szt: output array of tile sizes.
  */
-int nv_tiler (hx_array *x, struct nv_header *hdr, int dir) {
-  /* declare a few required variables:
+int nv_tiling (struct nv_header *hdr, hx_index nt, hx_index szt) {
+  /* declare a required variable:
    * @i: general purpose loop counter.
-   * @k: number of dimensions.
-   * @nt: array of tile counts.
-   * @szt: array of tile sizes.
    */
-  hx_index nt, szt;
-  int i, k;
-
-  /* gain a handle on the dimensionality of the array data. */
-  k = (int) hdr->ndims;
-
-  /* allocate the size index arrays. */
-  nt = hx_index_alloc(k);
-  szt = hx_index_alloc(k);
-
-  /* check that all index allocations were successful. */
-  if (!nt || !szt)
-    throw("failed to allocate two sets of %d indices", k);
+  int i;
 
   /* initialize the size arrays. */
-  for (i = 0; i < k; i++) {
+  for (i = 0; i < (int) hdr->ndims; i++) {
     /* check that the point and tile counts are nonzero. */
     if (hdr->dims[i].sz < 1 || hdr->dims[i].szblk < 1)
       throw("invalid tiling (%d, %d) along dimension %d",
@@ -321,28 +308,10 @@ int nv_tiler (hx_array *x, struct nv_header *hdr, int dir) {
     szt[i] = hdr->dims[i].szblk;
   }
 
-  /* perform the mapping operation. */
-  if (!hx_array_tiler(x, k, nt, szt, dir, HX_ARRAY_INCR_NORMAL))
-    throw("failed to perform tile mapping");
-
-  /* free the allocated index arrays. */
-  hx_index_free(nt);
-  hx_index_free(szt);
-
   /* return success. */
   return 1;
 }
 
-/* nv_linearize(): map tiles to linear array data.
- */
-#define nv_linearize(x, hdr) \
-  nv_tiler(x, hdr, HX_ARRAY_TILER_FORWARD)
-
-/* ucsf_tileize(): map linear array data to tiles.
- */
-#define nv_tileize(x, hdr) \
-  nv_tiler(x, hdr, HX_ARRAY_TILER_REVERSE)
-
 /* nv_guess(): check whether a file contains nmrview-format data.
  * @fname: the input filename.
  */
@@ -490,34 +459,34 @@ int nv_encode (datum *D, const char *fname) {
    * @n_tile: number of words per tile.
    * @hdr: the output file header structure.
    * @ts: calendar time structure.
+   * @tm: storage for @ts.
    * @fh: output file handle.
    */
   unsigned int i_div, n_tile;
   struct nv_header hdr;
-  struct tm *ts;
+  struct tm *ts, tm;
   FILE *fh;
 
-  /* declare variables required for size adjustment:
-   * @szadj: whether to adjust the array size.
+  /* declare variables required for size adjustment and tiling:
    * @sz: previous array size.
    * @sznew: adjusted array size.
+   * @nt: array of tile counts.
+   * @szt: array of tile sizes.
    */
-  hx_index sz, sznew;
-  int szadj;
+  hx_index sz, sznew, nt, szt;
 
   /* declare a dimension loop counter. */
   unsigned int d;
 
-  /* declare an array structure to use for writing. */
-  hx_array xout;
-
-  /* allocate size arrays for possible adjustments. */
+  /* allocate size arrays for adjustments and tiling. */
   sz = hx_index_alloc(D->array.k);
   sznew = hx_index_alloc(D->array.k);
+  nt = hx_index_alloc(D->array.k);
+  szt = hx_index_alloc(D->array.k);
 
   /* check that array allocation succeeded. */
-  if (!sz || !sznew)
-    throw("failed to allocate two sets of %d indices", D->array.k);
+  if (!sz || !sznew || !nt || !szt)
+    throw("failed to allocate four sets of %d indices", D->array.k);
 
   /* initialize the file header. */
   memset(&hdr, 0, sizeof(struct nv_header));
@@ -528,8 +497,10 @@ int nv_encode (datum *D, const char *fname) {
   hdr.bhdrsz = 0;
   hdr.ndims = D->nd;
 
-  /* compute the calendar date structure fields. */
-  ts = gmtime(&D->epoch);
+  /* compute the calendar date structure fields. encoders may run in
+   * several threads at once, so the result is kept in local storage.
+   */
+  ts = gmtime_r(&D->epoch, &tm);
 
   /* store the header date fields. */
   hdr.month = ts->tm_mon + 1;
@@ -565,20 +536,15 @@ int nv_encode (datum *D, const char *fname) {
     hdr.blkelem *= hdr.dims[d].szblk;
 
   /* configure each dimension sub-header. */
-  for (d = 0, szadj = 0; d < D->nd; d++) {
+  for (d = 0; d < D->nd; d++) {
     /* store the old dimension size. */
     sznew[d] = sz[d] = D->dims[d].sz;
 
     /* if any single dimension does not evenly divide into blocks,
-     * the array will need to be resized.
+     * the written tiles will be padded with zeros.
      */
-    if (sznew[d] % hdr.dims[d].szblk) {
-      /* adjustment is required. */
-      szadj = 1;
-
-      /* compute the adjusted dimension size. */
+    if (sznew[d] % hdr.dims[d].szblk)
       sznew[d] = hdr.dims[d].szblk * (sz[d] / hdr.dims[d].szblk + 1);
-    }
 
     /* set the dimension sub-header fields. */
     hdr.dims[d].sz = sznew[d];
@@ -602,25 +568,9 @@ int nv_encode (datum *D, const char *fname) {
     strcpy(hdr.dims[d].label, D->dims[d].nuc);
   }
 
-  /* check if the datum array is real. */
-  if (D->array.d == 0) {
-    /* just use the datum array. */
-    if (!hx_array_copy(&xout, &D->array))
-      throw("failed to copy core array");
-  }
-  else {
-    /* copy the real component of the datum array. */
-    if (!hx_array_copy_real(&xout, &D->array))
-      throw("failed to copy real component of core array");
-  }
-
-  /* check if size adjustment is required. */
-  if (szadj && !hx_array_resize(&xout, xout.d, xout.k, sznew))
-    throw("failed to adjust array size for output");
-
-  /* map the linear datum array back into tiles. */
-  if (!nv_tileize(&xout, &hdr))
-    throw("failed to delinearize array into tiles");
+  /* determine the tiling of the output file. */
+  if (!nv_tiling(&hdr, nt, szt))
+    throw("failed to determine output tiling");
 
   /* de-adjust the header size values. */
   for (d = 0; d < D->nd; d++)
@@ -640,20 +590,21 @@ int nv_encode (datum *D, const char *fname) {
   if (fwrite(&hdr, sizeof(struct nv_header), 1, fh) != 1)
     throw("failed to write file header");
 
-  /* write the array data. */
-  if (!hx_array_fwrite_raw(fh, &xout, bytes_get_native(), sizeof(float), 1))
+  /* gather the real array data into tiles and write them. */
+  if (!hx_array_fwrite_tiled(fh, &D->array, bytes_get_native(),
+                             sizeof(float), 1, nt, szt,
+                             HX_ARRAY_INCR_NORMAL))
     throw("failed to write core array data");
 
   /* close the output file. */
   if (fname)
     fclose(fh);
 
-  /* throw away the real copy of the datum array. */
-  hx_array_free(&xout);
-
   /* free the allocated size arrays. */
   hx_index_free(sz);
   hx_index_free(sznew);
+  hx_index_free(nt);
+  hx_index_free(szt);
 
   /* return success. */
   return 1;
@@ -670,12 +621,15 @@ int nv_array (datum *D) {
   enum byteorder endian = BYTES_ENDIAN_AUTO;
   struct nv_header hdr;
 
-  /* declare variables for reading raw data bytes:
+  /* declare variables for reading tiles:
    * @offset: byte offset where point data begins.
-   * @i: general purpose loop counter.
-   * @n: number of words to read.
+   * @nt: array of tile counts.
+   * @szt: array of tile sizes.
+   * @n: number of words read.
    */
-  unsigned int offset, i, n;
+  unsigned int offset;
+  hx_index nt, szt;
+  int n;
   FILE *fh;
 
   /* check that the input filename is valid. */
@@ -690,13 +644,21 @@ int nv_array (datum *D) {
   if (!nv_adjust_header(D->fname, &hdr))
     throw("failed to perform header adjustment");
 
+  /* allocate the tiling index arrays. */
+  nt = hx_index_alloc(hdr.ndims);
+  szt = hx_index_alloc(hdr.ndims);
+
+  /* check that allocation succeeded. */
+  if (!nt || !szt)
+    throw("failed to allocate two sets of %d indices", hdr.ndims);
+
+  /* determine the tiling of the file. */
+  if (!nv_tiling(&hdr, nt, szt))
+    throw("failed to determine tiling of '%s'", D->fname);
+
   /* compute the byte offset from which to begin reading point data. */
   offset = sizeof(struct nv_header);
 
-  /* compute the number of words to read. */
-  for (i = 0, n = 1; i < hdr.ndims; i++)
-    n *= hdr.dims[i].sz;
-
   /* open the input file for reading. */
   fh = fopen(D->fname, "rb");
 
@@ -704,17 +666,23 @@ int nv_array (datum *D) {
   if (!fh)
     throw("failed to open '%s'", D->fname);
 
-  /* read data from the file into the output array. */
-  if (!hx_array_fread_raw(fh, &D->array, endian, sizeof(float), 1,
-                          offset, 0, 1, n, 0))
-    throw("failed to read raw data from '%s'", D->fname);
+  /* read and linearize the tiles in a single pass. */
+  if (!hx_array_fread_tiled(fh, &D->array, endian, sizeof(float), 1,
+                            offset, hdr.ndims, nt, szt,
+                            HX_ARRAY_INCR_NORMAL, NULL, NULL))
+    throw("failed to read tiled data from '%s'", D->fname);
 
   /* close the input file. */
   fclose(fh);
 
-  /* convert tiles to linear values. */
-  if (!nv_linearize(&D->array, &hdr))
-    throw("failed to linearize tiled array");
+  /* flatten the linear values into a vector, ready for refactoring. */
+  n = D->array.len;
+  if (!hx_array_reshape(&D->array, 1, &n))
+    throw("failed to flatten tiled array");
+
+  /* free the allocated index arrays. */
+  hx_index_free(nt);
+  hx_index_free(szt);
 
   /* return success. */
   return 1;
@@ -771,3 +739,102 @@ int nv_post (datum *D) {
   return 1;
 }
 
+/* nv_region(): read a region of an nmrview-format data file into a datum
+ * array, reading only the tiles that overlap the region. the region must
+ * lie within the unadjusted dimension sizes, so no post-processing of the
+ * resulting array is required.
+ * @D: pointer to the destination datum structure.
+ * @lower: lower region bounds, or NULL to read the whole array.
+ * @upper: upper region bounds, or NULL to read the whole array.
+ */
+int nv_region (datum *D, hx_index lower, hx_index upper) {
+  /* declare variables required to read header information:
+   * @endianness: the byte ordering of the data file.
+   * @hdr: the nmrview file header structure.
+   */
+  enum byteorder endian = BYTES_ENDIAN_AUTO;
+  struct nv_header hdr;
+
+  /* declare variables for reading tiles:
+   * @nt: array of tile counts.
+   * @szt: array of tile sizes.
+   * @lo: lower region bounds.
+   * @hi: upper region bounds.
+   * @d: dimension loop counter.
+   */
+  hx_index nt, szt, lo, hi;
+  unsigned int d;
+  FILE *fh;
+
+  /* check that the input filename is valid. */
+  if (D->fname == NULL)
+    throw("invalid input filename");
+
+  /* read the header information from the data file. */
+  if (!nv_read_header(D->fname, &endian, &hdr))
+    throw("failed to read header of '%s'", D->fname);
+
+  /* adjust the file header, if necessary. */
+  if (!nv_adjust_header(D->fname, &hdr))
+    throw("failed to perform header adjustment");
+
+  /* allocate the index arrays. */
+  nt = hx_index_alloc(hdr.ndims);
+  szt = hx_index_alloc(hdr.ndims);
+  lo = hx_index_alloc(hdr.ndims);
+  hi = hx_index_alloc(hdr.ndims);
+
+  /* check that allocation succeeded. */
+  if (!nt || !szt || !lo || !hi)
+    throw("failed to allocate four sets of %d indices", hdr.ndims);
+
+  /* determine the tiling of the file. */
+  if (!nv_tiling(&hdr, nt, szt))
+    throw("failed to determine tiling of '%s'", D->fname);
+
+  /* bound the region by the unadjusted sizes, which nv_post() would
+   * otherwise restore.
+   */
+  for (d = 0; d < D->nd; d++) {
+    /* store the region bounds. */
+    lo[d] = (lower ? lower[d] : 0);
+    hi[d] = (upper ? upper[d] : (int) D->dims[d].td - 1);
+    D->dims[d].sz = D->dims[d].td;
+
+    /* check the region bounds. */
+    if (lo[d] < 0 || lo[d] > hi[d] || hi[d] >= (int) D->dims[d].td)
+      throw("region [%d,%d] out of bounds [0,%u] (#%u)",
+            lo[d], hi[d], D->dims[d].td - 1, d);
+  }
+
+  /* open the input file for reading. */
+  fh = fopen(D->fname, "rb");
+
+  /* check that the file was opened. */
+  if (!fh)
+    throw("failed to open '%s'", D->fname);
+
+  /* read the overlapping tiles into the output array. */
+  if (!hx_array_fread_tiled(fh, &D->array, endian, sizeof(float), 1,
+                            sizeof(struct nv_header), hdr.ndims, nt, szt,
+                            HX_ARRAY_INCR_NORMAL, lo, hi))
+    throw("failed to read tiled data from '%s'", D->fname);
+
+  /* close the input file. */
+  fclose(fh);
+
+  /* store the real array dimension indices. */
+  for (d = 0; d < D->nd; d++) {
+    D->dims[d].d = DATUM_DIM_INVALID;
+    D->dims[d].k = (int) d;
+  }
+
+  /* free the allocated index arrays. */
+  hx_index_free(nt);
+  hx_index_free(szt);
+  hx_index_free(lo);
+  hx_index_free(hi);
+
+  /* return success. */
+  return 1;
+}
@@ -20,6 +20,9 @@
  *   Boston, MA  02110-1301, USA.
  */
 
+/* request posix extensions for reentrant time conversion. */
+#define _POSIX_C_SOURCE 200809L
+
 /* include the pipe header. */
 #include <hxnd/nmr-pipe.h>
 
@@ -29,6 +32,12 @@
 /* define the maximum number of dimensions supported by pipe files. */
 #define PIPE_MAXDIM  4
 
+/* define the size of the plane buffer for pipe file writing, in bytes. */
+#define PIPE_FWRITE_SZ_BUF  33554432
+
+/* define the maximum field width of plane series filename conversions. */
+#define PIPE_SERIES_MAXWIDTH  16
+
 /* define sizes of the string struct members of the pipe header.
  */
 #define PIPE_HDRSTR_SZ_LABEL      8
@@ -510,27 +519,28 @@ struct pipe_header {
   float pad_end[28];
 };
 
-/* pipe_read_header(): read the contents of a header from a pipe-format file.
- * @fname: the input filename.
+/* pipe_fread_header(): read the contents of a header from a pipe-format
+ * input stream, leaving the stream positioned at the first data word.
+ * @fh: the input file handle.
  * @endianness: byte order result pointer.
  * @hdr: header result pointer.
  */
-int pipe_read_header (const char *fname,
-                      enum byteorder *endianness,
-                      struct pipe_header *hdr) {
+int pipe_fread_header (FILE *fh,
+                       enum byteorder *endianness,
+                       struct pipe_header *hdr) {
   /* declare a few required variables:
+   * @n_bytes: number of bytes in the header.
+   * @n_words: number of words in the header.
+   * @bytes: array of header bytes.
    */
   unsigned int n_bytes, n_words;
-  uint8_t *bytes;
+  uint8_t bytes[sizeof(struct pipe_header)];
 
   /* read in the file header bytes. */
   n_bytes = sizeof(struct pipe_header);
   n_words = n_bytes / sizeof(float);
-  bytes = bytes_read_block(fname, 0, n_bytes);
-
-  /* check that the bytes were read successfully. */
-  if (!bytes)
-    throw("failed to read header from '%s'", fname);
+  if (fread(bytes, 1, n_bytes, fh) != n_bytes)
+    throw("failed to read %u header bytes", n_bytes);
 
   /* copy the header bytes onto the header structure. */
   memcpy(hdr, bytes, n_bytes);
@@ -553,8 +563,39 @@ int pipe_read_header (const char *fname,
     *endianness = bytes_get_native();
   }
 
-  /* free the read bytes. */
-  free(bytes);
+  /* return success. */
+  return 1;
+}
+
+/* pipe_read_header(): read the contents of a header from a pipe-format file.
+ * @fname: the input filename.
+ * @endianness: byte order result pointer.
+ * @hdr: header result pointer.
+ */
+int pipe_read_header (const char *fname,
+                      enum byteorder *endianness,
+                      struct pipe_header *hdr) {
+  /* declare a few required variables:
+   * @fh: input file handle.
+   * @ret: header read result.
+   */
+  FILE *fh;
+  int ret;
+
+  /* open the input file. */
+  fh = fopen(fname, "rb");
+
+  /* check that the file was opened. */
+  if (!fh)
+    throw("failed to open '%s'", fname);
+
+  /* read the header from the file. */
+  ret = pipe_fread_header(fh, endianness, hdr);
+  fclose(fh);
+
+  /* check that the header was read successfully. */
+  if (!ret)
+    throw("failed to read header from '%s'", fname);
 
   /* return success. */
   return 1;
@@ -657,18 +698,12 @@ int pipe_guess (const char *fname) {
   return 0;
 }
 
-/* pipe_decode(): read pipe parameters into a datum structure.
+/* pipe_decode_header(): store the parameters of a pipe-format file header
+ * into a datum structure.
  * @D: pointer to the destination datum structure.
- * @fname: the input filename.
+ * @hdr: pointer to the source header structure.
  */
-int pipe_decode (datum *D, const char *fname) {
-  /* declare variables required to determine byte ordering:
-   * @endian: the byte ordering of the data file.
-   * @hdr: the pipe file header structure.
-   */
-  enum byteorder endian = BYTES_ENDIAN_AUTO;
-  struct pipe_header hdr;
-
+int pipe_decode_header (datum *D, struct pipe_header *hdr) {
   /* declare variables required to traverse dimensions:
    * @d: dimension loop counter.
    * @ord: dimension index array.
@@ -681,30 +716,26 @@ int pipe_decode (datum *D, const char *fname) {
    */
   struct tm ts;
 
-  /* read the header information from the data file. */
-  if (!pipe_read_header(fname, &endian, &hdr))
-    throw("failed to read header of '%s'", fname);
-
   /* check if time/date information exists in the header fields. */
-  if (hdr.d_year && hdr.d_month) {
+  if (hdr->d_year && hdr->d_month) {
     /* parse the time header fields. */
-    ts.tm_hour = (int) hdr.t_hour;
-    ts.tm_min = (int) hdr.t_min;
-    ts.tm_sec = (int) hdr.t_sec;
+    ts.tm_hour = (int) hdr->t_hour;
+    ts.tm_min = (int) hdr->t_min;
+    ts.tm_sec = (int) hdr->t_sec;
 
     /* parse the date header fields. */
-    ts.tm_mon = (int) hdr.d_month - 1;
-    ts.tm_mday = (int) hdr.d_day;
-    ts.tm_year = (int) hdr.d_year - 1900;
+    ts.tm_mon = (int) hdr->d_month - 1;
+    ts.tm_mday = (int) hdr->d_day;
+    ts.tm_year = (int) hdr->d_year - 1900;
 
     /* convert the date and time into an epoch offset. */
     D->epoch = mktime(&ts);
   }
 
   /* check the dimensionality. */
-  if ((int) hdr.ndims < 1 ||
-      (int) hdr.ndims > PIPE_MAXDIM)
-    throw("invalid dimensionality %.0f", hdr.ndims);
+  if ((int) hdr->ndims < 1 ||
+      (int) hdr->ndims > PIPE_MAXDIM)
+    throw("invalid dimensionality %.0f", hdr->ndims);
 
   /* initially set the number of dimensions to the maximum allowed, because
    * pipe arranges its dimension information in a really screwy way.
@@ -714,92 +745,116 @@ int pipe_decode (datum *D, const char *fname) {
 
   /* store the dimension ordering array values. */
   for (d = 0; d < PIPE_MAXDIM; d++)
-    ord[d] = hdr.dimorder[d] - 1;
+    ord[d] = hdr->dimorder[d] - 1;
 
   /* store the complex states from the quadrature flags. */
-  D->dims[ord[0]].cx = ((int) hdr.quad_f1 != PIPE_QUAD_REAL);
-  D->dims[ord[1]].cx = ((int) hdr.quad_f2 != PIPE_QUAD_REAL);
-  D->dims[ord[2]].cx = ((int) hdr.quad_f3 != PIPE_QUAD_REAL);
-  D->dims[ord[3]].cx = ((int) hdr.quad_f4 != PIPE_QUAD_REAL);
+  D->dims[ord[0]].cx = ((int) hdr->quad_f1 != PIPE_QUAD_REAL);
+  D->dims[ord[1]].cx = ((int) hdr->quad_f2 != PIPE_QUAD_REAL);
+  D->dims[ord[2]].cx = ((int) hdr->quad_f3 != PIPE_QUAD_REAL);
+  D->dims[ord[3]].cx = ((int) hdr->quad_f4 != PIPE_QUAD_REAL);
 
   /* store the alternation states from the sign flags. */
-  D->dims[ord[0]].alt = ((int) hdr.aqsgn_f1 & PIPE_AQSGN_ALT ? 1 : 0);
-  D->dims[ord[1]].alt = ((int) hdr.aqsgn_f2 & PIPE_AQSGN_ALT ? 1 : 0);
-  D->dims[ord[2]].alt = ((int) hdr.aqsgn_f3 & PIPE_AQSGN_ALT ? 1 : 0);
-  D->dims[ord[3]].alt = ((int) hdr.aqsgn_f4 & PIPE_AQSGN_ALT ? 1 : 0);
+  D->dims[ord[0]].alt = ((int) hdr->aqsgn_f1 & PIPE_AQSGN_ALT ? 1 : 0);
+  D->dims[ord[1]].alt = ((int) hdr->aqsgn_f2 & PIPE_AQSGN_ALT ? 1 : 0);
+  D->dims[ord[2]].alt = ((int) hdr->aqsgn_f3 & PIPE_AQSGN_ALT ? 1 : 0);
+  D->dims[ord[3]].alt = ((int) hdr->aqsgn_f4 & PIPE_AQSGN_ALT ? 1 : 0);
 
   /* store the negation states from the sign flags. */
-  D->dims[ord[0]].neg = ((int) hdr.aqsgn_f1 & PIPE_AQSGN_NEG ? 1 : 0);
-  D->dims[ord[1]].neg = ((int) hdr.aqsgn_f2 & PIPE_AQSGN_NEG ? 1 : 0);
-  D->dims[ord[2]].neg = ((int) hdr.aqsgn_f3 & PIPE_AQSGN_NEG ? 1 : 0);
-  D->dims[ord[3]].neg = ((int) hdr.aqsgn_f4 & PIPE_AQSGN_NEG ? 1 : 0);
+  D->dims[ord[0]].neg = ((int) hdr->aqsgn_f1 & PIPE_AQSGN_NEG ? 1 : 0);
+  D->dims[ord[1]].neg = ((int) hdr->aqsgn_f2 & PIPE_AQSGN_NEG ? 1 : 0);
+  D->dims[ord[2]].neg = ((int) hdr->aqsgn_f3 & PIPE_AQSGN_NEG ? 1 : 0);
+  D->dims[ord[3]].neg = ((int) hdr->aqsgn_f4 & PIPE_AQSGN_NEG ? 1 : 0);
 
   /* store the gradient-enhanced states from the quadrature flags. */
-  D->dims[ord[0]].genh = ((int) hdr.quad_f1 == PIPE_QUAD_GE);
-  D->dims[ord[1]].genh = ((int) hdr.quad_f2 == PIPE_QUAD_GE);
-  D->dims[ord[2]].genh = ((int) hdr.quad_f3 == PIPE_QUAD_GE);
-  D->dims[ord[3]].genh = ((int) hdr.quad_f4 == PIPE_QUAD_GE);
+  D->dims[ord[0]].genh = ((int) hdr->quad_f1 == PIPE_QUAD_GE);
+  D->dims[ord[1]].genh = ((int) hdr->quad_f2 == PIPE_QUAD_GE);
+  D->dims[ord[2]].genh = ((int) hdr->quad_f3 == PIPE_QUAD_GE);
+  D->dims[ord[3]].genh = ((int) hdr->quad_f4 == PIPE_QUAD_GE);
 
   /* store the fourier-transform flags. */
-  D->dims[ord[0]].ft = (unsigned int) hdr.ftflag_f1;
-  D->dims[ord[1]].ft = (unsigned int) hdr.ftflag_f2;
-  D->dims[ord[2]].ft = (unsigned int) hdr.ftflag_f3;
-  D->dims[ord[3]].ft = (unsigned int) hdr.ftflag_f4;
+  D->dims[ord[0]].ft = (unsigned int) hdr->ftflag_f1;
+  D->dims[ord[1]].ft = (unsigned int) hdr->ftflag_f2;
+  D->dims[ord[2]].ft = (unsigned int) hdr->ftflag_f3;
+  D->dims[ord[3]].ft = (unsigned int) hdr->ftflag_f4;
 
   /* store the nucleus strings. */
-  strncpy(D->dims[ord[0]].nuc, hdr.label_f1, PIPE_HDRSTR_SZ_LABEL);
-  strncpy(D->dims[ord[1]].nuc, hdr.label_f2, PIPE_HDRSTR_SZ_LABEL);
-  strncpy(D->dims[ord[2]].nuc, hdr.label_f3, PIPE_HDRSTR_SZ_LABEL);
-  strncpy(D->dims[ord[3]].nuc, hdr.label_f4, PIPE_HDRSTR_SZ_LABEL);
+  strncpy(D->dims[ord[0]].nuc, hdr->label_f1, PIPE_HDRSTR_SZ_LABEL);
+  strncpy(D->dims[ord[1]].nuc, hdr->label_f2, PIPE_HDRSTR_SZ_LABEL);
+  strncpy(D->dims[ord[2]].nuc, hdr->label_f3, PIPE_HDRSTR_SZ_LABEL);
+  strncpy(D->dims[ord[3]].nuc, hdr->label_f4, PIPE_HDRSTR_SZ_LABEL);
 
   /* null-terminate the nucleus string. */
   for (d = 0; d < PIPE_MAXDIM; d++)
     D->dims[d].nuc[7] = '\0';
 
   /* store the size parameters. */
-  D->dims[ord[0]].td = D->dims[ord[0]].tdunif = hdr.tdsz_f1;
-  D->dims[ord[1]].td = D->dims[ord[1]].tdunif = hdr.tdsz_f2;
-  D->dims[ord[2]].td = D->dims[ord[2]].tdunif = hdr.tdsz_f3;
-  D->dims[ord[3]].td = D->dims[ord[3]].tdunif = hdr.tdsz_f4;
+  D->dims[ord[0]].td = D->dims[ord[0]].tdunif = hdr->tdsz_f1;
+  D->dims[ord[1]].td = D->dims[ord[1]].tdunif = hdr->tdsz_f2;
+  D->dims[ord[2]].td = D->dims[ord[2]].tdunif = hdr->tdsz_f3;
+  D->dims[ord[3]].td = D->dims[ord[3]].tdunif = hdr->tdsz_f4;
 
   /* store the f1 current size parameter. */
-  D->dims[ord[0]].sz = hdr.x1_f1 && hdr.xn_f1 ? hdr.xn_f1 - hdr.x1_f1 + 1 :
-                       D->dims[ord[0]].ft ? hdr.ftsz_f1 : hdr.apod_f1;
+  D->dims[ord[0]].sz = hdr->x1_f1 && hdr->xn_f1 ? hdr->xn_f1 - hdr->x1_f1 + 1 :
+                       D->dims[ord[0]].ft ? hdr->ftsz_f1 : hdr->apod_f1;
 
   /* store the f2 current size parameter. */
-  D->dims[ord[1]].sz = hdr.x1_f2 && hdr.xn_f2 ? hdr.xn_f2 - hdr.x1_f2 + 1 :
-                       D->dims[ord[1]].ft ? hdr.ftsz_f2 : hdr.apod_f2;
+  D->dims[ord[1]].sz = hdr->x1_f2 && hdr->xn_f2 ? hdr->xn_f2 - hdr->x1_f2 + 1 :
+                       D->dims[ord[1]].ft ? hdr->ftsz_f2 : hdr->apod_f2;
 
   /* store the f3 current size parameter. */
-  D->dims[ord[2]].sz = hdr.x1_f3 && hdr.xn_f3 ? hdr.xn_f3 - hdr.x1_f3 + 1 :
-                       D->dims[ord[2]].ft ? hdr.ftsz_f3 : hdr.apod_f3;
+  D->dims[ord[2]].sz = hdr->x1_f3 && hdr->xn_f3 ? hdr->xn_f3 - hdr->x1_f3 + 1 :
+                       D->dims[ord[2]].ft ? hdr->ftsz_f3 : hdr->apod_f3;
 
   /* store the f4 current size parameter. */
-  D->dims[ord[3]].sz = hdr.x1_f4 && hdr.xn_f4 ? hdr.xn_f4 - hdr.x1_f4 + 1 :
-                       D->dims[ord[3]].ft ? hdr.ftsz_f4 : hdr.apod_f4;
+  D->dims[ord[3]].sz = hdr->x1_f4 && hdr->xn_f4 ? hdr->xn_f4 - hdr->x1_f4 + 1 :
+                       D->dims[ord[3]].ft ? hdr->ftsz_f4 : hdr->apod_f4;
 
   /* store the spectral width parameters. */
-  D->dims[ord[0]].width = hdr.sw_f1;
-  D->dims[ord[1]].width = hdr.sw_f2;
-  D->dims[ord[2]].width = hdr.sw_f3;
-  D->dims[ord[3]].width = hdr.sw_f4;
+  D->dims[ord[0]].width = hdr->sw_f1;
+  D->dims[ord[1]].width = hdr->sw_f2;
+  D->dims[ord[2]].width = hdr->sw_f3;
+  D->dims[ord[3]].width = hdr->sw_f4;
 
   /* store the carrier frequency parameters. */
-  D->dims[ord[0]].carrier = hdr.obs_f1;
-  D->dims[ord[1]].carrier = hdr.obs_f2;
-  D->dims[ord[2]].carrier = hdr.obs_f3;
-  D->dims[ord[3]].carrier = hdr.obs_f4;
+  D->dims[ord[0]].carrier = hdr->obs_f1;
+  D->dims[ord[1]].carrier = hdr->obs_f2;
+  D->dims[ord[2]].carrier = hdr->obs_f3;
+  D->dims[ord[3]].carrier = hdr->obs_f4;
 
   /* store the spectral offset parameters. */
-  D->dims[ord[0]].offset = hdr.car_f1 * hdr.obs_f1;
-  D->dims[ord[1]].offset = hdr.car_f2 * hdr.obs_f2;
-  D->dims[ord[2]].offset = hdr.car_f3 * hdr.obs_f3;
-  D->dims[ord[3]].offset = hdr.car_f4 * hdr.obs_f4;
+  D->dims[ord[0]].offset = hdr->car_f1 * hdr->obs_f1;
+  D->dims[ord[1]].offset = hdr->car_f2 * hdr->obs_f2;
+  D->dims[ord[2]].offset = hdr->car_f3 * hdr->obs_f3;
+  D->dims[ord[3]].offset = hdr->car_f4 * hdr->obs_f4;
 
   /* set the true dimension count and reallocate the dimension array. */
-  if (!datum_dims_realloc(D, hdr.ndims))
+  if (!datum_dims_realloc(D, hdr->ndims))
     throw("failed to reallocate dimension array");
 
+  /* return success. */
+  return 1;
+}
+
+/* pipe_decode(): read pipe parameters into a datum structure.
+ * @D: pointer to the destination datum structure.
+ * @fname: the input filename.
+ */
+int pipe_decode (datum *D, const char *fname) {
+  /* declare variables required to determine byte ordering:
+   * @endian: the byte ordering of the data file.
+   * @hdr: the pipe file header structure.
+   */
+  enum byteorder endian = BYTES_ENDIAN_AUTO;
+  struct pipe_header hdr;
+
+  /* read the header information from the data file. */
+  if (!pipe_read_header(fname, &endian, &hdr))
+    throw("failed to read header of '%s'", fname);
+
+  /* store the header parameters into the datum. */
+  if (!pipe_decode_header(D, &hdr))
+    throw("failed to decode header of '%s'", fname);
+
   /* store the filename string. */
   D->fname = (char*) malloc((strlen(fname) + 1) * sizeof(char));
   if (D->fname)
@@ -813,242 +868,560 @@ int pipe_decode (datum *D, const char *fname) {
   return 1;
 }
 
-/* pipe_fwrite_dim(): write the contents of a datum core array into an
- * output file stream of pipe-format coefficients. recursively drop from
- * cubes, to planes, to traces, and finally to points.
+/* pipe_offsets(): build tables of core array coefficient offsets for each
+ * datum dimension, listed in the order in which pipe-format files store
+ * them. along the first dimension, entire real and imaginary traces are
+ * stored one after the other. along all other dimensions, the real and
+ * imaginary sub-blocks of each point alternate. unused dimensions receive
+ * a single zero offset.
  * @D: pointer to the source datum structure.
- * @dim: current datum dimension in the recursion.
- * @n0: current coefficient offset in the recursion.
- * @idx: index array for looping through the datum core array.
- * @fh: the output file handle.
+ * @tbl: output array of offset tables, one per pipe dimension.
+ * @cnt: output array of offset table lengths.
  */
-int pipe_fwrite_dim (datum *D, unsigned int dim, int n0, hx_index idx,
-                     FILE *fh) {
+int pipe_offsets (datum *D, int **tbl, int *cnt) {
   /* declare a few required variables:
-   * @d: current array algebraic dimension index.
-   * @k: current array topological dimension index.
-   * @n: current array coefficient imaginary offset.
-   * @num: size along current array dimension.
-   * @pidx: array linear scalar index.
-   * @f: float output value.
+   * @dim: datum dimension loop counter.
+   * @i: point loop counter.
+   * @c: complex component loop counter.
+   * @nc: number of complex components.
+   * @sz: number of points along the dimension.
+   * @n: coefficient offset of the imaginary component.
+   * @stride: coefficient stride between points.
    */
-  int d, k, n, num, pidx;
-  float f;
-
-  /* determine the array dimension indices. */
-  d = D->dims[dim].d;
-  k = D->dims[dim].k;
-
-  /* determine the coefficient index. */
-  n = (d == DATUM_DIM_INVALID ? 0 : 1 << d);
-
-  /* compute the number of points in the dimension. */
-  num = D->array.sz[k];
-
-  /* check if we've reached the lowest dimension. */
-  if (k == 0) {
-    /* store the real points of the current trace. */
-    for (idx[k] = 0; idx[k] < num; idx[k]++) {
-      /* pack the linear index and get the coefficient. */
-      hx_index_pack(D->array.k, D->array.sz, idx, &pidx);
-      f = (float) D->array.x[D->array.n * pidx + n0];
-
-      /* write the coefficient. */
-      if (fwrite(&f, sizeof(float), 1, fh) != 1)
-        return 0;
+  int dim, i, c, nc, sz, n, stride;
+
+  /* loop over the pipe dimensions. */
+  for (dim = 0; dim < PIPE_MAXDIM; dim++) {
+    /* check if the dimension is unused. */
+    if (dim >= D->nd) {
+      /* store a single zero offset. */
+      cnt[dim] = 1;
+      tbl[dim] = hx_index_alloc(1);
+      if (!tbl[dim])
+        throw("failed to allocate offset table %d", dim);
+
+      /* move to the next dimension. */
+      continue;
     }
 
-    /* check if the trace is complex. */
-    if (D->dims[dim].cx) {
-      /* store the imaginary points of the current trace. */
-      for (idx[k] = 0; idx[k] < num; idx[k]++) {
-        /* pack the linear index and get the coefficient. */
-        hx_index_pack(D->array.k, D->array.sz, idx, &pidx);
-        f = (float) D->array.x[D->array.n * pidx + n0 + n];
-
-        /* write the coefficient. */
-        if (fwrite(&f, sizeof(float), 1, fh) != 1)
-          return 0;
+    /* determine the component count and the imaginary offset. */
+    nc = (D->dims[dim].cx ? 2 : 1);
+    n = (D->dims[dim].d == DATUM_DIM_INVALID ? 0 : 1 << D->dims[dim].d);
+
+    /* determine the point count and the coefficient stride. */
+    sz = D->array.sz[D->dims[dim].k];
+    for (i = 0, stride = D->array.n; i < D->dims[dim].k; i++)
+      stride *= D->array.sz[i];
+
+    /* allocate the offset table. */
+    cnt[dim] = nc * sz;
+    tbl[dim] = hx_index_alloc(cnt[dim]);
+    if (!tbl[dim])
+      throw("failed to allocate offset table %d", dim);
+
+    /* fill the offset table. */
+    for (i = 0; i < sz; i++) {
+      for (c = 0; c < nc; c++) {
+        /* store traces whole along the first dimension, and interleave
+         * components along all others.
+         */
+        if (dim == 0)
+          tbl[dim][c * sz + i] = i * stride + c * n;
+        else
+          tbl[dim][i * nc + c] = i * stride + c * n;
       }
     }
   }
-  else {
-    /* recurse into the lower dimensions. */
-    for (idx[k] = 0; idx[k] < num; idx[k]++) {
-      /* recurse the real component. */
-      if (!pipe_fwrite_dim(D, dim - 1, n0, idx, fh))
-        return 0;
-
-      /* recurse the imaginary component. */
-      if (D->dims[dim].cx && !pipe_fwrite_dim(D, dim - 1, n0 + n, idx, fh))
-        return 0;
-    }
+
+  /* return success. */
+  return 1;
+}
+
+/* pipe_gather_plane(): gather a single plane of pipe-ordered coefficients
+ * from a datum core array into a contiguous buffer of floats.
+ * @D: pointer to the source datum structure.
+ * @tbl: array of offset tables from pipe_offsets().
+ * @cnt: array of offset table lengths from pipe_offsets().
+ * @p: index of the plane to gather.
+ * @buf: output array of floats.
+ */
+void pipe_gather_plane (datum *D, int **tbl, int *cnt, int p, float *buf) {
+  /* declare a few required variables:
+   * @i, @j: plane loop counters.
+   * @base: coefficient offset of the plane.
+   * @xi: pointer to the current plane row.
+   */
+  int i, j, base;
+  real *xi;
+
+  /* compute the plane offset from the outer dimension offsets. */
+  base = tbl[2][p % cnt[2]] + tbl[3][p / cnt[2]];
+
+  /* loop over the rows of the plane. */
+  for (j = 0; j < cnt[1]; j++) {
+    /* gather the points of the row. */
+    xi = D->array.x + base + tbl[1][j];
+    for (i = 0; i < cnt[0]; i++)
+      *(buf++) = (float) xi[tbl[0][i]];
   }
+}
+
+/* pipe_fwrite_planes(): write the contents of a datum core array into an
+ * output file stream of pipe-format coefficients. runs of planes are
+ * gathered in parallel into a buffer, which is written in a single call.
+ * @D: pointer to the source datum structure.
+ * @tbl: array of offset tables from pipe_offsets().
+ * @cnt: array of offset table lengths from pipe_offsets().
+ * @fh: the output file handle.
+ */
+int pipe_fwrite_planes (datum *D, int **tbl, int *cnt, FILE *fh) {
+  /* declare a few required variables:
+   * @p0: index of the first plane in the current run.
+   * @np: number of planes in the current run.
+   * @nrun: maximum number of planes per run.
+   * @nplanes: total number of planes.
+   * @szp: number of floats per plane.
+   * @buf: buffer of gathered floats.
+   */
+  int p0, np, nrun, nplanes, szp;
+  float *buf;
+
+  /* compute the plane size and count. */
+  szp = cnt[0] * cnt[1];
+  nplanes = cnt[2] * cnt[3];
+
+  /* compute the number of planes that fit in the buffer. */
+  nrun = PIPE_FWRITE_SZ_BUF / (szp * sizeof(float));
+  nrun = (nrun < 1 ? 1 : nrun > nplanes ? nplanes : nrun);
+
+  /* allocate the plane buffer. */
+  buf = (float*) malloc(nrun * szp * sizeof(float));
+  if (!buf)
+    throw("failed to allocate buffer of %d planes", nrun);
+
+  /* loop over the runs of planes. */
+  for (p0 = 0; p0 < nplanes; p0 += np) {
+    /* determine the number of planes in the current run. */
+    np = (nplanes - p0 < nrun ? nplanes - p0 : nrun);
+
+    /* gather the planes of the run in parallel. */
+    #pragma omp parallel for
+    for (int p = 0; p < np; p++)
+      pipe_gather_plane(D, tbl, cnt, p0 + p, buf + p * szp);
+
+    /* write the run of planes. */
+    if (fwrite(buf, sizeof(float), np * szp, fh) != np * szp)
+      throw("failed to write planes %d..%d", p0, p0 + np - 1);
+  }
+
+  /* free the plane buffer. */
+  free(buf);
 
   /* return success. */
   return 1;
 }
 
-/* pipe_encode(): write a datum structure in pipe-format to a file.
- * @D: pointer to the source structure.
- * @fname: the output filename.
+/* pipe_series_name(): build a plane filename from a series filename
+ * template. the template may hold literal '%%' sequences and integer
+ * conversions of the form '%[0-9]*d' only, which are formatted by fixed
+ * format strings rather than by passing the template to printf. returns
+ * the number of conversions in the template, or -1 if the template is
+ * invalid or the filename does not fit its buffer.
+ * @fmt: the filename template.
+ * @vals: array of values of the conversions, or NULL to only check the
+ *        template.
+ * @nvals: maximum number of conversions.
+ * @fname: output filename buffer, or NULL to only check the template.
+ * @n: size of the filename buffer.
  */
-int pipe_encode (datum *D, const char *fname) {
-  /* declare variables required to output pipe-format files:
+static int pipe_series_name (const char *fmt, const int *vals, int nvals,
+                             char *fname, size_t n) {
+  /* declare a few required variables:
+   * @i: filename template character index.
+   * @len: length of the built filename.
+   * @nc: number of conversions read from the template.
+   * @width: field width of the current conversion.
+   * @zero: whether the current conversion is zero-padded.
+   * @w: number of characters written by the current conversion.
+   */
+  size_t i, len;
+  int nc, width, zero, w;
+
+  /* loop over the template characters. */
+  for (i = 0, len = 0, nc = 0; fmt[i]; i++) {
+    /* copy literal characters, and literal percent signs. */
+    if (fmt[i] != '%' || fmt[i + 1] == '%') {
+      if (fname && len + 1 >= n)
+        return -1;
+
+      if (fname)
+        fname[len] = fmt[i];
+
+      len++;
+      i += (fmt[i] == '%' ? 1 : 0);
+      continue;
+    }
+
+    /* read the optional zero flag and field width of the conversion. */
+    zero = (fmt[i + 1] == '0');
+    for (i++, width = 0; fmt[i] >= '0' && fmt[i] <= '9'; i++) {
+      width = 10 * width + (fmt[i] - '0');
+      if (width > PIPE_SERIES_MAXWIDTH)
+        return -1;
+    }
+
+    /* accept only integer conversions, up to the maximum count. */
+    if (fmt[i] != 'd' || nc >= nvals)
+      return -1;
+
+    /* format the conversion value using a fixed format string. */
+    if (fname && vals) {
+      w = snprintf(fname + len, n - len, zero ? "%0*d" : "%*d",
+                   width, vals[nc]);
+      if (w < 0 || len + w >= n)
+        return -1;
+
+      len += w;
+    }
+
+    /* count the conversion. */
+    nc++;
+  }
+
+  /* terminate the filename. */
+  if (fname)
+    fname[len] = '\0';
+
+  /* return the number of conversions. */
+  return nc;
+}
+
+/* pipe_fwrite_series(): write the contents of a datum core array into a
+ * series of pipe-format plane files, in parallel. the filename template
+ * must hold one integer conversion (the plane number) or, for four-dimensional
+ * data, two (the fourth- and third-dimension numbers), e.g. '%03d.ft3'.
+ * @D: pointer to the source datum structure.
+ * @hdr: pointer to the header to write into each file.
+ * @fmt: the output filename template.
+ * @tbl: array of offset tables from pipe_offsets().
+ * @cnt: array of offset table lengths from pipe_offsets().
+ */
+int pipe_fwrite_series (datum *D, struct pipe_header *hdr, const char *fmt,
+                        int **tbl, int *cnt) {
+  /* declare a few required variables:
+   * @nfmt: number of conversions in the filename template.
+   * @nplanes: total number of planes.
+   * @szp: number of floats per plane.
+   * @nhdr: number of floats in @hdr.
+   * @ok: whether every plane file was written.
+   */
+  int nfmt, nplanes, szp, nhdr, ok;
+
+  /* check the filename template and count its conversions. */
+  nfmt = pipe_series_name(fmt, NULL, 2, NULL, 0);
+
+  /* check that the template matches the dimensionality. */
+  if (nfmt != 1 && !(nfmt == 2 && D->nd == 4))
+    throw("invalid plane filename template '%s'", fmt);
+
+  /* compute the plane size and count. */
+  szp = cnt[0] * cnt[1];
+  nplanes = cnt[2] * cnt[3];
+  nhdr = sizeof(struct pipe_header) / sizeof(float);
+
+  /* mark the header as describing one file of a series. */
+  hdr->pipe = 0.0;
+  hdr->file_count = (float) nplanes;
+
+  /* write the plane files in parallel. */
+  ok = 1;
+  #pragma omp parallel
+  {
+    /* declare required thread-local variables:
+     * @p: plane loop counter.
+     * @vals: conversion values of the current plane filename.
+     * @fname: current plane filename.
+     * @buf: buffer of gathered floats.
+     * @fh: current plane file handle.
+     * @live: whether no failure has been flagged by any thread.
+     */
+    char fname[FILENAME_MAX];
+    float *buf;
+    FILE *fh;
+    int p, live, vals[2];
+
+    /* allocate the plane buffer. */
+    buf = (float*) malloc(szp * sizeof(float));
+    if (!buf) {
+      /* raise an error and flag the failure. */
+      #pragma omp critical (pipe_series)
+      raise("failed to allocate plane buffer");
+      #pragma omp atomic write
+      ok = 0;
+    }
+
+    /* loop over the planes. */
+    #pragma omp for
+    for (p = 0; p < nplanes; p++) {
+      /* skip all work after a failure. */
+      #pragma omp atomic read
+      live = ok;
+      if (!live || !buf)
+        continue;
+
+      /* compute the plane numbers of the filename. */
+      if (nfmt == 2) {
+        vals[0] = p / cnt[2] + 1;
+        vals[1] = p % cnt[2] + 1;
+      }
+      else
+        vals[0] = p + 1;
+
+      /* build the plane filename. */
+      if (pipe_series_name(fmt, vals, nfmt, fname, FILENAME_MAX) < 0) {
+        /* raise an error and flag the failure. */
+        #pragma omp critical (pipe_series)
+        raise("plane %d filename exceeds %d characters", p, FILENAME_MAX);
+        #pragma omp atomic write
+        ok = 0;
+        continue;
+      }
+
+      /* gather the plane coefficients. */
+      pipe_gather_plane(D, tbl, cnt, p, buf);
+
+      /* open, write and close the plane file. */
+      fh = fopen(fname, "wb");
+      if (!fh ||
+          fwrite(hdr, sizeof(float), nhdr, fh) != nhdr ||
+          fwrite(buf, sizeof(float), szp, fh) != szp) {
+        /* raise an error and flag the failure. */
+        #pragma omp critical (pipe_series)
+        raise("failed to write plane file '%s'", fname);
+        #pragma omp atomic write
+        ok = 0;
+      }
+
+      /* close the plane file. */
+      if (fh)
+        fclose(fh);
+    }
+
+    /* free the plane buffer. */
+    free(buf);
+  }
+
+  /* return the result. */
+  return ok;
+}
+
+/* pipe_encode_header(): build a pipe-format file header from the parameters
+ * of a datum structure.
+ * @D: pointer to the source datum structure.
+ * @hdr: pointer to the destination header structure.
+ */
+int pipe_encode_header (datum *D, struct pipe_header *hdr) {
+  /* declare variables required to build pipe-format headers:
    * @ord: dimension ordering array.
-   * @arr: array index for iteration during output.
-   * @hdr: the pipe file header structure.
-   * @nhdr: number of floats in @fhdr.
    * @ts: calendar time structure.
-   * @fh: the output file handle.
+   * @tm: storage for @ts.
+   * @i: dimension loop counter.
    */
-  int ord[PIPE_MAXDIM], arr[PIPE_MAXDIM];
-  struct pipe_header hdr;
-  int i, n, nhdr;
-  struct tm *ts;
-  FILE *fh;
+  int i, ord[PIPE_MAXDIM];
+  struct tm *ts, tm;
 
   /* check that the datum will fit in a pipe-format file. */
   if (D->nd > PIPE_MAXDIM)
     throw("datum contains too many dimensions for pipe format");
 
   /* initialize the values in the header. */
-  memset(&hdr, 0, sizeof(struct pipe_header));
+  memset(hdr, 0, sizeof(struct pipe_header));
 
   /* set the magic numbers. */
-  hdr.magic = 0.0;
-  hdr.format = (float) 0xeeeeeeee;
-  hdr.order = (float) PIPE_MAGIC;
+  hdr->magic = 0.0;
+  hdr->format = (float) 0xeeeeeeee;
+  hdr->order = (float) PIPE_MAGIC;
 
-  /* compute the calendar date structure fields. */
-  ts = gmtime(&D->epoch);
+  /* compute the calendar date structure fields. encoders may run in
+   * several threads at once, so the result is kept in local storage.
+   */
+  ts = gmtime_r(&D->epoch, &tm);
 
   /* store the header date fields. */
-  hdr.d_year = (float) ts->tm_year + 1900;
-  hdr.d_month = (float) ts->tm_mon + 1.0;
-  hdr.d_day = (float) ts->tm_mday;
+  hdr->d_year = (float) ts->tm_year + 1900;
+  hdr->d_month = (float) ts->tm_mon + 1.0;
+  hdr->d_day = (float) ts->tm_mday;
 
   /* store the header time fields. */
-  hdr.t_hour = (float) ts->tm_hour;
-  hdr.t_min = (float) ts->tm_min;
-  hdr.t_sec = (float) ts->tm_sec;
+  hdr->t_hour = (float) ts->tm_hour;
+  hdr->t_min = (float) ts->tm_min;
+  hdr->t_sec = (float) ts->tm_sec;
 
   /* set the number of dimensions and the plane mode. */
-  hdr.ndims = (float) D->nd;
-  hdr.phase2d = PIPE_PHASE2D_STATES;
+  hdr->ndims = (float) D->nd;
+  hdr->phase2d = PIPE_PHASE2D_STATES;
 
   /* set the master quadrature flag. */
-  hdr.quad = (float) PIPE_QUAD_REAL;
+  hdr->quad = (float) PIPE_QUAD_REAL;
   for (i = 0; i < D->nd; i++) {
     /* having even one complex dimension sets the complex flag. */
-    if (D->dims[i].cx || (int) hdr.quad == PIPE_QUAD_COMPLEX)
-      hdr.quad = PIPE_QUAD_COMPLEX;
+    if (D->dims[i].cx || (int) hdr->quad == PIPE_QUAD_COMPLEX)
+      hdr->quad = PIPE_QUAD_COMPLEX;
   }
 
   /* set the dimension order (YXZA). */
   for (i = 0; i < PIPE_MAXDIM; i++)
-    hdr.dimorder[i] = (float) (ord[i] = i + 1);
+    hdr->dimorder[i] = (float) (ord[i] = i + 1);
 
   /* if necessary, write the first-dimension header information. */
   if (D->nd >= 1) {
     /* set quadrature information. */
-    hdr.quad_f1 = (D->dims[0].cx ? PIPE_QUAD_COMPLEX : PIPE_QUAD_REAL);
-    hdr.aqsgn_f1 = PIPE_AQSGN_NONE;
-    hdr.ftflag_f1 = (float) D->dims[0].ft;
+    hdr->quad_f1 = (D->dims[0].cx ? PIPE_QUAD_COMPLEX : PIPE_QUAD_REAL);
+    hdr->aqsgn_f1 = PIPE_AQSGN_NONE;
+    hdr->ftflag_f1 = (float) D->dims[0].ft;
 
     /* set nucleus information. */
-    strncpy(hdr.label_f1, D->dims[0].nuc, PIPE_HDRSTR_SZ_LABEL);
+    strncpy(hdr->label_f1, D->dims[0].nuc, PIPE_HDRSTR_SZ_LABEL);
 
     /* set size information. */
-    hdr.tdsz_f1 = (float) D->dims[0].td;
-    hdr.ftsz_f1 = (float) D->dims[0].sz;
-    hdr.apod_f1 = (float) D->dims[0].sz;
-    hdr.sz = (float) D->dims[0].sz;
+    hdr->tdsz_f1 = (float) D->dims[0].td;
+    hdr->ftsz_f1 = (float) D->dims[0].sz;
+    hdr->apod_f1 = (float) D->dims[0].sz;
+    hdr->sz = (float) D->dims[0].sz;
 
     /* set spectral width, offset and carrier. */
-    hdr.sw_f1 = (float) D->dims[0].width;
-    hdr.obs_f1 = (float) D->dims[0].carrier;
-    hdr.orig_f1 = (float) D->dims[0].offset;
+    hdr->sw_f1 = (float) D->dims[0].width;
+    hdr->obs_f1 = (float) D->dims[0].carrier;
+    hdr->orig_f1 = (float) D->dims[0].offset;
   }
 
   /* if necessary, write the second-dimension header information. */
   if (D->nd >= 2) {
     /* set quadrature information. */
-    hdr.quad_f2 = (D->dims[1].cx ? PIPE_QUAD_COMPLEX : PIPE_QUAD_REAL);
-    hdr.aqsgn_f2 = PIPE_AQSGN_NONE;
-    hdr.ftflag_f2 = (float) D->dims[1].ft;
+    hdr->quad_f2 = (D->dims[1].cx ? PIPE_QUAD_COMPLEX : PIPE_QUAD_REAL);
+    hdr->aqsgn_f2 = PIPE_AQSGN_NONE;
+    hdr->ftflag_f2 = (float) D->dims[1].ft;
 
     /* set nucleus information. */
-    strncpy(hdr.label_f2, D->dims[1].nuc, PIPE_HDRSTR_SZ_LABEL);
+    strncpy(hdr->label_f2, D->dims[1].nuc, PIPE_HDRSTR_SZ_LABEL);
 
     /* set size information. */
-    hdr.tdsz_f2 = (float) D->dims[1].td;
-    hdr.ftsz_f2 = (float) D->dims[1].sz;
-    hdr.apod_f2 = (float) D->dims[1].sz;
-    hdr.specnum = (float) D->dims[1].sz;
-    if (D->dims[1].cx) hdr.specnum *= 2.0;
+    hdr->tdsz_f2 = (float) D->dims[1].td;
+    hdr->ftsz_f2 = (float) D->dims[1].sz;
+    hdr->apod_f2 = (float) D->dims[1].sz;
+    hdr->specnum = (float) D->dims[1].sz;
+    if (D->dims[1].cx) hdr->specnum *= 2.0;
 
     /* set spectral width, offset and carrier. */
-    hdr.sw_f2 = (float) D->dims[1].width;
-    hdr.obs_f2 = (float) D->dims[1].carrier;
-    hdr.orig_f2 = (float) D->dims[1].offset -  hdr.sw_f2 / 2.0;
+    hdr->sw_f2 = (float) D->dims[1].width;
+    hdr->obs_f2 = (float) D->dims[1].carrier;
+    hdr->orig_f2 = (float) D->dims[1].offset -  hdr->sw_f2 / 2.0;
   }
 
   /* if necessary, write the third-dimension header information. */
   if (D->nd >= 3) {
     /* set the pipe flag. */
-    hdr.pipe = 1;
+    hdr->pipe = 1;
 
     /* set quadrature information. */
-    hdr.quad_f3 = (D->dims[2].cx ? PIPE_QUAD_COMPLEX : PIPE_QUAD_REAL);
-    hdr.aqsgn_f3 = PIPE_AQSGN_NONE;
-    hdr.ftflag_f3 = (float) D->dims[2].ft;
+    hdr->quad_f3 = (D->dims[2].cx ? PIPE_QUAD_COMPLEX : PIPE_QUAD_REAL);
+    hdr->aqsgn_f3 = PIPE_AQSGN_NONE;
+    hdr->ftflag_f3 = (float) D->dims[2].ft;
 
     /* set nucleus information. */
-    strncpy(hdr.label_f3, D->dims[2].nuc, PIPE_HDRSTR_SZ_LABEL);
+    strncpy(hdr->label_f3, D->dims[2].nuc, PIPE_HDRSTR_SZ_LABEL);
 
     /* set size information. */
-    hdr.tdsz_f3 = (float) D->dims[2].td;
-    hdr.ftsz_f3 = (float) D->dims[2].sz;
-    hdr.apod_f3 = (float) D->dims[2].sz;
-    hdr.size_f3 = (float) D->dims[2].sz;
-    if (D->dims[2].cx) hdr.size_f3 *= 2.0;
+    hdr->tdsz_f3 = (float) D->dims[2].td;
+    hdr->ftsz_f3 = (float) D->dims[2].sz;
+    hdr->apod_f3 = (float) D->dims[2].sz;
+    hdr->size_f3 = (float) D->dims[2].sz;
+    if (D->dims[2].cx) hdr->size_f3 *= 2.0;
 
     /* set spectral width, offset and carrier. */
-    hdr.sw_f3 = (float) D->dims[2].width;
-    hdr.obs_f3 = (float) D->dims[2].carrier;
-    hdr.orig_f3 = (float) D->dims[2].offset -  hdr.sw_f3 / 2.0;
+    hdr->sw_f3 = (float) D->dims[2].width;
+    hdr->obs_f3 = (float) D->dims[2].carrier;
+    hdr->orig_f3 = (float) D->dims[2].offset -  hdr->sw_f3 / 2.0;
   }
 
   /* if necessary, write the fourth-dimension header information. */
   if (D->nd >= 4) {
     /* set quadrature information. */
-    hdr.quad_f4 = (D->dims[3].cx ? PIPE_QUAD_COMPLEX : PIPE_QUAD_REAL);
-    hdr.aqsgn_f4 = PIPE_AQSGN_NONE;
-    hdr.ftflag_f4 = (float) D->dims[3].ft;
+    hdr->quad_f4 = (D->dims[3].cx ? PIPE_QUAD_COMPLEX : PIPE_QUAD_REAL);
+    hdr->aqsgn_f4 = PIPE_AQSGN_NONE;
+    hdr->ftflag_f4 = (float) D->dims[3].ft;
 
     /* set nucleus information. */
-    strncpy(hdr.label_f4, D->dims[3].nuc, PIPE_HDRSTR_SZ_LABEL);
+    strncpy(hdr->label_f4, D->dims[3].nuc, PIPE_HDRSTR_SZ_LABEL);
 
     /* set size information. */
-    hdr.tdsz_f4 = (float) D->dims[3].td;
-    hdr.ftsz_f4 = (float) D->dims[3].sz;
-    hdr.apod_f4 = (float) D->dims[3].sz;
-    hdr.size_f4 = (float) D->dims[3].sz;
-    if (D->dims[3].cx) hdr.size_f4 *= 2.0;
+    hdr->tdsz_f4 = (float) D->dims[3].td;
+    hdr->ftsz_f4 = (float) D->dims[3].sz;
+    hdr->apod_f4 = (float) D->dims[3].sz;
+    hdr->size_f4 = (float) D->dims[3].sz;
+    if (D->dims[3].cx) hdr->size_f4 *= 2.0;
 
     /* set spectral width, offset and carrier. */
-    hdr.sw_f4 = (float) D->dims[3].width;
-    hdr.obs_f4 = (float) D->dims[3].carrier;
-    hdr.orig_f4 = (float) D->dims[3].offset -  hdr.sw_f4 / 2.0;
+    hdr->sw_f4 = (float) D->dims[3].width;
+    hdr->obs_f4 = (float) D->dims[3].carrier;
+    hdr->orig_f4 = (float) D->dims[3].offset -  hdr->sw_f4 / 2.0;
   }
 
+  /* return success. */
+  return 1;
+}
+
+/* pipe_encode_file(): write a datum structure in pipe-format, either to a
+ * single file or to a series of plane files.
+ * @D: pointer to the source structure.
+ * @fname: the output filename, or series filename template.
+ * @series: whether to write a series of plane files.
+ */
+static int pipe_encode_file (datum *D, const char *fname, int series) {
+  /* declare variables required to output pipe-format files:
+   * @tbl: pipe-ordered coefficient offset tables.
+   * @cnt: pipe-ordered coefficient offset table lengths.
+   * @hdr: the pipe file header structure.
+   * @nhdr: number of floats in @fhdr.
+   * @fh: the output file handle.
+   */
+  int *tbl[PIPE_MAXDIM], cnt[PIPE_MAXDIM];
+  struct pipe_header hdr;
+  int i, nhdr;
+  FILE *fh;
+
+  /* check that a plane series can be written. */
+  if (series && (!fname || D->nd < 3))
+    throw("plane series require a filename and three or four dimensions");
+
+  /* build the header from the datum parameters. */
+  if (!pipe_encode_header(D, &hdr))
+    throw("failed to build pipe header");
+
   /* compute the size of the header buffer. */
   nhdr = sizeof(struct pipe_header) / sizeof(float);
 
-  /* initialize the data buffer index. */
-  arr[0] = arr[1] = arr[2] = arr[3] = 0;
-  n = 0;
+  /* build the tables of pipe-ordered coefficient offsets. */
+  if (!pipe_offsets(D, tbl, cnt))
+    throw("failed to build pipe coefficient offsets");
+
+  /* check if a series of plane files was requested. */
+  if (series) {
+    /* write the planes into separate files. */
+    if (!pipe_fwrite_series(D, &hdr, fname, tbl, cnt)) {
+      /* free the offset tables and return failure. */
+      for (i = 0; i < PIPE_MAXDIM; i++)
+        hx_index_free(tbl[i]);
+
+      throw("failed to write pipe plane series '%s'", fname);
+    }
+
+    /* free the offset tables and return success. */
+    for (i = 0; i < PIPE_MAXDIM; i++)
+      hx_index_free(tbl[i]);
+
+    return 1;
+  }
 
   /* open the output file. */
   if (fname)
@@ -1065,17 +1438,42 @@ int pipe_encode (datum *D, const char *fname) {
     throw("failed to write %d header values", nhdr);
 
   /* write coefficients out from the datum core array. */
-  if (!pipe_fwrite_dim(D, D->nd - 1, n, arr, fh))
+  if (!pipe_fwrite_planes(D, tbl, cnt, fh))
     throw("failed to convert core array to pipe format");
 
   /* close the output file, if necessary. */
   if (fname)
     fclose(fh);
 
+  /* free the offset tables. */
+  for (i = 0; i < PIPE_MAXDIM; i++)
+    hx_index_free(tbl[i]);
+
   /* return success. */
   return 1;
 }
 
+/* pipe_encode(): write a datum structure in pipe-format to a file.
+ * @D: pointer to the source structure.
+ * @fname: the output filename.
+ */
+int pipe_encode (datum *D, const char *fname) {
+  /* write a single file. */
+  return pipe_encode_file(D, fname, 0);
+}
+
+/* pipe_encode_series(): write a three- or four-dimensional datum structure
+ * into a series of pipe-format plane files. the filename template must
+ * hold one integer conversion (the plane number) or, for four-dimensional
+ * data, two (the fourth- and third-dimension numbers), e.g. 'ft/p%03d.ft3'.
+ * @D: pointer to the source structure.
+ * @fname: the output filename template.
+ */
+int pipe_encode_series (datum *D, const char *fname) {
+  /* write a series of plane files. */
+  return pipe_encode_file(D, fname, 1);
+}
+
 /* pipe_array(): read a pipe-format data file into a datum array.
  * @D: pointer to the destination datum structure.
  */
@@ -1141,3 +1539,232 @@ int pipe_array (datum *D) {
   return 1;
 }
 
+
+/* pipe_stream_open(): read pipe parameters from the header of an input
+ * stream into a datum structure, in preparation for reading the stream
+ * one plane at a time using pipe_stream_read().
+ * @D: pointer to the destination datum structure.
+ * @fh: the input file handle.
+ */
+int pipe_stream_open (datum *D, FILE *fh) {
+  /* declare a few required variables:
+   * @endian: the byte ordering of the input stream.
+   * @hdr: the pipe file header structure.
+   * @d: dimension loop counter.
+   */
+  enum byteorder endian = BYTES_ENDIAN_AUTO;
+  struct pipe_header hdr;
+  unsigned int d;
+
+  /* read the header information from the input stream. */
+  if (!pipe_fread_header(fh, &endian, &hdr))
+    throw("failed to read header from input stream");
+
+  /* store the header parameters into the datum. */
+  if (!pipe_decode_header(D, &hdr))
+    throw("failed to decode header from input stream");
+
+  /* check that the stream holds single-file data. */
+  if (D->nd > 2 && hdr.pipe == 0.0 && hdr.file_count > 1.0)
+    throw("input stream holds one plane of a series of files");
+
+  /* gradient-enhanced planes may not be refactored independently. */
+  for (d = 2; d < D->nd; d++) {
+    if (D->dims[d].genh)
+      throw("gradient-enhanced dimension %u is not plane-local", d);
+  }
+
+  /* store the datum type. */
+  D->type = DATUM_TYPE_PIPE;
+  D->endian = endian;
+
+  /* return success. */
+  return 1;
+}
+
+/* pipe_stream_planes(): return the number of planes held in a pipe-format
+ * stream whose parameters have been read using pipe_stream_open().
+ * @D: pointer to the source datum structure.
+ */
+int pipe_stream_planes (datum *D) {
+  /* declare a few required variables:
+   * @d: dimension loop counter.
+   * @n: number of planes.
+   */
+  unsigned int d;
+  int n;
+
+  /* multiply together all point counts outside the plane. */
+  for (d = 2, n = 1; d < D->nd; d++)
+    n *= (D->dims[d].cx ? 2 : 1) * D->dims[d].sz;
+
+  /* return the plane count. */
+  return n;
+}
+
+/* pipe_stream_read(): read the next plane of a pipe-format input stream
+ * into a datum structure that holds (at most) the first two dimensions of
+ * the stream. sign alternation and imaginary negation of the outer stream
+ * dimensions are applied to the plane.
+ * @D: pointer to the stream datum structure.
+ * @P: pointer to the destination plane datum structure.
+ * @p: index of the plane to read.
+ * @fh: the input file handle.
+ */
+int pipe_stream_read (datum *D, datum *P, int p, FILE *fh) {
+  /* declare a few required variables:
+   * @d: dimension loop counter.
+   * @np: number of plane dimensions.
+   * @n: number of floats per plane.
+   * @nc: number of complex components of the current dimension.
+   * @q: remaining plane index to unpack.
+   * @i: point index of the plane along the current dimension.
+   * @sgn: sign of the plane after outer-dimension corrections.
+   * @buf: buffer of read bytes.
+   */
+  unsigned int d, np;
+  int n, nc, q, i;
+  real sgn;
+  uint8_t *buf;
+
+  /* determine the number of plane dimensions. */
+  np = (D->nd < 2 ? D->nd : 2);
+
+  /* compute the number of floats per plane. */
+  for (d = 0, n = 1; d < np; d++)
+    n *= (D->dims[d].cx ? 2 : 1) * D->dims[d].sz;
+
+  /* reset the plane dimension parameters from the stream datum. */
+  if (P->nd != np && !datum_dims_realloc(P, np))
+    throw("failed to allocate plane dimension array");
+
+  memcpy(P->dims, D->dims, np * sizeof(datum_dim));
+
+  /* free any previously read plane array. */
+  if (P->array_alloc) {
+    hx_array_free(&P->array);
+    P->array_alloc = 0;
+  }
+
+  /* allocate the raw plane array. */
+  if (!hx_array_alloc(&P->array, 0, 1, &n))
+    throw("failed to allocate plane array of %d reals", n);
+
+  P->array_alloc = 1;
+  P->type = DATUM_TYPE_PIPE;
+  P->epoch = D->epoch;
+
+  /* allocate the plane byte buffer. */
+  buf = (uint8_t*) malloc(n * sizeof(float));
+  if (!buf)
+    throw("failed to allocate buffer of %d floats", n);
+
+  /* read and decode the plane. */
+  if (fread(buf, sizeof(float), n, fh) != n) {
+    free(buf);
+    throw("failed to read plane %d from input stream", p);
+  }
+
+  hx_array_decode_raw(buf, P->array.x, n, D->endian, sizeof(float), 1);
+  free(buf);
+
+  /* interlace the complex direct-dimension traces, if necessary. */
+  if (P->dims[0].cx && !pipe_interlace(&P->array, P->dims[0].sz))
+    throw("failed to interlace complex traces");
+
+  /* refactor the plane array. */
+  if (!datum_array_refactor(P))
+    throw("failed to refactor plane %d", p);
+
+  /* determine the sign of the plane from the outer dimensions. */
+  for (d = 2, q = p, sgn = 1.0; d < D->nd; d++) {
+    /* unpack the point index and component of the current dimension. */
+    nc = (D->dims[d].cx ? 2 : 1);
+    i = (q % (nc * D->dims[d].sz)) / nc;
+
+    /* apply sign alternation and imaginary negation. */
+    if (D->dims[d].alt && i % 2)
+      sgn = -sgn;
+
+    if (D->dims[d].neg && nc == 2 && q % 2)
+      sgn = -sgn;
+
+    /* move to the next dimension. */
+    q /= nc * D->dims[d].sz;
+  }
+
+  /* negate the plane, if required. */
+  if (sgn < 0.0 && !hx_array_scale(&P->array, sgn, &P->array))
+    throw("failed to negate plane %d", p);
+
+  /* return success. */
+  return 1;
+}
+
+/* pipe_stream_header(): write a pipe-format header to an output stream,
+ * in preparation for writing the stream one plane at a time using
+ * pipe_stream_write().
+ * @D: pointer to the stream datum structure.
+ * @fh: the output file handle.
+ */
+int pipe_stream_header (datum *D, FILE *fh) {
+  /* declare a few required variables:
+   * @hdr: the pipe file header structure.
+   * @nhdr: number of floats in @hdr.
+   */
+  struct pipe_header hdr;
+  int nhdr;
+
+  /* build the header from the datum parameters. */
+  if (!pipe_encode_header(D, &hdr))
+    throw("failed to build pipe header");
+
+  /* write the header to the output stream. */
+  nhdr = sizeof(struct pipe_header) / sizeof(float);
+  if (fwrite(&hdr, sizeof(float), nhdr, fh) != nhdr)
+    throw("failed to write %d header values", nhdr);
+
+  /* return success. */
+  return 1;
+}
+
+/* pipe_stream_write(): write a plane datum structure to a pipe-format
+ * output stream.
+ * @P: pointer to the source plane datum structure.
+ * @fh: the output file handle.
+ */
+int pipe_stream_write (datum *P, FILE *fh) {
+  /* declare a few required variables:
+   * @tbl: pipe-ordered coefficient offset tables.
+   * @cnt: pipe-ordered coefficient offset table lengths.
+   * @i: offset table loop counter.
+   * @ret: plane write result.
+   */
+  int *tbl[PIPE_MAXDIM], cnt[PIPE_MAXDIM];
+  int i, ret;
+
+  /* check that the datum is a plane. */
+  if (P->nd > 2)
+    throw("datum contains too many dimensions for a plane");
+
+  /* build the tables of pipe-ordered coefficient offsets. */
+  if (!pipe_offsets(P, tbl, cnt))
+    throw("failed to build pipe coefficient offsets");
+
+  /* write the plane coefficients. */
+  ret = pipe_fwrite_planes(P, tbl, cnt, fh);
+
+  /* free the offset tables. */
+  for (i = 0; i < PIPE_MAXDIM; i++)
+    hx_index_free(tbl[i]);
+
+  /* check that the plane was written. */
+  if (!ret)
+    throw("failed to write plane to output stream");
+
+  /* flush the plane downstream. */
+  fflush(fh);
+
+  /* return success. */
+  return 1;
+}
@@ -607,28 +607,29 @@ int rnmrtk_decode (datum *D, const char *fname) {
   return 1;
 }
 
-/* rnmrtk_fwrite_dim(): write the contents of a datum core array into an
- * output file stream of rnmrtk-format coefficients. recursively drop from
- * cubes, to planes, to traces, and finally to points.
+/* rnmrtk_pack_dim(): pack the contents of a datum core array into an
+ * array of rnmrtk-ordered coefficients. recursively drop from cubes, to
+ * planes, to traces, and finally to points.
  * @D: pointer to the source datum structure.
  * @dim: current datum dimension in the recursion.
  * @n0: current coefficient offset in the resursion.
  * @idx: index array for looping though the datum core array.
- * @fh: the output file handle.
+ * @xout: the output coefficient array.
+ * @pos: pointer to the current output coefficient index.
  */
-int rnmrtk_fwrite_dim (datum *D, unsigned int dim,
-                       int n0, hx_index idx,
-                       FILE *fh) {
+void rnmrtk_pack_dim (datum *D, unsigned int dim,
+                      int n0, hx_index idx,
+                      real *xout, int *pos) {
   /* declare a few required variables:
    * @d: current array algebraic dimension index.
    * @k: current array topological dimension index.
    * @n: current array coefficient imaginary offset.
    * @num: size along current array dimension.
    * @pidx: packed linear scalar index.
-   * @f: float output value.
+   * @xi: pointer to the current input coefficient.
    */
   int d, k, n, num, pidx;
-  float f;
+  real *xi;
 
   /* determine the array dimension indices. */
   d = D->dims[dim].d;
@@ -642,40 +643,32 @@ int rnmrtk_fwrite_dim (datum *D, unsigned int dim,
 
   /* check if we've reached the lowest dimension. */
   if (k == 0) {
-    /* store the points of the current trace. */
-    for (idx[k] = 0; idx[k] < num; idx[k]++) {
-      /* pack the linear index. */
-      hx_index_pack(D->array.k, D->array.sz, idx, &pidx);
+    /* pack the linear index of the first trace point. */
+    idx[k] = 0;
+    hx_index_pack(D->array.k, D->array.sz, idx, &pidx);
+    xi = D->array.x + D->array.n * pidx + n0;
 
-      /* get the real coefficient and write it out. */
-      f = (float) D->array.x[D->array.n * pidx + n0];
-      if (fwrite(&f, sizeof(float), 1, fh) != 1)
-        return 0;
+    /* store the points of the current trace. */
+    for (idx[k] = 0; idx[k] < num; idx[k]++, xi += D->array.n) {
+      /* store the real coefficient. */
+      xout[(*pos)++] = xi[0];
 
       /* check if the trace is complex. */
-      if (D->dims[dim].cx) {
-        /* get the imaginary coefficient and write it out. */
-        f = (float) D->array.x[D->array.n * pidx + n0 + n];
-        if (fwrite(&f, sizeof(float), 1, fh) != 1)
-          return 0;
-      }
+      if (D->dims[dim].cx)
+        xout[(*pos)++] = xi[n];
     }
   }
   else {
     /* recurse into the lower dimensions. */
     for (idx[k] = 0; idx[k] < num; idx[k]++) {
       /* recurse the real component. */
-      if (!rnmrtk_fwrite_dim(D, dim - 1, n0, idx, fh))
-        return 0;
+      rnmrtk_pack_dim(D, dim - 1, n0, idx, xout, pos);
 
       /* recurse the imaginary component. */
-      if (D->dims[dim].cx && !rnmrtk_fwrite_dim(D, dim - 1, n0 + n, idx, fh))
-        return 0;
+      if (D->dims[dim].cx)
+        rnmrtk_pack_dim(D, dim - 1, n0 + n, idx, xout, pos);
     }
   }
-
-  /* return success. */
-  return 1;
 }
 
 /* rnmrtk_encode(): write a datum structure in rnmrtk-format to a file.
@@ -686,11 +679,15 @@ int rnmrtk_encode (datum *D, const char *fname) {
   /* declare variables required for parameter output:
    * @par: structure to hold all data file parameters.
    * @d: dimension loop counter.
+   * @len: number of output coefficients.
+   * @pos: output coefficient index.
+   * @xout: array of output coefficients.
    * @fh: output data file handle.
    */
-  int n, arr[RNMRTK_MAXDIM], ord[RNMRTK_MAXDIM];
+  int n, len, pos, arr[RNMRTK_MAXDIM], ord[RNMRTK_MAXDIM];
   struct rnmrtk_parms par;
   unsigned int d;
+  hx_array xout;
   FILE *fh;
 
   /* check the output filename. */
@@ -740,9 +737,20 @@ int rnmrtk_encode (datum *D, const char *fname) {
   if (!rnmrtk_write_parms(fname, &par))
     throw("failed to write parameters for '%s'", fname);
 
+  /* compute the number of output coefficients. */
+  for (d = 0, len = 1; d < D->nd; d++)
+    len *= (D->dims[d].cx ? 2 : 1) * D->array.sz[D->dims[d].k];
+
+  /* allocate an array for the output coefficients. */
+  if (!hx_array_alloc(&xout, 0, 1, &len))
+    throw("failed to allocate output coefficient array");
+
   /* initialize the data buffer index. */
   arr[0] = arr[1] = arr[2] = arr[3] = 0;
-  n = 0;
+  n = pos = 0;
+
+  /* pack coefficients out from the datum core array. */
+  rnmrtk_pack_dim(D, D->nd - 1, n, arr, xout.x, &pos);
 
   /* open the output data file. */
   fh = fopen(fname, "wb");
@@ -751,9 +759,12 @@ int rnmrtk_encode (datum *D, const char *fname) {
   if (!fh)
     throw("failed to open '%s'", fname);
 
-  /* write coefficients out from the datum core array. */
-  if (!rnmrtk_fwrite_dim(D, D->nd - 1, n, arr, fh))
-    throw("failed to convert core array to rnmrtk format");
+  /* write the packed coefficients to the output file. */
+  if (!hx_array_fwrite_raw(fh, &xout, par.endian, sizeof(float), 1))
+    throw("failed to write rnmrtk-format core array data");
+
+  /* free the output coefficient array. */
+  hx_array_free(&xout);
 
   /* close the output file. */
   fclose(fh);
@@ -23,22 +23,232 @@
 /* include the text header. */
 #include <hxnd/nmr-text.h>
 
-/* text_encode(): write a datum structure in text-format to a file.
+/* include the floating point limits header. */
+#include <float.h>
+
+/* TEXT_SZ_CHUNK: number of array points formatted into each buffer.
+ */
+#define TEXT_SZ_CHUNK  16384
+
+/* TEXT_SZ_INDEX, TEXT_SZ_COEFF: maximum number of characters written by
+ * text_format_index() and text_format_real().
+ */
+#define TEXT_SZ_INDEX  12
+#define TEXT_SZ_COEFF  32
+
+/* TEXT_POW_MAX: largest exponent in the table of powers of ten.
+ */
+#define TEXT_POW_MAX  27
+
+/* text_pow10: powers of ten that are exactly representable as long double
+ * values, used to scale coefficients into nine-digit integers.
+ */
+static const long double text_pow10[] = {
+  1e0L,  1e1L,  1e2L,  1e3L,  1e4L,  1e5L,  1e6L,  1e7L,  1e8L,  1e9L,
+  1e10L, 1e11L, 1e12L, 1e13L, 1e14L, 1e15L, 1e16L, 1e17L, 1e18L, 1e19L,
+  1e20L, 1e21L, 1e22L, 1e23L, 1e24L, 1e25L, 1e26L, 1e27L
+};
+
+/* text_format_index(): write an array index into a string in the same
+ * form as the printf format "%6d ", returning the number of characters
+ * written.
+ * @s: the output string.
+ * @v: the index to format.
+ */
+int text_format_index (char *s, int v) {
+  /* declare a few required variables:
+   * @buf: reversed digits of the index.
+   * @n: number of digits.
+   * @len: number of characters written.
+   * @u: magnitude of the index.
+   */
+  char buf[TEXT_SZ_INDEX];
+  unsigned int u;
+  int n, len;
+
+  /* extract the digits of the index magnitude, least significant first. */
+  u = (v < 0 ? 0u - (unsigned int) v : (unsigned int) v);
+  n = 0;
+  do {
+    buf[n++] = (char) ('0' + u % 10);
+    u /= 10;
+  } while (u);
+
+  /* add the sign, if any. */
+  if (v < 0)
+    buf[n++] = '-';
+
+  /* pad the field to six characters. */
+  for (len = 0; len + n < 6; len++)
+    s[len] = ' ';
+
+  /* write the digits in order, followed by a space. */
+  while (n)
+    s[len++] = buf[--n];
+
+  s[len++] = ' ';
+
+  /* return the number of written characters. */
+  return len;
+}
+
+/* text_format_real(): write a coefficient into a string in the same form
+ * as the printf format "%18.8e ", returning the number of characters
+ * written. the coefficient is scaled by an exact power of ten into a
+ * nine-digit integer, and printf is only used when the scaled value lies
+ * too close to a rounding boundary, or outside the table of powers.
+ * @s: the output string.
+ * @x: the coefficient to format.
+ */
+int text_format_real (char *s, real x) {
+  /* declare variables for decimal conversion:
+   * @v: scaled coefficient magnitude.
+   * @f: fractional part of @v.
+   * @m: nine-digit decimal mantissa.
+   * @e: decimal exponent.
+   * @p: power of ten used to scale the coefficient.
+   * @neg: whether the coefficient is negative.
+   */
+  long double v, f;
+  uint64_t m;
+  int e, p, neg;
+
+  /* declare variables for string output:
+   * @buf: unpadded output characters.
+   * @ue: magnitude of the exponent.
+   * @n: number of unpadded output characters.
+   * @len: number of characters written.
+   * @i: digit loop counter.
+   */
+  char buf[TEXT_SZ_COEFF];
+  int ue, n, len, i;
+
+  /* fall back to printf for infinite and undefined values. */
+  if (!isfinite(x))
+    return sprintf(s, "%18.8e ", (double) x);
+
+  /* get the sign and magnitude of the coefficient. */
+  neg = signbit(x) ? 1 : 0;
+  v = fabsl((long double) x);
+
+  /* check for the special case of zero. */
+  if (v == 0.0L) {
+    /* zero has an all-zero mantissa and exponent. */
+    m = 0;
+    e = 0;
+  }
+  else {
+    /* estimate the decimal exponent. */
+    e = (int) floor(log10((double) v));
+
+    /* scale the magnitude into the range [1e8, 1e9). */
+    do {
+      /* fall back to printf if no exact power of ten is available. */
+      p = 8 - e;
+      if (p > TEXT_POW_MAX || p < -TEXT_POW_MAX)
+        return sprintf(s, "%18.8e ", (double) x);
+
+      /* scale the magnitude by the power of ten. */
+      f = fabsl((long double) x);
+      f = (p >= 0 ? f * text_pow10[p] : f / text_pow10[-p]);
+
+      /* correct the exponent estimate, if required. */
+      if (f < 1e8L)
+        e--;
+      else if (f >= 1e9L)
+        e++;
+    } while (f < 1e8L || f >= 1e9L);
+
+    /* split the scaled magnitude into its integer and fractional parts. */
+    v = f;
+    m = (uint64_t) v;
+    f = v - (long double) m;
+
+    /* fall back to printf if the rounding direction is uncertain. */
+    if (fabsl(f - 0.5L) < 8.0L * 1e9L * LDBL_EPSILON)
+      return sprintf(s, "%18.8e ", (double) x);
+
+    /* round the mantissa, carrying into the exponent if needed. */
+    if (f > 0.5L && ++m == 1000000000u) {
+      m = 100000000u;
+      e++;
+    }
+  }
+
+  /* write the sign and the leading digit. */
+  n = 0;
+  if (neg)
+    buf[n++] = '-';
+
+  buf[n++] = (char) ('0' + m / 100000000u);
+  buf[n++] = '.';
+
+  /* write the remaining eight digits. */
+  for (i = 7; i >= 0; i--) {
+    buf[n + i] = (char) ('0' + m % 10);
+    m /= 10;
+  }
+  n += 8;
+
+  /* write the exponent, with at least two digits. */
+  ue = (e < 0 ? -e : e);
+  buf[n++] = 'e';
+  buf[n++] = (e < 0 ? '-' : '+');
+  if (ue >= 100)
+    buf[n++] = (char) ('0' + ue / 100);
+
+  buf[n++] = (char) ('0' + (ue / 10) % 10);
+  buf[n++] = (char) ('0' + ue % 10);
+
+  /* pad the field to eighteen characters. */
+  for (len = 0; len + n < 18; len++)
+    s[len] = ' ';
+
+  /* copy the characters, followed by a space. */
+  memcpy(s + len, buf, n);
+  len += n;
+  s[len++] = ' ';
+
+  /* return the number of written characters. */
+  return len;
+}
+
+/* text_write(): write a datum structure in text-format to a file. the
+ * points of the array are formatted in parallel into a batch of buffers,
+ * one contiguous range of points per buffer, and the buffers are then
+ * written out in order.
  * @D: pointer to the source structure.
  * @fname: the output filename.
+ * @flags: bitwise or of TEXT_NO_INDEX and TEXT_REAL_ONLY.
  */
-int text_encode (datum *D, const char *fname) {
-  /* declare required variables:
-   * @idx: unpacked multidimensional array indices.
-   * @pidx: packed linear array index.
+int text_write (datum *D, const char *fname, int flags) {
+  /* declare variables for output formatting:
    * @d: dimension loop counter.
+   * @nidx: number of index columns per line.
+   * @ncoef: number of coefficient columns per line.
+   * @szline: maximum number of characters per line.
+   * @npts: number of points in the array.
    * @fh: output file handle.
    */
   unsigned int d;
-  hx_index idx;
-  int i, pidx;
+  int nidx, ncoef, npts;
+  size_t szline;
   FILE *fh;
 
+  /* declare variables for batched, parallel formatting:
+   * @bufs: array of formatted chunk buffers.
+   * @lens: array of formatted chunk lengths.
+   * @nbuf: number of chunk buffers in a batch.
+   * @nchunk: total number of chunks.
+   * @c0: first chunk of the current batch.
+   * @nb: number of chunks in the current batch.
+   * @c: chunk loop counter.
+   * @ok: whether every chunk was formatted.
+   */
+  int nbuf, nchunk, c0, nb, c, ok;
+  size_t *lens;
+  char **bufs;
+
   /* open the output file. */
   if (fname)
     fh = fopen(fname, "wb");
@@ -67,37 +277,151 @@ int text_encode (datum *D, const char *fname) {
     fprintf(fh, "#\n");
   }
 
-  /* allocate an index array for iteration. */
-  idx = hx_index_alloc(D->array.k);
+  /* determine the columns of each line. */
+  nidx = (flags & TEXT_NO_INDEX ? 0 : D->array.k);
+  ncoef = (flags & TEXT_REAL_ONLY ? 1 : D->array.n);
+  szline = (size_t) nidx * TEXT_SZ_INDEX +
+           (size_t) ncoef * TEXT_SZ_COEFF + 1;
 
-  /* check that allocation was successful. */
-  if (!idx)
-    throw("failed to allocate %d indices", D->array.k);
+  /* determine the number of points and chunks. */
+  npts = D->array.len / D->array.n;
+  nchunk = (npts + TEXT_SZ_CHUNK - 1) / TEXT_SZ_CHUNK;
 
-  /* iterate over the points in the core array. */
-  do {
-    /* pack the linear index. */
-    hx_index_pack(D->array.k, D->array.sz, idx, &pidx);
+  /* determine the number of chunks in each batch. */
+  nbuf = 2 * omp_get_max_threads();
+  nbuf = (nbuf < nchunk ? nbuf : nchunk);
+  nbuf = (nbuf > 0 ? nbuf : 1);
 
-    /* print the indices. */
-    for (i = 0; i < D->array.k; i++)
-      fprintf(fh, "%6d ", idx[i]);
+  /* allocate the chunk buffer arrays. */
+  bufs = (char**) calloc(nbuf, sizeof(char*));
+  lens = (size_t*) calloc(nbuf, sizeof(size_t));
+  if (!bufs || !lens)
+    throw("failed to allocate %d chunk buffers", nbuf);
+
+  /* allocate the chunk buffers. */
+  for (c = 0; c < nbuf; c++) {
+    bufs[c] = (char*) malloc(szline * TEXT_SZ_CHUNK);
+    if (!bufs[c])
+      throw("failed to allocate chunk buffer %d", c);
+  }
 
-    /* print the coefficients. */
-    for (i = 0; i < D->array.n; i++)
-      fprintf(fh, "%18.8e ", D->array.x[i + D->array.n * pidx]);
+  /* loop over the chunks, one batch at a time. */
+  for (c0 = 0; c0 < nchunk; c0 += nb) {
+    /* determine the number of chunks in the current batch. */
+    nb = (nchunk - c0 < nbuf ? nchunk - c0 : nbuf);
+    ok = 1;
 
-    /* print a newline. */
-    fprintf(fh, "\n");
-  } while (hx_index_incr(D->array.k, D->array.sz, idx));
+    /* format the chunks of the batch in parallel. */
+    #pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+    for (c = c0; c < c0 + nb; c++) {
+      /* declare required thread-local variables:
+       * @idx: unpacked multidimensional array indices.
+       * @p: linear point index.
+       * @pend: end of the point range of the chunk.
+       * @i: column loop counter.
+       * @s: current output character.
+       * @x: coefficients of the current point.
+       */
+      hx_index idx;
+      int p, pend, i;
+      real *x;
+      char *s;
+
+      /* allocate the thread-local index. */
+      idx = hx_index_alloc(D->array.k);
+      if (idx) {
+        /* determine the point range of the chunk. */
+        p = c * TEXT_SZ_CHUNK;
+        pend = (p + TEXT_SZ_CHUNK < npts ? p + TEXT_SZ_CHUNK : npts);
+        hx_index_unpack(D->array.k, D->array.sz, idx, p);
+
+        /* format each point of the chunk. */
+        for (s = bufs[c - c0]; p < pend; p++) {
+          /* write the indices. */
+          for (i = 0; i < nidx; i++)
+            s += text_format_index(s, idx[i]);
+
+          /* write the coefficients. */
+          x = D->array.x + (size_t) p * D->array.n;
+          for (i = 0; i < ncoef; i++)
+            s += text_format_real(s, x[i]);
+
+          /* write a newline and move to the next point. */
+          *(s++) = '\n';
+          hx_index_incr(D->array.k, D->array.sz, idx);
+        }
+
+        /* store the formatted length. */
+        lens[c - c0] = (size_t) (s - bufs[c - c0]);
+      }
+      else
+        ok = 0;
+
+      /* free the thread-local index. */
+      hx_index_free(idx);
+    }
+
+    /* check that every chunk was formatted. */
+    if (!ok)
+      throw("failed to format chunks %d..%d", c0, c0 + nb - 1);
+
+    /* write the formatted chunks in order. */
+    for (c = 0; c < nb; c++) {
+      if (fwrite(bufs[c], 1, lens[c], fh) != lens[c])
+        throw("failed to write chunk %d", c0 + c);
+    }
+  }
 
   /* close the output file. */
   fclose(fh);
 
-  /* free the multidimensional index. */
-  hx_index_free(idx);
+  /* free the chunk buffers. */
+  for (c = 0; c < nbuf; c++)
+    free(bufs[c]);
+
+  /* free the chunk buffer arrays. */
+  free(bufs);
+  free(lens);
 
   /* return success. */
   return 1;
 }
 
+/* text_encode(): write a datum structure in text-format to a file.
+ * @D: pointer to the source structure.
+ * @fname: the output filename.
+ */
+int text_encode (datum *D, const char *fname) {
+  /* write all indices and coefficients. */
+  return text_write(D, fname, 0);
+}
+
+/* text_encode_real(): write a datum structure in text-format to a file,
+ * including only the real coefficient of each point.
+ * @D: pointer to the source structure.
+ * @fname: the output filename.
+ */
+int text_encode_real (datum *D, const char *fname) {
+  /* write all indices and the real coefficients. */
+  return text_write(D, fname, TEXT_REAL_ONLY);
+}
+
+/* text_encode_values(): write a datum structure in text-format to a file,
+ * omitting the index columns.
+ * @D: pointer to the source structure.
+ * @fname: the output filename.
+ */
+int text_encode_values (datum *D, const char *fname) {
+  /* write all coefficients. */
+  return text_write(D, fname, TEXT_NO_INDEX);
+}
+
+/* text_encode_real_values(): write a datum structure in text-format to a
+ * file, omitting the index columns and all but the real coefficients.
+ * @D: pointer to the source structure.
+ * @fname: the output filename.
+ */
+int text_encode_real_values (datum *D, const char *fname) {
+  /* write only the real coefficients. */
+  return text_write(D, fname, TEXT_NO_INDEX | TEXT_REAL_ONLY);
+}
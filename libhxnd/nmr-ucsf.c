@@ -177,40 +177,23 @@ int ucsf_read_header (const char *fname,
   return 1;
 }
 
-/* ucsf_tiler(): redo or undo the tiling inherent in ucsf-format files,
- * effectively mapping between tiled array data and a real linear
- * array suitable for refactoring.
- * @x: pointer to the array to linearize.
+/* ucsf_tiling(): compute the tile counts and sizes of ucsf-format data
+ * from the file and dimension headers.
  * @fhdr: pointer to the file header.
  * @dhdr: array of dimension headers.
- * @dir: direction, either 0 (linearize) or 1 (tileize).
+ * @nt: output array of tile counts.
+ * @szt: output array of tile sizes.
  */
-int ucsf_tiler (hx_array *x,
-                struct ucsf_file_header *fhdr,
-                struct ucsf_dim_header *dhdr,
-                int dir) {
-  /* declare a few required variables:
+int ucsf_tiling (struct ucsf_file_header *fhdr,
+                 struct ucsf_dim_header *dhdr,
+                 hx_index nt, hx_index szt) {
+  /* declare a required variable:
    * @i: general purpose loop counter.
-   * @k: number of dimensions.
-   * @nt: array of tile counts.
-   * @szt: array of tile sizes.
    */
-  hx_index nt, szt;
-  int i, k;
-
-  /* gain a handle on the dimensionality of the array data. */
-  k = (int) fhdr->ndims;
-
-  /* allocate the size index arrays. */
-  nt = hx_index_alloc(k);
-  szt = hx_index_alloc(k);
-
-  /* check that all index allocations were successful. */
-  if (!nt || !szt)
-    throw("failed to allocate two sets of %d indices", k);
+  int i;
 
   /* initialize the size arrays. */
-  for (i = 0; i < k; i++) {
+  for (i = 0; i < (int) fhdr->ndims; i++) {
     /* check that the point and tile counts are nonzero. */
     if (dhdr[i].npts < 1 || dhdr[i].sztile < 1)
       throw("invalid tiling (%u, %u) along dimension %d",
@@ -228,28 +211,10 @@ int ucsf_tiler (hx_array *x,
     szt[i] = dhdr[i].sztile;
   }
 
-  /* perform the mapping operation. */
-  if (!hx_array_tiler(x, k, nt, szt, dir, HX_ARRAY_INCR_REVERSE))
-    throw("failed to perform tile mapping");
-
-  /* free the allocated index arrays. */
-  hx_index_free(nt);
-  hx_index_free(szt);
-
   /* return success. */
   return 1;
 }
 
-/* ucsf_linearize(): map tiles to linear array data.
- */
-#define ucsf_linearize(x, fhdr, dhdr) \
-  ucsf_tiler(x, fhdr, dhdr, HX_ARRAY_TILER_FORWARD)
-
-/* ucsf_tileize(): map linear array data to tiles.
- */
-#define ucsf_tileize(x, fhdr, dhdr) \
-  ucsf_tiler(x, fhdr, dhdr, HX_ARRAY_TILER_REVERSE)
-
 /* ucsf_guess(): check whether a file contains ucsf-format data.
  * @fname: the input filename.
  */
@@ -367,12 +332,14 @@ int ucsf_encode (datum *D, const char *fname) {
   unsigned int i_div, n_tile;
   FILE *fh;
 
-  /* declare a dimension loop counter. */
+  /* declare variables required for tiled output:
+   * @nt: array of tile counts.
+   * @szt: array of tile sizes.
+   * @d: dimension loop counter.
+   */
+  hx_index nt, szt;
   unsigned int d;
 
-  /* declare an array structure to use for writing. */
-  hx_array xout;
-
   /* allocate an array of dimension headers. */
   dhdr = (struct ucsf_dim_header*)
     calloc(D->nd, sizeof(struct ucsf_dim_header));
@@ -435,20 +402,17 @@ int ucsf_encode (datum *D, const char *fname) {
       n_tile *= dhdr[d].sztile;
   } while (n_tile > UCSF_MAX_TILE);
 
-  /* check if the datum array is real. */
-  if (D->array.d == 0) {
-    /* just use the datum array. */
-    xout = D->array;
-  }
-  else {
-    /* copy the real component of the datum array. */
-    if (!hx_array_copy_real(&xout, &D->array))
-      throw("failed to copy real component of core array");
-  }
+  /* allocate the tiling index arrays. */
+  nt = hx_index_alloc(D->nd);
+  szt = hx_index_alloc(D->nd);
+
+  /* check that allocation succeeded. */
+  if (!nt || !szt)
+    throw("failed to allocate two sets of %u indices", D->nd);
 
-  /* map the linear datum array back into tiles. */
-  if (!ucsf_tileize(&xout, &fhdr, dhdr))
-    throw("failed to delinearize array into tiles");
+  /* determine the tiling of the output file. */
+  if (!ucsf_tiling(&fhdr, dhdr, nt, szt))
+    throw("failed to determine output tiling");
 
   /* open the output file. */
   if (fname)
@@ -468,26 +432,19 @@ int ucsf_encode (datum *D, const char *fname) {
   if (fwrite(dhdr, sizeof(struct ucsf_dim_header), D->nd, fh) != D->nd)
     throw("failed to write %u dimension headers", D->nd);
 
-  /* write the array data. */
-  if (!hx_array_fwrite_raw(fh, &xout, bytes_get_native(), sizeof(float), 1))
+  /* gather the real array data into tiles and write them. */
+  if (!hx_array_fwrite_tiled(fh, &D->array, bytes_get_native(),
+                             sizeof(float), 1, nt, szt,
+                             HX_ARRAY_INCR_REVERSE))
     throw("failed to write core array data");
 
   /* close the output file. */
   if (fname)
     fclose(fh);
 
-  /* check if the datum array was used directly. */
-  if (D->array.d == 0) {
-    /* map the tiled array back into the proper format, just in case it
-     * needs to be used again.
-     */
-    if (!ucsf_linearize(&xout, &fhdr, dhdr))
-      throw("failed to re-linearize tiled array");
-  }
-  else {
-    /* throw away the real copy of the datum array. */
-    hx_array_free(&xout);
-  }
+  /* free the tiling index arrays. */
+  hx_index_free(nt);
+  hx_index_free(szt);
 
   /* free the dimension header array. */
   free(dhdr);
@@ -509,12 +466,15 @@ int ucsf_array (datum *D) {
   struct ucsf_file_header fhdr;
   struct ucsf_dim_header *dhdr;
 
-  /* declare variables for reading raw data bytes:
+  /* declare variables for reading tiles:
    * @offset: byte offset where point data begins.
-   * @i: general purpose loop counter.
-   * @n: number of words to read.
+   * @nt: array of tile counts.
+   * @szt: array of tile sizes.
+   * @n: number of words read.
    */
-  unsigned int offset, i, n;
+  unsigned int offset;
+  hx_index nt, szt;
+  int n;
   FILE *fh;
 
   /* check that the input filename is valid. */
@@ -525,14 +485,22 @@ int ucsf_array (datum *D) {
   if (!ucsf_read_header(D->fname, &endian, &fhdr, &dhdr))
     throw("failed to read header of '%s'", D->fname);
 
+  /* allocate the tiling index arrays. */
+  nt = hx_index_alloc(fhdr.ndims);
+  szt = hx_index_alloc(fhdr.ndims);
+
+  /* check that allocation succeeded. */
+  if (!nt || !szt)
+    throw("failed to allocate two sets of %u indices", fhdr.ndims);
+
+  /* determine the tiling of the file. */
+  if (!ucsf_tiling(&fhdr, dhdr, nt, szt))
+    throw("failed to determine tiling of '%s'", D->fname);
+
   /* compute the byte offset from which to begin reading point data. */
   offset = sizeof(struct ucsf_file_header);
   offset += fhdr.ndims * sizeof(struct ucsf_dim_header);
 
-  /* compute the number of words to read. */
-  for (i = 0, n = 1; i < fhdr.ndims; i++)
-    n *= dhdr[i].npts;
-
   /* open the input file for reading. */
   fh = fopen(D->fname, "rb");
 
@@ -540,22 +508,106 @@ int ucsf_array (datum *D) {
   if (!fh)
     throw("failed to open '%s'", D->fname);
 
-  /* read data from the file into the output array. */
-  if (!hx_array_fread_raw(fh, &D->array, endian, sizeof(float), 1,
-                          offset, 0, 1, n, 0))
-    throw("failed to read raw data from '%s'", D->fname);
+  /* read and linearize the tiles in a single pass. */
+  if (!hx_array_fread_tiled(fh, &D->array, endian, sizeof(float), 1,
+                            offset, fhdr.ndims, nt, szt,
+                            HX_ARRAY_INCR_REVERSE, NULL, NULL))
+    throw("failed to read tiled data from '%s'", D->fname);
 
   /* close the input file. */
   fclose(fh);
 
-  /* convert tiles to linear values. */
-  if (!ucsf_linearize(&D->array, &fhdr, dhdr))
-    throw("failed to linearize tiled array");
+  /* flatten the linear values into a vector, ready for refactoring. */
+  n = D->array.len;
+  if (!hx_array_reshape(&D->array, 1, &n))
+    throw("failed to flatten tiled array");
 
-  /* free the dimension header array. */
+  /* free the allocated memory. */
+  hx_index_free(nt);
+  hx_index_free(szt);
   free(dhdr);
 
   /* return success. */
   return 1;
 }
 
+/* ucsf_region(): read a region of a ucsf-format data file into a datum
+ * array, reading only the tiles that overlap the region.
+ * @D: pointer to the destination datum structure.
+ * @lower: lower region bounds, or NULL to read the whole array.
+ * @upper: upper region bounds, or NULL to read the whole array.
+ */
+int ucsf_region (datum *D, hx_index lower, hx_index upper) {
+  /* declare variables required to read headers.
+   * @endian: byte ordering of the input file.
+   * @fhdr: file header structure.
+   * @dhdr: array of dimension header structures.
+   */
+  enum byteorder endian = BYTES_ENDIAN_AUTO;
+  struct ucsf_file_header fhdr;
+  struct ucsf_dim_header *dhdr;
+
+  /* declare variables for reading tiles:
+   * @offset: byte offset where point data begins.
+   * @nt: array of tile counts.
+   * @szt: array of tile sizes.
+   * @d: dimension loop counter.
+   */
+  unsigned int offset, d;
+  hx_index nt, szt;
+  FILE *fh;
+
+  /* check that the input filename is valid. */
+  if (D->fname == NULL)
+    throw("invalid input filename");
+
+  /* attempt to read the file and dimension headers from the file. */
+  if (!ucsf_read_header(D->fname, &endian, &fhdr, &dhdr))
+    throw("failed to read header of '%s'", D->fname);
+
+  /* allocate the tiling index arrays. */
+  nt = hx_index_alloc(fhdr.ndims);
+  szt = hx_index_alloc(fhdr.ndims);
+
+  /* check that allocation succeeded. */
+  if (!nt || !szt)
+    throw("failed to allocate two sets of %u indices", fhdr.ndims);
+
+  /* determine the tiling of the file. */
+  if (!ucsf_tiling(&fhdr, dhdr, nt, szt))
+    throw("failed to determine tiling of '%s'", D->fname);
+
+  /* compute the byte offset from which to begin reading point data. */
+  offset = sizeof(struct ucsf_file_header);
+  offset += fhdr.ndims * sizeof(struct ucsf_dim_header);
+
+  /* open the input file for reading. */
+  fh = fopen(D->fname, "rb");
+
+  /* check that the file was opened. */
+  if (!fh)
+    throw("failed to open '%s'", D->fname);
+
+  /* read the overlapping tiles into the output array. */
+  if (!hx_array_fread_tiled(fh, &D->array, endian, sizeof(float), 1,
+                            offset, fhdr.ndims, nt, szt,
+                            HX_ARRAY_INCR_REVERSE, lower, upper))
+    throw("failed to read tiled data from '%s'", D->fname);
+
+  /* close the input file. */
+  fclose(fh);
+
+  /* store the real array dimension indices. */
+  for (d = 0; d < D->nd; d++) {
+    D->dims[d].d = DATUM_DIM_INVALID;
+    D->dims[d].k = (int) d;
+  }
+
+  /* free the allocated memory. */
+  hx_index_free(nt);
+  hx_index_free(szt);
+  free(dhdr);
+
+  /* return success. */
+  return 1;
+}
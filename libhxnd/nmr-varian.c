@@ -92,29 +92,85 @@ struct varian_hdr_ext {
   float f_spare2;
 };
 
+/* varian_parse_parms(): parse every parameter of a varian 'procpar'
+ * file into a parameter table, keeping the line that follows each
+ * attributes line as the unparsed value.
+ * @fh: the opened parameter file.
+ * @P: the destination parameter table.
+ */
+int varian_parse_parms (FILE *fh, parms *P) {
+  /* declare required variables for file/string parsing:
+   * @buf: buffer string for each line of the file.
+   * @attr: string array of parameter attributes.
+   * @nattr: length of @attr.
+   * @ok: whether the parameter was stored.
+   */
+  char buf[N_BUF], **attr;
+  unsigned int nattr;
+  int ok;
+
+  /* loop until we've read the entire file. */
+  while (!feof(fh)) {
+    /* read a new line from the file. */
+    if (!fgets(buf, N_BUF, fh))
+      continue;
+
+    /* trim trailing newlines from the string. */
+    strnltrim((char*) buf);
+
+    /* split the line by whitespace. */
+    attr = strsplit(buf, " ", &nattr);
+    if (!attr)
+      throw("failed to split parameter line");
+
+    /* check if we've hit an attributes line. */
+    ok = 1;
+    if (nattr == 11) {
+      /* read the values line that follows the attributes. */
+      if (fgets(buf, N_BUF, fh)) {
+        /* trim trailing newlines and store the values line. */
+        strnltrim((char*) buf);
+        ok = parms_set(P, attr[0], buf);
+      }
+    }
+
+    /* free the string array. */
+    strvfree(attr, nattr);
+
+    /* check that the parameter was stored. */
+    if (!ok)
+      throw("failed to store parameter");
+  }
+
+  /* return success. */
+  return 1;
+}
+
 /* varian_read_parms(): read any number of parameters from a varian
  * 'procpar' file. each parameter requested must be provided as a
- * type char, a key string, and a result pointer.
+ * type char, a key string, and a result pointer. the file is parsed
+ * once into a cached table, so repeated calls on the same file only
+ * perform table lookups.
  * @fname: the parameter filename.
  * @n: the number of parameters to read.
  * @...: the parameters requested.
  */
 int varian_read_parms (const char *fname, unsigned int n, ...) {
-  /* declare required variables for file/string parsing:
-   * @buf: buffer string for each line of the file.
-   * @attr: string array of parameter attributes.
+  /* declare required variables for parameter lookup:
+   * @P: the parsed parameter table.
+   * @str: unparsed values line of the current parameter.
    * @fields: string array of parameter values.
    * @ncpy: number of chars to copy for strings.
-   * @nattr: length of @attr.
    * @nfields: length of @fields.
-   * @fh: the input file handle.
    */
-  char buf[N_BUF], **attr, **fields;
-  unsigned int ncpy, nattr, nfields;
-  FILE *fh;
+  unsigned int ncpy, nfields;
+  const char *str;
+  char **fields;
+  parms *P;
 
   /* declare required variables for variable arguments parsing:
    * @i: parameter index, out of @n.
+   * @j: value index, for integer arrays.
    * @nid: number of parameters parsed.
    * @vl: variable argument list structure.
    */
@@ -122,145 +178,93 @@ int varian_read_parms (const char *fname, unsigned int n, ...) {
   va_list vl;
 
   /* declare required variables for key/value pair parsing:
-   * @keys: key string array.
-   * @typs: value type char array.
-   * @vals: result pointer array.
+   * @typ: currently parsed value type char.
    * @key: currently parsed key.
    * @val: currently parsed pointer.
    */
-  char **keys, *typs;
-  void **vals;
-  char *key;
+  char typ, *key;
   void *val;
 
-  /* open the file for reading. */
-  fh = fopen(fname, "rb");
+  /* get the parameter table of the file. */
+  P = parms_load(fname, varian_parse_parms);
 
-  /* check that the file was opened. */
-  if (!fh)
-    throw("failed to open '%s'", fname);
+  /* check that the table was loaded. */
+  if (!P)
+    throw("failed to load parameters from '%s'", fname);
 
-  /* initialize the variable arguments list. */
+  /* initialize the variable arguments list and the number of read
+   * parameters.
+   */
   va_start(vl, n);
-
-  /* allocate memory to store the search options for each parameter. */
-  keys = (char**) malloc(n * sizeof(char*));
-  vals = (void**) malloc(n * sizeof(void*));
-  typs = (char*) malloc(n * sizeof(char));
-
-  /* check that the memory was allocated successfully. */
-  if (!keys || !vals || !typs)
-    throw("failed to allocate option arrays");
+  nid = 0;
 
   /* loop through the expected number of parameters. */
   for (i = 0; i < n; i++) {
     /* read a type, a key and a pointer from the arguments list. */
-    typs[i] = (char) va_arg(vl, int);
+    typ = (char) va_arg(vl, int);
     key = va_arg(vl, char*);
     val = va_arg(vl, void*);
 
-    /* allocate memory to hold the key string. */
-    keys[i] = (char*) malloc((strlen(key) + 1) * sizeof(char));
-
-    /* check that key string memory was allocated. */
-    if (!keys[i])
-      throw("failed to allocate key string %d", i);
+    /* look up the parameter, skipping it if it was not found. */
+    str = parms_get(P, key);
+    if (!str)
+      continue;
 
-    /* copy the key string and pointer into their arrays. */
-    strcpy(keys[i], key);
-    vals[i] = val;
-  }
+    /* increment the number of identified parameters. */
+    nid++;
 
-  /* free the variable arguments list and initialize the number
-   * of read parameters.
-   */
-  va_end(vl);
-  nid = 0;
+    /* split the values line by whitespace or quotes. */
+    if (typ == VARIAN_PARMTYPE_STRING)
+      fields = strsplit(str, "\"", &nfields);
+    else
+      fields = strsplit(str, " ", &nfields);
 
-  /* loop until we've read the entire file. */
-  while (!feof(fh)) {
-    /* read a new line from the file. */
-    if (fgets(buf, N_BUF, fh)) {
-      /* trim trailing newlines from the string. */
-      strnltrim((char*) buf);
-
-      /* split the line by whitespace. */
-      attr = strsplit(buf, " ", &nattr);
-
-      /* check if we've hit an attributes line. */
-      if (nattr == 11) {
-        /* loop through the parameters to search for. */
-        for (i = 0; i < n; i++) {
-          /* check if the current parameter key is a match. */
-          if (strcmp(keys[i], attr[0]) == 0) {
-            /* yep! increment the number of identified parameters. */
-            nid++;
-
-            /* tokenize the next line. */
-            if (!fgets(buf, N_BUF, fh))
-              continue;
-
-            /* trim trailing newlines from the string. */
-            strnltrim((char*) buf);
-
-            /* split the next line by whitespace or quotes. */
-            if (typs[i] == VARIAN_PARMTYPE_STRING)
-              fields = strsplit(buf, "\"", &nfields);
-            else
-              fields = strsplit(buf, " ", &nfields);
-
-            /* act based on the parameter type. */
-            switch (typs[i]) {
-              /* integer. */
-              case VARIAN_PARMTYPE_INT:
-                *((int*) vals[i]) = atol(fields[1]);
-                break;
-
-              /* integer array. */
-              case VARIAN_PARMTYPE_INTS:
-                for (j = 0; j < nfields && strlen(fields[j]); j++)
-                  ((int*) vals[i])[j] = atol(fields[j]);
-                break;
-
-              /* float */
-              case VARIAN_PARMTYPE_FLOAT:
-                *((float*) vals[i]) = atof(fields[1]);
-                break;
-
-              /* string */
-              case VARIAN_PARMTYPE_STRING:
-                ncpy = strlen(fields[1]);
-                strncpy(vals[i], fields[1], ncpy);
-                ((char*) vals[i])[ncpy] = '\0';
-                break;
-
-              /* other. */
-              default:
-                break;
-            }
-
-            /* free the fields string array. */
-            strvfree(fields, nfields);
-          }
-        }
-      }
+    /* check that the values line was split. */
+    if (!fields)
+      continue;
 
-      /* free the string array. */
-      strvfree(attr, nattr);
+    /* skip scalar parameters that hold no values. */
+    if (nfields < 2 && typ != VARIAN_PARMTYPE_INTS) {
+      strvfree(fields, nfields);
+      continue;
     }
-  }
 
-  /* close the input file. */
-  fclose(fh);
+    /* act based on the parameter type. */
+    switch (typ) {
+      /* integer. */
+      case VARIAN_PARMTYPE_INT:
+        *((int*) val) = atol(fields[1]);
+        break;
+
+      /* integer array. */
+      case VARIAN_PARMTYPE_INTS:
+        for (j = 0; j < nfields && strlen(fields[j]); j++)
+          ((int*) val)[j] = atol(fields[j]);
+        break;
+
+      /* float */
+      case VARIAN_PARMTYPE_FLOAT:
+        *((float*) val) = atof(fields[1]);
+        break;
+
+      /* string */
+      case VARIAN_PARMTYPE_STRING:
+        ncpy = strlen(fields[1]);
+        strncpy(val, fields[1], ncpy);
+        ((char*) val)[ncpy] = '\0';
+        break;
+
+      /* other. */
+      default:
+        break;
+    }
 
-  /* free each key string in the array. */
-  for (i = 0; i < n; i++)
-    free(keys[i]);
+    /* free the fields string array. */
+    strvfree(fields, nfields);
+  }
 
-  /* free the temporary search option arrays. */
-  free(keys);
-  free(vals);
-  free(typs);
+  /* free the variable arguments list. */
+  va_end(vl);
 
   /* return the number of read parameters. */
   return nid;
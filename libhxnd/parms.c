@@ -0,0 +1,280 @@
+
+/* hxnd: A framework for n-dimensional hypercomplex calculations for NMR.
+ * Copyright (C) 2014  Bradley Worley  <geekysuavo@gmail.com>.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to:
+ *
+ *   Free Software Foundation, Inc.
+ *   51 Franklin Street, Fifth Floor
+ *   Boston, MA  02110-1301, USA.
+ */
+
+/* request posix extensions for file status queries. */
+#define _POSIX_C_SOURCE 200809L
+
+/* include the parameter table header. */
+#include <hxnd/parms.h>
+
+/* include the posix file status header. */
+#include <sys/stat.h>
+
+/* parms_cache: most recently parsed parameter files, which allows
+ * the many lookups made while decoding a single dataset to share one
+ * parse of each file.
+ */
+static parms *parms_cache[PARMS_N_CACHE];
+
+/* parms_cache_next: cache slot to be replaced on the next miss.
+ */
+static unsigned int parms_cache_next = 0;
+
+/* parms_hash(): compute the hash table bucket of a parameter name.
+ * @key: the parameter name string.
+ */
+static unsigned int parms_hash (const char *key) {
+  /* declare a required variable:
+   * @h: fnv-1a hash value.
+   */
+  uint32_t h;
+
+  /* hash each character of the key. */
+  for (h = 2166136261u; *key; key++) {
+    h ^= (uint8_t) *key;
+    h *= 16777619u;
+  }
+
+  /* return the bucket index. */
+  return (unsigned int) (h % PARMS_N_BUCKET);
+}
+
+/* parms_free(): free all memory associated with a parameter table.
+ * @P: pointer to the table to free.
+ */
+static void parms_free (parms *P) {
+  /* declare a few required variables:
+   * @e: current table entry.
+   * @next: following table entry.
+   * @i: bucket loop counter.
+   */
+  parms_entry *e, *next;
+  unsigned int i;
+
+  /* return if the table is null. */
+  if (!P)
+    return;
+
+  /* free the entries of each bucket. */
+  for (i = 0; i < PARMS_N_BUCKET; i++) {
+    for (e = P->tab[i]; e; e = next) {
+      next = e->next;
+      free(e->key);
+      free(e->val);
+      free(e);
+    }
+  }
+
+  /* free the filename and the table itself. */
+  free(P->fname);
+  free(P);
+}
+
+/* parms_set(): store a parameter value in a table, replacing any value
+ * already stored under the same name.
+ * @P: pointer to the destination table.
+ * @key: the parameter name string.
+ * @val: the unparsed parameter value string.
+ */
+int parms_set (parms *P, const char *key, const char *val) {
+  /* declare a few required variables:
+   * @e: table entry for the parameter.
+   * @s: copy of the value string.
+   * @h: bucket index of the parameter.
+   */
+  parms_entry *e;
+  unsigned int h;
+  char *s;
+
+  /* copy the value string. */
+  s = (char*) malloc((strlen(val) + 1) * sizeof(char));
+  if (!s)
+    throw("failed to allocate value of '%s'", key);
+
+  /* store the value string. */
+  strcpy(s, val);
+
+  /* search the bucket for an existing entry. */
+  h = parms_hash(key);
+  for (e = P->tab[h]; e; e = e->next) {
+    /* replace the value of a matching entry. */
+    if (strcmp(e->key, key) == 0) {
+      free(e->val);
+      e->val = s;
+      return 1;
+    }
+  }
+
+  /* allocate a new entry. */
+  e = (parms_entry*) malloc(sizeof(parms_entry));
+  if (!e)
+    throw("failed to allocate entry for '%s'", key);
+
+  /* allocate the key string of the entry. */
+  e->key = (char*) malloc((strlen(key) + 1) * sizeof(char));
+  if (!e->key)
+    throw("failed to allocate key '%s'", key);
+
+  /* fill the entry and link it into the bucket. */
+  strcpy(e->key, key);
+  e->val = s;
+  e->next = P->tab[h];
+  P->tab[h] = e;
+  P->n++;
+
+  /* return success. */
+  return 1;
+}
+
+/* parms_get(): look up the unparsed value of a parameter in a table.
+ * returns NULL if the parameter was not stored.
+ * @P: pointer to the table to search.
+ * @key: the parameter name string.
+ */
+const char *parms_get (parms *P, const char *key) {
+  /* declare a required variable:
+   * @e: current table entry.
+   */
+  parms_entry *e;
+
+  /* search the bucket of the parameter. */
+  for (e = P->tab[parms_hash(key)]; e; e = e->next) {
+    /* return the value of a matching entry. */
+    if (strcmp(e->key, key) == 0)
+      return e->val;
+  }
+
+  /* no match found. */
+  return NULL;
+}
+
+/* parms_load(): return the parameter table of a file, parsing the file
+ * only if it has not already been parsed, or has changed since it was.
+ * the returned table is owned by the cache and must not be freed.
+ * @fname: the parameter filename.
+ * @parser: function that parses the opened file into a table.
+ */
+parms *parms_load (const char *fname, parms_parser parser) {
+  /* declare a few required variables:
+   * @st: file status of the parameter file.
+   * @P: parameter table.
+   * @fh: input file handle.
+   * @i: cache slot loop counter.
+   */
+  struct stat st;
+  unsigned int i;
+  parms *P;
+  FILE *fh;
+
+  /* get the current status of the file. */
+  if (stat(fname, &st)) {
+    /* raise an error and return nothing. */
+    raise("failed to stat '%s'", fname);
+    return NULL;
+  }
+
+  /* search the cache for an up-to-date table of the file. */
+  for (i = 0; i < PARMS_N_CACHE; i++) {
+    /* skip empty and non-matching slots. */
+    P = parms_cache[i];
+    if (!P || P->parser != parser || strcmp(P->fname, fname))
+      continue;
+
+    /* return the table if the file is unchanged. */
+    if (P->fsz == (long) st.st_size && P->mtime == st.st_mtime)
+      return P;
+
+    /* drop the stale table. */
+    parms_free(P);
+    parms_cache[i] = NULL;
+  }
+
+  /* allocate a new table. */
+  P = (parms*) calloc(1, sizeof(parms));
+  if (!P) {
+    /* raise an error and return nothing. */
+    raise("failed to allocate parameter table");
+    return NULL;
+  }
+
+  /* store the file identification. */
+  P->fname = (char*) malloc((strlen(fname) + 1) * sizeof(char));
+  if (!P->fname) {
+    /* free the table and return nothing. */
+    raise("failed to allocate filename string");
+    parms_free(P);
+    return NULL;
+  }
+
+  /* fill the identification fields. */
+  strcpy(P->fname, fname);
+  P->fsz = (long) st.st_size;
+  P->mtime = st.st_mtime;
+  P->parser = parser;
+
+  /* open the file for reading. */
+  fh = fopen(fname, "rb");
+  if (!fh) {
+    /* free the table and return nothing. */
+    raise("failed to open '%s'", fname);
+    parms_free(P);
+    return NULL;
+  }
+
+  /* parse the file contents into the table. */
+  if (!parser(fh, P)) {
+    /* close the file, free the table and return nothing. */
+    raise("failed to parse '%s'", fname);
+    fclose(fh);
+    parms_free(P);
+    return NULL;
+  }
+
+  /* close the input file. */
+  fclose(fh);
+
+  /* store the table in the next cache slot. */
+  parms_free(parms_cache[parms_cache_next]);
+  parms_cache[parms_cache_next] = P;
+  parms_cache_next = (parms_cache_next + 1) % PARMS_N_CACHE;
+
+  /* return the new table. */
+  return P;
+}
+
+/* parms_cache_free(): release every parameter table held in the cache.
+ */
+void parms_cache_free (void) {
+  /* declare a required variable:
+   * @i: cache slot loop counter.
+   */
+  unsigned int i;
+
+  /* free each cached table. */
+  for (i = 0; i < PARMS_N_CACHE; i++) {
+    parms_free(parms_cache[i]);
+    parms_cache[i] = NULL;
+  }
+
+  /* reset the replacement slot. */
+  parms_cache_next = 0;
+}
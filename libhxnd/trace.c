@@ -116,56 +116,73 @@ void traceback_clear (void) {
  */
 int traceback_throw (const char *f, const unsigned int l,
                      const char *format, ...) {
-  /* declare a few required variables. */
+  /* declare a few required variables:
+   * @tbnew: reallocated traceback array.
+   * @file: copy of the emitter filename.
+   * @msg: custom message string.
+   * @num: error code at the time of the throw.
+   */
+  struct traceback *tbnew;
+  char *file, *msg;
   unsigned int n_msg;
-  int i, n_print;
+  int n_print, num;
   va_list vl;
 
-  /* ensure the traceback array is initialized. */
-  traceback_init();
-
-  /* increment the traceback array size. */
-  i = n_tb;
-  n_tb++;
-
-  /* reallocate the traceback array. */
-  tb = (struct traceback*) realloc(tb, n_tb * sizeof(struct traceback));
-  if (!tb)
-    return 0;
+  /* store the current error code. */
+  num = errno;
 
-  /* add the filename string to the traceback. */
+  /* copy the filename string. */
   n_msg = 2 * strlen(f);
-  tb[i].file = (char*) malloc(n_msg * sizeof(char));
-  if (tb[i].file)
-    strcpy(tb[i].file, f);
-
-  /* add the information into the traceback. */
-  tb[i].num = errno;
-  tb[i].line = l;
+  file = (char*) malloc(n_msg * sizeof(char));
+  if (file)
+    strcpy(file, f);
 
   /* build the custom message string. */
+  msg = NULL;
   if (format) {
     /* begin with a guess of the output string length. */
     n_msg = strlen(format);
-    tb[i].msg = NULL;
 
     /* loop until the whole string was printed. */
     do {
       /* allocate memory for the message. */
       n_msg *= 2;
-      tb[i].msg = (char*) realloc(tb[i].msg, n_msg * sizeof(char));
+      msg = (char*) realloc(msg, n_msg * sizeof(char));
 
       /* check that the array was allocated successfully. */
-      if (!tb[i].msg)
-        return 0;
+      if (!msg)
+        break;
 
       /* write the formatted message string. */
       va_start(vl, format);
-      n_print = vsnprintf(tb[i].msg, n_msg, format, vl);
+      n_print = vsnprintf(msg, n_msg, format, vl);
       va_end(vl);
     } while (n_print >= n_msg);
   }
 
+  /* append the frame to the traceback. frames may be thrown from several
+   * threads at once, so only one thread appends at a time.
+   */
+  #pragma omp critical (traceback)
+  {
+    /* ensure the traceback array is initialized. */
+    traceback_init();
+
+    /* reallocate the traceback array. */
+    tbnew = (struct traceback*)
+      realloc(tb, (n_tb + 1) * sizeof(struct traceback));
+
+    /* store the new frame. */
+    if (tbnew) {
+      tb = tbnew;
+      tb[n_tb].file = file;
+      tb[n_tb].msg = msg;
+      tb[n_tb].num = num;
+      tb[n_tb].line = l;
+      n_tb++;
+    }
+  }
+
   /* always return failure. this allows the throw() macro to be used
    * easily in tail-calls.
    */
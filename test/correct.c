@@ -0,0 +1,121 @@
+
+/* hxnd: A framework for n-dimensional hypercomplex calculations for NMR.
+ * Copyright (C) 2014-2015  Bradley Worley  <geekysuavo@gmail.com>.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to:
+ *
+ *   Free Software Foundation, Inc.
+ *   51 Franklin Street, Fifth Floor
+ *   Boston, MA  02110-1301, USA.
+ */
+
+/* include the hypercomplex math header. */
+#include <hxnd/hx.h>
+
+/* CORRECT_D, CORRECT_K: algebraic and topological dimensionalities of the
+ * arrays used to compare the correction passes.
+ */
+#define CORRECT_D  3
+#define CORRECT_K  3
+
+/* main(): compare the fused correction pass of hx_array_correct() against
+ * the per-dimension sign alternation, imaginary negation, shift and resize
+ * passes that it replaced, for every combination of alternated and negated
+ * dimensions and every number of removed leading points.
+ */
+int main (int argc, char **argv) {
+  /* declare variables for the compared arrays:
+   * @x: array corrected in a single fused pass.
+   * @y: array corrected one dimension at a time.
+   * @x0: uncorrected source array.
+   * @sz: topological array size.
+   * @szc: topological array size after point removal.
+   */
+  hx_array x, y, x0;
+  int sz[CORRECT_K] = { 6, 5, 4 };
+  int szc[CORRECT_K];
+
+  /* declare variables for looping over the corrections:
+   * @alt: bit mask of sign-alternated topological dimensions.
+   * @neg: bit mask of negated algebraic dimensions.
+   * @ncrop: number of removed leading points.
+   * @n_fail: number of mismatched combinations.
+   * @i: general purpose loop counter.
+   */
+  int alt, neg, ncrop, n_fail, i;
+
+  /* allocate the source array. */
+  hx_array_init(&x0);
+  if (!hx_array_alloc(&x0, CORRECT_D, CORRECT_K, sz))
+    trace("failed to allocate source array");
+
+  /* fill the source array with distinct nonzero coefficients. */
+  for (i = 0; i < x0.len; i++)
+    x0.x[i] = (real) (i + 1);
+
+  /* loop over every combination of corrections. */
+  n_fail = 0;
+  for (ncrop = 0; ncrop < sz[0]; ncrop++) {
+    for (alt = 0; alt < (1 << CORRECT_K); alt++) {
+      for (neg = 0; neg < (1 << CORRECT_D); neg++) {
+        /* copy the source array into both compared arrays. */
+        if (!hx_array_copy(&x, &x0) || !hx_array_copy(&y, &x0))
+          trace("failed to copy source array");
+
+        /* apply the fused correction pass. */
+        if (!hx_array_correct(&x, alt, neg, ncrop))
+          trace("failed to apply fused correction");
+
+        /* apply the per-dimension correction passes. */
+        for (i = 0; i < CORRECT_K; i++) {
+          if ((alt & (1 << i)) && !hx_array_alternate_sign(&y, i))
+            trace("failed to sign-alternate dimension %d", i);
+        }
+        for (i = 0; i < CORRECT_D; i++) {
+          if ((neg & (1 << i)) && !hx_array_negate_basis(&y, i))
+            trace("failed to negate algebraic dimension %d", i);
+        }
+
+        /* shift out and remove the leading points. */
+        memcpy(szc, sz, CORRECT_K * sizeof(int));
+        szc[0] -= ncrop;
+        if (!hx_array_shift(&y, 0, -ncrop) ||
+            !hx_array_resize(&y, y.d, y.k, szc))
+          trace("failed to remove %d leading points", ncrop);
+
+        /* compare the results. */
+        if (hx_array_cmp(&x, &y) != HXCMP_ID) {
+          fprintf(stderr, "correct: mismatch at alt=0x%x neg=0x%x "
+                  "crop=%d\n", alt, neg, ncrop);
+          n_fail++;
+        }
+
+        /* free the compared arrays. */
+        hx_array_free(&x);
+        hx_array_free(&y);
+      }
+    }
+  }
+
+  /* free the source array. */
+  hx_array_free(&x0);
+
+  /* report the results. */
+  fprintf(stderr, "correct: %d of %d combinations mismatched\n",
+          n_fail, sz[0] << (CORRECT_K + CORRECT_D));
+
+  /* return the comparison status. */
+  return (n_fail ? 1 : 0);
+}
+
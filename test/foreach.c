@@ -0,0 +1,147 @@
+
+/* hxnd: A framework for n-dimensional hypercomplex calculations for NMR.
+ * Copyright (C) 2014-2015  Bradley Worley  <geekysuavo@gmail.com>.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to:
+ *
+ *   Free Software Foundation, Inc.
+ *   51 Franklin Street, Fifth Floor
+ *   Boston, MA  02110-1301, USA.
+ */
+
+/* include the hypercomplex math header. */
+#include <hxnd/hx.h>
+
+/* FOREACH_K: topological dimensionality of the arrays used to check the
+ * per-vector iteration.
+ */
+#define FOREACH_K  3
+
+/* foreach_cb(): per-vector callback that scales each vector by its packed
+ * index plus one, and counts the vectors it receives.
+ *
+ * varargs:
+ *  @nv: pointer to the number of visited vectors.
+ */
+int foreach_cb (hx_array *x, hx_array *y, hx_index idx, int pidx,
+                va_list *vl) {
+  /* declare a few required variables:
+   * @nv: pointer to the vector count.
+   * @i: coefficient loop counter.
+   */
+  int *nv, i;
+
+  /* get the vector count. */
+  nv = va_arg(*vl, int*);
+  (*nv)++;
+
+  /* scale the vector coefficients. */
+  for (i = 0; i < y->len; i++)
+    y->x[i] *= (real) (pidx + 1);
+
+  /* return success. */
+  return 1;
+}
+
+/* foreach_check(): iterate over the vectors of an array along each of its
+ * dimensions and check that every vector is visited and stored once.
+ * @sz: topological array size.
+ */
+int foreach_check (int *sz) {
+  /* declare a few required variables:
+   * @x: array visited by the iteration.
+   * @k: vector dimension loop counter.
+   * @nv: number of visited vectors.
+   * @n_fail: number of failed dimensions.
+   * @i: coefficient loop counter.
+   * @j: packed vector index of a coefficient.
+   * @idx: unpacked index of a coefficient.
+   * @ok: whether the current dimension succeeded.
+   */
+  int k, nv, n_fail, i, j, ok;
+  int idx[FOREACH_K];
+  hx_array x;
+
+  /* loop over the vector dimensions. */
+  for (k = 0, n_fail = 0; k < FOREACH_K; k++) {
+    /* allocate the array and fill it with ones. */
+    if (!hx_array_alloc(&x, 1, FOREACH_K, sz))
+      trace("failed to allocate (1, %d)-array", FOREACH_K);
+
+    for (i = 0; i < x.len; i++)
+      x.x[i] = 1.0;
+
+    /* iterate over the vectors. */
+    nv = 0;
+    ok = hx_array_foreach_vector(&x, k, &foreach_cb, &nv);
+    if (!ok) {
+      traceback_print();
+      traceback_clear();
+    }
+
+    /* check the number of visited vectors. */
+    ok = (ok && nv == x.len / (x.n * x.sz[k]));
+
+    /* check that each coefficient was scaled by its vector index. */
+    for (i = 0; ok && i < x.len; i += x.n) {
+      /* compute the packed index of the vector origin. */
+      hx_index_unpack(x.k, x.sz, idx, i / x.n);
+      idx[k] = 0;
+      hx_index_pack(x.k, x.sz, idx, &j);
+
+      /* compare the coefficient. */
+      ok = (x.x[i] == (real) (j + 1));
+    }
+
+    /* report failures. */
+    if (!ok) {
+      fprintf(stderr, "foreach: failed on (%d, %d, %d) along %d\n",
+              sz[0], sz[1], sz[2], k);
+      n_fail++;
+    }
+
+    /* free the array. */
+    hx_array_free(&x);
+  }
+
+  /* return the number of failures. */
+  return n_fail;
+}
+
+/* main(): check per-vector iteration over arrays that hold single-point
+ * dimensions, including the first dimension, where consecutive vectors
+ * are adjacent in memory.
+ */
+int main (int argc, char **argv) {
+  /* declare variables for the checked array sizes:
+   * @sizes: topological sizes of each checked array.
+   * @n_fail: number of failed checks.
+   * @i: array size loop counter.
+   */
+  int sizes[][FOREACH_K] = {
+    { 1, 5, 3 }, { 1, 1, 40 }, { 4, 1, 3 }, { 6, 5, 1 }, { 1, 1, 1 }
+  };
+  int i, n_fail;
+
+  /* check each array size. */
+  for (i = 0, n_fail = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    n_fail += foreach_check(sizes[i]);
+
+  /* report the results. */
+  fprintf(stderr, "foreach: %d failed checks\n", n_fail);
+
+  /* return the check status. */
+  return (n_fail ? 1 : 0);
+}
+